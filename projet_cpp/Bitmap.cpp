@@ -0,0 +1,123 @@
+#include "Bitmap.h"
+#include <bitset>
+#include <stdexcept>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+Bitmap::Bitmap() : bits(0) {
+}
+
+Bitmap::Bitmap(size_t size, bool value) : words((size + 63) / 64, value ? ~uint64_t(0) : 0), bits(size) {
+    clearTail();
+}
+
+void Bitmap::set(size_t row) {
+    if (row >= bits) {
+        resize(row + 1);
+    }
+    words[row / 64] |= uint64_t(1) << (row % 64);
+}
+
+void Bitmap::reset(size_t row) {
+    if (row < bits) {
+        words[row / 64] &= ~(uint64_t(1) << (row % 64));
+    }
+}
+
+bool Bitmap::test(size_t row) const {
+    if (row >= bits) {
+        return false;
+    }
+    return (words[row / 64] >> (row % 64)) & 1;
+}
+
+void Bitmap::resize(size_t size) {
+    words.resize((size + 63) / 64, 0);
+    bits = size;
+    clearTail();
+}
+
+size_t Bitmap::size() const {
+    return bits;
+}
+
+size_t Bitmap::count() const {
+    size_t total = 0;
+    for (uint64_t word : words) {
+        total += std::bitset<64>(word).count();
+    }
+    return total;
+}
+
+bool Bitmap::none() const {
+    for (uint64_t word : words) {
+        if (word != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Bitmap& Bitmap::operator&=(const Bitmap& other) {
+    validateSize(other);
+    for (size_t i = 0; i < words.size(); i++) {
+        words[i] &= other.words[i];
+    }
+    return *this;
+}
+
+Bitmap& Bitmap::operator|=(const Bitmap& other) {
+    validateSize(other);
+    for (size_t i = 0; i < words.size(); i++) {
+        words[i] |= other.words[i];
+    }
+    return *this;
+}
+
+Bitmap& Bitmap::andNot(const Bitmap& other) {
+    validateSize(other);
+    for (size_t i = 0; i < words.size(); i++) {
+        words[i] &= ~other.words[i];
+    }
+    return *this;
+}
+
+std::vector<size_t> Bitmap::rows() const {
+    std::vector<size_t> result;
+    result.reserve(count());
+    forEach([&result](size_t row) { result.push_back(row); });
+    return result;
+}
+
+size_t Bitmap::lowestBit(uint64_t word) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return index;
+#else
+    return static_cast<size_t>(__builtin_ctzll(word));
+#endif
+}
+
+void Bitmap::clearTail() {
+    if (bits % 64 != 0 && !words.empty()) {
+        words.back() &= (uint64_t(1) << (bits % 64)) - 1;
+    }
+}
+
+void Bitmap::validateSize(const Bitmap& other) const {
+    if (other.bits != bits) {
+        throw std::invalid_argument("Bitmaps must have the same size");
+    }
+}
+
+Bitmap operator&(Bitmap left, const Bitmap& right) {
+    left &= right;
+    return left;
+}
+
+Bitmap operator|(Bitmap left, const Bitmap& right) {
+    left |= right;
+    return left;
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef BITMAP_H
+#define BITMAP_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Ensemble de lignes sous forme de bitmap, combiné mot par mot (64 lignes à la fois)
+class Bitmap {
+public:
+    Bitmap();
+    explicit Bitmap(size_t size, bool value = false);
+
+    void set(size_t row);
+    void reset(size_t row);
+    bool test(size_t row) const;
+    void resize(size_t size);
+
+    size_t size() const;
+    size_t count() const;
+    bool none() const;
+
+    Bitmap& operator&=(const Bitmap& other);
+    Bitmap& operator|=(const Bitmap& other);
+    Bitmap& andNot(const Bitmap& other);
+
+    // Positions des lignes présentes, dans l'ordre croissant
+    std::vector<size_t> rows() const;
+
+    template <typename Function>
+    void forEach(Function function) const {
+        for (size_t w = 0; w < words.size(); w++) {
+            uint64_t word = words[w];
+            while (word != 0) {
+                function(w * 64 + lowestBit(word));
+                word &= word - 1;
+            }
+        }
+    }
+
+private:
+    std::vector<uint64_t> words;
+    size_t bits;
+
+    static size_t lowestBit(uint64_t word);
+    void clearTail();
+    void validateSize(const Bitmap& other) const;
+};
+
+Bitmap operator&(Bitmap left, const Bitmap& right);
+Bitmap operator|(Bitmap left, const Bitmap& right);
+
+#endif
\ No newline at end of file
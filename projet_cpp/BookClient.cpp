@@ -0,0 +1,194 @@
+#include "BookClient.h"
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#ifdef MSG_NOSIGNAL
+#define BOOK_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define BOOK_SEND_FLAGS 0
+#endif
+
+using protocol::Opcode;
+
+void BookClient::createDeal(const protocol::DealSpec& spec) {
+    protocol::Encoder out = begin(Opcode::CREATE_DEAL);
+    protocol::encode(out, spec);
+}
+
+void BookClient::addFacility(const protocol::FacilitySpec& spec) {
+    protocol::Encoder out = begin(Opcode::ADD_FACILITY);
+    protocol::encode(out, spec);
+}
+
+void BookClient::pay(const protocol::PaymentSpec& spec) {
+    protocol::Encoder out = begin(Opcode::PAY);
+    protocol::encode(out, spec);
+}
+
+void BookClient::getDeal(const std::string& contractNum) {
+    begin(Opcode::GET_DEAL).putString(contractNum);
+}
+
+void BookClient::query(const protocol::QuerySpec& spec) {
+    protocol::Encoder out = begin(Opcode::QUERY);
+    protocol::encode(out, spec);
+}
+
+void BookClient::portfolio(const std::string& contractNum) {
+    begin(Opcode::PORTFOLIO).putString(contractNum);
+}
+
+void BookClient::accrue(const std::string& date, const std::string& contractNum, uint32_t facilityIndex) {
+    protocol::Encoder out = begin(Opcode::ACCRUE);
+    out.putString(date);
+    out.putString(contractNum);
+    out.putU32(facilityIndex);
+}
+
+size_t BookClient::getPendingCount() const {
+    return pending.size();
+}
+
+std::vector<protocol::Reply> BookClient::flush() {
+    send();
+    return receive();
+}
+
+void BookClient::send() {
+    if (!awaiting.empty()) {
+        throw std::logic_error("Previous batch has not been received");
+    }
+    if (pending.empty()) {
+        return;
+    }
+
+    std::vector<uint8_t> frame;
+    protocol::Encoder out(frame);
+    size_t start = out.beginFrame();
+    out.putU16(static_cast<uint16_t>(pending.size()));
+    frame.insert(frame.end(), requests.begin(), requests.end());
+    out.endFrame(start);
+
+    awaiting.swap(pending);
+    requests.clear();
+    sendFrame(frame);
+}
+
+std::vector<protocol::Reply> BookClient::receive() {
+    std::vector<protocol::Reply> replies;
+    if (awaiting.empty()) {
+        return replies;
+    }
+    std::vector<Opcode> opcodes;
+    opcodes.swap(awaiting);
+
+    std::vector<uint8_t> response = receiveFrame();
+    protocol::Decoder in(response.data(), response.size());
+    if (in.getU16() != opcodes.size()) {
+        throw std::runtime_error("Reply count does not match the batch");
+    }
+    for (Opcode opcode : opcodes) {
+        replies.push_back(protocol::decodeReply(in, opcode));
+    }
+    return replies;
+}
+
+protocol::Encoder BookClient::begin(Opcode opcode) {
+    if (pending.size() == 0xFFFF) {
+        throw std::length_error("Batch is full, flush it first");
+    }
+    pending.push_back(opcode);
+    protocol::Encoder out(requests);
+    out.putU8(static_cast<uint8_t>(opcode));
+    return out;
+}
+
+#ifndef _WIN32
+
+BookClient::BookClient(const std::string& socketPath) : fd(-1) {
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Socket path too long: " + socketPath);
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        std::string error = std::strerror(errno);
+        if (fd >= 0) {
+            close(fd);
+        }
+        throw std::runtime_error("Cannot connect to " + socketPath + ": " + error);
+    }
+}
+
+BookClient::BookClient(int fd) : fd(fd) {
+    if (fd < 0) {
+        throw std::invalid_argument("Invalid book server connection");
+    }
+}
+
+BookClient::~BookClient() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+void BookClient::sendFrame(const std::vector<uint8_t>& frame) {
+    size_t sent = 0;
+    while (sent < frame.size()) {
+        ssize_t n = ::send(fd, frame.data() + sent, frame.size() - sent, BOOK_SEND_FLAGS);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            throw std::runtime_error("Connection to the book server lost");
+        }
+        sent += static_cast<size_t>(n);
+    }
+}
+
+std::vector<uint8_t> BookClient::receiveFrame() {
+    std::vector<uint8_t> buffer;
+    size_t frame = 0;
+    uint8_t chunk[65536];
+    while ((frame = protocol::completeFrameSize(buffer.data(), buffer.size())) == 0) {
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            throw std::runtime_error("Connection to the book server lost");
+        }
+        buffer.insert(buffer.end(), chunk, chunk + n);
+    }
+    return std::vector<uint8_t>(buffer.begin() + 4, buffer.begin() + frame);
+}
+
+#else
+
+BookClient::BookClient(const std::string&) : fd(-1) {
+    throw std::runtime_error("Local book client is not supported on this platform");
+}
+
+BookClient::BookClient(int) : fd(-1) {
+    throw std::runtime_error("Local book client is not supported on this platform");
+}
+
+BookClient::~BookClient() {}
+
+void BookClient::sendFrame(const std::vector<uint8_t>&) {}
+
+std::vector<uint8_t> BookClient::receiveFrame() {
+    return {};
+}
+
+#endif
\ No newline at end of file
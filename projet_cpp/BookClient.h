@@ -0,0 +1,50 @@
+#ifndef BOOK_CLIENT_H
+#define BOOK_CLIENT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "BookProtocol.h"
+
+// Client du serveur de book : les requêtes sont mises en lot puis envoyées en une
+// seule trame par flush(), qui retourne les réponses dans l'ordre des requêtes
+class BookClient {
+public:
+    explicit BookClient(const std::string& socketPath);
+    // Connexion déjà ouverte (socketpair vers un processus shard), fermée par le client
+    explicit BookClient(int fd);
+    ~BookClient();
+
+    BookClient(const BookClient&) = delete;
+    BookClient& operator=(const BookClient&) = delete;
+
+    // Mise en lot des requêtes
+    void createDeal(const protocol::DealSpec& spec);
+    void addFacility(const protocol::FacilitySpec& spec);
+    void pay(const protocol::PaymentSpec& spec);
+    void getDeal(const std::string& contractNum);
+    void query(const protocol::QuerySpec& spec);
+    void portfolio(const std::string& contractNum = "");
+    // Arrêté de tout le book, ou d'une seule facility si le contrat est donné
+    void accrue(const std::string& date, const std::string& contractNum = "", uint32_t facilityIndex = 0);
+
+    size_t getPendingCount() const;
+    std::vector<protocol::Reply> flush();
+
+    // flush() en deux temps : plusieurs serveurs traitent leurs lots pendant que le
+    // client envoie les suivants, les réponses sont lues ensuite
+    void send();
+    std::vector<protocol::Reply> receive();
+
+private:
+    int fd;
+    std::vector<uint8_t> requests;
+    std::vector<protocol::Opcode> pending;
+    std::vector<protocol::Opcode> awaiting;   // Lot envoyé, réponses non lues
+
+    protocol::Encoder begin(protocol::Opcode opcode);
+    void sendFrame(const std::vector<uint8_t>& frame);
+    std::vector<uint8_t> receiveFrame();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,376 @@
+#include "BookDigest.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+uint64_t mix(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+// Empreinte 64 bits d'une suite de champs, sensible à leur ordre
+class Hasher {
+public:
+    Hasher& add(uint64_t value) {
+        state = mix(state ^ mix(value + 0x9e3779b97f4a7c15ULL));
+        return *this;
+    }
+
+    Hasher& add(int64_t value) {
+        return add(static_cast<uint64_t>(value));
+    }
+
+    Hasher& add(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return add(bits);
+    }
+
+    Hasher& add(const std::string& value) {
+        // FNV-1a sur les octets, précédé de la longueur
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (char c : value) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+        }
+        add(static_cast<uint64_t>(value.size()));
+        return add(hash);
+    }
+
+    // Jamais 0, réservé aux nœuds absents
+    uint64_t result() const {
+        return state == 0 ? 1 : state;
+    }
+
+private:
+    uint64_t state = 0x6a09e667f3bcc908ULL;
+};
+
+std::string contractOf(uint16_t code) {
+    std::string number = std::to_string(code % 10000);
+    return contract_tables::LETTERS[code / 10000 - 1] + std::string(4 - number.size(), '0') + number;
+}
+
+}
+
+// Arbre de Merkle
+
+void MerkleTrie::set(uint16_t key, uint64_t hash) {
+    uint32_t leaf = idOf(DEPTH, key);
+    auto it = nodes.find(leaf);
+    if (it == nodes.end() && hash == 0) {
+        return;
+    }
+    if (hash == 0) {
+        nodes.erase(it);
+        leaves--;
+    } else if (it == nodes.end()) {
+        nodes.emplace(leaf, hash);
+        leaves++;
+    } else {
+        it->second = hash;
+    }
+
+    // Recalcul du chemin jusqu'à la racine
+    for (int level = DEPTH - 1; level >= 0; level--) {
+        uint32_t prefix = static_cast<uint32_t>(key) >> (4 * (DEPTH - level));
+        Hasher hasher;
+        bool empty = true;
+        for (uint32_t child = 0; child < FANOUT; child++) {
+            uint64_t childHash = getNode(level + 1, prefix * FANOUT + child);
+            if (childHash != 0) {
+                hasher.add(static_cast<uint64_t>(child)).add(childHash);
+                empty = false;
+            }
+        }
+        if (empty) {
+            nodes.erase(idOf(level, prefix));
+        } else {
+            nodes[idOf(level, prefix)] = hasher.result();
+        }
+    }
+}
+
+uint64_t MerkleTrie::get(uint16_t key) const {
+    return getNode(DEPTH, key);
+}
+
+uint64_t MerkleTrie::getRoot() const {
+    return getNode(0, 0);
+}
+
+uint64_t MerkleTrie::getNode(int level, uint32_t prefix) const {
+    auto it = nodes.find(idOf(level, prefix));
+    return it == nodes.end() ? 0 : it->second;
+}
+
+size_t MerkleTrie::getLeavesCount() const {
+    return leaves;
+}
+
+void MerkleTrie::diff(const MerkleTrie& other, std::vector<uint16_t>& keys, size_t& visited) const {
+    diffNode(other, 0, 0, keys, visited);
+}
+
+void MerkleTrie::diffNode(const MerkleTrie& other, int level, uint32_t prefix, std::vector<uint16_t>& keys,
+                          size_t& visited) const {
+    visited++;
+    if (getNode(level, prefix) == other.getNode(level, prefix)) {
+        return;
+    }
+    if (level == DEPTH) {
+        keys.push_back(static_cast<uint16_t>(prefix));
+        return;
+    }
+    for (uint32_t child = 0; child < FANOUT; child++) {
+        diffNode(other, level + 1, prefix * FANOUT + child, keys, visited);
+    }
+}
+
+uint32_t MerkleTrie::idOf(int level, uint32_t prefix) {
+    return static_cast<uint32_t>(level) << 16 | prefix;
+}
+
+// Empreintes du book
+
+uint64_t BookDigest::hashPart(const Part& part) {
+    return Hasher().add(part.getMoney().getUnits()).add(part.getDate()).result();
+}
+
+BookDigest::FacilityDigest BookDigest::digestFacility(const Facility& facility) {
+    // Le registre d'intérêts courus est un état dérivé : il n'entre pas dans l'empreinte
+    Hasher terms;
+    terms.add(facility.getStartDate()).add(facility.getEndDate()).add(facility.getAmountMoney().getUnits())
+         .add(facility.getCurrency()).add(facility.getAnnualInterestRate());
+    terms.add(static_cast<uint64_t>(facility.isFloating()));
+    if (facility.isFloating()) {
+        terms.add(facility.getCurveCurrency().toString()).add(facility.getSpread());
+    }
+    for (size_t i = 0; i < facility.getLenders().size(); i++) {
+        terms.add(facility.getLenders()[i].getName()).add(facility.getShares()[i].getUnits());
+    }
+
+    FacilityDigest digest{0, terms.result(), {}};
+    Hasher hash;
+    hash.add(digest.terms);
+    for (const Part& part : facility.getParts()) {
+        digest.parts.push_back(hashPart(part));
+        hash.add(digest.parts.back());
+    }
+    digest.hash = hash.result();
+    return digest;
+}
+
+BookDigest::DealDigest BookDigest::digestDeal(const Deal& deal) {
+    Hasher terms;
+    terms.add(deal.getContractNum()).add(deal.getAgent()).add(deal.getBorrower().getName())
+         .add(deal.getProjectMoney().getUnits()).add(deal.getCurrency()).add(deal.getContractSignDate())
+         .add(deal.getContractEndDate()).add(static_cast<uint64_t>(deal.getStatus()));
+    for (const Lender& lender : deal.getPool()) {
+        terms.add(lender.getName());
+    }
+
+    DealDigest digest{0, terms.result(), {}};
+    Hasher hash;
+    hash.add(digest.terms);
+    for (const Facility& facility : deal.getFacilities()) {
+        digest.facilities.push_back(digestFacility(facility));
+        hash.add(digest.facilities.back().hash);
+    }
+    digest.hash = hash.result();
+    return digest;
+}
+
+BookDigest::BookDigest(BookStore& book) : book(book) {
+    for (const Deal& deal : book.getDeals()) {
+        update(deal);
+    }
+    book.addObserver(this);
+}
+
+BookDigest::~BookDigest() {
+    book.removeObserver(this);
+}
+
+uint64_t BookDigest::getRoot() const {
+    return borrowersTree.getRoot();
+}
+
+uint64_t BookDigest::getDealHash(const std::string& contractNum) const {
+    ContractNumber contract = ContractNumber::parse(contractNum);
+    auto it = borrowerOf.find(contract);
+    if (it == borrowerOf.end()) {
+        return 0;
+    }
+    return borrowers.at(it->second).deals.get(contract.getCode());
+}
+
+uint64_t BookDigest::getBorrowerHash(const std::string& borrower) const {
+    auto it = borrowers.find(borrower);
+    return it == borrowers.end() ? 0 : it->second.deals.getRoot();
+}
+
+const MerkleTrie& BookDigest::getBorrowersTree() const {
+    return borrowersTree;
+}
+
+BookDigest::Report BookDigest::compare(const BookDigest& other) const {
+    static const MerkleTrie empty;
+    Report report{{}, 0};
+
+    // Groupes d'emprunteurs différents, puis deals différents dans chaque emprunteur
+    std::vector<uint16_t> groups;
+    borrowersTree.diff(other.borrowersTree, groups, report.comparedNodes);
+    std::vector<uint16_t> contracts;
+    for (uint16_t group : groups) {
+        std::vector<std::string> names;
+        for (const BookDigest* side : {this, &other}) {
+            auto bucket = side->buckets.find(group);
+            if (bucket != side->buckets.end()) {
+                names.insert(names.end(), bucket->second.begin(), bucket->second.end());
+            }
+        }
+        std::sort(names.begin(), names.end());
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+        for (const std::string& name : names) {
+            auto here = borrowers.find(name);
+            auto there = other.borrowers.find(name);
+            const MerkleTrie& mine = here == borrowers.end() ? empty : here->second.deals;
+            const MerkleTrie& theirs = there == other.borrowers.end() ? empty : there->second.deals;
+            mine.diff(theirs, contracts, report.comparedNodes);
+        }
+    }
+    std::sort(contracts.begin(), contracts.end());
+    contracts.erase(std::unique(contracts.begin(), contracts.end()), contracts.end());
+
+    // Descente dans les seuls deals différents
+    for (uint16_t code : contracts) {
+        ContractNumber contract = ContractNumber::parse(contractOf(code));
+        const Deal* mine = findDeal(contract);
+        const Deal* theirs = other.findDeal(contract);
+        Difference difference{contract.toString(), Kind::CHANGED, false, {}};
+        if (!theirs) {
+            difference.kind = Kind::ONLY_HERE;
+        } else if (!mine) {
+            difference.kind = Kind::ONLY_THERE;
+        } else {
+            DealDigest a = digestDeal(*mine);
+            DealDigest b = digestDeal(*theirs);
+            if (a.hash == b.hash) {
+                continue;   // Deal passé d'un emprunteur à l'autre sans autre changement
+            }
+            difference.termsChanged = a.terms != b.terms;
+            for (size_t i = 0; i < std::max(a.facilities.size(), b.facilities.size()); i++) {
+                if (i >= a.facilities.size() || i >= b.facilities.size() || a.facilities[i].hash != b.facilities[i].hash) {
+                    difference.facilities.push_back(i);
+                }
+            }
+        }
+        report.differences.push_back(std::move(difference));
+    }
+    return report;
+}
+
+void BookDigest::onDealAdded(const Deal& deal) {
+    update(deal);
+}
+
+void BookDigest::onFacilityAdded(const Deal& deal, size_t) {
+    update(deal);
+}
+
+void BookDigest::onPartPaid(const Deal& deal, size_t) {
+    update(deal);
+}
+
+void BookDigest::onSharesTransferred(const Deal& deal, size_t) {
+    update(deal);
+}
+
+void BookDigest::onInterestAccrued(const Deal&, size_t) {
+    // Le condensé ne couvre pas les registres d'intérêts, recalculables par un arrêté
+}
+
+void BookDigest::onStatusChanged(const Deal& deal) {
+    update(deal);
+}
+
+void BookDigest::onAgentChanged(const Deal& deal) {
+    update(deal);
+}
+
+void BookDigest::onDealRemoved(const Deal& deal) {
+    remove(deal.getContractNumber());
+}
+
+void BookDigest::update(const Deal& deal) {
+    ContractNumber contract = deal.getContractNumber();
+    const std::string& borrower = deal.getBorrower().getName();
+    auto known = borrowerOf.find(contract);
+    if (known != borrowerOf.end() && known->second != borrower) {
+        remove(contract);
+    }
+
+    auto inserted = borrowers.emplace(borrower, BorrowerTree());
+    if (inserted.second) {
+        buckets[bucketOf(borrower)].push_back(borrower);
+    }
+    MerkleTrie& deals = inserted.first->second.deals;
+    uint64_t previous = deals.getRoot();
+    deals.set(contract.getCode(), digestDeal(deal).hash);
+    setBorrowerRoot(borrower, previous, deals.getRoot());
+    borrowerOf[contract] = borrower;
+}
+
+void BookDigest::remove(ContractNumber contract) {
+    auto known = borrowerOf.find(contract);
+    if (known == borrowerOf.end()) {
+        return;
+    }
+    std::string borrower = known->second;
+    borrowerOf.erase(known);
+
+    auto tree = borrowers.find(borrower);
+    uint64_t previous = tree->second.deals.getRoot();
+    tree->second.deals.set(contract.getCode(), 0);
+    setBorrowerRoot(borrower, previous, tree->second.deals.getRoot());
+    if (tree->second.deals.getLeavesCount() == 0) {
+        borrowers.erase(tree);
+        std::vector<std::string>& bucket = buckets[bucketOf(borrower)];
+        bucket.erase(std::find(bucket.begin(), bucket.end(), borrower));
+        if (bucket.empty()) {
+            buckets.erase(bucketOf(borrower));
+        }
+    }
+}
+
+void BookDigest::setBorrowerRoot(const std::string& borrower, uint64_t previous, uint64_t current) {
+    uint16_t bucket = bucketOf(borrower);
+    uint64_t leaf = borrowersTree.get(bucket);
+    if (previous != 0) {
+        leaf -= contribution(borrower, previous);
+    }
+    if (current != 0) {
+        leaf += contribution(borrower, current);
+    }
+    borrowersTree.set(bucket, leaf);
+}
+
+const Deal* BookDigest::findDeal(ContractNumber contract) const {
+    if (!book.hasDeal(contract.toString())) {
+        return nullptr;
+    }
+    return &book.getDeal(book.findDeal(contract));
+}
+
+uint16_t BookDigest::bucketOf(const std::string& borrower) {
+    return static_cast<uint16_t>(Hasher().add(borrower).result() >> 48);
+}
+
+uint64_t BookDigest::contribution(const std::string& borrower, uint64_t root) {
+    return Hasher().add(borrower).add(root).result();
+}
\ No newline at end of file
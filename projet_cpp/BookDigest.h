@@ -0,0 +1,128 @@
+#ifndef BOOK_DIGEST_H
+#define BOOK_DIGEST_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "BookStore.h"
+#include "ContractNumber.h"
+
+// Arbre de Merkle à clés de 16 bits : 4 niveaux de branchement 16 (un quartet de la clé
+// par niveau). Seuls les nœuds non vides sont stockés ; modifier une feuille recalcule
+// les 4 nœuds de son chemin. Deux arbres se comparent de la racine vers les feuilles
+// en ne descendant que dans les nœuds dont les empreintes diffèrent.
+class MerkleTrie {
+public:
+    static const int DEPTH = 4;
+    static const int FANOUT = 16;
+
+    // Empreinte 0 = feuille absente
+    void set(uint16_t key, uint64_t hash);
+    uint64_t get(uint16_t key) const;
+    uint64_t getRoot() const;
+    uint64_t getNode(int level, uint32_t prefix) const;
+    size_t getLeavesCount() const;
+
+    // Clés dont les feuilles diffèrent ; visited compte les nœuds comparés
+    void diff(const MerkleTrie& other, std::vector<uint16_t>& keys, size_t& visited) const;
+
+private:
+    // Identifiant de nœud : niveau (0 = racine, DEPTH = feuilles) et préfixe de la clé
+    std::unordered_map<uint32_t, uint64_t> nodes;
+    size_t leaves = 0;
+
+    static uint32_t idOf(int level, uint32_t prefix);
+    void diffNode(const MerkleTrie& other, int level, uint32_t prefix, std::vector<uint16_t>& keys,
+                  size_t& visited) const;
+};
+
+// Empreintes de contenu du book pour la réconciliation entre deux exemplaires
+// (banque agent, photo de la veille).
+//
+// Chaque part, facility et deal a une empreinte de 64 bits calculée sur son contenu
+// (non cryptographique : elle détecte les écarts, elle ne protège pas d'une
+// falsification). Les deals sont rangés dans un arbre de Merkle par emprunteur (clé :
+// numéro de contrat) et les emprunteurs dans un arbre de tête (clé : empreinte du nom).
+// L'empreinte est tenue à jour à chaque mutation du book pour le coût du seul deal
+// modifié. La comparaison de deux books ne descend que dans les branches différentes :
+// O(écarts × log n) empreintes échangées pour un book en grande partie inchangé.
+class BookDigest : public BookObserver {
+public:
+    // Empreintes d'un deal pour descendre jusqu'aux facilities et aux parts en écart
+    struct FacilityDigest {
+        uint64_t hash;
+        uint64_t terms;              // Conditions et participations, hors parts
+        std::vector<uint64_t> parts;
+    };
+
+    struct DealDigest {
+        uint64_t hash;
+        uint64_t terms;              // Attributs du deal, hors facilities
+        std::vector<FacilityDigest> facilities;
+    };
+
+    enum class Kind { ONLY_HERE, ONLY_THERE, CHANGED };
+
+    struct Difference {
+        std::string contractNum;
+        Kind kind;
+        bool termsChanged;                   // Attributs du deal différents (CHANGED)
+        std::vector<size_t> facilities;      // Facilities différentes ou absentes d'un côté (CHANGED)
+    };
+
+    struct Report {
+        std::vector<Difference> differences;
+        size_t comparedNodes;
+    };
+
+    static uint64_t hashPart(const Part& part);
+    static FacilityDigest digestFacility(const Facility& facility);
+    static DealDigest digestDeal(const Deal& deal);
+
+    // Reprend le book puis s'abonne à ses mutations
+    explicit BookDigest(BookStore& book);
+    ~BookDigest() override;
+
+    BookDigest(const BookDigest&) = delete;
+    BookDigest& operator=(const BookDigest&) = delete;
+
+    uint64_t getRoot() const;
+    uint64_t getDealHash(const std::string& contractNum) const;
+    uint64_t getBorrowerHash(const std::string& borrower) const;
+    const MerkleTrie& getBorrowersTree() const;
+
+    // Réconciliation avec un autre exemplaire, différences triées par contrat
+    Report compare(const BookDigest& other) const;
+
+    void onDealAdded(const Deal& deal) override;
+    void onFacilityAdded(const Deal& deal, size_t facilityIndex) override;
+    void onPartPaid(const Deal& deal, size_t facilityIndex) override;
+    void onSharesTransferred(const Deal& deal, size_t facilityIndex) override;
+    void onInterestAccrued(const Deal& deal, size_t facilityIndex) override;
+    void onStatusChanged(const Deal& deal) override;
+    void onAgentChanged(const Deal& deal) override;
+    void onDealRemoved(const Deal& deal) override;
+
+private:
+    struct BorrowerTree {
+        MerkleTrie deals;
+    };
+
+    BookStore& book;
+    std::unordered_map<ContractNumber, std::string> borrowerOf;
+    std::unordered_map<std::string, BorrowerTree> borrowers;
+    // Feuille d'un groupe d'emprunteurs : somme des empreintes (indépendante de l'ordre)
+    MerkleTrie borrowersTree;
+    std::unordered_map<uint16_t, std::vector<std::string>> buckets;
+
+    void update(const Deal& deal);
+    void remove(ContractNumber contract);
+    void setBorrowerRoot(const std::string& borrower, uint64_t previous, uint64_t current);
+    const Deal* findDeal(ContractNumber contract) const;
+
+    static uint16_t bucketOf(const std::string& borrower);
+    static uint64_t contribution(const std::string& borrower, uint64_t root);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,306 @@
+#include "BookHistory.h"
+#include "DateUtils.h"
+#include <algorithm>
+#include <ctime>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Registre d'intérêts rejoué sur les parts jusqu'à un jour donné (parts triées par date)
+struct Ledger {
+    int day;
+    Money balance;
+    double accrued;
+};
+
+Ledger replay(const FacilityVersion& facility, int untilDay) {
+    int start = toDayNumber(facility.startDate);
+    std::vector<std::pair<int, Money>> events;
+    for (size_t i = 0; i < facility.parts.size(); i++) {
+        const PartVersion& part = facility.parts[i];
+        events.push_back({std::max(part.day, start), part.amount});
+    }
+    std::stable_sort(events.begin(), events.end(),
+                     [](const std::pair<int, Money>& a, const std::pair<int, Money>& b) { return a.first < b.first; });
+
+    Ledger ledger{start, facility.amount, 0};
+    for (const auto& event : events) {
+        if (event.first > untilDay) {
+            break;
+        }
+        ledger.accrued += ledger.balance.toDouble() * facility.annualInterestRate * (event.first - ledger.day) / 365.0;
+        ledger.day = event.first;
+        ledger.balance -= event.second;
+    }
+    return ledger;
+}
+
+}
+
+double FacilityVersion::accruedInterestAt(int day) const {
+    if (day >= accrualDay) {
+        return accruedInterest + accrualBalance.toDouble() * annualInterestRate * (day - accrualDay) / 365.0;
+    }
+    // Date antérieure à la dernière part de la version : reprise des parts jusqu'à cette date
+    Ledger ledger = replay(*this, day);
+    if (day <= ledger.day) {
+        return ledger.accrued;
+    }
+    return ledger.accrued + ledger.balance.toDouble() * annualInterestRate * (day - ledger.day) / 365.0;
+}
+
+BookHistory::BookHistory(BookStore& book)
+    : BookHistory(book, toDateString(static_cast<int>(std::time(nullptr) / 86400))) {}
+
+BookHistory::BookHistory(BookStore& book, const std::string& currentDate)
+    : book(book), currentDay(toDayNumber(currentDate)), sequence(0) {
+    for (const Deal& deal : book.getDeals()) {
+        onDealAdded(deal);
+    }
+    book.addObserver(this);
+}
+
+BookHistory::~BookHistory() {
+    book.removeObserver(this);
+}
+
+void BookHistory::setCurrentDate(const std::string& date) {
+    int day = toDayNumber(date);
+    if (day < currentDay) {
+        throw std::invalid_argument("History date cannot go backwards: " + date);
+    }
+    currentDay = day;
+}
+
+std::string BookHistory::getCurrentDate() const {
+    return toDateString(currentDay);
+}
+
+std::shared_ptr<const DealVersion> BookHistory::dealAsOf(const std::string& contractNum,
+                                                         const std::string& date) const {
+    auto it = timelines.find(ContractNumber::parse(contractNum));
+    if (it == timelines.end()) {
+        return nullptr;
+    }
+    // Recherche dichotomique de la dernière version datée au plus tard ce jour-là
+    const Timeline& timeline = it->second;
+    int day = toDayNumber(date);
+    auto position = std::upper_bound(timeline.days.begin(), timeline.days.end(), day);
+    if (position == timeline.days.begin()) {
+        return nullptr;
+    }
+    std::shared_ptr<const DealVersion> version = timeline.versions[position - timeline.days.begin() - 1];
+
+    // Les facilities sans part postérieure à la date restent partagées avec la version
+    std::shared_ptr<DealVersion> filtered;
+    for (size_t i = 0; i < version->facilities.size(); i++) {
+        std::shared_ptr<const FacilityVersion> facility = partsUntil(version->facilities[i], day);
+        if (facility != version->facilities[i]) {
+            if (!filtered) {
+                filtered = std::make_shared<DealVersion>(*version);
+            }
+            filtered->facilities = filtered->facilities.set(i, facility);
+        }
+    }
+    if (filtered) {
+        return filtered;
+    }
+    return version;
+}
+
+std::shared_ptr<const FacilityVersion> BookHistory::facilityAsOf(const std::string& contractNum, size_t facilityIndex,
+                                                                 const std::string& date) const {
+    std::shared_ptr<const DealVersion> version = dealAsOf(contractNum, date);
+    if (!version || facilityIndex >= version->facilities.size()) {
+        return nullptr;
+    }
+    return version->facilities[facilityIndex];
+}
+
+double BookHistory::accruedInterestAsOf(const std::string& contractNum, size_t facilityIndex,
+                                        const std::string& date) const {
+    std::shared_ptr<const FacilityVersion> facility = facilityAsOf(contractNum, facilityIndex, date);
+    if (!facility) {
+        throw std::invalid_argument("No facility " + std::to_string(facilityIndex + 1) + " for contract " +
+                                    contractNum + " on " + date);
+    }
+    return facility->accruedInterestAt(toDayNumber(date));
+}
+
+size_t BookHistory::getVersionsCount(const std::string& contractNum) const {
+    auto it = timelines.find(ContractNumber::parse(contractNum));
+    return it == timelines.end() ? 0 : it->second.versions.size();
+}
+
+std::shared_ptr<const DealVersion> BookHistory::getVersion(const std::string& contractNum, size_t version) const {
+    return timelineOf(contractNum).versions.at(version);
+}
+
+void BookHistory::onDealAdded(const Deal& deal) {
+    DealVersion version;
+    version.agent = deal.getAgent();
+    version.status = deal.getStatus();
+    for (const Facility& facility : deal.getFacilities()) {
+        version.facilities = version.facilities.pushBack(snapshotFacility(facility));
+    }
+    record(deal, std::move(version), toDayNumber(deal.getContractSignDate()));
+}
+
+void BookHistory::onFacilityAdded(const Deal& deal, size_t facilityIndex) {
+    DealVersion version = *latest(deal);
+    const Facility& facility = deal.getFacilities()[facilityIndex];
+    version.facilities = version.facilities.pushBack(snapshotFacility(facility));
+    record(deal, std::move(version), toDayNumber(facility.getStartDate()));
+}
+
+void BookHistory::onPartPaid(const Deal& deal, size_t facilityIndex) {
+    DealVersion version = *latest(deal);
+    const Facility& facility = deal.getFacilities()[facilityIndex];
+    Part part = facility.getParts().back();
+    int day = toDayNumber(part.getDate());
+    version.facilities = version.facilities.set(facilityIndex, withPart(*version.facilities[facilityIndex],
+                                                                        {day, part.getMoney()}));
+    record(deal, std::move(version), day);
+}
+
+void BookHistory::onSharesTransferred(const Deal& deal, size_t facilityIndex) {
+    DealVersion version = *latest(deal);
+    const Facility& facility = deal.getFacilities()[facilityIndex];
+    auto changed = std::make_shared<FacilityVersion>(*version.facilities[facilityIndex]);
+    changed->lenders = std::make_shared<const std::vector<Lender>>(facility.getLenders());
+    changed->shares = std::make_shared<const std::vector<Money>>(facility.getShares());
+    version.facilities = version.facilities.set(facilityIndex, changed);
+    record(deal, std::move(version), currentDay);
+}
+
+void BookHistory::onInterestAccrued(const Deal& deal, size_t facilityIndex) {
+    // Registre de la facility repris tel qu'arrêté : toutes ses parts sont antérieures
+    DealVersion version = *latest(deal);
+    const Facility& facility = deal.getFacilities()[facilityIndex];
+    auto changed = std::make_shared<FacilityVersion>(*version.facilities[facilityIndex]);
+    changed->accrualDay = toDayNumber(facility.getAccrualDate());
+    changed->accrualBalance = facility.getRemainingMoney();
+    changed->accruedInterest = facility.getAccruedInterest();
+    version.facilities = version.facilities.set(facilityIndex, changed);
+    record(deal, std::move(version), changed->accrualDay);
+}
+
+void BookHistory::onStatusChanged(const Deal& deal) {
+    DealVersion version = *latest(deal);
+    version.status = deal.getStatus();
+    record(deal, std::move(version), currentDay);
+}
+
+void BookHistory::onAgentChanged(const Deal& deal) {
+    DealVersion version = *latest(deal);
+    version.agent = deal.getAgent();
+    record(deal, std::move(version), currentDay);
+}
+
+void BookHistory::onDealRemoved(const Deal&) {
+    // L'historique est conservé pour l'audit
+}
+
+void BookHistory::record(const Deal& deal, DealVersion version, int businessDay) {
+    Timeline& timeline = timelines[deal.getContractNumber()];
+    // Date de gestion bornée par l'horloge et par la dernière version du deal
+    int day = std::min(businessDay, currentDay);
+    if (!timeline.days.empty()) {
+        day = std::max(day, timeline.days.back());
+    }
+    version.sequence = ++sequence;
+    version.day = day;
+    timeline.days.push_back(day);
+    timeline.versions = timeline.versions.pushBack(std::make_shared<const DealVersion>(std::move(version)));
+}
+
+const BookHistory::Timeline& BookHistory::timelineOf(const std::string& contractNum) const {
+    auto it = timelines.find(ContractNumber::parse(contractNum));
+    if (it == timelines.end()) {
+        throw std::invalid_argument("No history for contract number: " + contractNum);
+    }
+    return it->second;
+}
+
+std::shared_ptr<const DealVersion> BookHistory::latest(const Deal& deal) const {
+    return timelineOf(deal.getContractNum()).versions.back();
+}
+
+std::shared_ptr<const FacilityVersion> BookHistory::snapshotFacility(const Facility& facility) {
+    auto version = std::make_shared<FacilityVersion>();
+    version->startDate = facility.getStartDate();
+    version->endDate = facility.getEndDate();
+    version->amount = facility.getAmountMoney();
+    version->currency = facility.getCurrencyCode();
+    version->annualInterestRate = facility.getAnnualInterestRate();
+    version->lenders = std::make_shared<const std::vector<Lender>>(facility.getLenders());
+    version->shares = std::make_shared<const std::vector<Money>>(facility.getShares());
+    // Jours et montants lus dans l'historique compressé, sans construire les Part
+    const PartHistory& parts = facility.getParts();
+    for (PartHistory::const_iterator it = parts.begin(); it != parts.end(); ++it) {
+        version->parts = version->parts.pushBack({it.getDay(), it.getMoney()});
+    }
+    version->remaining = facility.getRemainingMoney();
+
+    Ledger ledger = replay(*version, std::numeric_limits<int>::max());
+    version->accrualDay = ledger.day;
+    version->accrualBalance = ledger.balance;
+    version->accruedInterest = ledger.accrued;
+    return version;
+}
+
+std::shared_ptr<const FacilityVersion> BookHistory::withPart(const FacilityVersion& previous, PartVersion part) {
+    auto version = std::make_shared<FacilityVersion>(previous);
+    version->parts = previous.parts.pushBack(part);
+    version->remaining -= part.amount;
+
+    // Même règle que le registre de Facility : avance en O(1), reprise si la part est antidatée
+    int day = std::max(part.day, toDayNumber(previous.startDate));
+    if (day >= previous.accrualDay) {
+        version->accruedInterest += previous.accrualBalance.toDouble() * previous.annualInterestRate *
+                                    (day - previous.accrualDay) / 365.0;
+        version->accrualDay = day;
+        version->accrualBalance -= part.amount;
+    } else {
+        Ledger ledger = replay(*version, previous.accrualDay);
+        version->accrualDay = ledger.day;
+        version->accrualBalance = ledger.balance;
+        version->accruedInterest = ledger.accrued;
+        if (previous.accrualDay > ledger.day) {
+            version->accruedInterest += ledger.balance.toDouble() * previous.annualInterestRate *
+                                        (previous.accrualDay - ledger.day) / 365.0;
+            version->accrualDay = previous.accrualDay;
+        }
+    }
+    return version;
+}
+
+std::shared_ptr<const FacilityVersion> BookHistory::partsUntil(const std::shared_ptr<const FacilityVersion>& facility,
+                                                               int day) {
+    bool later = false;
+    for (size_t i = 0; i < facility->parts.size() && !later; i++) {
+        later = facility->parts[i].day > day;
+    }
+    if (!later) {
+        return facility;
+    }
+
+    // Parts effectives à la date seulement : encours et registre repris sur ces parts
+    auto version = std::make_shared<FacilityVersion>(*facility);
+    version->parts = PersistentVector<PartVersion>();
+    version->remaining = facility->amount;
+    for (size_t i = 0; i < facility->parts.size(); i++) {
+        const PartVersion& part = facility->parts[i];
+        if (part.day <= day) {
+            version->parts = version->parts.pushBack(part);
+            version->remaining -= part.amount;
+        }
+    }
+    Ledger ledger = replay(*version, day);
+    version->accrualDay = ledger.day;
+    version->accrualBalance = ledger.balance;
+    version->accruedInterest = ledger.accrued;
+    return version;
+}
\ No newline at end of file
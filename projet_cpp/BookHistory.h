@@ -0,0 +1,116 @@
+#ifndef BOOK_HISTORY_H
+#define BOOK_HISTORY_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include "BookStore.h"
+#include "PersistentVector.h"
+
+// Part d'une version : jour et montant, sans la date en texte d'une Part
+struct PartVersion {
+    int day;
+    Money amount;
+};
+
+// État figé d'une facility dans une version : les parts sont partagées avec les
+// versions précédentes, le registre d'intérêts couvre toutes les parts de la version.
+struct FacilityVersion {
+    std::string startDate;
+    std::string endDate;
+    Money amount;
+    CurrencyCode currency;
+    double annualInterestRate;
+    std::shared_ptr<const std::vector<Lender>> lenders;
+    std::shared_ptr<const std::vector<Money>> shares;
+    PersistentVector<PartVersion> parts;
+    Money remaining;
+    int accrualDay;
+    Money accrualBalance;
+    double accruedInterest;
+
+    // Intérêts courus à une date : O(1) à partir du registre, sinon reprise des parts
+    double accruedInterestAt(int day) const;
+};
+
+// État figé d'un deal : agent, statut et facilities à la date de la version
+struct DealVersion {
+    uint64_t sequence;
+    int day;
+    std::string agent;
+    Deal::Status status;
+    PersistentVector<std::shared_ptr<const FacilityVersion>> facilities;
+};
+
+// Historique du book pour les requêtes « à date » des auditeurs.
+//
+// Chaque mutation notifiée par le BookStore (création, facility, part, cession, statut, agent)
+// ajoute une version du deal datée par sa date de gestion : signature du contrat, début de
+// la facility, date de la part ou date d'arrêté des intérêts ; les cessions et changements
+// de statut ou d'agent, sans date propre, prennent l'horloge de l'historique. Une date
+// postérieure à l'horloge est ramenée à l'horloge, une date antérieure à la dernière version
+// du deal est ramenée à cette version : les jours des versions restent croissants.
+// Un état à date ne retient que les parts effectives à cette date, quelle que soit la
+// version qui les porte. Les versions partagent leur structure (PersistentVector), la
+// mémoire croît avec le nombre de changements et non avec la taille des états.
+// Les deals retirés du book restent consultables.
+class BookHistory : public BookObserver {
+public:
+    // Reprend l'état courant du book, daté du jour ou de la date donnée, puis
+    // s'abonne à ses mutations
+    explicit BookHistory(BookStore& book);
+    BookHistory(BookStore& book, const std::string& currentDate);
+    ~BookHistory() override;
+
+    BookHistory(const BookHistory&) = delete;
+    BookHistory& operator=(const BookHistory&) = delete;
+
+    // Horloge de l'historique (par défaut le jour courant) : date des mutations sans date de
+    // gestion et date maximale des versions
+    void setCurrentDate(const std::string& date);
+    std::string getCurrentDate() const;
+
+    // Dernière version datée au plus tard à la date, parts postérieures écartées (encours et
+    // registre d'intérêts recalculés) ; nullptr si le deal n'existait pas
+    std::shared_ptr<const DealVersion> dealAsOf(const std::string& contractNum, const std::string& date) const;
+    std::shared_ptr<const FacilityVersion> facilityAsOf(const std::string& contractNum, size_t facilityIndex,
+                                                        const std::string& date) const;
+    double accruedInterestAsOf(const std::string& contractNum, size_t facilityIndex, const std::string& date) const;
+
+    size_t getVersionsCount(const std::string& contractNum) const;
+    std::shared_ptr<const DealVersion> getVersion(const std::string& contractNum, size_t version) const;
+
+    void onDealAdded(const Deal& deal) override;
+    void onFacilityAdded(const Deal& deal, size_t facilityIndex) override;
+    void onPartPaid(const Deal& deal, size_t facilityIndex) override;
+    void onSharesTransferred(const Deal& deal, size_t facilityIndex) override;
+    void onInterestAccrued(const Deal& deal, size_t facilityIndex) override;
+    void onStatusChanged(const Deal& deal) override;
+    void onAgentChanged(const Deal& deal) override;
+    void onDealRemoved(const Deal& deal) override;
+
+private:
+    // Versions d'un deal, jours croissants
+    struct Timeline {
+        std::vector<int> days;
+        PersistentVector<std::shared_ptr<const DealVersion>> versions;
+    };
+
+    BookStore& book;
+    int currentDay;
+    uint64_t sequence;
+    std::unordered_map<ContractNumber, Timeline> timelines;
+
+    void record(const Deal& deal, DealVersion version, int businessDay);
+    const Timeline& timelineOf(const std::string& contractNum) const;
+    std::shared_ptr<const DealVersion> latest(const Deal& deal) const;
+
+    static std::shared_ptr<const FacilityVersion> snapshotFacility(const Facility& facility);
+    static std::shared_ptr<const FacilityVersion> withPart(const FacilityVersion& previous, PartVersion part);
+    static std::shared_ptr<const FacilityVersion> partsUntil(const std::shared_ptr<const FacilityVersion>& facility,
+                                                             int day);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,329 @@
+#include "BookProtocol.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace protocol {
+
+bool isWrite(Opcode opcode) {
+    return opcode == Opcode::CREATE_DEAL || opcode == Opcode::ADD_FACILITY || opcode == Opcode::PAY ||
+           opcode == Opcode::ACCRUE;
+}
+
+Encoder::Encoder(std::vector<uint8_t>& out) : out(out) {}
+
+void Encoder::putU8(uint8_t value) {
+    out.push_back(value);
+}
+
+void Encoder::putU16(uint16_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void Encoder::putU32(uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+void Encoder::putU64(uint64_t value) {
+    for (int shift = 0; shift < 64; shift += 8) {
+        out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+void Encoder::putI64(int64_t value) {
+    putU64(static_cast<uint64_t>(value));
+}
+
+void Encoder::putDouble(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    putU64(bits);
+}
+
+void Encoder::putMoney(Money value) {
+    putI64(value.getUnits());
+}
+
+void Encoder::putString(const std::string& value) {
+    if (value.size() > 0xFFFF) {
+        throw std::invalid_argument("String too long for the protocol");
+    }
+    putU16(static_cast<uint16_t>(value.size()));
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+void Encoder::putStrings(const std::vector<std::string>& values) {
+    putU32(static_cast<uint32_t>(values.size()));
+    for (const std::string& value : values) {
+        putString(value);
+    }
+}
+
+size_t Encoder::beginFrame() {
+    size_t start = out.size();
+    putU32(0);
+    return start;
+}
+
+void Encoder::endFrame(size_t start) {
+    uint32_t length = static_cast<uint32_t>(out.size() - start - 4);
+    for (int i = 0; i < 4; i++) {
+        out[start + i] = static_cast<uint8_t>(length >> (8 * i));
+    }
+}
+
+Decoder::Decoder(const uint8_t* data, size_t size) : data(data), size(size), pos(0) {}
+
+uint8_t Decoder::getU8() {
+    require(1);
+    return data[pos++];
+}
+
+uint16_t Decoder::getU16() {
+    require(2);
+    uint16_t value = static_cast<uint16_t>(data[pos] | (data[pos + 1] << 8));
+    pos += 2;
+    return value;
+}
+
+uint32_t Decoder::getU32() {
+    require(4);
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= static_cast<uint32_t>(data[pos + i]) << (8 * i);
+    }
+    pos += 4;
+    return value;
+}
+
+uint64_t Decoder::getU64() {
+    require(8);
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value |= static_cast<uint64_t>(data[pos + i]) << (8 * i);
+    }
+    pos += 8;
+    return value;
+}
+
+int64_t Decoder::getI64() {
+    return static_cast<int64_t>(getU64());
+}
+
+double Decoder::getDouble() {
+    uint64_t bits = getU64();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+Money Decoder::getMoney() {
+    return Money::fromUnits(getI64());
+}
+
+std::string Decoder::getString() {
+    uint16_t length = getU16();
+    require(length);
+    std::string value(reinterpret_cast<const char*>(data + pos), length);
+    pos += length;
+    return value;
+}
+
+std::vector<std::string> Decoder::getStrings() {
+    uint32_t count = getU32();
+    std::vector<std::string> values;
+    for (uint32_t i = 0; i < count; i++) {
+        values.push_back(getString());
+    }
+    return values;
+}
+
+bool Decoder::atEnd() const {
+    return pos == size;
+}
+
+void Decoder::require(size_t count) const {
+    if (size - pos < count) {
+        throw std::runtime_error("Truncated protocol message");
+    }
+}
+
+size_t completeFrameSize(const uint8_t* data, size_t size) {
+    if (size < 4) {
+        return 0;
+    }
+    Decoder header(data, 4);
+    uint32_t length = header.getU32();
+    if (length > MAX_FRAME_SIZE) {
+        throw std::runtime_error("Protocol frame too large");
+    }
+    return size - 4 >= length ? length + 4 : 0;
+}
+
+void encode(Encoder& out, const DealSpec& spec) {
+    out.putString(spec.contractNum);
+    out.putString(spec.agent);
+    out.putString(spec.borrower);
+    out.putDouble(spec.amount);
+    out.putString(spec.currency);
+    out.putString(spec.signDate);
+    out.putString(spec.endDate);
+    out.putU8(spec.status);
+    out.putStrings(spec.pool);
+}
+
+void encode(Encoder& out, const FacilitySpec& spec) {
+    out.putString(spec.contractNum);
+    out.putString(spec.startDate);
+    out.putString(spec.endDate);
+    out.putDouble(spec.amount);
+    out.putString(spec.currency);
+    out.putDouble(spec.rate);
+    out.putStrings(spec.lenders);
+    out.putU32(static_cast<uint32_t>(spec.shares.size()));
+    for (Money share : spec.shares) {
+        out.putMoney(share);
+    }
+    out.putString(spec.curveCurrency);
+    out.putDouble(spec.spread);
+}
+
+void encode(Encoder& out, const PaymentSpec& spec) {
+    out.putString(spec.contractNum);
+    out.putU32(spec.facilityIndex);
+    out.putDouble(spec.amount);
+    out.putString(spec.date);
+}
+
+void encode(Encoder& out, const QuerySpec& spec) {
+    out.putU8(spec.status);
+    out.putString(spec.currency);
+    out.putString(spec.borrower);
+    out.putString(spec.lender);
+}
+
+void encode(Encoder& out, const DealSummary& summary) {
+    out.putString(summary.contractNum);
+    out.putString(summary.borrower);
+    out.putString(summary.currency);
+    out.putU8(summary.status);
+    out.putMoney(summary.amount);
+    out.putMoney(summary.remaining);
+    out.putU32(summary.facilitiesCount);
+}
+
+void encode(Encoder& out, const QueryResult& result) {
+    out.putU32(result.count);
+    out.putDouble(result.amount);
+    out.putDouble(result.remaining);
+    out.putStrings(result.contracts);
+}
+
+void encode(Encoder& out, const PortfolioTotals& totals) {
+    out.putMoney(totals.amount);
+    out.putMoney(totals.interest);
+    out.putMoney(totals.accrued);
+    out.putMoney(totals.remaining);
+    out.putU32(totals.partsCount);
+}
+
+DealSpec decodeDealSpec(Decoder& in) {
+    DealSpec spec;
+    spec.contractNum = in.getString();
+    spec.agent = in.getString();
+    spec.borrower = in.getString();
+    spec.amount = in.getDouble();
+    spec.currency = in.getString();
+    spec.signDate = in.getString();
+    spec.endDate = in.getString();
+    spec.status = in.getU8();
+    spec.pool = in.getStrings();
+    return spec;
+}
+
+FacilitySpec decodeFacilitySpec(Decoder& in) {
+    FacilitySpec spec;
+    spec.contractNum = in.getString();
+    spec.startDate = in.getString();
+    spec.endDate = in.getString();
+    spec.amount = in.getDouble();
+    spec.currency = in.getString();
+    spec.rate = in.getDouble();
+    spec.lenders = in.getStrings();
+    uint32_t shares = in.getU32();
+    for (uint32_t i = 0; i < shares; i++) {
+        spec.shares.push_back(in.getMoney());
+    }
+    spec.curveCurrency = in.getString();
+    spec.spread = in.getDouble();
+    return spec;
+}
+
+PaymentSpec decodePaymentSpec(Decoder& in) {
+    PaymentSpec spec;
+    spec.contractNum = in.getString();
+    spec.facilityIndex = in.getU32();
+    spec.amount = in.getDouble();
+    spec.date = in.getString();
+    return spec;
+}
+
+QuerySpec decodeQuerySpec(Decoder& in) {
+    QuerySpec spec;
+    spec.status = in.getU8();
+    spec.currency = in.getString();
+    spec.borrower = in.getString();
+    spec.lender = in.getString();
+    return spec;
+}
+
+Reply decodeReply(Decoder& in, Opcode opcode) {
+    Reply reply{};
+    reply.opcode = opcode;
+    reply.ok = static_cast<Status>(in.getU8()) == Status::OK;
+    if (!reply.ok) {
+        reply.error = in.getString();
+        return reply;
+    }
+
+    switch (opcode) {
+        case Opcode::CREATE_DEAL:
+        case Opcode::ACCRUE:
+            break;
+        case Opcode::ADD_FACILITY:
+            reply.facilityIndex = in.getU32();
+            break;
+        case Opcode::PAY:
+            reply.remaining = in.getMoney();
+            break;
+        case Opcode::GET_DEAL:
+            reply.deal.contractNum = in.getString();
+            reply.deal.borrower = in.getString();
+            reply.deal.currency = in.getString();
+            reply.deal.status = in.getU8();
+            reply.deal.amount = in.getMoney();
+            reply.deal.remaining = in.getMoney();
+            reply.deal.facilitiesCount = in.getU32();
+            break;
+        case Opcode::QUERY:
+            reply.query.count = in.getU32();
+            reply.query.amount = in.getDouble();
+            reply.query.remaining = in.getDouble();
+            reply.query.contracts = in.getStrings();
+            break;
+        case Opcode::PORTFOLIO:
+            reply.portfolio.amount = in.getMoney();
+            reply.portfolio.interest = in.getMoney();
+            reply.portfolio.accrued = in.getMoney();
+            reply.portfolio.remaining = in.getMoney();
+            reply.portfolio.partsCount = in.getU32();
+            break;
+        default:
+            throw std::runtime_error("Unknown protocol opcode");
+    }
+    return reply;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,192 @@
+#ifndef BOOK_PROTOCOL_H
+#define BOOK_PROTOCOL_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Money.h"
+
+// Protocole binaire du serveur de book.
+//
+// Trame : longueur du contenu (u32) puis contenu. Le contenu d'une trame est un lot :
+// nombre de messages (u16) puis les messages à la suite. Les réponses d'un lot sont
+// renvoyées dans une seule trame, dans l'ordre des requêtes.
+//
+// Entiers en little-endian, double par leur représentation IEEE 754 sur 64 bits,
+// chaîne = longueur (u16) + octets, montants Money = unités (i64).
+//
+// Requête : opcode (u8) puis les champs de l'opération.
+// Réponse : statut (u8) puis, si OK, les champs du résultat, sinon le message d'erreur.
+namespace protocol {
+
+const uint32_t MAX_FRAME_SIZE = 16 * 1024 * 1024;
+const uint8_t ANY_STATUS = 0xFF;
+
+enum class Opcode : uint8_t {
+    CREATE_DEAL = 1,   // contrat, agent, emprunteur, montant, devise, dates, statut, pool
+    ADD_FACILITY = 2,  // contrat, dates, montant, devise, taux, prêteurs, participations, taux variable
+                       // -> index de la facility
+    PAY = 3,           // contrat, index de facility, montant, date -> restant dû
+    GET_DEAL = 4,      // contrat -> résumé du deal
+    QUERY = 5,         // statut, devise, emprunteur, prêteur -> agrégat et contrats
+    PORTFOLIO = 6,     // contrat (vide = tout le book) -> totaux du portfolio
+    ACCRUE = 7         // date, contrat (vide = tout le book), index de facility
+                       // -> (intérêts courus arrêtés à la date)
+};
+
+enum class Status : uint8_t {
+    OK = 0,
+    ERROR = 1
+};
+
+// Seules les créations, paiements et arrêtés d'intérêts modifient le book
+bool isWrite(Opcode opcode);
+
+// Sérialisation dans un tampon d'octets
+class Encoder {
+public:
+    explicit Encoder(std::vector<uint8_t>& out);
+
+    void putU8(uint8_t value);
+    void putU16(uint16_t value);
+    void putU32(uint32_t value);
+    void putU64(uint64_t value);
+    void putI64(int64_t value);
+    void putDouble(double value);
+    void putMoney(Money value);
+    void putString(const std::string& value);
+    void putStrings(const std::vector<std::string>& values);
+
+    // Trame : réserve la longueur puis la complète une fois le contenu écrit
+    size_t beginFrame();
+    void endFrame(size_t start);
+
+private:
+    std::vector<uint8_t>& out;
+};
+
+// Lecture d'un message, exception si le message est tronqué
+class Decoder {
+public:
+    Decoder(const uint8_t* data, size_t size);
+
+    uint8_t getU8();
+    uint16_t getU16();
+    uint32_t getU32();
+    uint64_t getU64();
+    int64_t getI64();
+    double getDouble();
+    Money getMoney();
+    std::string getString();
+    std::vector<std::string> getStrings();
+
+    bool atEnd() const;
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+
+    void require(size_t count) const;
+};
+
+// Taille de la première trame complète du tampon (longueur comprise), 0 si incomplète
+size_t completeFrameSize(const uint8_t* data, size_t size);
+
+// Paramètres des requêtes
+struct DealSpec {
+    std::string contractNum;
+    std::string agent;
+    std::string borrower;
+    std::vector<std::string> pool;
+    double amount;
+    std::string currency;
+    std::string signDate;
+    std::string endDate;
+    uint8_t status;
+};
+
+struct FacilitySpec {
+    std::string contractNum;
+    std::string startDate;
+    std::string endDate;
+    double amount;
+    std::string currency;
+    double rate;
+    std::vector<std::string> lenders;
+    std::vector<Money> shares;    // Participation de chaque prêteur, vide = parts égales
+    std::string curveCurrency;    // Vide = taux fixe
+    double spread = 0;
+};
+
+struct PaymentSpec {
+    std::string contractNum;
+    uint32_t facilityIndex;
+    double amount;
+    std::string date;
+};
+
+// Critères vides (ou ANY_STATUS) = pas de filtre
+struct QuerySpec {
+    uint8_t status = ANY_STATUS;
+    std::string currency;
+    std::string borrower;
+    std::string lender;
+};
+
+// Résultats
+struct DealSummary {
+    std::string contractNum;
+    std::string borrower;
+    std::string currency;
+    uint8_t status;
+    Money amount;
+    Money remaining;
+    uint32_t facilitiesCount;
+};
+
+struct QueryResult {
+    uint32_t count;
+    double amount;
+    double remaining;
+    std::vector<std::string> contracts;
+};
+
+struct PortfolioTotals {
+    Money amount;
+    Money interest;   // Somme des intérêts par part
+    Money accrued;    // Registres d'intérêts courus
+    Money remaining;
+    uint32_t partsCount;
+};
+
+// Réponse décodée par le client ; seuls les champs de l'opération sont renseignés
+struct Reply {
+    Opcode opcode;
+    bool ok;
+    std::string error;
+    uint32_t facilityIndex;
+    Money remaining;
+    DealSummary deal;
+    QueryResult query;
+    PortfolioTotals portfolio;
+};
+
+void encode(Encoder& out, const DealSpec& spec);
+void encode(Encoder& out, const FacilitySpec& spec);
+void encode(Encoder& out, const PaymentSpec& spec);
+void encode(Encoder& out, const QuerySpec& spec);
+void encode(Encoder& out, const DealSummary& summary);
+void encode(Encoder& out, const QueryResult& result);
+void encode(Encoder& out, const PortfolioTotals& totals);
+
+DealSpec decodeDealSpec(Decoder& in);
+FacilitySpec decodeFacilitySpec(Decoder& in);
+PaymentSpec decodePaymentSpec(Decoder& in);
+QuerySpec decodeQuerySpec(Decoder& in);
+Reply decodeReply(Decoder& in, Opcode opcode);
+
+}
+
+#endif
\ No newline at end of file
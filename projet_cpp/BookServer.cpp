@@ -0,0 +1,587 @@
+#include "BookServer.h"
+#include "Portfolio.h"
+#include <stdexcept>
+#include <utility>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#ifdef MSG_NOSIGNAL
+#define BOOK_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define BOOK_SEND_FLAGS 0
+#endif
+
+using protocol::Opcode;
+
+BookServer::BookServer(BookStore& book, const std::string& socketPath, size_t threads)
+    : book(book), socketPath(socketPath), threadsCount(threads), engine(book), archive(nullptr),
+      listenFd(-1), acceptWakeRead(-1), acceptWakeWrite(-1), running(false),
+      requestsCount(0), batchesCount(0) {
+    validateThreads(threads);
+}
+
+BookServer::~BookServer() {
+    stop();
+}
+
+void BookServer::setArchive(const TieredBook* archive) {
+    this->archive = archive;
+}
+
+bool BookServer::isRunning() const {
+    return running;
+}
+
+uint64_t BookServer::getRequestsCount() const {
+    return requestsCount;
+}
+
+uint64_t BookServer::getBatchesCount() const {
+    return batchesCount;
+}
+
+void BookServer::handleBatch(const uint8_t* data, size_t size, std::vector<uint8_t>& reply) {
+    // Le lot est entièrement décodé avant exécution : un lot mal formé n'a aucun effet
+    protocol::Decoder in(data, size);
+    uint16_t count = in.getU16();
+    std::vector<Request> requests;
+    requests.reserve(count);
+    for (uint16_t i = 0; i < count; i++) {
+        requests.push_back(decodeRequest(in));
+    }
+    if (!in.atEnd()) {
+        throw std::runtime_error("Unexpected data after protocol batch");
+    }
+
+    protocol::Encoder out(reply);
+    size_t frame = out.beginFrame();
+    out.putU16(count);
+
+    // Les requêtes consécutives de même nature sont exécutées sous un seul verrou
+    size_t i = 0;
+    while (i < requests.size()) {
+        bool write = protocol::isWrite(requests[i].opcode);
+        size_t end = i;
+        while (end < requests.size() && protocol::isWrite(requests[end].opcode) == write) {
+            end++;
+        }
+
+        if (write) {
+            std::unique_lock<std::shared_mutex> lock(bookMutex);
+            BookStore::Batch batch(book);
+            for (; i < end; i++) {
+                execute(requests[i], nullptr, out);
+            }
+        } else {
+            std::shared_ptr<const BookSnapshot> snapshot = book.snapshot();
+            std::shared_lock<std::shared_mutex> lock(bookMutex, std::defer_lock);
+            for (; i < end; i++) {
+                if (requests[i].opcode == Opcode::QUERY && !lock.owns_lock()) {
+                    // Sous le verrou, la dernière version publiée est celle des index
+                    lock.lock();
+                    snapshot = book.snapshot();
+                }
+                execute(requests[i], snapshot, out);
+            }
+        }
+    }
+
+    out.endFrame(frame);
+    requestsCount += count;
+    batchesCount++;
+}
+
+BookServer::Request BookServer::decodeRequest(protocol::Decoder& in) {
+    Request request;
+    request.opcode = static_cast<Opcode>(in.getU8());
+    switch (request.opcode) {
+        case Opcode::CREATE_DEAL:
+            request.deal = protocol::decodeDealSpec(in);
+            break;
+        case Opcode::ADD_FACILITY:
+            request.facility = protocol::decodeFacilitySpec(in);
+            break;
+        case Opcode::PAY:
+            request.payment = protocol::decodePaymentSpec(in);
+            break;
+        case Opcode::GET_DEAL:
+        case Opcode::PORTFOLIO:
+            request.contractNum = in.getString();
+            break;
+        case Opcode::ACCRUE:
+            request.date = in.getString();
+            request.contractNum = in.getString();
+            request.facilityIndex = in.getU32();
+            break;
+        case Opcode::QUERY:
+            request.query = protocol::decodeQuerySpec(in);
+            break;
+        default:
+            throw std::runtime_error("Unknown protocol opcode");
+    }
+    return request;
+}
+
+void BookServer::execute(const Request& request, const std::shared_ptr<const BookSnapshot>& snapshot,
+                         protocol::Encoder& out) {
+    // Une requête en échec n'interrompt pas le lot : l'erreur est renvoyée à sa place
+    std::vector<uint8_t> result;
+    protocol::Encoder resultOut(result);
+    try {
+        if (protocol::isWrite(request.opcode)) {
+            executeWrite(request, resultOut);
+        } else {
+            executeRead(request, snapshot, resultOut);
+        }
+    } catch (const std::exception& e) {
+        out.putU8(static_cast<uint8_t>(protocol::Status::ERROR));
+        out.putString(e.what());
+        return;
+    }
+    out.putU8(static_cast<uint8_t>(protocol::Status::OK));
+    for (uint8_t byte : result) {
+        out.putU8(byte);
+    }
+}
+
+void BookServer::executeWrite(const Request& request, protocol::Encoder& out) {
+    switch (request.opcode) {
+        case Opcode::CREATE_DEAL: {
+            const protocol::DealSpec& spec = request.deal;
+            if (spec.status > static_cast<uint8_t>(Deal::Status::CLOSED)) {
+                throw std::invalid_argument("Invalid deal status");
+            }
+            if (archive != nullptr && archive->isArchived(spec.contractNum)) {
+                throw std::invalid_argument("Contract number is already archived: " + spec.contractNum);
+            }
+            std::vector<Lender> pool;
+            for (const std::string& name : spec.pool) {
+                pool.push_back(Lender(name));
+            }
+            book.addDeal(Deal(spec.contractNum, spec.agent, pool, Borrower(spec.borrower), spec.amount,
+                              spec.currency, spec.signDate, spec.endDate, static_cast<Deal::Status>(spec.status)));
+            break;
+        }
+        case Opcode::ADD_FACILITY: {
+            const protocol::FacilitySpec& spec = request.facility;
+            std::vector<Lender> lenders;
+            for (const std::string& name : spec.lenders) {
+                lenders.push_back(Lender(name));
+            }
+            Facility facility(spec.startDate, spec.endDate, spec.amount, spec.currency, lenders, spec.rate);
+            if (!spec.shares.empty()) {
+                facility.setShares(spec.shares);
+            }
+            if (!spec.curveCurrency.empty()) {
+                facility.setFloatingRate(spec.curveCurrency, spec.spread);
+            }
+            FacilityHandle handle = book.addFacility(book.findDeal(spec.contractNum), std::move(facility));
+            out.putU32(handle.index);
+            break;
+        }
+        case Opcode::PAY: {
+            const protocol::PaymentSpec& spec = request.payment;
+            FacilityHandle handle{book.findDeal(spec.contractNum), spec.facilityIndex};
+            book.payPart(handle, spec.amount, spec.date);
+            out.putMoney(book.getFacility(handle).getRemainingMoney());
+            break;
+        }
+        case Opcode::ACCRUE:
+            if (request.contractNum.empty()) {
+                book.accrueTo(request.date);
+            } else {
+                book.accrueTo({book.findDeal(request.contractNum), request.facilityIndex}, request.date);
+            }
+            break;
+        default:
+            throw std::logic_error("Not a write request");
+    }
+}
+
+void BookServer::executeRead(const Request& request, const std::shared_ptr<const BookSnapshot>& pinned,
+                             protocol::Encoder& out) const {
+    const BookSnapshot& snapshot = *pinned;
+    switch (request.opcode) {
+        case Opcode::GET_DEAL: {
+            // Contrat sorti du book actif : décodé depuis son segment froid
+            if (archive != nullptr && !snapshot.hasDeal(request.contractNum) && archive->isArchived(request.contractNum)) {
+                protocol::encode(out, summarize(archive->loadArchived(request.contractNum)));
+            } else {
+                protocol::encode(out, summarize(snapshot.getDeal(snapshot.findDeal(request.contractNum))));
+            }
+            break;
+        }
+        case Opcode::QUERY: {
+            const protocol::QuerySpec& spec = request.query;
+            QueryEngine::Filter filter;
+            if (spec.status != protocol::ANY_STATUS) {
+                filter.status(static_cast<Deal::Status>(spec.status));
+            }
+            if (!spec.currency.empty()) {
+                filter.currency(spec.currency);
+            }
+            if (!spec.borrower.empty()) {
+                filter.borrower(spec.borrower);
+            }
+            if (!spec.lender.empty()) {
+                filter.lender(spec.lender);
+            }
+            Bitmap selection = engine.selectDeals(filter);
+            QueryEngine::Aggregate aggregate = engine.aggregateDeals(selection);
+            protocol::QueryResult result{static_cast<uint32_t>(aggregate.count), aggregate.amount,
+                                         aggregate.remaining, {}};
+            for (const Deal* deal : engine.getDeals(selection)) {
+                result.contracts.push_back(deal->getContractNum());
+            }
+
+            // Deals archivés (tous terminés) : parcours des segments froids, après le book actif
+            bool terminated = spec.status == protocol::ANY_STATUS ||
+                              spec.status == static_cast<uint8_t>(Deal::Status::TERMINATED);
+            if (archive != nullptr && terminated) {
+                for (const std::string& contractNum : archive->getArchivedContracts()) {
+                    if (snapshot.hasDeal(contractNum)) {
+                        continue;
+                    }
+                    Deal deal = archive->loadArchived(contractNum);
+                    if (QueryEngine::matchesDeal(filter, deal)) {
+                        result.count++;
+                        result.amount += deal.getProjectAmount();
+                        result.remaining += summarize(deal).remaining.toDouble();
+                        result.contracts.push_back(contractNum);
+                    }
+                }
+            }
+            protocol::encode(out, result);
+            break;
+        }
+        case Opcode::PORTFOLIO: {
+            std::vector<FacilityHandle> handles;
+            if (request.contractNum.empty()) {
+                handles = snapshot.getFacilityHandles();
+            } else {
+                DealHandle deal = snapshot.findDeal(request.contractNum);
+                for (size_t f = 0; f < snapshot.getDeal(deal).getFacilitiesCount(); f++) {
+                    handles.push_back({deal, static_cast<uint32_t>(f)});
+                }
+            }
+            // Tous les totaux sont lus sur la même version, sans retenir les écritures
+            Portfolio portfolio(pinned, handles);
+            protocol::encode(out, protocol::PortfolioTotals{
+                portfolio.getTotalAmountMoney(), portfolio.getTotalInterestMoney(),
+                portfolio.getAccruedInterestMoney(), portfolio.getRemainingMoney(), static_cast<uint32_t>(portfolio.getNumberOfParts())});
+            break;
+        }
+        default:
+            throw std::logic_error("Not a read request");
+    }
+}
+
+protocol::DealSummary BookServer::summarize(const Deal& deal) {
+    Money remaining;
+    for (const Facility& facility : deal.getFacilities()) {
+        remaining += facility.getRemainingMoney();
+    }
+    return {deal.getContractNum(), deal.getBorrower().getName(), deal.getCurrency(),
+            static_cast<uint8_t>(deal.getStatus()), deal.getProjectMoney(), remaining,
+            static_cast<uint32_t>(deal.getFacilitiesCount())};
+}
+
+void BookServer::validateThreads(size_t threads) const {
+    if (threads == 0) {
+        throw std::invalid_argument("Server needs at least one thread");
+    }
+}
+
+#ifndef _WIN32
+
+namespace {
+
+void setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+void makePipe(int& readFd, int& writeFd) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        throw std::runtime_error(std::string("Cannot create pipe: ") + std::strerror(errno));
+    }
+    setNonBlocking(fds[0]);
+    readFd = fds[0];
+    writeFd = fds[1];
+}
+
+void wake(int fd) {
+    char byte = 1;
+    ssize_t written = write(fd, &byte, 1);
+    (void)written;
+}
+
+void drain(int fd) {
+    char buffer[64];
+    while (read(fd, buffer, sizeof(buffer)) > 0) {
+    }
+}
+
+}
+
+void BookServer::start() {
+    if (running) {
+        return;
+    }
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Socket path too long: " + socketPath);
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        throw std::runtime_error(std::string("Cannot create socket: ") + std::strerror(errno));
+    }
+    unlink(socketPath.c_str());
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listenFd, 64) != 0) {
+        std::string error = std::strerror(errno);
+        close(listenFd);
+        listenFd = -1;
+        throw std::runtime_error("Cannot listen on " + socketPath + ": " + error);
+    }
+    setNonBlocking(listenFd);
+    makePipe(acceptWakeRead, acceptWakeWrite);
+
+    running = true;
+    for (size_t i = 0; i < threadsCount; i++) {
+        workers.push_back(std::make_unique<Worker>());
+        Worker& worker = *workers.back();
+        makePipe(worker.wakeRead, worker.wakeWrite);
+        worker.thread = std::thread(&BookServer::workerLoop, this, std::ref(worker));
+    }
+    acceptor = std::thread(&BookServer::acceptLoop, this);
+}
+
+void BookServer::stop() {
+    if (!running) {
+        return;
+    }
+    running = false;
+    wake(acceptWakeWrite);
+    acceptor.join();
+    for (std::unique_ptr<Worker>& worker : workers) {
+        wake(worker->wakeWrite);
+        worker->thread.join();
+        close(worker->wakeRead);
+        close(worker->wakeWrite);
+        for (int fd : worker->pending) {
+            close(fd);
+        }
+    }
+    workers.clear();
+
+    close(acceptWakeRead);
+    close(acceptWakeWrite);
+    close(listenFd);
+    listenFd = -1;
+    unlink(socketPath.c_str());
+}
+
+void BookServer::acceptLoop() {
+    size_t next = 0;
+    while (running) {
+        pollfd fds[2] = {{listenFd, POLLIN, 0}, {acceptWakeRead, POLLIN, 0}};
+        if (poll(fds, 2, -1) < 0 && errno != EINTR) {
+            break;
+        }
+        if (fds[1].revents & POLLIN) {
+            drain(acceptWakeRead);
+        }
+        if (!(fds[0].revents & POLLIN)) {
+            continue;
+        }
+
+        // Répartition circulaire des nouvelles connexions entre les boucles d'événements
+        int fd;
+        while ((fd = accept(listenFd, nullptr, nullptr)) >= 0) {
+            setNonBlocking(fd);
+            Worker& worker = *workers[next++ % workers.size()];
+            {
+                std::lock_guard<std::mutex> lock(worker.mutex);
+                worker.pending.push_back(fd);
+            }
+            wake(worker.wakeWrite);
+        }
+    }
+}
+
+void BookServer::workerLoop(Worker& worker) {
+    std::vector<Connection> connections;
+    std::vector<pollfd> fds;
+    while (running) {
+        fds.clear();
+        fds.push_back({worker.wakeRead, POLLIN, 0});
+        for (const Connection& connection : connections) {
+            fds.push_back({connection.fd, pollEvents(connection), 0});
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        std::vector<Connection> alive;
+        for (size_t i = 1; i < fds.size(); i++) {
+            Connection& connection = connections[i - 1];
+            if (fds[i].revents == 0 || serviceConnection(connection, fds[i].revents)) {
+                alive.push_back(std::move(connection));
+            } else {
+                close(connection.fd);
+            }
+        }
+        connections.swap(alive);
+
+        if (fds[0].revents & POLLIN) {
+            drain(worker.wakeRead);
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            for (int fd : worker.pending) {
+                connections.push_back({fd, {}, {}, 0});
+            }
+            worker.pending.clear();
+        }
+    }
+
+    for (const Connection& connection : connections) {
+        close(connection.fd);
+    }
+}
+
+void BookServer::serve(int fd) {
+    setNonBlocking(fd);
+    Connection connection{fd, {}, {}, 0};
+    while (true) {
+        pollfd events{fd, pollEvents(connection), 0};
+        if (poll(&events, 1, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (!serviceConnection(connection, events.revents)) {
+            break;
+        }
+    }
+}
+
+short BookServer::pollEvents(const Connection& connection) {
+    // Plus de lecture tant qu'un client ne lit pas ses réponses
+    size_t pending = connection.output.size() - connection.sent;
+    short events = pending < MAX_BUFFERED_OUTPUT ? POLLIN : 0;
+    if (pending > 0) {
+        events |= POLLOUT;
+    }
+    return events;
+}
+
+bool BookServer::flushOutput(Connection& connection) {
+    while (connection.sent < connection.output.size()) {
+        ssize_t n = send(connection.fd, connection.output.data() + connection.sent,
+                         connection.output.size() - connection.sent, BOOK_SEND_FLAGS);
+        if (n > 0) {
+            connection.sent += static_cast<size_t>(n);
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // Reste envoyé quand poll signalera POLLOUT
+            return true;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    connection.output.clear();
+    connection.sent = 0;
+    return true;
+}
+
+bool BookServer::serviceConnection(Connection& connection, short events) {
+    if (events & (POLLERR | POLLNVAL)) {
+        return false;
+    }
+    if (events & POLLOUT) {
+        if (!flushOutput(connection)) {
+            return false;
+        }
+    }
+    if (!(events & (POLLIN | POLLHUP))) {
+        return true;
+    }
+
+    // Lecture de tout ce qui est disponible : plusieurs trames peuvent arriver ensemble
+    uint8_t buffer[65536];
+    while (connection.input.size() < MAX_BUFFERED_INPUT) {
+        ssize_t n = recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            connection.input.insert(connection.input.end(), buffer, buffer + n);
+        } else if (n == 0) {
+            return false;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else if (errno != EINTR) {
+            return false;
+        }
+    }
+
+    try {
+        size_t offset = 0;
+        size_t frame;
+        while ((frame = protocol::completeFrameSize(connection.input.data() + offset,
+                                                    connection.input.size() - offset)) > 0) {
+            handleBatch(connection.input.data() + offset + 4, frame - 4, connection.output);
+            offset += frame;
+        }
+        connection.input.erase(connection.input.begin(), connection.input.begin() + offset);
+    } catch (const std::exception&) {
+        // Erreur de protocole : la connexion est fermée
+        return false;
+    }
+
+    // Réponses de toutes les trames traitées renvoyées en une seule écriture si possible
+    return flushOutput(connection);
+}
+
+#else
+
+void BookServer::start() {
+    throw std::runtime_error("Local book server is not supported on this platform");
+}
+
+void BookServer::stop() {}
+
+void BookServer::serve(int) {
+    throw std::runtime_error("Local book server is not supported on this platform");
+}
+
+void BookServer::acceptLoop() {}
+
+void BookServer::workerLoop(Worker&) {}
+
+bool BookServer::serviceConnection(Connection&, short) {
+    return false;
+}
+
+bool BookServer::flushOutput(Connection&) {
+    return false;
+}
+
+short BookServer::pollEvents(const Connection&) {
+    return 0;
+}
+
+#endif
\ No newline at end of file
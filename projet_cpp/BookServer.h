@@ -0,0 +1,120 @@
+#ifndef BOOK_SERVER_H
+#define BOOK_SERVER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <cstdint>
+#include "BookStore.h"
+#include "QueryEngine.h"
+#include "BookProtocol.h"
+#include "TieredBook.h"
+
+// Serveur local du book sur socket Unix (protocole décrit dans BookProtocol.h).
+// Un thread accepte les connexions et les répartit entre des boucles d'événements
+// (une par thread du pool). Les trames reçues ensemble sur une connexion sont traitées
+// à la suite et leurs réponses renvoyées en une seule écriture. Dans un lot, les
+// écritures consécutives s'exécutent sous un verrou exclusif et sont publiées d'un seul
+// bloc (BookStore::Batch) ; les lectures consécutives gardent une version publiée du
+// book (BookSnapshot) et ne bloquent pas les écritures, seules les requêtes QUERY,
+// servies par les index tenus sur le book, prennent le verrou partagé.
+// Une réponse qu'un client lent ne lit pas reste dans le tampon de sa connexion et part
+// quand la socket redevient prête : la boucle d'événements ne bloque jamais sur un client.
+// Au-delà de MAX_BUFFERED_OUTPUT en attente, la connexion n'est plus lue. Une lecture
+// s'arrête à MAX_BUFFERED_INPUT reçus (une trame de taille maximale) : les trames
+// complètes sont traitées avant de lire la suite, une trame annoncée plus grande
+// ferme la connexion.
+class BookServer {
+public:
+    BookServer(BookStore& book, const std::string& socketPath, size_t threads = 4);
+    ~BookServer();
+
+    BookServer(const BookServer&) = delete;
+    BookServer& operator=(const BookServer&) = delete;
+
+    // Segments froids consultés pour les contrats sortis du book actif (GET_DEAL, QUERY,
+    // CREATE_DEAL refusé sur un contrat archivé) ; à fixer avant start(), sans archivage
+    // pendant que le serveur tourne
+    void setArchive(const TieredBook* archive);
+
+    void start();
+    void stop();
+    bool isRunning() const;
+
+    // Sert sur le thread appelant une connexion déjà ouverte (processus shard) jusqu'à sa fermeture
+    void serve(int fd);
+
+    // Traitement d'un lot (contenu d'une trame), réponse ajoutée en trame complète
+    void handleBatch(const uint8_t* data, size_t size, std::vector<uint8_t>& reply);
+
+    uint64_t getRequestsCount() const;
+    uint64_t getBatchesCount() const;
+
+private:
+    struct Request {
+        protocol::Opcode opcode;
+        std::string contractNum;
+        std::string date;
+        uint32_t facilityIndex = 0;
+        protocol::DealSpec deal;
+        protocol::FacilitySpec facility;
+        protocol::PaymentSpec payment;
+        protocol::QuerySpec query;
+    };
+
+    struct Connection {
+        int fd;
+        std::vector<uint8_t> input;
+        std::vector<uint8_t> output;
+        size_t sent = 0;   // Octets de output déjà envoyés
+    };
+
+    static const size_t MAX_BUFFERED_OUTPUT = 4 * 1024 * 1024;
+    static const size_t MAX_BUFFERED_INPUT = 4 + protocol::MAX_FRAME_SIZE;
+
+    struct Worker {
+        std::thread thread;
+        int wakeRead = -1;
+        int wakeWrite = -1;
+        std::mutex mutex;
+        std::vector<int> pending;
+    };
+
+    BookStore& book;
+    std::string socketPath;
+    size_t threadsCount;
+    std::shared_mutex bookMutex;
+    QueryEngine engine;
+    const TieredBook* archive;
+
+    int listenFd;
+    int acceptWakeRead;
+    int acceptWakeWrite;
+    std::atomic<bool> running;
+    std::thread acceptor;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<uint64_t> requestsCount;
+    std::atomic<uint64_t> batchesCount;
+
+    void acceptLoop();
+    void workerLoop(Worker& worker);
+    bool serviceConnection(Connection& connection, short events);
+    static bool flushOutput(Connection& connection);
+    static short pollEvents(const Connection& connection);
+
+    static Request decodeRequest(protocol::Decoder& in);
+    // Version lue par une lecture, nulle pour une écriture
+    void execute(const Request& request, const std::shared_ptr<const BookSnapshot>& snapshot,
+                 protocol::Encoder& out);
+    void executeWrite(const Request& request, protocol::Encoder& out);
+    void executeRead(const Request& request, const std::shared_ptr<const BookSnapshot>& pinned,
+                     protocol::Encoder& out) const;
+    static protocol::DealSummary summarize(const Deal& deal);
+    void validateThreads(size_t threads) const;
+};
+
+#endif
\ No newline at end of file
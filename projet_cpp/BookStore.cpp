@@ -0,0 +1,432 @@
+#include "BookStore.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <utility>
+
+// Version publiée
+
+BookSnapshot::BookSnapshot() : epoch(0), dealsCount(0) {}
+
+uint64_t BookSnapshot::getEpoch() const {
+    return epoch;
+}
+
+bool BookSnapshot::isValid(DealHandle handle) const {
+    return entryOf(handle) != nullptr;
+}
+
+bool BookSnapshot::isValid(FacilityHandle handle) const {
+    const Entry* entry = entryOf(handle.deal);
+    return entry != nullptr && handle.index < entry->deal->getFacilitiesCount();
+}
+
+const Deal& BookSnapshot::getDeal(DealHandle handle) const {
+    const Entry* entry = entryOf(handle);
+    if (entry == nullptr) {
+        throw std::invalid_argument("Invalid or stale deal handle");
+    }
+    return *entry->deal;
+}
+
+const Facility& BookSnapshot::getFacility(FacilityHandle handle) const {
+    const Deal& deal = getDeal(handle.deal);
+    if (handle.index >= deal.getFacilitiesCount()) {
+        throw std::out_of_range("Facility index out of range");
+    }
+    return deal.getFacilities()[handle.index];
+}
+
+bool BookSnapshot::hasDeal(const std::string& contractNum) const {
+    return ContractNumber::isValid(contractNum) && slotOf(ContractNumber::parse(contractNum)) != 0;
+}
+
+DealHandle BookSnapshot::findDeal(const std::string& contractNum) const {
+    return findDeal(ContractNumber::parse(contractNum));
+}
+
+DealHandle BookSnapshot::findDeal(ContractNumber contractNum) const {
+    uint32_t slot = slotOf(contractNum);
+    if (slot == 0) {
+        throw std::invalid_argument("Unknown contract number: " + contractNum.toString());
+    }
+    return {slot - 1, slots[slot - 1].generation};
+}
+
+std::vector<DealHandle> BookSnapshot::getHandles() const {
+    std::vector<DealHandle> handles;
+    handles.reserve(dealsCount);
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (slots[i].deal) {
+            handles.push_back({static_cast<uint32_t>(i), slots[i].generation});
+        }
+    }
+    return handles;
+}
+
+std::vector<FacilityHandle> BookSnapshot::getFacilityHandles() const {
+    std::vector<FacilityHandle> handles;
+    for (DealHandle deal : getHandles()) {
+        for (size_t f = 0; f < getDeal(deal).getFacilitiesCount(); f++) {
+            handles.push_back({deal, static_cast<uint32_t>(f)});
+        }
+    }
+    return handles;
+}
+
+size_t BookSnapshot::getDealsCount() const {
+    return dealsCount;
+}
+
+const BookSnapshot::Entry* BookSnapshot::entryOf(DealHandle handle) const {
+    if (handle.index >= slots.size()) {
+        return nullptr;
+    }
+    const Entry& entry = slots[handle.index];
+    return entry.deal && entry.generation == handle.generation ? &entry : nullptr;
+}
+
+uint32_t BookSnapshot::slotOf(ContractNumber contractNum) const {
+    return contractNum.getCode() < contracts.size() ? contracts[contractNum.getCode()] : 0;
+}
+
+// Book
+
+BookStore::Batch::Batch(BookStore& book) : book(book) {
+    book.openBatches++;
+}
+
+BookStore::Batch::~Batch() {
+    if (--book.openBatches == 0) {
+        book.publish();
+    }
+}
+
+BookStore::BookStore() : published(std::make_shared<const BookSnapshot>()), openBatches(0) {}
+
+DealHandle BookStore::addDeal(const Deal& deal) {
+    validateNewDeal(deal);
+    DealHandle handle = insert(Deal(deal));
+    changed(handle.index);
+    for (BookObserver* observer : observers) {
+        observer->onDealAdded(getDeal(handle));
+    }
+    return handle;
+}
+
+DealHandle BookStore::addDeal(Deal&& deal) {
+    validateNewDeal(deal);
+    DealHandle handle = insert(std::move(deal));
+    changed(handle.index);
+    for (BookObserver* observer : observers) {
+        observer->onDealAdded(getDeal(handle));
+    }
+    return handle;
+}
+
+FacilityHandle BookStore::addFacility(DealHandle handle, const Facility& facility) {
+    dealAt(handle).addFacility(facility);
+    changed(handle.index);
+    FacilityHandle added = lastFacility(handle);
+    for (BookObserver* observer : observers) {
+        observer->onFacilityAdded(getDeal(handle), added.index);
+    }
+    return added;
+}
+
+FacilityHandle BookStore::addFacility(DealHandle handle, Facility&& facility) {
+    dealAt(handle).addFacility(std::move(facility));
+    changed(handle.index);
+    FacilityHandle added = lastFacility(handle);
+    for (BookObserver* observer : observers) {
+        observer->onFacilityAdded(getDeal(handle), added.index);
+    }
+    return added;
+}
+
+void BookStore::removeDeal(DealHandle handle) {
+    size_t position = positionOf(handle);
+    for (BookObserver* observer : observers) {
+        observer->onDealRemoved(deals[position]);
+    }
+    byContract.erase(deals[position].getContractNumber());
+
+    // Le dernier deal prend la place du deal retiré pour garder le stockage contigu
+    size_t last = deals.size() - 1;
+    if (position != last) {
+        deals[position] = std::move(deals[last]);
+        owners[position] = owners[last];
+        slots[owners[position]].position = position;
+    }
+    deals.pop_back();
+    owners.pop_back();
+
+    // Nouvelle génération : les handles existants vers cet emplacement deviennent invalides
+    Slot& slot = slots[handle.index];
+    slot.used = false;
+    slot.generation++;
+    freeSlots.push_back(handle.index);
+    changed(handle.index);
+}
+
+void BookStore::payPart(FacilityHandle handle, double amount, const std::string& date) {
+    dealAt(handle.deal).payPart(handle.index, amount, date);
+    changed(handle.deal.index);
+    for (BookObserver* observer : observers) {
+        observer->onPartPaid(getDeal(handle.deal), handle.index);
+    }
+}
+
+void BookStore::transferShare(FacilityHandle handle, const std::string& seller, const std::string& buyer,
+                              Money amount) {
+    dealAt(handle.deal).transferShare(handle.index, seller, buyer, amount);
+    changed(handle.deal.index);
+    for (BookObserver* observer : observers) {
+        observer->onSharesTransferred(getDeal(handle.deal), handle.index);
+    }
+}
+
+void BookStore::setStatus(DealHandle handle, Deal::Status status) {
+    dealAt(handle).setStatus(status);
+    changed(handle.index);
+    for (BookObserver* observer : observers) {
+        observer->onStatusChanged(getDeal(handle));
+    }
+}
+
+void BookStore::setAgent(DealHandle handle, const std::string& agent) {
+    dealAt(handle).setAgent(agent);
+    changed(handle.index);
+    for (BookObserver* observer : observers) {
+        observer->onAgentChanged(getDeal(handle));
+    }
+}
+
+void BookStore::accrueTo(const std::string& date) {
+    // Deals indépendants : courus en parallèle par tranches. Les observateurs sont
+    // prévenus ensuite, dans l'ordre du book, des facilities dont le registre a avancé.
+    // L'arrêté est publié d'un seul bloc.
+    Batch batch(*this);
+    std::vector<std::vector<uint32_t>> accrued(deals.size());
+    TaskScheduler::shared().parallelFor(0, deals.size(), ACCRUAL_GRAIN,
+                                        [this, &date, &accrued](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            for (size_t f = 0; f < deals[i].getFacilitiesCount(); f++) {
+                uint64_t before = deals[i].getFacilities()[f].getVersion();
+                deals[i].accrueTo(f, date);
+                if (deals[i].getFacilities()[f].getVersion() != before) {
+                    accrued[i].push_back(static_cast<uint32_t>(f));
+                }
+            }
+        }
+    });
+    for (size_t i = 0; i < deals.size(); i++) {
+        if (!accrued[i].empty()) {
+            changed(owners[i]);
+        }
+    }
+    for (size_t i = 0; i < deals.size(); i++) {
+        for (uint32_t f : accrued[i]) {
+            for (BookObserver* observer : observers) {
+                observer->onInterestAccrued(deals[i], f);
+            }
+        }
+    }
+}
+
+void BookStore::accrueTo(FacilityHandle handle, const std::string& date) {
+    uint64_t before = getFacility(handle).getVersion();
+    dealAt(handle.deal).accrueTo(handle.index, date);
+    if (getFacility(handle).getVersion() == before) {
+        return;
+    }
+    changed(handle.deal.index);
+    for (BookObserver* observer : observers) {
+        observer->onInterestAccrued(getDeal(handle.deal), handle.index);
+    }
+}
+
+std::shared_ptr<const BookSnapshot> BookStore::snapshot() const {
+    return std::atomic_load(&published);
+}
+
+void BookStore::addObserver(BookObserver* observer) {
+    if (observer == nullptr) {
+        throw std::invalid_argument("Observer cannot be null");
+    }
+    observers.push_back(observer);
+}
+
+void BookStore::removeObserver(BookObserver* observer) {
+    observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
+}
+
+bool BookStore::isValid(DealHandle handle) const {
+    return handle.index < slots.size() && slots[handle.index].used &&
+           slots[handle.index].generation == handle.generation;
+}
+
+bool BookStore::isValid(FacilityHandle handle) const {
+    return isValid(handle.deal) && handle.index < getDeal(handle.deal).getFacilitiesCount();
+}
+
+const Deal& BookStore::getDeal(DealHandle handle) const {
+    return deals[positionOf(handle)];
+}
+
+const Facility& BookStore::getFacility(FacilityHandle handle) const {
+    const Deal& deal = getDeal(handle.deal);
+    if (handle.index >= deal.getFacilitiesCount()) {
+        throw std::out_of_range("Facility index out of range");
+    }
+    return deal.getFacilities()[handle.index];
+}
+
+bool BookStore::hasDeal(const std::string& contractNum) const {
+    return ContractNumber::isValid(contractNum) &&
+           byContract.count(ContractNumber::parse(contractNum)) > 0;
+}
+
+DealHandle BookStore::findDeal(const std::string& contractNum) const {
+    return findDeal(ContractNumber::parse(contractNum));
+}
+
+DealHandle BookStore::findDeal(ContractNumber contractNum) const {
+    auto it = byContract.find(contractNum);
+    if (it == byContract.end()) {
+        throw std::invalid_argument("Unknown contract number: " + contractNum.toString());
+    }
+    return {it->second, slots[it->second].generation};
+}
+
+const std::vector<Deal>& BookStore::getDeals() const {
+    return deals;
+}
+
+DealHandle BookStore::getHandle(size_t position) const {
+    if (position >= deals.size()) {
+        throw std::out_of_range("Deal position out of range");
+    }
+    uint32_t index = owners[position];
+    return {index, slots[index].generation};
+}
+
+std::vector<DealHandle> BookStore::getHandles() const {
+    std::vector<DealHandle> handles;
+    handles.reserve(deals.size());
+    for (size_t i = 0; i < deals.size(); i++) {
+        handles.push_back(getHandle(i));
+    }
+    return handles;
+}
+
+std::vector<FacilityHandle> BookStore::getFacilityHandles() const {
+    std::vector<FacilityHandle> handles;
+    for (size_t i = 0; i < deals.size(); i++) {
+        DealHandle deal = getHandle(i);
+        for (size_t f = 0; f < deals[i].getFacilitiesCount(); f++) {
+            handles.push_back({deal, static_cast<uint32_t>(f)});
+        }
+    }
+    return handles;
+}
+
+size_t BookStore::getDealsCount() const {
+    return deals.size();
+}
+
+size_t BookStore::getFacilitiesCount() const {
+    size_t total = 0;
+    for (const Deal& deal : deals) {
+        total += deal.getFacilitiesCount();
+    }
+    return total;
+}
+
+DealHandle BookStore::insert(Deal&& deal) {
+    uint32_t index;
+    if (!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        index = static_cast<uint32_t>(slots.size());
+        slots.push_back({0, 0, false});
+        pending.push_back(0);
+    }
+
+    Slot& slot = slots[index];
+    slot.position = deals.size();
+    slot.used = true;
+    byContract[deal.getContractNumber()] = index;
+    deals.push_back(std::move(deal));
+    owners.push_back(index);
+    return {index, slot.generation};
+}
+
+size_t BookStore::positionOf(DealHandle handle) const {
+    if (!isValid(handle)) {
+        throw std::invalid_argument("Invalid or stale deal handle");
+    }
+    return slots[handle.index].position;
+}
+
+void BookStore::changed(uint32_t index) {
+    if (!pending[index]) {
+        pending[index] = 1;
+        dirty.push_back(index);
+    }
+    if (openBatches == 0) {
+        publish();
+    }
+}
+
+void BookStore::publish() {
+    if (dirty.empty()) {
+        return;
+    }
+    // Copie de la version courante : les arbres persistants sont partagés, seuls les
+    // chemins des emplacements modifiés sont recopiés
+    auto next = std::make_shared<BookSnapshot>(*published);
+    next->epoch++;
+    next->dealsCount = deals.size();
+
+    // Contrats retirés d'abord : un contrat peut changer d'emplacement dans un même lot
+    for (uint32_t index : dirty) {
+        if (index < next->slots.size() && next->slots[index].deal) {
+            next->contracts = next->contracts.set(next->slots[index].deal->getContractNumber().getCode(), 0);
+        }
+    }
+    for (uint32_t index : dirty) {
+        pending[index] = 0;
+        BookSnapshot::Entry entry{slots[index].generation, nullptr};
+        if (slots[index].used) {
+            entry.deal = std::make_shared<const Deal>(deals[slots[index].position]);
+            uint16_t code = entry.deal->getContractNumber().getCode();
+            while (next->contracts.size() <= code) {
+                next->contracts = next->contracts.pushBack(0);
+            }
+            next->contracts = next->contracts.set(code, index + 1);
+        }
+        while (next->slots.size() <= index) {
+            next->slots = next->slots.pushBack({0, nullptr});
+        }
+        next->slots = next->slots.set(index, std::move(entry));
+    }
+    dirty.clear();
+    std::atomic_store(&published, std::shared_ptr<const BookSnapshot>(std::move(next)));
+}
+
+Deal& BookStore::dealAt(DealHandle handle) {
+    return deals[positionOf(handle)];
+}
+
+FacilityHandle BookStore::lastFacility(DealHandle handle) const {
+    return {handle, static_cast<uint32_t>(getDeal(handle).getFacilitiesCount() - 1)};
+}
+
+void BookStore::validateNewDeal(const Deal& deal) const {
+    if (byContract.count(deal.getContractNumber()) > 0) {
+        throw std::invalid_argument("Contract number already exists in the book: " + deal.getContractNum());
+    }
+}
\ No newline at end of file
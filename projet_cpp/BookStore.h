@@ -0,0 +1,195 @@
+#ifndef BOOK_STORE_H
+#define BOOK_STORE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include "Deal.h"
+#include "Facility.h"
+#include "ContractNumber.h"
+#include "PersistentVector.h"
+
+// Handle stable vers un deal du book : emplacement + génération de l'emplacement.
+// Un handle dont le deal a été retiré devient invalide au lieu de pointer ailleurs.
+struct DealHandle {
+    uint32_t index;
+    uint32_t generation;
+
+    bool operator==(const DealHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const DealHandle& other) const { return !(*this == other); }
+};
+
+// Handle vers une facility : deal propriétaire + position dans le deal
+struct FacilityHandle {
+    DealHandle deal;
+    uint32_t index;
+
+    bool operator==(const FacilityHandle& other) const {
+        return deal == other.deal && index == other.index;
+    }
+    bool operator!=(const FacilityHandle& other) const { return !(*this == other); }
+};
+
+// Abonné aux mutations du book, notifié après chaque mutation réussie
+class BookObserver {
+public:
+    virtual ~BookObserver() = default;
+
+    virtual void onDealAdded(const Deal& deal) = 0;
+    virtual void onFacilityAdded(const Deal& deal, size_t facilityIndex) = 0;
+    virtual void onPartPaid(const Deal& deal, size_t facilityIndex) = 0;
+    virtual void onSharesTransferred(const Deal& deal, size_t facilityIndex) = 0;
+    // Registre d'intérêts de la facility avancé par un arrêté
+    virtual void onInterestAccrued(const Deal& deal, size_t facilityIndex) = 0;
+    virtual void onStatusChanged(const Deal& deal) = 0;
+    virtual void onAgentChanged(const Deal& deal) = 0;
+    // Appelé avant le retrait, le deal est encore accessible
+    virtual void onDealRemoved(const Deal& deal) = 0;
+};
+
+// Version publiée du book, immuable : les lecteurs qui la gardent (shared_ptr) lisent
+// sans verrou pendant que les écritures se poursuivent sur le book. Les deals non
+// modifiés d'une version à la suivante sont partagés ; une version et les copies de
+// deals qu'elle est seule à porter sont libérées avec son dernier détenteur.
+// Les handles du book s'y résolvent tant que le deal existait à la publication ;
+// le parcours suit l'ordre des emplacements et non celui du book.
+class BookSnapshot {
+public:
+    BookSnapshot();
+
+    // Numéro de la version, croissant à chaque publication
+    uint64_t getEpoch() const;
+
+    bool isValid(DealHandle handle) const;
+    bool isValid(FacilityHandle handle) const;
+    const Deal& getDeal(DealHandle handle) const;
+    const Facility& getFacility(FacilityHandle handle) const;
+
+    bool hasDeal(const std::string& contractNum) const;
+    DealHandle findDeal(const std::string& contractNum) const;
+    DealHandle findDeal(ContractNumber contractNum) const;
+
+    std::vector<DealHandle> getHandles() const;
+    std::vector<FacilityHandle> getFacilityHandles() const;
+    size_t getDealsCount() const;
+
+private:
+    friend class BookStore;
+
+    struct Entry {
+        uint32_t generation;
+        std::shared_ptr<const Deal> deal;   // Nul pour un emplacement libre
+    };
+
+    uint64_t epoch;
+    size_t dealsCount;
+    PersistentVector<Entry> slots;          // Par emplacement de handle
+    PersistentVector<uint32_t> contracts;   // Par code de contrat : emplacement + 1, 0 si absent
+
+    const Entry* entryOf(DealHandle handle) const;
+    uint32_t slotOf(ContractNumber contractNum) const;
+};
+
+// Propriétaire unique des deals (et de leurs facilities) du book.
+// Les deals sont rangés de manière contiguë ; les handles passent par une table
+// d'emplacements générationnels et restent valides malgré les réallocations.
+//
+// Chaque mutation publie une nouvelle version (BookSnapshot) où seul le deal modifié
+// est recopié ; dans un Batch, la publication attend la fermeture du dernier lot ouvert,
+// de sorte qu'un lecteur voit le lot entier ou rien. Les mutations et la publication
+// restent réservées à un seul thread à la fois ; snapshot() peut être appelé de
+// n'importe quel thread.
+class BookStore {
+public:
+    // Lot de mutations publié d'un seul bloc
+    class Batch {
+    public:
+        explicit Batch(BookStore& book);
+        ~Batch();
+
+        Batch(const Batch&) = delete;
+        Batch& operator=(const Batch&) = delete;
+
+    private:
+        BookStore& book;
+    };
+
+    BookStore();
+
+    // Ajout et retrait
+    DealHandle addDeal(const Deal& deal);
+    DealHandle addDeal(Deal&& deal);
+    FacilityHandle addFacility(DealHandle handle, const Facility& facility);
+    FacilityHandle addFacility(DealHandle handle, Facility&& facility);
+    void removeDeal(DealHandle handle);
+
+    // Mutations, toujours appliquées sur l'unique exemplaire de l'entité
+    void payPart(FacilityHandle handle, double amount, const std::string& date);
+    void transferShare(FacilityHandle handle, const std::string& seller, const std::string& buyer, Money amount);
+    void setStatus(DealHandle handle, Deal::Status status);
+    void setAgent(DealHandle handle, const std::string& agent);
+    // Arrêté des intérêts courus de tout le book, ou d'une facility, à la date donnée
+    void accrueTo(const std::string& date);
+    void accrueTo(FacilityHandle handle, const std::string& date);
+
+    // Dernière version publiée, lue atomiquement
+    std::shared_ptr<const BookSnapshot> snapshot() const;
+
+    // Abonnés non possédés, à retirer avant leur destruction
+    void addObserver(BookObserver* observer);
+    void removeObserver(BookObserver* observer);
+
+    // Résolution des handles (exception si le handle est invalide)
+    bool isValid(DealHandle handle) const;
+    bool isValid(FacilityHandle handle) const;
+    const Deal& getDeal(DealHandle handle) const;
+    const Facility& getFacility(FacilityHandle handle) const;
+
+    // Recherche par numéro de contrat
+    bool hasDeal(const std::string& contractNum) const;
+    DealHandle findDeal(const std::string& contractNum) const;
+    DealHandle findDeal(ContractNumber contractNum) const;
+
+    // Parcours : deals contigus et handles dans le même ordre
+    const std::vector<Deal>& getDeals() const;
+    DealHandle getHandle(size_t position) const;
+    std::vector<DealHandle> getHandles() const;
+    std::vector<FacilityHandle> getFacilityHandles() const;
+    size_t getDealsCount() const;
+    size_t getFacilitiesCount() const;
+
+private:
+    // Deals par tâche lors des intérêts courus en parallèle
+    static const size_t ACCRUAL_GRAIN = 256;
+
+    struct Slot {
+        uint32_t generation;
+        size_t position;
+        bool used;
+    };
+
+    std::vector<Deal> deals;
+    std::vector<uint32_t> owners;
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::unordered_map<ContractNumber, uint32_t> byContract;
+    std::vector<BookObserver*> observers;
+    std::shared_ptr<const BookSnapshot> published;
+    std::vector<uint32_t> dirty;     // Emplacements modifiés depuis la dernière publication
+    std::vector<uint8_t> pending;    // Par emplacement : déjà dans dirty
+    size_t openBatches;
+
+    DealHandle insert(Deal&& deal);
+    void changed(uint32_t index);
+    void publish();
+    size_t positionOf(DealHandle handle) const;
+    Deal& dealAt(DealHandle handle);
+    FacilityHandle lastFacility(DealHandle handle) const;
+    void validateNewDeal(const Deal& deal) const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,201 @@
+#include "BorrowerIndex.h"
+#include <algorithm>
+#include <stdexcept>
+
+BorrowerIndex::BorrowerIndex(BookStore& book) : book(book) {
+    for (const Deal& deal : book.getDeals()) {
+        registerDeal(deal);
+    }
+    book.addObserver(this);
+}
+
+BorrowerIndex::~BorrowerIndex() {
+    book.removeObserver(this);
+}
+
+void BorrowerIndex::setLimit(const std::string& borrower, const std::string& currency, double limit) {
+    validateLimit(limit);
+    CurrencyCode code = CurrencyCode::parse(currency);
+
+    Exposure& exposure = entries[borrower].exposures[code];
+    exposure.limit = Money::fromDouble(limit, code);
+    exposure.limited = true;
+    checkLimit(borrower, code, exposure, "");
+}
+
+void BorrowerIndex::clearLimit(const std::string& borrower, const std::string& currency) {
+    auto it = entries.find(borrower);
+    if (it == entries.end()) {
+        return;
+    }
+    auto exposure = it->second.exposures.find(CurrencyCode::parse(currency));
+    if (exposure != it->second.exposures.end()) {
+        exposure->second.limited = false;
+        exposure->second.limit = Money();
+    }
+}
+
+bool BorrowerIndex::hasLimit(const std::string& borrower, const std::string& currency) const {
+    const Exposure* exposure = findExposure(borrower, CurrencyCode::parse(currency));
+    return exposure != nullptr && exposure->limited;
+}
+
+Money BorrowerIndex::getLimit(const std::string& borrower, const std::string& currency) const {
+    const Exposure* exposure = findExposure(borrower, CurrencyCode::parse(currency));
+    if (exposure == nullptr || !exposure->limited) {
+        throw std::invalid_argument("No " + currency + " limit defined for borrower: " + borrower);
+    }
+    return exposure->limit;
+}
+
+bool BorrowerIndex::wouldBreach(const std::string& borrower, const std::string& currency,
+                                double additionalAmount) const {
+    CurrencyCode code = CurrencyCode::parse(currency);
+    const Exposure* exposure = findExposure(borrower, code);
+    if (exposure == nullptr || !exposure->limited) {
+        return false;
+    }
+    return exposure->outstanding + Money::fromDouble(additionalAmount, code) > exposure->limit;
+}
+
+bool BorrowerIndex::isBreached(const std::string& borrower, const std::string& currency) const {
+    return wouldBreach(borrower, currency, 0);
+}
+
+Money BorrowerIndex::getOutstanding(const std::string& borrower, const std::string& currency) const {
+    const Exposure* exposure = findExposure(borrower, CurrencyCode::parse(currency));
+    return exposure == nullptr ? Money() : exposure->outstanding;
+}
+
+const std::vector<std::string>& BorrowerIndex::getDeals(const std::string& borrower) const {
+    static const std::vector<std::string> empty;
+    auto it = entries.find(borrower);
+    return it == entries.end() ? empty : it->second.deals;
+}
+
+const std::vector<BorrowerIndex::FacilityRef>& BorrowerIndex::getFacilities(const std::string& borrower) const {
+    static const std::vector<FacilityRef> empty;
+    auto it = entries.find(borrower);
+    return it == entries.end() ? empty : it->second.facilities;
+}
+
+size_t BorrowerIndex::getBorrowersCount() const {
+    return entries.size();
+}
+
+const std::vector<BorrowerIndex::Breach>& BorrowerIndex::getBreaches() const {
+    return breaches;
+}
+
+const BookStore& BorrowerIndex::getBook() const {
+    return book;
+}
+
+void BorrowerIndex::onDealAdded(const Deal& deal) {
+    registerDeal(deal);
+}
+
+void BorrowerIndex::onFacilityAdded(const Deal& deal, size_t facilityIndex) {
+    DealState& state = stateOf(deal);
+    Entry& entry = entries[state.borrower];
+    const Facility& facility = deal.getFacilities()[facilityIndex];
+    FacilityState current{facility.getCurrencyCode(), facility.getRemainingMoney()};
+
+    // La position de la facility dans le deal est donnée par la notification
+    entry.facilities.push_back({deal.getContractNum(), facilityIndex});
+    state.facilities.push_back(current);
+    Exposure& exposure = entry.exposures[current.currency];
+    exposure.outstanding += current.remaining;
+    checkLimit(state.borrower, current.currency, exposure, deal.getContractNum());
+}
+
+void BorrowerIndex::onPartPaid(const Deal& deal, size_t facilityIndex) {
+    // Le montant de la part est validé par la facility avant toute mutation du book
+    DealState& state = stateOf(deal);
+    FacilityState& previous = state.facilities[facilityIndex];
+    Money remaining = deal.getFacilities()[facilityIndex].getRemainingMoney();
+
+    entries[state.borrower].exposures[previous.currency].outstanding -= previous.remaining - remaining;
+    previous.remaining = remaining;
+}
+
+void BorrowerIndex::onSharesTransferred(const Deal&, size_t) {
+    // Sans effet sur l'encours de l'emprunteur
+}
+
+void BorrowerIndex::onInterestAccrued(const Deal&, size_t) {
+    // Sans effet sur l'encours de l'emprunteur
+}
+
+void BorrowerIndex::onStatusChanged(const Deal&) {
+    // Sans effet sur l'encours de l'emprunteur
+}
+
+void BorrowerIndex::onAgentChanged(const Deal&) {
+    // Sans effet sur l'encours de l'emprunteur
+}
+
+void BorrowerIndex::onDealRemoved(const Deal& deal) {
+    auto it = deals.find(deal.getContractNumber());
+    if (it == deals.end()) {
+        return;
+    }
+    Entry& entry = entries[it->second.borrower];
+    std::string contractNum = deal.getContractNum();
+    for (const FacilityState& facility : it->second.facilities) {
+        entry.exposures[facility.currency].outstanding -= facility.remaining;
+    }
+    entry.deals.erase(std::remove(entry.deals.begin(), entry.deals.end(), contractNum), entry.deals.end());
+    entry.facilities.erase(std::remove_if(entry.facilities.begin(), entry.facilities.end(),
+                                          [&contractNum](const FacilityRef& ref) { return ref.contractNum == contractNum; }),
+                           entry.facilities.end());
+    deals.erase(it);
+}
+
+void BorrowerIndex::registerDeal(const Deal& deal) {
+    ContractNumber contractNum = deal.getContractNumber();
+    if (deals.count(contractNum) > 0) {
+        throw std::invalid_argument("Deal already registered: " + contractNum.toString());
+    }
+
+    const std::string& borrower = deal.getBorrower().getName();
+    deals[contractNum].borrower = borrower;
+    entries[borrower].deals.push_back(contractNum.toString());
+
+    // Reprise des facilities déjà présentes dans le deal
+    for (size_t f = 0; f < deal.getFacilitiesCount(); f++) {
+        onFacilityAdded(deal, f);
+    }
+}
+
+BorrowerIndex::DealState& BorrowerIndex::stateOf(const Deal& deal) {
+    auto it = deals.find(deal.getContractNumber());
+    if (it == deals.end()) {
+        throw std::invalid_argument("Deal not registered: " + deal.getContractNum());
+    }
+    return it->second;
+}
+
+const BorrowerIndex::Exposure* BorrowerIndex::findExposure(const std::string& borrower, CurrencyCode currency) const {
+    auto entry = entries.find(borrower);
+    if (entry == entries.end()) {
+        return nullptr;
+    }
+    auto it = entry->second.exposures.find(currency);
+    return it == entry->second.exposures.end() ? nullptr : &it->second;
+}
+
+void BorrowerIndex::checkLimit(const std::string& borrower, CurrencyCode currency, const Exposure& exposure,
+                               const std::string& contractNum) {
+    if (!exposure.limited || exposure.outstanding <= exposure.limit) {
+        return;
+    }
+
+    breaches.push_back({borrower, currency, contractNum, exposure.outstanding, exposure.limit});
+}
+
+void BorrowerIndex::validateLimit(double limit) const {
+    if (limit < 0) {
+        throw std::invalid_argument("Concentration limit cannot be negative");
+    }
+}
\ No newline at end of file
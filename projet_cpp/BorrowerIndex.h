@@ -0,0 +1,105 @@
+#ifndef BORROWER_INDEX_H
+#define BORROWER_INDEX_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "Deal.h"
+#include "Facility.h"
+#include "BookStore.h"
+#include "ContractNumber.h"
+#include "CurrencyCode.h"
+#include "Money.h"
+
+// Index des expositions par emprunteur : deals, facilities et encours agrégé par devise
+// maintenus à chaque mutation du book pour un contrôle des limites en O(1).
+// Les encours ne sont jamais convertis : une limite porte sur un couple (emprunteur, devise).
+// L'encours de chaque facility est retenu pour appliquer les mutations par différence.
+class BorrowerIndex : public BookObserver {
+public:
+    // Référence d'une facility dans le book (deal + position dans le deal)
+    struct FacilityRef {
+        std::string contractNum;
+        size_t index;
+    };
+
+    // Dépassement de limite constaté lors d'une mutation
+    struct Breach {
+        std::string borrower;
+        CurrencyCode currency;
+        std::string contractNum;   // Vide quand la limite est posée sur un encours existant
+        Money outstanding;
+        Money limit;
+    };
+
+    // Reprend les deals du book puis s'abonne à ses mutations
+    explicit BorrowerIndex(BookStore& book);
+    ~BorrowerIndex() override;
+
+    BorrowerIndex(const BorrowerIndex&) = delete;
+    BorrowerIndex& operator=(const BorrowerIndex&) = delete;
+
+    // Limites de concentration, par devise
+    void setLimit(const std::string& borrower, const std::string& currency, double limit);
+    void clearLimit(const std::string& borrower, const std::string& currency);
+    bool hasLimit(const std::string& borrower, const std::string& currency) const;
+    Money getLimit(const std::string& borrower, const std::string& currency) const;
+    bool wouldBreach(const std::string& borrower, const std::string& currency, double additionalAmount) const;
+    bool isBreached(const std::string& borrower, const std::string& currency) const;
+
+    // Consultation de l'index
+    Money getOutstanding(const std::string& borrower, const std::string& currency) const;
+    const std::vector<std::string>& getDeals(const std::string& borrower) const;
+    const std::vector<FacilityRef>& getFacilities(const std::string& borrower) const;
+    size_t getBorrowersCount() const;
+    const std::vector<Breach>& getBreaches() const;
+    const BookStore& getBook() const;
+
+    void onDealAdded(const Deal& deal) override;
+    void onFacilityAdded(const Deal& deal, size_t facilityIndex) override;
+    void onPartPaid(const Deal& deal, size_t facilityIndex) override;
+    void onSharesTransferred(const Deal& deal, size_t facilityIndex) override;
+    void onInterestAccrued(const Deal& deal, size_t facilityIndex) override;
+    void onStatusChanged(const Deal& deal) override;
+    void onAgentChanged(const Deal& deal) override;
+    void onDealRemoved(const Deal& deal) override;
+
+private:
+    struct Exposure {
+        Money outstanding;
+        Money limit;
+        bool limited = false;
+    };
+
+    struct Entry {
+        std::vector<std::string> deals;
+        std::vector<FacilityRef> facilities;
+        std::unordered_map<CurrencyCode, Exposure> exposures;
+    };
+
+    // Devise et dernier encours connu d'une facility
+    struct FacilityState {
+        CurrencyCode currency;
+        Money remaining;
+    };
+
+    // Emprunteur du deal et état de chacune de ses facilities
+    struct DealState {
+        std::string borrower;
+        std::vector<FacilityState> facilities;
+    };
+
+    BookStore& book;
+    std::unordered_map<std::string, Entry> entries;
+    std::unordered_map<ContractNumber, DealState> deals;
+    std::vector<Breach> breaches;
+
+    void registerDeal(const Deal& deal);
+    DealState& stateOf(const Deal& deal);
+    const Exposure* findExposure(const std::string& borrower, CurrencyCode currency) const;
+    void checkLimit(const std::string& borrower, CurrencyCode currency, const Exposure& exposure,
+                    const std::string& contractNum);
+    void validateLimit(double limit) const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "BufferWriter.h"
+#include <charconv>
+#include <stdexcept>
+
+BufferWriter::BufferWriter(std::ostream& out, size_t blockSize) : out(out), blockSize(blockSize) {
+    if (blockSize == 0) {
+        throw std::invalid_argument("Block size must be positive");
+    }
+    buffer.reserve(blockSize);
+}
+
+BufferWriter::~BufferWriter() {
+    try {
+        flush();
+    } catch (...) {
+        // Un destructeur ne doit pas propager d'exception
+    }
+}
+
+BufferWriter& BufferWriter::operator<<(std::string_view text) {
+    buffer.append(text.data(), text.size());
+    return *this;
+}
+
+BufferWriter& BufferWriter::operator<<(const std::string& text) {
+    buffer.append(text);
+    return *this;
+}
+
+BufferWriter& BufferWriter::operator<<(const char* text) {
+    buffer.append(text);
+    return *this;
+}
+
+BufferWriter& BufferWriter::operator<<(char c) {
+    buffer.push_back(c);
+    return *this;
+}
+
+BufferWriter& BufferWriter::operator<<(double value) {
+    // Précision fixe : les erreurs d'arrondi binaire n'apparaissent pas à l'affichage.
+    // Notation la plus courte seulement pour les valeurs extrêmes.
+    char digits[128];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value,
+                                                std::chars_format::fixed, DISPLAY_DECIMALS);
+    if (result.ec != std::errc()) {
+        return appendNumber(value);
+    }
+    char* end = result.ptr;
+    while (end[-1] == '0') {
+        end--;
+    }
+    if (end[-1] == '.') {
+        end--;
+    }
+    // Une valeur négative arrondie à zéro s'écrit 0
+    if (end - digits == 2 && digits[0] == '-' && digits[1] == '0') {
+        buffer.push_back('0');
+        return *this;
+    }
+    buffer.append(digits, end);
+    return *this;
+}
+
+BufferWriter& BufferWriter::operator<<(int value) {
+    return appendNumber(value);
+}
+
+BufferWriter& BufferWriter::operator<<(int64_t value) {
+    return appendNumber(value);
+}
+
+BufferWriter& BufferWriter::operator<<(uint64_t value) {
+    return appendNumber(value);
+}
+
+BufferWriter& BufferWriter::fixed(double value, int precision) {
+    char digits[64];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value,
+                                                std::chars_format::fixed, precision);
+    if (result.ec != std::errc()) {
+        throw std::runtime_error("Failed to format number");
+    }
+    buffer.append(digits, result.ptr);
+    return *this;
+}
+
+void BufferWriter::endBlock() {
+    if (buffer.size() >= blockSize) {
+        flush();
+    }
+}
+
+void BufferWriter::flush() {
+    if (buffer.empty()) {
+        return;
+    }
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    out.flush();
+    buffer.clear();
+}
+
+size_t BufferWriter::getBufferedSize() const {
+    return buffer.size();
+}
+
+template <typename T>
+BufferWriter& BufferWriter::appendNumber(T value) {
+    char digits[64];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    if (result.ec != std::errc()) {
+        throw std::runtime_error("Failed to format number");
+    }
+    buffer.append(digits, result.ptr);
+    return *this;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#ifndef BUFFER_WRITER_H
+#define BUFFER_WRITER_H
+
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <cstdint>
+
+// Tampon d'écriture réutilisable : le texte est formaté en mémoire (nombres via
+// std::to_chars) puis transmis au flux en une seule écriture par bloc
+class BufferWriter {
+public:
+    // Décimales des nombres à virgule écrits par operator<<
+    static const int DISPLAY_DECIMALS = 6;
+
+    explicit BufferWriter(std::ostream& out, size_t blockSize = 64 * 1024);
+    ~BufferWriter();
+
+    BufferWriter(const BufferWriter&) = delete;
+    BufferWriter& operator=(const BufferWriter&) = delete;
+
+    BufferWriter& operator<<(std::string_view text);
+    BufferWriter& operator<<(const std::string& text);
+    BufferWriter& operator<<(const char* text);
+    BufferWriter& operator<<(char c);
+    // Arrondi à DISPLAY_DECIMALS décimales, sans zéros de fin (3.5 et non 3.5000000000000004)
+    BufferWriter& operator<<(double value);
+    BufferWriter& operator<<(int value);
+    BufferWriter& operator<<(int64_t value);
+    BufferWriter& operator<<(uint64_t value);
+
+    // Nombre à virgule fixe avec le nombre de décimales demandé
+    BufferWriter& fixed(double value, int precision);
+
+    // Fin de bloc logique : écrit le tampon s'il dépasse la taille de bloc
+    void endBlock();
+    void flush();
+
+    size_t getBufferedSize() const;
+
+private:
+    std::ostream& out;
+    std::string buffer;
+    size_t blockSize;
+
+    template <typename T>
+    BufferWriter& appendNumber(T value);
+};
+
+#endif
\ No newline at end of file
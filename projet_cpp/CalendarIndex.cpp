@@ -0,0 +1,211 @@
+#include "CalendarIndex.h"
+#include "DateUtils.h"
+#include <algorithm>
+#include <stdexcept>
+
+CalendarIndex::CalendarIndex(BookStore& book)
+    : book(book), eventsCount(0), sweptUntil(0), swept(false) {
+    rebuild();
+    book.addObserver(this);
+}
+
+CalendarIndex::~CalendarIndex() {
+    book.removeObserver(this);
+}
+
+void CalendarIndex::rebuild() {
+    buckets.clear();
+    dealDays.clear();
+    overdue.clear();
+    eventsCount = 0;
+    for (DealHandle deal : book.getHandles()) {
+        addDeal(deal);
+    }
+}
+
+void CalendarIndex::addDeal(DealHandle handle) {
+    const Deal& deal = book.getDeal(handle);
+    addEvent({toDayNumber(deal.getContractEndDate()), EventType::DEAL_MATURITY, handle, 0, 0,
+              Deal::Status::TERMINATED});
+
+    for (size_t f = 0; f < deal.getFacilitiesCount(); f++) {
+        FacilityHandle facility{handle, static_cast<uint32_t>(f)};
+        addFacility(facility);
+        for (const Part& part : deal.getFacilities()[f].getParts()) {
+            addRepayment(facility, part);
+        }
+    }
+}
+
+void CalendarIndex::addFacility(FacilityHandle handle) {
+    const Facility& facility = book.getFacility(handle);
+    addEvent({toDayNumber(facility.getEndDate()), EventType::FACILITY_MATURITY, handle.deal, handle.index,
+              facility.getRemainingAmount(), book.getDeal(handle.deal).getStatus()});
+}
+
+void CalendarIndex::addRepayment(FacilityHandle handle, const Part& part) {
+    book.getFacility(handle);
+    addEvent({toDayNumber(part.getDate()), EventType::REPAYMENT, handle.deal, handle.index,
+              part.getAmount(), book.getDeal(handle.deal).getStatus()});
+}
+
+void CalendarIndex::updateMaturity(FacilityHandle handle) {
+    // Le remboursement prévu à l'échéance suit le restant dû après chaque part
+    const Facility& facility = book.getFacility(handle);
+    auto bucket = buckets.find(toDayNumber(facility.getEndDate()));
+    if (bucket == buckets.end()) {
+        return;
+    }
+    for (Event& event : bucket->second) {
+        if (event.type == EventType::FACILITY_MATURITY && event.deal == handle.deal &&
+            event.facilityIndex == handle.index) {
+            event.amount = facility.getRemainingAmount();
+        }
+    }
+}
+
+void CalendarIndex::scheduleStatusChange(DealHandle handle, const std::string& date, Deal::Status status) {
+    book.getDeal(handle);
+    int day = toDayNumber(date);
+    if (swept && day <= sweptUntil) {
+        throw std::invalid_argument("Cannot schedule a status change on an already swept date");
+    }
+    addEvent({day, EventType::STATUS_CHANGE, handle, 0, 0, status});
+}
+
+std::vector<CalendarIndex::Event> CalendarIndex::nextEvents(const std::string& fromDate, size_t count) const {
+    std::vector<Event> result;
+    for (auto it = buckets.lower_bound(toDayNumber(fromDate)); it != buckets.end() && result.size() < count; ++it) {
+        for (const Event& event : it->second) {
+            if (result.size() == count) {
+                break;
+            }
+            result.push_back(event);
+        }
+    }
+    return result;
+}
+
+std::vector<CalendarIndex::Event> CalendarIndex::eventsInRange(const std::string& fromDate,
+                                                               const std::string& toDate) const {
+    int from = toDayNumber(fromDate);
+    int to = toDayNumber(toDate);
+    if (to < from) {
+        throw std::invalid_argument("Range end must not be before range start");
+    }
+
+    std::vector<Event> result;
+    for (auto it = buckets.lower_bound(from); it != buckets.end() && it->first <= to; ++it) {
+        result.insert(result.end(), it->second.begin(), it->second.end());
+    }
+    return result;
+}
+
+size_t CalendarIndex::sweep(const std::string& today) {
+    int day = toDayNumber(today);
+    if (swept && day < sweptUntil) {
+        throw std::invalid_argument("Sweep date cannot go back in time");
+    }
+
+    // Échéances ajoutées depuis le dernier balayage sur des jours déjà balayés
+    std::vector<Event> late;
+    late.swap(overdue);
+    size_t changed = 0;
+    for (const Event& event : late) {
+        if (apply(event)) {
+            changed++;
+        }
+    }
+
+    // Seuls les jours non encore traités sont parcourus
+    auto it = swept ? buckets.upper_bound(sweptUntil) : buckets.begin();
+    for (; it != buckets.end() && it->first <= day; ++it) {
+        for (const Event& event : it->second) {
+            if (apply(event)) {
+                changed++;
+            }
+        }
+    }
+
+    sweptUntil = day;
+    swept = true;
+    return changed;
+}
+
+size_t CalendarIndex::getEventsCount() const {
+    return eventsCount;
+}
+
+void CalendarIndex::onDealAdded(const Deal& deal) {
+    addDeal(book.findDeal(deal.getContractNumber()));
+}
+
+void CalendarIndex::onFacilityAdded(const Deal& deal, size_t facilityIndex) {
+    addFacility({book.findDeal(deal.getContractNumber()), static_cast<uint32_t>(facilityIndex)});
+}
+
+void CalendarIndex::onPartPaid(const Deal& deal, size_t facilityIndex) {
+    FacilityHandle facility{book.findDeal(deal.getContractNumber()), static_cast<uint32_t>(facilityIndex)};
+    addRepayment(facility, deal.getFacilities()[facilityIndex].getParts().back());
+    updateMaturity(facility);
+}
+
+void CalendarIndex::onSharesTransferred(const Deal&, size_t) {
+    // Sans effet sur le calendrier
+}
+
+void CalendarIndex::onInterestAccrued(const Deal&, size_t) {
+    // Sans effet sur le calendrier
+}
+
+void CalendarIndex::onStatusChanged(const Deal&) {
+    // Les changements de statut programmés restent à appliquer
+}
+
+void CalendarIndex::onAgentChanged(const Deal&) {
+    // Sans effet sur le calendrier
+}
+
+void CalendarIndex::onDealRemoved(const Deal& deal) {
+    auto days = dealDays.find(deal.getContractNumber());
+    if (days == dealDays.end()) {
+        return;
+    }
+    DealHandle handle = book.findDeal(deal.getContractNumber());
+    auto ofDeal = [handle](const Event& event) { return event.deal == handle; };
+    for (int day : days->second) {
+        auto bucket = buckets.find(day);
+        if (bucket == buckets.end()) {
+            continue;
+        }
+        std::vector<Event>& events = bucket->second;
+        size_t before = events.size();
+        events.erase(std::remove_if(events.begin(), events.end(), ofDeal), events.end());
+        eventsCount -= before - events.size();
+        if (events.empty()) {
+            buckets.erase(bucket);
+        }
+    }
+    overdue.erase(std::remove_if(overdue.begin(), overdue.end(), ofDeal), overdue.end());
+    dealDays.erase(days);
+}
+
+void CalendarIndex::addEvent(const Event& event) {
+    buckets[event.day].push_back(event);
+    dealDays[book.getDeal(event.deal).getContractNumber()].push_back(event.day);
+    eventsCount++;
+    if (swept && event.day <= sweptUntil && event.type == EventType::DEAL_MATURITY) {
+        overdue.push_back(event);
+    }
+}
+
+bool CalendarIndex::apply(const Event& event) {
+    if (event.type != EventType::DEAL_MATURITY && event.type != EventType::STATUS_CHANGE) {
+        return false;
+    }
+    if (!book.isValid(event.deal) || book.getDeal(event.deal).getStatus() == event.status) {
+        return false;
+    }
+    book.setStatus(event.deal, event.status);
+    return true;
+}
\ No newline at end of file
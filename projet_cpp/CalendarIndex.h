@@ -0,0 +1,84 @@
+#ifndef CALENDAR_INDEX_H
+#define CALENDAR_INDEX_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include "Deal.h"
+#include "BookStore.h"
+#include "ContractNumber.h"
+
+// Calendrier des événements du book (échéances, remboursements, changements de
+// statut) rangés par numéro de jour pour des parcours chronologiques.
+// Abonné au book : les deals, facilities et parts ajoutés y sont indexés à la
+// mutation, les événements d'un deal retiré en sont effacés.
+class CalendarIndex : public BookObserver {
+public:
+    enum class EventType {
+        DEAL_MATURITY,      // Fin de contrat du deal
+        FACILITY_MATURITY,  // Remboursement prévu du restant dû à l'échéance de la facility
+        REPAYMENT,          // Remboursement (part) effectué
+        STATUS_CHANGE       // Changement de statut programmé
+    };
+
+    struct Event {
+        int day;
+        EventType type;
+        DealHandle deal;
+        size_t facilityIndex;
+        double amount;
+        Deal::Status status;
+    };
+
+    // Indexe les événements du book puis s'abonne à ses mutations
+    explicit CalendarIndex(BookStore& book);
+    ~CalendarIndex() override;
+
+    CalendarIndex(const CalendarIndex&) = delete;
+    CalendarIndex& operator=(const CalendarIndex&) = delete;
+
+    // Reconstruction complète (les changements de statut programmés sont perdus)
+    void rebuild();
+    void scheduleStatusChange(DealHandle deal, const std::string& date, Deal::Status status);
+
+    // Parcours chronologiques
+    std::vector<Event> nextEvents(const std::string& fromDate, size_t count) const;
+    std::vector<Event> eventsInRange(const std::string& fromDate, const std::string& toDate) const;
+
+    // Traitement de fin de journée : applique les événements échus jusqu'à la date
+    // incluse (deals arrivés à échéance -> TERMINATED), retourne le nombre de deals modifiés.
+    // Seuls les jours non encore balayés sont parcourus ; l'échéance d'un deal ajouté sur
+    // un jour déjà balayé est appliquée au balayage suivant.
+    size_t sweep(const std::string& today);
+
+    size_t getEventsCount() const;
+
+    void onDealAdded(const Deal& deal) override;
+    void onFacilityAdded(const Deal& deal, size_t facilityIndex) override;
+    void onPartPaid(const Deal& deal, size_t facilityIndex) override;
+    void onSharesTransferred(const Deal& deal, size_t facilityIndex) override;
+    void onInterestAccrued(const Deal& deal, size_t facilityIndex) override;
+    void onStatusChanged(const Deal& deal) override;
+    void onAgentChanged(const Deal& deal) override;
+    void onDealRemoved(const Deal& deal) override;
+
+private:
+    BookStore& book;
+    std::map<int, std::vector<Event>> buckets;
+    // Jours portant des événements de chaque deal, pour les effacer à son retrait
+    std::unordered_map<ContractNumber, std::vector<int>> dealDays;
+    std::vector<Event> overdue;
+    size_t eventsCount;
+    int sweptUntil;
+    bool swept;
+
+    void addDeal(DealHandle deal);
+    void addFacility(FacilityHandle facility);
+    void addRepayment(FacilityHandle facility, const Part& part);
+    void updateMaturity(FacilityHandle facility);
+    void addEvent(const Event& event);
+    bool apply(const Event& event);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include "ChangeStream.h"
+#include "DateUtils.h"
+#include <stdexcept>
+
+namespace {
+
+const char* const TYPE_NAMES[] = {"deal_added", "facility_added", "part_paid", "shares_transferred",
+                                  "status_changed", "agent_changed", "deal_removed", "interest_accrued"};
+const size_t TYPES_COUNT = sizeof(TYPE_NAMES) / sizeof(TYPE_NAMES[0]);
+
+// Jour absent (changement sans date)
+const uint32_t NO_DAY = 0x80000000u;
+
+}
+
+// Curseur
+
+ChangeStream::Cursor::Cursor(const ChangeStream& stream, uint64_t next) : stream(stream), next(next) {}
+
+ChangeStream::PollResult ChangeStream::Cursor::poll(ChangeRecord& record) {
+    uint64_t published = stream.published.load(std::memory_order_acquire);
+    if (next >= published) {
+        return PollResult::EMPTY;
+    }
+    if (published - next > stream.mask + 1) {
+        return PollResult::LAPPED;
+    }
+
+    // Lecture optimiste : l'emplacement doit porter la même séquence avant et après la copie
+    const Slot& slot = stream.slots[next & stream.mask];
+    uint64_t before = slot.sequence.load(std::memory_order_acquire);
+    uint64_t header = slot.words[0].load(std::memory_order_relaxed);
+    uint64_t amount = slot.words[1].load(std::memory_order_relaxed);
+    uint64_t extra = slot.words[2].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t after = slot.sequence.load(std::memory_order_relaxed);
+    if (before != next || after != next) {
+        return PollResult::LAPPED;
+    }
+
+    record.sequence = next;
+    record.type = static_cast<ChangeRecord::Type>(header & 0xff);
+    record.contractNum = ContractNumber::fromCode(static_cast<uint16_t>(header >> 8)).toString();
+    record.facilityIndex = static_cast<uint32_t>(header >> 24);
+    record.amount = Money::fromUnits(static_cast<int64_t>(amount));
+    uint32_t day = static_cast<uint32_t>(extra);
+    record.date = day == NO_DAY ? "" : toDateString(static_cast<int32_t>(day));
+    uint32_t text = static_cast<uint32_t>(extra >> 32);
+    record.text = text == 0 ? "" : stream.getText(text);
+    next++;
+    return PollResult::RECORD;
+}
+
+uint64_t ChangeStream::Cursor::getNextSequence() const {
+    return next;
+}
+
+// Flux
+
+ChangeStream::ChangeStream(BookStore& book, size_t capacity) : book(book), mask(0), published(1) {
+    validateCapacity(capacity);
+    size_t size = 2;
+    while (size < capacity) {
+        size *= 2;
+    }
+    slots.reset(new Slot[size]);
+    mask = size - 1;
+    texts.push_back("");   // Identifiant 0 : pas de texte
+    book.addObserver(this);
+}
+
+ChangeStream::~ChangeStream() {
+    book.removeObserver(this);
+}
+
+ChangeStream::Cursor ChangeStream::subscribe() const {
+    return Cursor(*this, getNextSequence());
+}
+
+ChangeStream::Cursor ChangeStream::subscribeFrom(uint64_t sequence) const {
+    if (sequence == 0 || sequence > getNextSequence()) {
+        throw std::invalid_argument("Sequence " + std::to_string(sequence) + " has not been produced yet");
+    }
+    return Cursor(*this, sequence);
+}
+
+uint64_t ChangeStream::getNextSequence() const {
+    return published.load(std::memory_order_acquire);
+}
+
+uint64_t ChangeStream::getOldestSequence() const {
+    uint64_t next = getNextSequence();
+    return next > mask + 1 ? next - (mask + 1) : 1;
+}
+
+size_t ChangeStream::getCapacity() const {
+    return mask + 1;
+}
+
+void ChangeStream::onDealAdded(const Deal& deal) {
+    publish(ChangeRecord::Type::DEAL_ADDED, deal, 0, deal.getProjectMoney(), toDayNumber(deal.getContractSignDate()),
+            deal.getBorrower().getName());
+}
+
+void ChangeStream::onFacilityAdded(const Deal& deal, size_t facilityIndex) {
+    const Facility& facility = deal.getFacilities()[facilityIndex];
+    publish(ChangeRecord::Type::FACILITY_ADDED, deal, facilityIndex, facility.getAmountMoney(),
+            toDayNumber(facility.getStartDate()), "");
+}
+
+void ChangeStream::onPartPaid(const Deal& deal, size_t facilityIndex) {
+    const Part& part = deal.getFacilities()[facilityIndex].getParts().back();
+    publish(ChangeRecord::Type::PART_PAID, deal, facilityIndex, part.getMoney(), toDayNumber(part.getDate()), "");
+}
+
+void ChangeStream::onSharesTransferred(const Deal& deal, size_t facilityIndex) {
+    publish(ChangeRecord::Type::SHARES_TRANSFERRED, deal, facilityIndex, Money(), static_cast<int>(NO_DAY), "");
+}
+
+void ChangeStream::onInterestAccrued(const Deal& deal, size_t facilityIndex) {
+    const Facility& facility = deal.getFacilities()[facilityIndex];
+    publish(ChangeRecord::Type::INTEREST_ACCRUED, deal, facilityIndex, facility.getAccruedInterestMoney(),
+            toDayNumber(facility.getAccrualDate()), "");
+}
+
+void ChangeStream::onStatusChanged(const Deal& deal) {
+    publish(ChangeRecord::Type::STATUS_CHANGED, deal, 0, Money(), static_cast<int>(NO_DAY), deal.getStatusString());
+}
+
+void ChangeStream::onAgentChanged(const Deal& deal) {
+    publish(ChangeRecord::Type::AGENT_CHANGED, deal, 0, Money(), static_cast<int>(NO_DAY), deal.getAgent());
+}
+
+void ChangeStream::onDealRemoved(const Deal& deal) {
+    publish(ChangeRecord::Type::DEAL_REMOVED, deal, 0, Money(), static_cast<int>(NO_DAY), "");
+}
+
+void ChangeStream::publish(ChangeRecord::Type type, const Deal& deal, size_t facilityIndex, Money amount, int day,
+                           const std::string& text) {
+    uint64_t sequence = published.load(std::memory_order_relaxed);
+    uint64_t header = static_cast<uint64_t>(type) | static_cast<uint64_t>(deal.getContractNumber().getCode()) << 8 |
+                      static_cast<uint64_t>(facilityIndex) << 24;
+    uint64_t extra = static_cast<uint32_t>(day) | static_cast<uint64_t>(text.empty() ? 0 : textOf(text)) << 32;
+
+    // Emplacement marqué en écriture, puis publié avec sa séquence
+    Slot& slot = slots[sequence & mask];
+    slot.sequence.store(WRITING, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.words[0].store(header, std::memory_order_relaxed);
+    slot.words[1].store(static_cast<uint64_t>(amount.getUnits()), std::memory_order_relaxed);
+    slot.words[2].store(extra, std::memory_order_relaxed);
+    slot.sequence.store(sequence, std::memory_order_release);
+    published.store(sequence + 1, std::memory_order_release);
+}
+
+uint32_t ChangeStream::textOf(const std::string& text) {
+    auto it = textIds.find(text);
+    if (it != textIds.end()) {
+        return it->second;
+    }
+    uint32_t id;
+    {
+        std::lock_guard<std::mutex> lock(textsMutex);
+        texts.push_back(text);
+        id = static_cast<uint32_t>(texts.size() - 1);
+    }
+    textIds.emplace(text, id);
+    return id;
+}
+
+std::string ChangeStream::getText(uint32_t id) const {
+    std::lock_guard<std::mutex> lock(textsMutex);
+    return id < texts.size() ? texts[id] : "";
+}
+
+void ChangeStream::validateCapacity(size_t capacity) const {
+    if (capacity == 0) {
+        throw std::invalid_argument("Change stream capacity must be positive");
+    }
+}
+
+// Puits fichier
+
+ChangeFileSink::ChangeFileSink(const ChangeStream& stream, const std::string& path)
+    : ChangeFileSink(stream, path, stream.getNextSequence()) {}
+
+ChangeFileSink::ChangeFileSink(const ChangeStream& stream, const std::string& path, uint64_t fromSequence)
+    : cursor(stream.subscribeFrom(fromSequence)), path(path), out(path, std::ios::app) {
+    if (!out) {
+        throw std::runtime_error("Cannot open change sink: " + path);
+    }
+}
+
+size_t ChangeFileSink::drain() {
+    size_t written = 0;
+    ChangeRecord record;
+    while (true) {
+        ChangeStream::PollResult result = cursor.poll(record);
+        if (result == ChangeStream::PollResult::EMPTY) {
+            break;
+        }
+        if (result == ChangeStream::PollResult::LAPPED) {
+            out.flush();
+            throw std::runtime_error("Change sink " + path + " fell behind the stream at sequence " +
+                                     std::to_string(cursor.getNextSequence()));
+        }
+        out << record.sequence << ',' << TYPE_NAMES[static_cast<int>(record.type)] << ',' << record.contractNum << ','
+            << record.facilityIndex << ',' << record.amount.getUnits() << ',' << record.date << ',' << record.text << '\n';
+        written++;
+    }
+    out.flush();
+    return written;
+}
+
+uint64_t ChangeFileSink::getNextSequence() const {
+    return cursor.getNextSequence();
+}
+
+std::vector<ChangeRecord> ChangeFileSink::read(const std::string& path, uint64_t fromSequence) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open change file: " + path);
+    }
+    std::vector<ChangeRecord> records;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        // Six champs séparés par des virgules, le texte occupe la fin de la ligne
+        std::vector<std::string> fields;
+        size_t start = 0;
+        for (int i = 0; i < 6; i++) {
+            size_t comma = line.find(',', start);
+            if (comma == std::string::npos) {
+                throw std::runtime_error("Invalid change line: " + line);
+            }
+            fields.push_back(line.substr(start, comma - start));
+            start = comma + 1;
+        }
+        ChangeRecord record;
+        record.sequence = std::stoull(fields[0]);
+        if (record.sequence < fromSequence) {
+            continue;
+        }
+        size_t type = 0;
+        while (type < TYPES_COUNT && fields[1] != TYPE_NAMES[type]) {
+            type++;
+        }
+        if (type == TYPES_COUNT) {
+            throw std::runtime_error("Invalid change type: " + fields[1]);
+        }
+        record.type = static_cast<ChangeRecord::Type>(type);
+        record.contractNum = fields[2];
+        record.facilityIndex = static_cast<uint32_t>(std::stoul(fields[3]));
+        record.amount = Money::fromUnits(std::stoll(fields[4]));
+        record.date = fields[5];
+        record.text = line.substr(start);
+        records.push_back(std::move(record));
+    }
+    return records;
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#ifndef CHANGE_STREAM_H
+#define CHANGE_STREAM_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <fstream>
+#include <cstdint>
+#include <unordered_map>
+#include "BookStore.h"
+
+// Enregistrement de changement : compact, numéroté dans l'ordre des mutations du book
+struct ChangeRecord {
+    enum class Type { DEAL_ADDED, FACILITY_ADDED, PART_PAID, SHARES_TRANSFERRED, STATUS_CHANGED, AGENT_CHANGED,
+                      DEAL_REMOVED, INTEREST_ACCRUED };
+
+    uint64_t sequence;
+    Type type;
+    std::string contractNum;
+    uint32_t facilityIndex;   // FACILITY_ADDED, PART_PAID, SHARES_TRANSFERRED, INTEREST_ACCRUED
+    Money amount;             // Montant du deal, de la facility ou de la part, intérêts courus
+    std::string date;         // Début de la facility, date de la part, date d'arrêté
+    std::string text;         // Nouvel agent, emprunteur d'un nouveau deal, statut
+};
+
+// Flux de capture des changements du book (CDC).
+//
+// Chaque mutation notifiée par le BookStore est codée sur 3 mots de 64 bits, plus la
+// séquence de l'emplacement, dans un anneau de taille fixe. Un seul producteur (le thread qui modifie le book) ; autant de
+// curseurs de lecture que voulu, chacun à son rythme, sans verrou. Le producteur
+// n'attend jamais : un curseur distancé de plus d'un tour d'anneau est prévenu
+// (LAPPED) et reprend depuis un puits fichier à partir de son numéro de séquence.
+// Les textes (agents, emprunteurs) sont partagés par un dictionnaire. Le producteur
+// retrouve un texte connu par une table de hachage qui n'appartient qu'à lui, sans
+// verrou ; le verrou ne protège que la liste des textes, à l'ajout d'un nouveau texte
+// et à la lecture d'un texte par un curseur.
+class ChangeStream : public BookObserver {
+public:
+    enum class PollResult { RECORD, EMPTY, LAPPED };
+
+    // Curseur de lecture, à utiliser depuis un seul thread
+    class Cursor {
+    public:
+        PollResult poll(ChangeRecord& record);
+        uint64_t getNextSequence() const;
+
+    private:
+        friend class ChangeStream;
+        Cursor(const ChangeStream& stream, uint64_t next);
+
+        const ChangeStream& stream;
+        uint64_t next;
+    };
+
+    static const size_t DEFAULT_CAPACITY = 4096;
+
+    explicit ChangeStream(BookStore& book, size_t capacity = DEFAULT_CAPACITY);
+    ~ChangeStream() override;
+
+    ChangeStream(const ChangeStream&) = delete;
+    ChangeStream& operator=(const ChangeStream&) = delete;
+
+    // Curseur placé sur le prochain changement, ou sur une séquence passée (reprise)
+    Cursor subscribe() const;
+    Cursor subscribeFrom(uint64_t sequence) const;
+
+    // Séquence du prochain changement (la première vaut 1)
+    uint64_t getNextSequence() const;
+    // Plus ancienne séquence encore présente dans l'anneau
+    uint64_t getOldestSequence() const;
+    size_t getCapacity() const;
+
+    void onDealAdded(const Deal& deal) override;
+    void onFacilityAdded(const Deal& deal, size_t facilityIndex) override;
+    void onPartPaid(const Deal& deal, size_t facilityIndex) override;
+    void onSharesTransferred(const Deal& deal, size_t facilityIndex) override;
+    void onInterestAccrued(const Deal& deal, size_t facilityIndex) override;
+    void onStatusChanged(const Deal& deal) override;
+    void onAgentChanged(const Deal& deal) override;
+    void onDealRemoved(const Deal& deal) override;
+
+private:
+    static const uint64_t WRITING = UINT64_MAX;
+
+    // Mots : type | contrat | facility, montant, jour | texte. La séquence de
+    // l'emplacement sert de verrou de version (WRITING pendant l'écriture).
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<uint64_t> words[3];
+    };
+
+    BookStore& book;
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    std::atomic<uint64_t> published;   // Les séquences inférieures sont lisibles
+    mutable std::mutex textsMutex;
+    std::vector<std::string> texts;
+    std::unordered_map<std::string, uint32_t> textIds;   // Producteur uniquement
+
+    void publish(ChangeRecord::Type type, const Deal& deal, size_t facilityIndex, Money amount, int day,
+                 const std::string& text);
+    uint32_t textOf(const std::string& text);
+    std::string getText(uint32_t id) const;
+    void validateCapacity(size_t capacity) const;
+};
+
+// Puits fichier (ou tube nommé) : une ligne CSV par changement, dans l'ordre
+//   séquence,type,contrat,facility,montant en millièmes,date,texte
+class ChangeFileSink {
+public:
+    // Ajoute au fichier les changements à partir de la séquence donnée (par défaut le prochain)
+    ChangeFileSink(const ChangeStream& stream, const std::string& path);
+    ChangeFileSink(const ChangeStream& stream, const std::string& path, uint64_t fromSequence);
+
+    // Écrit les changements disponibles ; exception si le puits a été distancé
+    size_t drain();
+    uint64_t getNextSequence() const;
+
+    // Relecture d'un fichier à partir d'une séquence, pour la reprise d'un consommateur
+    static std::vector<ChangeRecord> read(const std::string& path, uint64_t fromSequence);
+
+private:
+    ChangeStream::Cursor cursor;
+    std::string path;
+    std::ofstream out;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,498 @@
+#include "ColumnarExporter.h"
+#include <fstream>
+#include <filesystem>
+#include <unordered_map>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+const char MAGIC[8] = {'S', 'F', 'C', 'O', 'L', '0', '0', '1'};
+
+using ColumnType = ColumnarExporter::ColumnType;
+
+struct ColumnSpec {
+    std::string name;
+    ColumnType type;
+    const std::vector<std::string>* dictionary;
+};
+
+// Dictionnaire de valeurs distinctes, dans l'ordre de première apparition
+class Dictionary {
+public:
+    void add(const std::string& value) {
+        if (codes.emplace(value, static_cast<uint32_t>(values.size())).second) {
+            values.push_back(value);
+        }
+    }
+
+    uint32_t code(const std::string& value) const {
+        return codes.at(value);
+    }
+
+    const std::vector<std::string>& getValues() const {
+        return values;
+    }
+
+private:
+    std::unordered_map<std::string, uint32_t> codes;
+    std::vector<std::string> values;
+};
+
+// Écriture par blocs : les octets sont accumulés puis écrits en une seule fois
+class BlockOutput {
+public:
+    BlockOutput(const std::string& path, size_t blockSize)
+        : out(path, std::ios::binary | std::ios::trunc), blockSize(blockSize) {
+        if (!out) {
+            throw std::runtime_error("Cannot open export file: " + path);
+        }
+        buffer.reserve(blockSize);
+    }
+
+    void write(const void* data, size_t size) {
+        if (buffer.size() + size > blockSize) {
+            flush();
+        }
+        if (size >= blockSize) {
+            out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            return;
+        }
+        buffer.append(static_cast<const char*>(data), size);
+    }
+
+    template <typename T>
+    void writeValue(T value) {
+        write(&value, sizeof(T));
+    }
+
+    void flush() {
+        if (!buffer.empty()) {
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+
+    void close() {
+        flush();
+        out.close();
+        if (out.fail()) {
+            throw std::runtime_error("Failed to write export file");
+        }
+    }
+
+private:
+    std::ofstream out;
+    std::string buffer;
+    size_t blockSize;
+};
+
+// Construction d'une table par lots de lignes, colonne par colonne
+class TableWriter {
+public:
+    TableWriter(const std::string& path, const std::vector<ColumnSpec>& specs,
+                const ColumnarExporter::Options& options)
+        : output(path, options.blockSize), specs(specs), columns(specs.size()),
+          batchRows(options.batchRows), rows(0), totalRows(0) {
+        output.write(MAGIC, sizeof(MAGIC));
+        output.writeValue(static_cast<uint32_t>(specs.size()));
+        for (const ColumnSpec& spec : specs) {
+            output.writeValue(static_cast<uint8_t>(spec.type));
+            output.writeValue(static_cast<uint16_t>(spec.name.size()));
+            output.write(spec.name.data(), spec.name.size());
+        }
+        for (const ColumnSpec& spec : specs) {
+            if (spec.type != ColumnType::DICTIONARY) {
+                continue;
+            }
+            output.writeValue(static_cast<uint32_t>(spec.dictionary->size()));
+            for (const std::string& value : *spec.dictionary) {
+                output.writeValue(static_cast<uint16_t>(value.size()));
+                output.write(value.data(), value.size());
+            }
+        }
+        for (Column& column : columns) {
+            column.offsets.push_back(0);
+        }
+    }
+
+    void setInt(size_t col, int64_t value) {
+        columns[col].data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void setDouble(size_t col, double value) {
+        columns[col].data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void setString(size_t col, const std::string& value) {
+        Column& column = columns[col];
+        column.data.append(value);
+        column.offsets.push_back(static_cast<uint32_t>(column.data.size()));
+    }
+
+    void setCode(size_t col, uint32_t code) {
+        columns[col].data.append(reinterpret_cast<const char*>(&code), sizeof(code));
+    }
+
+    void endRow() {
+        rows++;
+        if (rows == batchRows) {
+            flushBatch();
+        }
+    }
+
+    size_t finish() {
+        flushBatch();
+        output.writeValue(static_cast<uint32_t>(0));
+        output.close();
+        return totalRows;
+    }
+
+private:
+    struct Column {
+        std::string data;
+        std::vector<uint32_t> offsets;
+    };
+
+    BlockOutput output;
+    std::vector<ColumnSpec> specs;
+    std::vector<Column> columns;
+    size_t batchRows;
+    size_t rows;
+    size_t totalRows;
+
+    void flushBatch() {
+        if (rows == 0) {
+            return;
+        }
+        output.writeValue(static_cast<uint32_t>(rows));
+        for (size_t i = 0; i < columns.size(); i++) {
+            Column& column = columns[i];
+            if (specs[i].type == ColumnType::STRING) {
+                output.write(column.offsets.data(), column.offsets.size() * sizeof(uint32_t));
+                column.offsets.assign(1, 0);
+            }
+            output.write(column.data.data(), column.data.size());
+            column.data.clear();
+        }
+        totalRows += rows;
+        rows = 0;
+    }
+};
+
+// Colonne devise ou prêteur : codée par dictionnaire ou écrite en clair selon les options
+class CategoryColumn {
+public:
+    CategoryColumn(size_t index, const Dictionary& dictionary, bool encoded)
+        : index(index), dictionary(dictionary), encoded(encoded) {
+    }
+
+    ColumnSpec spec(const std::string& name) const {
+        return {name, encoded ? ColumnType::DICTIONARY : ColumnType::STRING, &dictionary.getValues()};
+    }
+
+    void set(TableWriter& writer, const std::string& value) const {
+        if (encoded) {
+            writer.setCode(index, dictionary.code(value));
+        } else {
+            writer.setString(index, value);
+        }
+    }
+
+private:
+    size_t index;
+    const Dictionary& dictionary;
+    bool encoded;
+};
+
+template <typename T>
+T readValue(std::ifstream& in) {
+    T value;
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (!in) {
+        throw std::runtime_error("Unexpected end of columnar file");
+    }
+    return value;
+}
+
+std::string readBytes(std::ifstream& in, size_t size) {
+    std::string value(size, '\0');
+    in.read(&value[0], static_cast<std::streamsize>(size));
+    if (!in) {
+        throw std::runtime_error("Unexpected end of columnar file");
+    }
+    return value;
+}
+
+}
+
+ColumnarExporter::ColumnarExporter(const std::string& directory)
+    : ColumnarExporter(directory, Options()) {
+}
+
+ColumnarExporter::ColumnarExporter(const std::string& directory, const Options& options)
+    : directory(directory), options(options) {
+    if (directory.empty()) {
+        throw std::invalid_argument("Export directory cannot be empty");
+    }
+    validateOptions(options);
+}
+
+size_t ColumnarExporter::exportBook(const std::vector<Deal>& deals) const {
+    std::filesystem::create_directories(directory);
+
+    // Premier passage : dictionnaires des devises, prêteurs et statuts
+    Dictionary currencies;
+    Dictionary lenders;
+    Dictionary statuses;
+    for (const Deal& deal : deals) {
+        currencies.add(deal.getCurrency());
+        lenders.add(deal.getAgent());
+        statuses.add(deal.getStatusString());
+        for (const Lender& lender : deal.getPool()) {
+            lenders.add(lender.getName());
+        }
+        for (const Facility& facility : deal.getFacilities()) {
+            currencies.add(facility.getCurrency());
+            for (const Lender& lender : facility.getLenders()) {
+                lenders.add(lender.getName());
+            }
+        }
+    }
+    bool encoded = options.dictionaryEncoding;
+    const std::string prefix = directory + "/";
+
+    // Table des deals
+    CategoryColumn dealAgent(2, lenders, encoded);
+    CategoryColumn dealCurrency(5, currencies, encoded);
+    TableWriter dealTable(prefix + "deals.sfc", {
+        {"deal_id", ColumnType::INT64, nullptr},
+        {"contract_num", ColumnType::STRING, nullptr},
+        dealAgent.spec("agent"),
+        {"borrower", ColumnType::STRING, nullptr},
+        {"project_amount", ColumnType::FLOAT64, nullptr},
+        dealCurrency.spec("currency"),
+        {"sign_date", ColumnType::STRING, nullptr},
+        {"end_date", ColumnType::STRING, nullptr},
+        {"status", ColumnType::DICTIONARY, &statuses.getValues()}
+    }, options);
+
+    // Table des facilities
+    CategoryColumn facilityCurrency(7, currencies, encoded);
+    TableWriter facilityTable(prefix + "facilities.sfc", {
+        {"facility_id", ColumnType::INT64, nullptr},
+        {"deal_id", ColumnType::INT64, nullptr},
+        {"start_date", ColumnType::STRING, nullptr},
+        {"end_date", ColumnType::STRING, nullptr},
+        {"amount", ColumnType::FLOAT64, nullptr},
+        {"remaining", ColumnType::FLOAT64, nullptr},
+        {"annual_rate", ColumnType::FLOAT64, nullptr},
+        facilityCurrency.spec("currency")
+    }, options);
+
+    // Table des remboursements
+    TableWriter partTable(prefix + "parts.sfc", {
+        {"facility_id", ColumnType::INT64, nullptr},
+        {"amount", ColumnType::FLOAT64, nullptr},
+        {"date", ColumnType::STRING, nullptr}
+    }, options);
+
+    // Table des prêteurs : pool des deals et prêteurs des facilities
+    Dictionary owners;
+    owners.add("deal");
+    owners.add("facility");
+    CategoryColumn lenderName(2, lenders, encoded);
+    TableWriter lenderTable(prefix + "lenders.sfc", {
+        {"owner", ColumnType::DICTIONARY, &owners.getValues()},
+        {"owner_id", ColumnType::INT64, nullptr},
+        lenderName.spec("lender")
+    }, options);
+
+    // Second passage : une seule traversée alimente les quatre tables
+    int64_t facilityId = 0;
+    for (size_t d = 0; d < deals.size(); d++) {
+        const Deal& deal = deals[d];
+        int64_t dealId = static_cast<int64_t>(d);
+
+        dealTable.setInt(0, dealId);
+        dealTable.setString(1, deal.getContractNum());
+        dealAgent.set(dealTable, deal.getAgent());
+        dealTable.setString(3, deal.getBorrower().getName());
+        dealTable.setDouble(4, deal.getProjectAmount());
+        dealCurrency.set(dealTable, deal.getCurrency());
+        dealTable.setString(6, deal.getContractSignDate());
+        dealTable.setString(7, deal.getContractEndDate());
+        dealTable.setCode(8, statuses.code(deal.getStatusString()));
+        dealTable.endRow();
+
+        for (const Lender& lender : deal.getPool()) {
+            lenderTable.setCode(0, owners.code("deal"));
+            lenderTable.setInt(1, dealId);
+            lenderName.set(lenderTable, lender.getName());
+            lenderTable.endRow();
+        }
+
+        for (const Facility& facility : deal.getFacilities()) {
+            facilityTable.setInt(0, facilityId);
+            facilityTable.setInt(1, dealId);
+            facilityTable.setString(2, facility.getStartDate());
+            facilityTable.setString(3, facility.getEndDate());
+            facilityTable.setDouble(4, facility.getAmount());
+            facilityTable.setDouble(5, facility.getRemainingAmount());
+            facilityTable.setDouble(6, facility.getAnnualInterestRate());
+            facilityCurrency.set(facilityTable, facility.getCurrency());
+            facilityTable.endRow();
+
+            for (const Lender& lender : facility.getLenders()) {
+                lenderTable.setCode(0, owners.code("facility"));
+                lenderTable.setInt(1, facilityId);
+                lenderName.set(lenderTable, lender.getName());
+                lenderTable.endRow();
+            }
+
+            for (const Part& part : facility.getParts()) {
+                partTable.setInt(0, facilityId);
+                partTable.setDouble(1, part.getAmount());
+                partTable.setString(2, part.getDate());
+                partTable.endRow();
+            }
+            facilityId++;
+        }
+    }
+
+    size_t total = dealTable.finish();
+    total += facilityTable.finish();
+    total += partTable.finish();
+    total += lenderTable.finish();
+    return total;
+}
+
+const std::string& ColumnarExporter::getDirectory() const {
+    return directory;
+}
+
+void ColumnarExporter::validateOptions(const Options& options) const {
+    if (options.batchRows == 0) {
+        throw std::invalid_argument("Batch size must be positive");
+    }
+    if (options.blockSize == 0) {
+        throw std::invalid_argument("Block size must be positive");
+    }
+}
+
+ColumnarTable::ColumnarTable(const std::string& path) : rowCount(0) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open columnar file: " + path);
+    }
+
+    if (readBytes(in, sizeof(MAGIC)) != std::string(MAGIC, sizeof(MAGIC))) {
+        throw std::runtime_error("Not a columnar export file: " + path);
+    }
+
+    uint32_t columnCount = readValue<uint32_t>(in);
+    columns.resize(columnCount);
+    for (Column& column : columns) {
+        column.type = static_cast<ColumnType>(readValue<uint8_t>(in));
+        column.name = readBytes(in, readValue<uint16_t>(in));
+    }
+    for (Column& column : columns) {
+        if (column.type != ColumnType::DICTIONARY) {
+            continue;
+        }
+        uint32_t entries = readValue<uint32_t>(in);
+        for (uint32_t i = 0; i < entries; i++) {
+            column.dictionary.push_back(readBytes(in, readValue<uint16_t>(in)));
+        }
+    }
+
+    // Lecture des lots jusqu'au lot vide de fin
+    while (true) {
+        uint32_t rows = readValue<uint32_t>(in);
+        if (rows == 0) {
+            break;
+        }
+        for (Column& column : columns) {
+            switch (column.type) {
+                case ColumnType::INT64:
+                    for (uint32_t i = 0; i < rows; i++) {
+                        column.ints.push_back(readValue<int64_t>(in));
+                    }
+                    break;
+                case ColumnType::FLOAT64:
+                    for (uint32_t i = 0; i < rows; i++) {
+                        column.doubles.push_back(readValue<double>(in));
+                    }
+                    break;
+                case ColumnType::DICTIONARY:
+                    for (uint32_t i = 0; i < rows; i++) {
+                        column.codes.push_back(readValue<uint32_t>(in));
+                    }
+                    break;
+                case ColumnType::STRING: {
+                    std::vector<uint32_t> offsets(rows + 1);
+                    for (uint32_t& offset : offsets) {
+                        offset = readValue<uint32_t>(in);
+                    }
+                    std::string bytes = readBytes(in, offsets[rows]);
+                    for (uint32_t i = 0; i < rows; i++) {
+                        column.strings.push_back(bytes.substr(offsets[i], offsets[i + 1] - offsets[i]));
+                    }
+                    break;
+                }
+                default:
+                    throw std::runtime_error("Unknown column type in " + path);
+            }
+        }
+        rowCount += rows;
+    }
+}
+
+size_t ColumnarTable::getRowCount() const {
+    return rowCount;
+}
+
+size_t ColumnarTable::getColumnCount() const {
+    return columns.size();
+}
+
+size_t ColumnarTable::getColumnIndex(const std::string& name) const {
+    for (size_t i = 0; i < columns.size(); i++) {
+        if (columns[i].name == name) {
+            return i;
+        }
+    }
+    throw std::invalid_argument("Unknown column: " + name);
+}
+
+const std::string& ColumnarTable::getColumnName(size_t column) const {
+    return columns.at(column).name;
+}
+
+ColumnarExporter::ColumnType ColumnarTable::getColumnType(size_t column) const {
+    return columns.at(column).type;
+}
+
+int64_t ColumnarTable::getInt(size_t column, size_t row) const {
+    return this->column(column, ColumnType::INT64).ints.at(row);
+}
+
+double ColumnarTable::getDouble(size_t column, size_t row) const {
+    return this->column(column, ColumnType::FLOAT64).doubles.at(row);
+}
+
+std::string ColumnarTable::getString(size_t column, size_t row) const {
+    const Column& target = columns.at(column);
+    if (target.type == ColumnType::DICTIONARY) {
+        return target.dictionary.at(target.codes.at(row));
+    }
+    return this->column(column, ColumnType::STRING).strings.at(row);
+}
+
+const ColumnarTable::Column& ColumnarTable::column(size_t index, ColumnarExporter::ColumnType expected) const {
+    const Column& target = columns.at(index);
+    if (target.type != expected) {
+        throw std::invalid_argument("Column type mismatch: " + target.name);
+    }
+    return target;
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef COLUMNAR_EXPORTER_H
+#define COLUMNAR_EXPORTER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Deal.h"
+
+// Export colonnaire binaire du book pour les outils d'analyse.
+//
+// Un fichier par table (deals.sfc, facilities.sfc, parts.sfc, lenders.sfc),
+// entiers little-endian, organisé comme suit :
+//   magic "SFCOL001" (8 octets)
+//   uint32 nombre de colonnes
+//   pour chaque colonne : uint8 type, uint16 longueur du nom, nom
+//   pour chaque colonne DICTIONARY : uint32 nombre d'entrées,
+//                                    puis (uint16 longueur, octets) par entrée
+//   lots de lignes : uint32 nombre de lignes (0 termine le fichier), puis
+//                    les colonnes du lot l'une après l'autre :
+//     INT64 / FLOAT64 : n valeurs de 8 octets
+//     STRING          : (n + 1) offsets uint32 puis les octets (style Arrow)
+//     DICTIONARY      : n codes uint32 dans le dictionnaire de la colonne
+class ColumnarExporter {
+public:
+    enum class ColumnType : uint8_t {
+        INT64 = 0,
+        FLOAT64 = 1,
+        STRING = 2,
+        DICTIONARY = 3
+    };
+
+    struct Options {
+        bool dictionaryEncoding = true;   // devises et prêteurs encodés par dictionnaire
+        size_t batchRows = 65536;         // lignes par lot
+        size_t blockSize = 1 << 20;       // taille des écritures séquentielles
+    };
+
+    explicit ColumnarExporter(const std::string& directory);
+    ColumnarExporter(const std::string& directory, const Options& options);
+
+    // Écrit les quatre tables et retourne le nombre total de lignes exportées
+    size_t exportBook(const std::vector<Deal>& deals) const;
+
+    const std::string& getDirectory() const;
+
+private:
+    std::string directory;
+    Options options;
+
+    void validateOptions(const Options& options) const;
+};
+
+// Lecture d'une table exportée, utilisée pour la vérification et les outils
+class ColumnarTable {
+public:
+    explicit ColumnarTable(const std::string& path);
+
+    size_t getRowCount() const;
+    size_t getColumnCount() const;
+    size_t getColumnIndex(const std::string& name) const;
+    const std::string& getColumnName(size_t column) const;
+    ColumnarExporter::ColumnType getColumnType(size_t column) const;
+
+    int64_t getInt(size_t column, size_t row) const;
+    double getDouble(size_t column, size_t row) const;
+    std::string getString(size_t column, size_t row) const;
+
+private:
+    struct Column {
+        std::string name;
+        ColumnarExporter::ColumnType type;
+        std::vector<std::string> dictionary;
+        std::vector<int64_t> ints;
+        std::vector<double> doubles;
+        std::vector<uint32_t> codes;
+        std::vector<std::string> strings;
+    };
+
+    std::vector<Column> columns;
+    size_t rowCount;
+
+    const Column& column(size_t index, ColumnarExporter::ColumnType expected) const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,14 @@
+#include "ContractNumber.h"
+
+std::string ContractNumber::toString() const {
+    if (code == 0) {
+        return "";
+    }
+    std::string text(5, '0');
+    text[0] = getPrefix();
+    int number = getNumber();
+    for (int i = 4; i >= 1; i--, number /= 10) {
+        text[i] = static_cast<char>('0' + number % 10);
+    }
+    return text;
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#ifndef CONTRACT_NUMBER_H
+#define CONTRACT_NUMBER_H
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+
+namespace contract_tables {
+
+inline constexpr char LETTERS[] = {'S', 'Z', 'B'};
+
+// Table générée à la compilation : rang (1..3) de la lettre, minuscules acceptées
+constexpr std::array<uint8_t, 256> makePrefixTable() {
+    std::array<uint8_t, 256> table{};
+    for (int i = 0; i < 3; i++) {
+        table[static_cast<unsigned char>(LETTERS[i])] = static_cast<uint8_t>(i + 1);
+        table[static_cast<unsigned char>(LETTERS[i] - 'A' + 'a')] = static_cast<uint8_t>(i + 1);
+    }
+    return table;
+}
+
+inline constexpr std::array<uint8_t, 256> PREFIXES = makePrefixTable();
+
+}
+
+// Numéro de contrat (S, Z ou B suivi de 4 chiffres) compacté sur 16 bits :
+// rang de la lettre * 10000 + numéro. Analyse constexpr, comparaison en temps constant.
+class ContractNumber {
+public:
+    constexpr ContractNumber() : code(0) {}
+
+    static constexpr bool isValid(std::string_view text) {
+        if (text.size() != 5 || contract_tables::PREFIXES[static_cast<unsigned char>(text[0])] == 0) {
+            return false;
+        }
+        for (size_t i = 1; i < text.size(); i++) {
+            if (text[i] < '0' || text[i] > '9') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static constexpr ContractNumber parse(std::string_view text) {
+        if (text.empty()) {
+            throw std::invalid_argument("Contract number cannot be empty");
+        }
+        // Validation du format : une lettre (S,Z,B) suivi par 4 chiffres
+        if (text.size() != 5) {
+            throw std::invalid_argument("Contract number must be 5 characters (1 letter + 4 digits)");
+        }
+        if (contract_tables::PREFIXES[static_cast<unsigned char>(text[0])] == 0) {
+            throw std::invalid_argument("Contract number must start with S, Z, or B");
+        }
+        if (!isValid(text)) {
+            throw std::invalid_argument("Contract number must have 4 digits after the letter");
+        }
+        int number = 0;
+        for (size_t i = 1; i < text.size(); i++) {
+            number = number * 10 + (text[i] - '0');
+        }
+        return ContractNumber(static_cast<uint16_t>(contract_tables::PREFIXES[static_cast<unsigned char>(text[0])] * 10000 + number));
+    }
+
+    // Numéro relu depuis son code compact (fichiers, flux de changements)
+    static constexpr ContractNumber fromCode(uint16_t code) {
+        if (code != 0 && (code < 10000 || code >= 40000)) {
+            throw std::invalid_argument("Invalid contract code");
+        }
+        return ContractNumber(code);
+    }
+
+    constexpr uint16_t getCode() const { return code; }
+    constexpr bool isEmpty() const { return code == 0; }
+    constexpr char getPrefix() const { return code == 0 ? '\0' : contract_tables::LETTERS[code / 10000 - 1]; }
+    constexpr int getNumber() const { return code % 10000; }
+
+    std::string toString() const;
+
+    constexpr bool operator==(ContractNumber other) const { return code == other.code; }
+    constexpr bool operator!=(ContractNumber other) const { return code != other.code; }
+    constexpr bool operator<(ContractNumber other) const { return code < other.code; }
+
+private:
+    uint16_t code;
+
+    constexpr explicit ContractNumber(uint16_t code) : code(code) {}
+};
+
+namespace std {
+template <>
+struct hash<ContractNumber> {
+    size_t operator()(ContractNumber contract) const noexcept {
+        return contract.getCode();
+    }
+};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "CovenantEngine.h"
+#include "DateUtils.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+CovenantEngine::CovenantEngine(BookStore& book, BorrowerIndex& borrowers)
+    : book(book), borrowers(borrowers), minimumPace(0) {
+    if (&borrowers.getBook() != &book) {
+        throw std::invalid_argument("Borrower index must cover the same book");
+    }
+    for (const Deal& deal : book.getDeals()) {
+        track(deal, nullptr);
+    }
+    book.addObserver(this);
+}
+
+CovenantEngine::~CovenantEngine() {
+    book.removeObserver(this);
+}
+
+void CovenantEngine::setLenderLimit(const std::string& lender, const std::string& currency, double limit) {
+    validateLimit(limit);
+    CurrencyCode code = CurrencyCode::parse(currency);
+    Total& total = lenderTotals[keyOf(nameOf(lender), code)];
+    total.limit = Money::fromDouble(limit, code);
+    total.limited = true;
+    Trigger trigger{Event::RULE_ADDED, nullptr, 0, ""};
+    add(total, Money(), Rule::LENDER_OUTSTANDING, lender, code, &trigger);
+}
+
+void CovenantEngine::setBorrowerLimit(const std::string& borrower, const std::string& currency, double limit) {
+    borrowers.setLimit(borrower, currency, limit);
+    Trigger trigger{Event::RULE_ADDED, nullptr, 0, ""};
+    checkBorrower(borrower, CurrencyCode::parse(currency), trigger);
+}
+
+void CovenantEngine::setCurrencyLimit(const std::string& currency, double limit) {
+    validateLimit(limit);
+    CurrencyCode code = CurrencyCode::parse(currency);
+    Total& total = currencyTotals[code.getCode()];
+    total.limit = Money::fromDouble(limit, code);
+    total.limited = true;
+    Trigger trigger{Event::RULE_ADDED, nullptr, 0, ""};
+    add(total, Money(), Rule::CURRENCY_OUTSTANDING, currency, code, &trigger);
+}
+
+void CovenantEngine::setMinimumRepaymentPace(double ratio) {
+    if (ratio < 0 || ratio > 1) {
+        throw std::invalid_argument("Minimum repayment pace must be between 0 and 1");
+    }
+    minimumPace = ratio;
+}
+
+Money CovenantEngine::getLenderOutstanding(const std::string& lender, const std::string& currency) const {
+    auto name = nameIds.find(lender);
+    if (name == nameIds.end()) {
+        return Money();
+    }
+    auto it = lenderTotals.find(keyOf(name->second, CurrencyCode::parse(currency)));
+    return it == lenderTotals.end() ? Money() : it->second.outstanding;
+}
+
+Money CovenantEngine::getBorrowerOutstanding(const std::string& borrower, const std::string& currency) const {
+    return borrowers.getOutstanding(borrower, currency);
+}
+
+Money CovenantEngine::getCurrencyOutstanding(const std::string& currency) const {
+    auto it = currencyTotals.find(CurrencyCode::parse(currency).getCode());
+    return it == currencyTotals.end() ? Money() : it->second.outstanding;
+}
+
+const std::vector<CovenantEngine::Breach>& CovenantEngine::getBreaches() const {
+    return breaches;
+}
+
+void CovenantEngine::clearBreaches() {
+    breaches.clear();
+}
+
+void CovenantEngine::onDealAdded(const Deal& deal) {
+    Trigger trigger{Event::DEAL_ADDED, &deal, 0, ""};
+    track(deal, &trigger);
+}
+
+void CovenantEngine::onFacilityAdded(const Deal& deal, size_t facilityIndex) {
+    auto it = deals.find(deal.getContractNumber());
+    if (it == deals.end()) {
+        track(deal, nullptr);
+        return;
+    }
+    const Facility& facility = deal.getFacilities()[facilityIndex];
+    Trigger trigger{Event::FACILITY_ADDED, &deal, facilityIndex, ""};
+    it->second.facilities.push_back({facility.getCurrencyCode(), Money(), {}});
+    apply(it->second, it->second.facilities.back(), stateOf(facility), &trigger);
+}
+
+void CovenantEngine::onPartPaid(const Deal& deal, size_t facilityIndex) {
+    auto it = deals.find(deal.getContractNumber());
+    if (it == deals.end()) {
+        track(deal, nullptr);
+        return;
+    }
+    const Facility& facility = deal.getFacilities()[facilityIndex];
+    Trigger trigger{Event::PART_PAID, &deal, facilityIndex, facility.getParts().back().getDate()};
+    apply(it->second, it->second.facilities[facilityIndex], stateOf(facility), &trigger);
+    checkPace(facility, trigger);
+}
+
+void CovenantEngine::onSharesTransferred(const Deal& deal, size_t facilityIndex) {
+    auto it = deals.find(deal.getContractNumber());
+    if (it == deals.end()) {
+        track(deal, nullptr);
+        return;
+    }
+    Trigger trigger{Event::SHARES_TRANSFERRED, &deal, facilityIndex, ""};
+    apply(it->second, it->second.facilities[facilityIndex], stateOf(deal.getFacilities()[facilityIndex]), &trigger);
+}
+
+void CovenantEngine::onInterestAccrued(const Deal& deal, size_t facilityIndex) {
+    // Les encours ne changent pas : seul le rythme est contrôlé, à la date d'arrêté
+    const Facility& facility = deal.getFacilities()[facilityIndex];
+    Trigger trigger{Event::INTEREST_ACCRUED, &deal, facilityIndex, facility.getAccrualDate()};
+    checkPace(facility, trigger);
+}
+
+void CovenantEngine::onStatusChanged(const Deal&) {
+    // Sans effet sur les encours
+}
+
+void CovenantEngine::onAgentChanged(const Deal&) {
+    // Sans effet sur les encours
+}
+
+void CovenantEngine::onDealRemoved(const Deal& deal) {
+    auto it = deals.find(deal.getContractNumber());
+    if (it == deals.end()) {
+        return;
+    }
+    for (FacilityState& facility : it->second.facilities) {
+        apply(it->second, facility, {facility.currency, Money(), {}}, nullptr);
+    }
+    deals.erase(it);
+}
+
+void CovenantEngine::track(const Deal& deal, const Trigger* trigger) {
+    DealState& state = deals[deal.getContractNumber()];
+    state.borrower = nameOf(deal.getBorrower().getName());
+    for (const Facility& facility : deal.getFacilities()) {
+        state.facilities.push_back({facility.getCurrencyCode(), Money(), {}});
+        apply(state, state.facilities.back(), stateOf(facility), trigger);
+    }
+}
+
+CovenantEngine::FacilityState CovenantEngine::stateOf(const Facility& facility) {
+    FacilityState state{facility.getCurrencyCode(), facility.getRemainingMoney(), {}};
+    const std::vector<Lender>& lenders = facility.getLenders();
+    const std::vector<Money>& shares = facility.getShares();
+
+    // Encours au prorata des participations, le dernier prêteur reçoit l'arrondi
+    Money allocated;
+    for (size_t i = 0; i < lenders.size(); i++) {
+        Money exposure = state.outstanding - allocated;
+        if (i + 1 < lenders.size()) {
+            long double ratio = static_cast<long double>(shares[i].getUnits()) / facility.getAmountMoney().getUnits();
+            exposure = Money::fromUnits(static_cast<int64_t>(state.outstanding.getUnits() * ratio + 0.5L));
+        }
+        allocated += exposure;
+        state.exposures.push_back({nameOf(lenders[i].getName()), exposure});
+    }
+    return state;
+}
+
+void CovenantEngine::apply(DealState& deal, FacilityState& previous, FacilityState current, const Trigger* trigger) {
+    Money delta = current.outstanding - previous.outstanding;
+    CurrencyCode currency = current.currency;
+    add(currencyTotals[currency.getCode()], delta, Rule::CURRENCY_OUTSTANDING, currency.toString(), currency, trigger);
+    // L'index emprunteur, notifié avant, a déjà appliqué la mutation
+    if (trigger && delta > Money()) {
+        checkBorrower(names[deal.borrower], currency, *trigger);
+    }
+
+    // Écart par prêteur : les prêteurs d'une facility sont peu nombreux
+    std::vector<std::pair<uint32_t, Money>> changes = current.exposures;
+    for (const auto& old : previous.exposures) {
+        auto it = std::find_if(changes.begin(), changes.end(),
+                               [&old](const std::pair<uint32_t, Money>& change) { return change.first == old.first; });
+        if (it != changes.end()) {
+            it->second -= old.second;
+        } else {
+            changes.push_back({old.first, -old.second});
+        }
+    }
+    for (const auto& change : changes) {
+        if (change.second != Money()) {
+            add(lenderTotals[keyOf(change.first, currency)], change.second, Rule::LENDER_OUTSTANDING,
+                names[change.first], currency, trigger);
+        }
+    }
+    previous = std::move(current);
+}
+
+void CovenantEngine::add(Total& total, Money delta, Rule rule, const std::string& subject, CurrencyCode currency,
+                         const Trigger* trigger) {
+    total.outstanding += delta;
+    // Seule une hausse (ou une nouvelle limite) peut provoquer un dépassement
+    if (trigger && total.limited && delta >= Money() && total.outstanding > total.limit &&
+        (delta > Money() || trigger->event == Event::RULE_ADDED)) {
+        report(rule, subject, currency, total.outstanding, total.limit, trigger);
+    }
+}
+
+void CovenantEngine::checkPace(const Facility& facility, const Trigger& trigger) {
+    if (minimumPace <= 0) {
+        return;
+    }
+    // Amortissement linéaire attendu à la date de la part
+    int start = toDayNumber(facility.getStartDate());
+    int end = toDayNumber(facility.getEndDate());
+    double elapsed = std::min(1.0, std::max(0.0, static_cast<double>(toDayNumber(trigger.date) - start) / (end - start)));
+    Money expected = Money::fromDouble(facility.getAmount() * elapsed * minimumPace, facility.getCurrencyCode());
+    Money repaid = facility.getAmountMoney() - facility.getRemainingMoney();
+    if (repaid < expected) {
+        report(Rule::REPAYMENT_PACE, trigger.deal->getContractNum(), facility.getCurrencyCode(), repaid, expected,
+               &trigger);
+    }
+}
+
+void CovenantEngine::checkBorrower(const std::string& borrower, CurrencyCode currency, const Trigger& trigger) {
+    std::string code = currency.toString();
+    if (borrowers.isBreached(borrower, code)) {
+        report(Rule::BORROWER_OUTSTANDING, borrower, currency, borrowers.getOutstanding(borrower, code),
+               borrowers.getLimit(borrower, code), &trigger);
+    }
+}
+
+void CovenantEngine::report(Rule rule, const std::string& subject, CurrencyCode currency, Money value, Money limit,
+                            const Trigger* trigger) {
+    Breach breach{rule, subject, currency, value, limit, trigger->event, "", trigger->facilityIndex, trigger->date};
+    if (trigger->deal) {
+        breach.contractNum = trigger->deal->getContractNum();
+    }
+    breaches.push_back(std::move(breach));
+}
+
+uint32_t CovenantEngine::nameOf(const std::string& name) {
+    auto it = nameIds.find(name);
+    if (it != nameIds.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(names.size());
+    names.push_back(name);
+    nameIds.emplace(name, id);
+    return id;
+}
+
+uint64_t CovenantEngine::keyOf(uint32_t name, CurrencyCode currency) {
+    return static_cast<uint64_t>(name) << 16 | currency.getCode();
+}
+
+void CovenantEngine::validateLimit(double limit) const {
+    if (limit < 0) {
+        throw std::invalid_argument("Limit cannot be negative");
+    }
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+#ifndef COVENANT_ENGINE_H
+#define COVENANT_ENGINE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "BookStore.h"
+#include "BorrowerIndex.h"
+#include "ContractNumber.h"
+#include "CurrencyCode.h"
+#include "Money.h"
+
+// Contrôle des covenants et limites à chaque mutation du book.
+//
+// Règles : encours maximal par prêteur, par emprunteur et par devise (sans conversion,
+// une limite porte sur une devise), et rythme minimal de remboursement par rapport à
+// un amortissement linéaire entre le début et la fin de la facility.
+//
+// Les règles sont compilées en tables de limites indexées par prêteur ou devise, adossées
+// à des encours tenus à jour par différence : chaque mutation ne touche que la facility
+// concernée, ses prêteurs et sa devise, soit un coût indépendant de la taille du book.
+// Les encours et limites par emprunteur sont ceux de l'index emprunteur, seul à les tenir.
+// Un dépassement est signalé quand une mutation fait monter un encours au-dessus de sa
+// limite, avec la mutation qui l'a provoqué ; le rythme de remboursement est contrôlé à
+// chaque part, à la date de la part, et à chaque calcul des intérêts courus, à la date
+// d'arrêté, de sorte qu'une facility jamais remboursée est aussi signalée.
+class CovenantEngine : public BookObserver {
+public:
+    enum class Rule { LENDER_OUTSTANDING, BORROWER_OUTSTANDING, CURRENCY_OUTSTANDING, REPAYMENT_PACE };
+    enum class Event { RULE_ADDED, DEAL_ADDED, FACILITY_ADDED, PART_PAID, SHARES_TRANSFERRED, INTEREST_ACCRUED };
+
+    struct Breach {
+        Rule rule;
+        std::string subject;       // Prêteur, emprunteur ou devise ; contrat pour le rythme
+        CurrencyCode currency;
+        Money value;               // Encours, ou montant remboursé pour le rythme
+        Money limit;               // Limite, ou remboursement minimal attendu
+        Event event;
+        std::string contractNum;   // Vide pour RULE_ADDED
+        size_t facilityIndex;
+        std::string date;          // Date de la part, ou date d'arrêté pour INTEREST_ACCRUED
+    };
+
+    // Reprend les encours du book sans rien signaler, puis s'abonne à ses mutations.
+    // L'index emprunteur porte sur le même book et, construit avant, est notifié avant.
+    CovenantEngine(BookStore& book, BorrowerIndex& borrowers);
+    ~CovenantEngine() override;
+
+    CovenantEngine(const CovenantEngine&) = delete;
+    CovenantEngine& operator=(const CovenantEngine&) = delete;
+
+    // Une limite remplace la précédente du même sujet ; l'encours courant est contrôlé aussitôt.
+    // La limite par emprunteur est celle de l'index emprunteur.
+    void setLenderLimit(const std::string& lender, const std::string& currency, double limit);
+    void setBorrowerLimit(const std::string& borrower, const std::string& currency, double limit);
+    void setCurrencyLimit(const std::string& currency, double limit);
+    // Part minimale de l'amortissement linéaire attendu à chaque part (entre 0 et 1, 0 = inactif)
+    void setMinimumRepaymentPace(double ratio);
+
+    // Encours restant dû (au prorata des participations pour un prêteur)
+    Money getLenderOutstanding(const std::string& lender, const std::string& currency) const;
+    Money getBorrowerOutstanding(const std::string& borrower, const std::string& currency) const;
+    Money getCurrencyOutstanding(const std::string& currency) const;
+
+    const std::vector<Breach>& getBreaches() const;
+    void clearBreaches();
+
+    void onDealAdded(const Deal& deal) override;
+    void onFacilityAdded(const Deal& deal, size_t facilityIndex) override;
+    void onPartPaid(const Deal& deal, size_t facilityIndex) override;
+    void onSharesTransferred(const Deal& deal, size_t facilityIndex) override;
+    void onInterestAccrued(const Deal& deal, size_t facilityIndex) override;
+    void onStatusChanged(const Deal& deal) override;
+    void onAgentChanged(const Deal& deal) override;
+    void onDealRemoved(const Deal& deal) override;
+
+private:
+    struct Total {
+        Money outstanding;
+        Money limit;
+        bool limited = false;
+    };
+
+    // Dernier état connu d'une facility : ce que ses encours apportent aux totaux
+    struct FacilityState {
+        CurrencyCode currency;
+        Money outstanding;
+        std::vector<std::pair<uint32_t, Money>> exposures;   // Encours par prêteur
+    };
+
+    struct DealState {
+        uint32_t borrower;
+        std::vector<FacilityState> facilities;
+    };
+
+    // Contexte de la mutation en cours, pour les dépassements signalés
+    struct Trigger {
+        Event event;
+        const Deal* deal;
+        size_t facilityIndex;
+        std::string date;
+    };
+
+    BookStore& book;
+    BorrowerIndex& borrowers;
+    double minimumPace;
+    std::unordered_map<ContractNumber, DealState> deals;
+    std::unordered_map<uint64_t, Total> lenderTotals;
+    std::unordered_map<uint16_t, Total> currencyTotals;
+    std::vector<std::string> names;
+    std::unordered_map<std::string, uint32_t> nameIds;
+    std::vector<Breach> breaches;
+
+    uint32_t nameOf(const std::string& name);
+    static uint64_t keyOf(uint32_t name, CurrencyCode currency);
+
+    FacilityState stateOf(const Facility& facility);
+    void apply(DealState& deal, FacilityState& previous, FacilityState current, const Trigger* trigger);
+    void add(Total& total, Money delta, Rule rule, const std::string& subject, CurrencyCode currency,
+             const Trigger* trigger);
+    void checkPace(const Facility& facility, const Trigger& trigger);
+    void checkBorrower(const std::string& borrower, CurrencyCode currency, const Trigger& trigger);
+    void report(Rule rule, const std::string& subject, CurrencyCode currency, Money value, Money limit,
+                const Trigger* trigger);
+    void track(const Deal& deal, const Trigger* trigger);
+
+    void validateLimit(double limit) const;
+};
+
+#endif
\ No newline at end of file
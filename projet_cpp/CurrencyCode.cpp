@@ -0,0 +1,12 @@
+#include "CurrencyCode.h"
+
+std::string CurrencyCode::toString() const {
+    if (code == 0) {
+        return "";
+    }
+    std::string text(3, 'A');
+    text[0] = static_cast<char>('A' - 1 + ((code >> 10) & 0x1F));
+    text[1] = static_cast<char>('A' - 1 + ((code >> 5) & 0x1F));
+    text[2] = static_cast<char>('A' - 1 + (code & 0x1F));
+    return text;
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+#ifndef CURRENCY_CODE_H
+#define CURRENCY_CODE_H
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+
+namespace currency_tables {
+
+// Table de validation générée à la compilation : 'A'..'Z' -> 1..26, 0 sinon
+constexpr std::array<uint8_t, 256> makeLetterTable() {
+    std::array<uint8_t, 256> table{};
+    for (int c = 'A'; c <= 'Z'; c++) {
+        table[c] = static_cast<uint8_t>(c - 'A' + 1);
+    }
+    return table;
+}
+
+constexpr uint16_t pack(const char (&text)[4]) {
+    return static_cast<uint16_t>(((text[0] - 'A' + 1) << 10) | ((text[1] - 'A' + 1) << 5) | (text[2] - 'A' + 1));
+}
+
+inline constexpr std::array<uint8_t, 256> LETTERS = makeLetterTable();
+
+// Devises dont l'unité mineure n'a pas 2 décimales
+inline constexpr uint16_t NO_DECIMALS[] = {
+    pack("JPY"), pack("KRW"), pack("CLP"), pack("ISK"), pack("VND"),
+    pack("XOF"), pack("XAF"), pack("PYG"), pack("UGX")
+};
+inline constexpr uint16_t THREE_DECIMALS[] = {
+    pack("BHD"), pack("KWD"), pack("OMR"), pack("JOD"), pack("TND"), pack("IQD"), pack("LYD")
+};
+
+}
+
+// Code devise ISO 4217 (3 lettres majuscules) compacté sur 16 bits, 5 bits par lettre.
+// Analyse et validation constexpr, égalité et hachage en temps constant.
+class CurrencyCode {
+public:
+    constexpr CurrencyCode() : code(0) {}
+
+    static constexpr bool isValid(std::string_view text) {
+        if (text.size() != 3) {
+            return false;
+        }
+        for (char c : text) {
+            if (currency_tables::LETTERS[static_cast<unsigned char>(c)] == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static constexpr CurrencyCode parse(std::string_view text) {
+        if (text.empty()) {
+            throw std::invalid_argument("Currency cannot be empty");
+        }
+        if (text.size() != 3) {
+            throw std::invalid_argument("Currency must be 3 characters (e.g., EUR, USD)");
+        }
+        if (!isValid(text)) {
+            throw std::invalid_argument("Currency must be uppercase letters");
+        }
+        uint16_t packed = 0;
+        for (char c : text) {
+            packed = static_cast<uint16_t>((packed << 5) | currency_tables::LETTERS[static_cast<unsigned char>(c)]);
+        }
+        return CurrencyCode(packed);
+    }
+
+    constexpr uint16_t getCode() const { return code; }
+    constexpr bool isEmpty() const { return code == 0; }
+
+    // Nombre de décimales de l'unité mineure (ISO 4217)
+    constexpr int minorUnitDigits() const {
+        for (uint16_t candidate : currency_tables::NO_DECIMALS) {
+            if (candidate == code) {
+                return 0;
+            }
+        }
+        for (uint16_t candidate : currency_tables::THREE_DECIMALS) {
+            if (candidate == code) {
+                return 3;
+            }
+        }
+        return 2;
+    }
+
+    std::string toString() const;
+
+    constexpr bool operator==(CurrencyCode other) const { return code == other.code; }
+    constexpr bool operator!=(CurrencyCode other) const { return code != other.code; }
+    constexpr bool operator<(CurrencyCode other) const { return code < other.code; }
+
+private:
+    uint16_t code;
+
+    constexpr explicit CurrencyCode(uint16_t code) : code(code) {}
+};
+
+namespace std {
+template <>
+struct hash<CurrencyCode> {
+    size_t operator()(CurrencyCode currency) const noexcept {
+        return currency.getCode();
+    }
+};
+}
+
+#endif
\ No newline at end of file
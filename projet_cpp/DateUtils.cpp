@@ -0,0 +1,74 @@
+#include "DateUtils.h"
+#include <stdexcept>
+#include <cctype>
+
+namespace {
+
+int parseDigits(const std::string& date, size_t start, size_t count) {
+    int value = 0;
+    for (size_t i = start; i < start + count; i++) {
+        if (!std::isdigit(static_cast<unsigned char>(date[i]))) {
+            throw std::invalid_argument("Invalid date format: " + date);
+        }
+        value = value * 10 + (date[i] - '0');
+    }
+    return value;
+}
+
+bool isLeapYear(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+int daysInMonth(int year, int month) {
+    static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return (month == 2 && isLeapYear(year)) ? 29 : days[month - 1];
+}
+
+}
+
+int toDayNumber(const std::string& date) {
+    if (date.length() != 10 || date[4] != '-' || date[7] != '-') {
+        throw std::invalid_argument("Date must be in YYYY-MM-DD format: " + date);
+    }
+
+    int year = parseDigits(date, 0, 4);
+    int month = parseDigits(date, 5, 2);
+    int day = parseDigits(date, 8, 2);
+    if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month)) {
+        throw std::invalid_argument("Invalid date: " + date);
+    }
+
+    // Algorithme des jours civils (calendrier grégorien proleptique)
+    year -= month <= 2 ? 1 : 0;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yearOfEra = year - era * 400;
+    int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+std::string toDateString(int dayNumber) {
+    int shifted = dayNumber + 719468;
+    int era = (shifted >= 0 ? shifted : shifted - 146096) / 146097;
+    int dayOfEra = shifted - era * 146097;
+    int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int monthIndex = (5 * dayOfYear + 2) / 153;
+    int day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    int month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    int year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+
+    if (year < 0 || year > 9999) {
+        throw std::out_of_range("Day number out of the YYYY-MM-DD range");
+    }
+
+    std::string result = "0000-00-00";
+    for (int i = 3; i >= 0; i--, year /= 10) {
+        result[i] = static_cast<char>('0' + year % 10);
+    }
+    result[5] = static_cast<char>('0' + month / 10);
+    result[6] = static_cast<char>('0' + month % 10);
+    result[8] = static_cast<char>('0' + day / 10);
+    result[9] = static_cast<char>('0' + day % 10);
+    return result;
+}
\ No newline at end of file
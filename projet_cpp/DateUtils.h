@@ -0,0 +1,11 @@
+#ifndef DATE_UTILS_H
+#define DATE_UTILS_H
+
+#include <string>
+
+// Conversion des dates YYYY-MM-DD en numéro de jour (jours depuis le 1970-01-01),
+// sans passer par std::mktime ni le fuseau horaire
+int toDayNumber(const std::string& date);
+std::string toDateString(int dayNumber);
+
+#endif
\ No newline at end of file
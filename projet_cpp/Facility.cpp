@@ -1,150 +1,341 @@
-#include "Facility.h"
-#include <cmath>
-#include <ctime>
-#include <sstream>
-#include <iomanip>
-#include <stdexcept>
-
-// Fonction utilitaire pour parser les dates
-std::tm parseDate(const std::string& date) {
-    std::tm tm = {};
-    std::stringstream ss(date);
-    ss >> std::get_time(&tm, "%Y-%m-%d");
-    
-    if (ss.fail()) {
-        throw std::invalid_argument("Invalid date format: " + date);
-    }
-    
-    return tm;
-}
-
-Facility::Facility(const std::string& startDate, const std::string& endDate, 
-                   double amount, const std::string& currency,
-                   const std::vector<Lender>& lenders, double annualInterestRate) 
-    : startDate(startDate), endDate(endDate), currency(currency), 
-      lenders(lenders), annualInterestRate(annualInterestRate), amount(amount) {
-    
-    // Validation des paramètres
-    validateAmount(amount);
-    validateInterestRate(annualInterestRate);
-    validateDates(startDate, endDate);
-    
-    if (currency.empty()) {
-        throw std::invalid_argument("Currency cannot be empty");
-    }
-    
-    if (lenders.empty()) {
-        throw std::invalid_argument("At least one lender is required");
-    }
-}
-
-void Facility::addPart(const Part& part) {
-    // Vérifier que le remboursement ne dépasse pas le montant restant
-    if (part.getAmount() > getRemainingAmount()) {
-        throw std::invalid_argument("Part amount exceeds remaining facility amount");
-    }
-    
-    parts.push_back(part);
-}
-
-void Facility::payPart(double amount, const std::string& date) {
-    Part newPart(amount, date);  // Part valide ses propres paramètres
-    addPart(newPart);
-}
-
-double Facility::getRemainingAmount() const {
-    double totalPaid = 0;
-    for (const Part& part : parts) {
-        totalPaid += part.getAmount();
-    }
-    return amount - totalPaid;
-}
-
-double Facility::getAmount() const {
-    return amount;
-}
-
-const std::string& Facility::getStartDate() const {
-    return startDate;
-}
-
-const std::string& Facility::getEndDate() const {
-    return endDate;
-}
-
-const std::string& Facility::getCurrency() const {
-    return currency;
-}
-
-const std::vector<Lender>& Facility::getLenders() const {
-    return lenders;
-}
-
-double Facility::getAnnualInterestRate() const {
-    return annualInterestRate;
-}
-
-const std::vector<Part>& Facility::getParts() const {
-    return parts;
-}
-
-size_t Facility::getPartsCount() const {
-    return parts.size();
-}
-
-double Facility::calculateInterest(const Part& part) const {
-    try {
-        // Convertir les dates pour calculer la durée en années
-        std::tm start = parseDate(startDate);
-        std::tm end = parseDate(part.getDate());
-        
-        std::time_t startTime = std::mktime(&start);
-        std::time_t endTime = std::mktime(&end);
-        
-        if (startTime == (std::time_t)(-1) || endTime == (std::time_t)(-1)) {
-            throw std::runtime_error("Failed to convert dates to time_t");
-        }
-        
-        double timeInYears = std::difftime(endTime, startTime) / (60 * 60 * 24 * 365);
-        
-        if (timeInYears < 0) {
-            throw std::invalid_argument("Part date cannot be before facility start date");
-        }
-        
-        // Calcul des intérêts composés
-        double interest = getRemainingAmount() * std::pow(annualInterestRate, timeInYears);
-        return interest;
-        
-    } catch (const std::exception& e) {
-        throw std::runtime_error("Error calculating interest: " + std::string(e.what()));
-    }
-}
-
-void Facility::validateAmount(double amount) const {
-    if (amount <= 0) {
-        throw std::invalid_argument("Facility amount must be positive");
-    }
-}
-
-void Facility::validateInterestRate(double rate) const {
-    if (rate < 0) {
-        throw std::invalid_argument("Interest rate cannot be negative");
-    }
-}
-
-void Facility::validateDates(const std::string& startDate, const std::string& endDate) const {
-    // Valider le format des dates
-    parseDate(startDate);  // Lève une exception si invalide
-    parseDate(endDate);    // Lève une exception si invalide
-    
-    // Vérifier que la date de fin est après la date de début
-    std::tm start = parseDate(startDate);
-    std::tm end = parseDate(endDate);
-    
-    std::time_t startTime = std::mktime(&start);
-    std::time_t endTime = std::mktime(&end);
-    
-    if (endTime <= startTime) {
-        throw std::invalid_argument("End date must be after start date");
-    }
+#include "Facility.h"
+#include "DateUtils.h"
+#include <algorithm>
+#include <ctime>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+// Fonction utilitaire pour parser les dates
+std::tm parseDate(const std::string& date) {
+    std::tm tm = {};
+    std::stringstream ss(date);
+    ss >> std::get_time(&tm, "%Y-%m-%d");
+    
+    if (ss.fail()) {
+        throw std::invalid_argument("Invalid date format: " + date);
+    }
+    
+    return tm;
+}
+
+Facility::Facility(const std::string& startDate, const std::string& endDate, 
+                   double amount, const std::string& currency,
+                   const std::vector<Lender>& lenders, double annualInterestRate) 
+    : startDate(startDate), endDate(endDate), currency(CurrencyCode::parse(currency)), 
+      lenders(lenders), annualInterestRate(annualInterestRate), floating(false), curveCurrency(), spread(0),
+      amount(Money::fromDouble(amount, this->currency)), parts(this->currency.minorUnitDigits()),
+      totalPaid(), version(0), accrualDay(0), accrualBalance(this->amount), accruedInterest(0),
+      growth(nullptr) {
+    
+    // Validation des paramètres
+    validateAmount(this->amount);
+    validateInterestRate(annualInterestRate);
+    validateDates(startDate, endDate);
+    
+    if (lenders.empty()) {
+        throw std::invalid_argument("At least one lender is required");
+    }
+    accrualDay = toDayNumber(startDate);
+    
+    // Répartition égale en unités mineures, le reste aux premiers prêteurs
+    int64_t step = Money::UNITS_PER_MAJOR;
+    for (int i = 0; i < Money::minorUnitDigits(this->currency.toString()); i++) {
+        step /= 10;
+    }
+    int64_t minorUnits = this->amount.getUnits() / step;
+    int64_t count = static_cast<int64_t>(lenders.size());
+    for (int64_t i = 0; i < count; i++) {
+        int64_t units = minorUnits / count + (i < minorUnits % count ? 1 : 0);
+        shares.push_back(Money::fromUnits(units * step));
+    }
+    growth = &GrowthFactorCache::shared().table(annualInterestRate);
+}
+
+void Facility::addPart(const Part& part) {
+    // Une part construite sans devise peut descendre sous l'unité mineure de la facility
+    validateMinorUnits(part.getMoney());
+    // Vérifier que le remboursement ne dépasse pas le montant restant
+    // Comparaison exacte : un dernier remboursement du restant dû est toujours accepté
+    if (part.getMoney() > getRemainingMoney()) {
+        throw std::invalid_argument("Part amount exceeds remaining facility amount");
+    }
+    int partDay = std::max(toDayNumber(part.getDate()), toDayNumber(startDate));
+    
+    parts.push_back(part);
+    totalPaid += part.getMoney();
+    if (partDay >= accrualDay) {
+        advanceAccrual(partDay);
+        accrualBalance -= part.getMoney();
+    } else {
+        replayAccrual(accrualDay);
+    }
+    version++;
+}
+
+void Facility::payPart(double amount, const std::string& date) {
+    Part newPart(Money::fromDouble(amount, currency), date);  // Part valide ses propres paramètres
+    addPart(newPart);
+}
+
+double Facility::accrueTo(const std::string& date) {
+    int day = toDayNumber(date);
+    if (day > accrualDay) {
+        advanceAccrual(day);
+        version++;
+    }
+    return accruedInterest;
+}
+
+double Facility::getAccruedInterest() const {
+    return accruedInterest;
+}
+
+Money Facility::getAccruedInterestMoney() const {
+    return Money::fromDouble(accruedInterest, currency);
+}
+
+std::string Facility::getAccrualDate() const {
+    return toDateString(accrualDay);
+}
+
+void Facility::advanceAccrual(int day) {
+    if (day <= accrualDay) {
+        return;
+    }
+    accruedInterest += accrualBalance.toDouble() * annualInterestRate * (day - accrualDay) / 365.0;
+    accrualDay = day;
+}
+
+void Facility::replayAccrual(int day) {
+    // Part antidatée : reprise depuis le début de la facility, parts triées par date
+    int start = toDayNumber(startDate);
+    std::vector<std::pair<int, Money>> events;
+    events.reserve(parts.size());
+    for (PartHistory::const_iterator it = parts.begin(); it != parts.end(); ++it) {
+        events.push_back({std::max(it.getDay(), start), it.getMoney()});
+    }
+    std::stable_sort(events.begin(), events.end(),
+                     [](const std::pair<int, Money>& a, const std::pair<int, Money>& b) { return a.first < b.first; });
+    
+    accrualDay = start;
+    accrualBalance = amount;
+    accruedInterest = 0;
+    for (const auto& event : events) {
+        advanceAccrual(event.first);
+        accrualBalance -= event.second;
+    }
+    advanceAccrual(day);
+}
+
+double Facility::getRemainingAmount() const {
+    return getRemainingMoney().toDouble();
+}
+
+double Facility::getAmount() const {
+    return amount.toDouble();
+}
+
+Money Facility::getRemainingMoney() const {
+    return amount - totalPaid;
+}
+
+Money Facility::getAmountMoney() const {
+    return amount;
+}
+
+const std::string& Facility::getStartDate() const {
+    return startDate;
+}
+
+const std::string& Facility::getEndDate() const {
+    return endDate;
+}
+
+std::string Facility::getCurrency() const {
+    return currency.toString();
+}
+
+CurrencyCode Facility::getCurrencyCode() const {
+    return currency;
+}
+
+const std::vector<Lender>& Facility::getLenders() const {
+    return lenders;
+}
+
+double Facility::getAnnualInterestRate() const {
+    return annualInterestRate;
+}
+
+const std::vector<Money>& Facility::getShares() const {
+    return shares;
+}
+
+Money Facility::getShare(const std::string& lender) const {
+    for (size_t i = 0; i < lenders.size(); i++) {
+        if (lenders[i].getName() == lender) {
+            return shares[i];
+        }
+    }
+    return Money();
+}
+
+void Facility::setShares(const std::vector<Money>& shares) {
+    validateShares(shares);
+    this->shares = shares;
+    version++;
+}
+
+void Facility::transferShare(const std::string& seller, const std::string& buyer, Money amount) {
+    if (amount <= Money()) {
+        throw std::invalid_argument("Transferred share must be positive");
+    }
+    if (buyer.empty()) {
+        throw std::invalid_argument("Buyer name cannot be empty");
+    }
+    if (seller == buyer) {
+        throw std::invalid_argument("Seller and buyer must be different lenders");
+    }
+    size_t from = lenders.size();
+    size_t to = lenders.size();
+    for (size_t i = 0; i < lenders.size(); i++) {
+        if (lenders[i].getName() == seller && from == lenders.size()) {
+            from = i;
+        } else if (lenders[i].getName() == buyer && to == lenders.size()) {
+            to = i;
+        }
+    }
+    if (from == lenders.size()) {
+        throw std::invalid_argument("Seller is not a lender of the facility: " + seller);
+    }
+    if (amount > shares[from]) {
+        throw std::invalid_argument("Transferred share exceeds the share held by " + seller);
+    }
+    
+    if (to == lenders.size()) {
+        lenders.push_back(Lender(buyer));
+        shares.push_back(Money());
+    }
+    shares[to] += amount;
+    shares[from] -= amount;
+    if (shares[from] == Money()) {
+        lenders.erase(lenders.begin() + from);
+        shares.erase(shares.begin() + from);
+    }
+    version++;
+}
+
+void Facility::setFloatingRate(const std::string& curveCurrency, double spread) {
+    validateSpread(spread);
+    this->curveCurrency = CurrencyCode::parse(curveCurrency);
+    this->spread = spread;
+    floating = true;
+    version++;
+}
+
+bool Facility::isFloating() const {
+    return floating;
+}
+
+CurrencyCode Facility::getCurveCurrency() const {
+    return curveCurrency;
+}
+
+double Facility::getSpread() const {
+    return spread;
+}
+
+const PartHistory& Facility::getParts() const {
+    return parts;
+}
+
+size_t Facility::getPartsCount() const {
+    return parts.size();
+}
+
+uint64_t Facility::getVersion() const {
+    return version;
+}
+
+double Facility::calculateInterest(const Part& part) const {
+    try {
+        // Durée en années à partir des numéros de jour (sans mktime ni fuseau horaire,
+        // donc sans état global partagé entre threads)
+        int days = toDayNumber(part.getDate()) - toDayNumber(startDate);
+        
+        if (days < 0) {
+            throw std::invalid_argument("Part date cannot be before facility start date");
+        }
+        
+        // Calcul des intérêts composés, facteur lu dans la table du taux
+        double interest = getRemainingAmount() * growth->factor(days);
+        return interest;
+        
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Error calculating interest: " + std::string(e.what()));
+    }
+}
+
+Money Facility::calculateInterestMoney(const Part& part) const {
+    return Money::fromDouble(calculateInterest(part), currency);
+}
+
+void Facility::validateAmount(Money amount) const {
+    if (amount <= Money()) {
+        throw std::invalid_argument("Facility amount must be positive");
+    }
+}
+
+void Facility::validateMinorUnits(Money amount) const {
+    if (Money::fromDouble(amount.toDouble(), currency) != amount) {
+        throw std::invalid_argument("Amount " + amount.toString() + " is not a whole number of minor units of "
+                                    + currency.toString());
+    }
+}
+
+void Facility::validateInterestRate(double rate) const {
+    if (rate < 0) {
+        throw std::invalid_argument("Interest rate cannot be negative");
+    }
+}
+
+void Facility::validateSpread(double spread) const {
+    // Marge en taux annuel, négative admise mais bornée
+    if (spread <= -1.0 || spread >= 1.0) {
+        throw std::invalid_argument("Spread must be between -100% and 100%");
+    }
+}
+
+void Facility::validateShares(const std::vector<Money>& shares) const {
+    if (shares.size() != lenders.size()) {
+        throw std::invalid_argument("Expected one share per lender");
+    }
+    Money total;
+    for (Money share : shares) {
+        if (share <= Money()) {
+            throw std::invalid_argument("Lender shares must be positive");
+        }
+        total += share;
+    }
+    if (total != amount) {
+        throw std::invalid_argument("Lender shares must add up to the facility amount");
+    }
+}
+
+void Facility::validateDates(const std::string& startDate, const std::string& endDate) const {
+    // Valider le format des dates
+    parseDate(startDate);  // Lève une exception si invalide
+    parseDate(endDate);    // Lève une exception si invalide
+    
+    // Vérifier que la date de fin est après la date de début
+    std::tm start = parseDate(startDate);
+    std::tm end = parseDate(endDate);
+    
+    std::time_t startTime = std::mktime(&start);
+    std::time_t endTime = std::mktime(&end);
+    
+    if (endTime <= startTime) {
+        throw std::invalid_argument("End date must be after start date");
+    }
 }
\ No newline at end of file
@@ -1,48 +1,106 @@
-#ifndef FACILITY_H
-#define FACILITY_H
-
-#include <vector>
-#include <string>
-#include "Lender.h"
-#include "Part.h"
-
-class Facility {
-public:
-    Facility(const std::string& startDate, const std::string& endDate, 
-             double amount, const std::string& currency,
-             const std::vector<Lender>& lenders, double annualInterestRate);
-    
-    void addPart(const Part& part);
-    void payPart(double amount, const std::string& date);
-    
-    double getRemainingAmount() const;
-    double getAmount() const;
-    double calculateInterest(const Part& part) const;
-    
-    // Getters pour les autres attributs
-    const std::string& getStartDate() const;
-    const std::string& getEndDate() const;
-    const std::string& getCurrency() const;
-    const std::vector<Lender>& getLenders() const;
-    double getAnnualInterestRate() const;
-    
-    // Accès en lecture seule aux parts
-    const std::vector<Part>& getParts() const;
-    size_t getPartsCount() const;
-
-private:
-    std::string startDate;
-    std::string endDate;
-    std::string currency;
-    std::vector<Lender> lenders;
-    double annualInterestRate;
-    double amount;
-    std::vector<Part> parts;
-    
-    // Méthodes de validation privées
-    void validateAmount(double amount) const;
-    void validateInterestRate(double rate) const;
-    void validateDates(const std::string& startDate, const std::string& endDate) const;
-};
-
+#ifndef FACILITY_H
+#define FACILITY_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "Lender.h"
+#include "Part.h"
+#include "PartHistory.h"
+#include "Money.h"
+#include "CurrencyCode.h"
+#include "GrowthFactorCache.h"
+
+class Facility {
+public:
+    Facility(const std::string& startDate, const std::string& endDate, 
+             double amount, const std::string& currency,
+             const std::vector<Lender>& lenders, double annualInterestRate);
+    
+    void addPart(const Part& part);
+    void payPart(double amount, const std::string& date);
+    
+    double getRemainingAmount() const;
+    double getAmount() const;
+    double calculateInterest(const Part& part) const;
+    
+    // Registre d'intérêts courus (intérêts simples, base 365) tenu à jour à chaque part :
+    // avancer jusqu'à une date coûte O(1), seule une part antidatée rejoue l'historique.
+    // Sans effet si le registre est déjà à une date postérieure.
+    double accrueTo(const std::string& date);
+    double getAccruedInterest() const;
+    Money getAccruedInterestMoney() const;
+    std::string getAccrualDate() const;
+    
+    // Montants exacts en virgule fixe
+    Money getRemainingMoney() const;
+    Money getAmountMoney() const;
+    // Intérêts arrondis à l'unité mineure de la devise
+    Money calculateInterestMoney(const Part& part) const;
+    
+    // Getters pour les autres attributs
+    const std::string& getStartDate() const;
+    const std::string& getEndDate() const;
+    std::string getCurrency() const;
+    CurrencyCode getCurrencyCode() const;
+    const std::vector<Lender>& getLenders() const;
+    double getAnnualInterestRate() const;
+    
+    // Participations : engagement détenu par chaque prêteur, dans l'ordre de getLenders().
+    // Réparties à parts égales à la création (à l'unité mineure près), leur somme vaut
+    // toujours le montant de la facility.
+    const std::vector<Money>& getShares() const;
+    Money getShare(const std::string& lender) const;
+    // Remplace toutes les participations (une par prêteur, positives, de somme le montant)
+    void setShares(const std::vector<Money>& shares);
+    // Cession d'une participation : le cédant disparaît s'il cède tout, le cessionnaire
+    // est ajouté s'il n'est pas encore prêteur. Tout est vérifié avant la modification.
+    void transferShare(const std::string& seller, const std::string& buyer, Money amount);
+    
+    // Taux variable : courbe de la devise indiquée plus une marge ; le taux annuel
+    // reste utilisé par calculateInterest et en l'absence de courbe
+    void setFloatingRate(const std::string& curveCurrency, double spread);
+    bool isFloating() const;
+    CurrencyCode getCurveCurrency() const;
+    double getSpread() const;
+    
+    // Accès en lecture seule aux parts
+    const PartHistory& getParts() const;
+    size_t getPartsCount() const;
+    
+    // Compteur de mutations, incrémenté à chaque modification de la facility
+    uint64_t getVersion() const;
+
+private:
+    std::string startDate;
+    std::string endDate;
+    CurrencyCode currency;
+    std::vector<Lender> lenders;
+    std::vector<Money> shares;
+    double annualInterestRate;
+    bool floating;
+    CurrencyCode curveCurrency;
+    double spread;
+    Money amount;
+    PartHistory parts;
+    Money totalPaid;
+    uint64_t version;
+    int accrualDay;
+    Money accrualBalance;
+    double accruedInterest;
+    // Table partagée des facteurs de croissance du taux de la facility
+    const GrowthFactorCache::Table* growth;
+    
+    void advanceAccrual(int day);
+    void replayAccrual(int day);
+    
+    // Méthodes de validation privées
+    void validateAmount(Money amount) const;
+    void validateMinorUnits(Money amount) const;
+    void validateInterestRate(double rate) const;
+    void validateSpread(double spread) const;
+    void validateShares(const std::vector<Money>& shares) const;
+    void validateDates(const std::string& startDate, const std::string& endDate) const;
+};
+
 #endif
\ No newline at end of file
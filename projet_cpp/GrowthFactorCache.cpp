@@ -0,0 +1,72 @@
+#include "GrowthFactorCache.h"
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+GrowthFactorCache::Table::Table(double base) : base(base), coarse(COARSE_STEPS) {
+    for (int day = 0; day < FINE_STEPS; day++) {
+        fine[day] = std::pow(base, day / 365.0);
+    }
+    for (int step = 0; step < COARSE_STEPS; step++) {
+        coarse[step] = std::pow(base, step * FINE_STEPS / 365.0);
+    }
+}
+
+double GrowthFactorCache::Table::factor(int days) const {
+    if (days < 0) {
+        return 1.0 / factor(-days);
+    }
+    if (days >= FINE_STEPS * COARSE_STEPS) {
+        return std::pow(base, days / 365.0);
+    }
+    return coarse[days / FINE_STEPS] * fine[days % FINE_STEPS];
+}
+
+double GrowthFactorCache::Table::getBase() const {
+    return base;
+}
+
+GrowthFactorCache& GrowthFactorCache::shared() {
+    static GrowthFactorCache cache;
+    return cache;
+}
+
+const GrowthFactorCache::Table& GrowthFactorCache::table(double base) {
+    uint64_t key = keyOf(base);
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = tables.find(key);
+        if (it != tables.end()) {
+            return *it->second;
+        }
+    }
+
+    // Construction hors verrou, un autre thread a pu insérer la même base entre-temps
+    std::unique_ptr<const Table> built(new Table(base));
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto inserted = tables.emplace(key, std::move(built));
+    return *inserted.first->second;
+}
+
+double GrowthFactorCache::growthFactor(double base, int days) {
+    return table(base).factor(days);
+}
+
+double GrowthFactorCache::discountFactor(double base, int days) {
+    return table(base).factor(-days);
+}
+
+size_t GrowthFactorCache::getTablesCount() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return tables.size();
+}
+
+uint64_t GrowthFactorCache::keyOf(double base) {
+    // -0.0 et 0.0 partagent la même table
+    if (base == 0) {
+        base = 0;
+    }
+    uint64_t key;
+    std::memcpy(&key, &base, sizeof(key));
+    return key;
+}
\ No newline at end of file
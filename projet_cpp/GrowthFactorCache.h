@@ -0,0 +1,52 @@
+#ifndef GROWTH_FACTOR_CACHE_H
+#define GROWTH_FACTOR_CACHE_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+// Facteurs de croissance base^(jours / 365) précalculés par base distincte.
+//
+// Chaque table tient en deux niveaux : FINE_STEPS facteurs jour par jour et
+// COARSE_STEPS facteurs par pas de FINE_STEPS jours. Un facteur est alors le produit
+// de deux lectures, sans appel à pow ; au-delà de l'horizon tabulé on revient à pow.
+// Les tables sont construites à la première demande puis partagées et jamais
+// modifiées : une référence obtenue reste valide et lisible sans verrou.
+class GrowthFactorCache {
+public:
+    static const int FINE_STEPS = 64;
+    static const int COARSE_STEPS = 512;
+
+    class Table {
+    public:
+        explicit Table(double base);
+
+        // base^(days / 365), inverse pour un nombre de jours négatif
+        double factor(int days) const;
+        double getBase() const;
+
+    private:
+        double base;
+        std::array<double, FINE_STEPS> fine;
+        std::vector<double> coarse;
+    };
+
+    // Instance partagée par toutes les facilities et courbes du processus
+    static GrowthFactorCache& shared();
+
+    const Table& table(double base);
+    double growthFactor(double base, int days);
+    double discountFactor(double base, int days);
+    size_t getTablesCount() const;
+
+private:
+    mutable std::shared_mutex mutex;
+    std::unordered_map<uint64_t, std::unique_ptr<const Table>> tables;
+
+    static uint64_t keyOf(double base);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,336 @@
+#include "ImportPipeline.h"
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Attente active courte : on cède le cœur tant que la file voisine n'est pas prête
+template <typename T>
+void pushBlocking(SpscQueue<T>& queue, T& value, size_t& stalls) {
+    while (!queue.tryPush(value)) {
+        stalls++;
+        std::this_thread::yield();
+    }
+}
+
+template <typename T>
+void popBlocking(SpscQueue<T>& queue, T& value, size_t& stalls) {
+    while (!queue.tryPop(value)) {
+        stalls++;
+        std::this_thread::yield();
+    }
+}
+
+std::vector<std::string> splitList(const std::string& value) {
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= value.size()) {
+        size_t end = value.find(';', start);
+        if (end == std::string::npos) {
+            end = value.size();
+        }
+        if (end > start) {
+            items.push_back(value.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+    return items;
+}
+
+std::vector<Lender> lendersOf(const std::string& value) {
+    std::vector<Lender> lenders;
+    for (const std::string& name : splitList(value)) {
+        lenders.push_back(Lender(name));
+    }
+    return lenders;
+}
+
+double parseNumber(const std::string& value) {
+    size_t used = 0;
+    double number;
+    try {
+        number = std::stod(value, &used);
+    } catch (const std::exception&) {
+        throw std::invalid_argument("Invalid number: " + value);
+    }
+    if (used != value.size()) {
+        throw std::invalid_argument("Invalid number: " + value);
+    }
+    return number;
+}
+
+Deal::Status parseStatus(const std::string& value) {
+    if (value == "closed" || value == "CLOSED") {
+        return Deal::Status::CLOSED;
+    }
+    if (value == "terminated" || value == "TERMINATED") {
+        return Deal::Status::TERMINATED;
+    }
+    throw std::invalid_argument("Invalid deal status: " + value);
+}
+
+void requireFields(const std::vector<std::string>& fields, size_t count) {
+    if (fields.size() != count) {
+        throw std::invalid_argument("Expected " + std::to_string(count) + " fields, got " +
+                                    std::to_string(fields.size()));
+    }
+}
+
+// Projection des contrats connus pour l'étape de résolution
+struct KnownDeal {
+    Money projectAmount;
+    Money facilitiesAmount;
+    size_t facilities;
+};
+
+}
+
+ImportPipeline::ImportPipeline(BookStore& book, size_t batchSize, size_t queueCapacity)
+    : book(book), batchSize(batchSize), queueCapacity(queueCapacity) {
+    validateBatchSize(batchSize);
+    validateBatchSize(queueCapacity);
+}
+
+ImportPipeline::Report ImportPipeline::runFile(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open import file: " + path);
+    }
+    return run(in);
+}
+
+ImportPipeline::Report ImportPipeline::run(std::istream& in) {
+    Clock::time_point start = Clock::now();
+    Report report{0, 0, 0, {}, {}, 0};
+    report.stages = {{"read", 0, 0, 0, 0}, {"tokenize", 0, 0, 0, 0}, {"validate", 0, 0, 0, 0},
+                     {"resolve", 0, 0, 0, 0}, {"commit", 0, 0, 0, 0}};
+    std::deque<SpscQueue<Batch>> queues;
+    for (int i = 0; i < 4; i++) {
+        queues.emplace_back(queueCapacity);
+    }
+
+    // Contrats déjà présents : l'étape de résolution ne lit jamais le book pendant l'import
+    std::unordered_map<ContractNumber, KnownDeal> known;
+    for (const Deal& deal : book.getDeals()) {
+        known[deal.getContractNumber()] = {deal.getProjectMoney(), deal.getTotalFacilitiesMoney(),
+                                           deal.getFacilitiesCount()};
+    }
+
+    // Étape intermédiaire : lot d'entrée, traitement de chaque ligne valide, lot de sortie
+    auto stage = [](SpscQueue<Batch>& input, SpscQueue<Batch>& output, StageStats& stats, auto process) {
+        while (true) {
+            Batch batch;
+            popBlocking(input, batch, stats.stalls);
+            Clock::time_point begin = Clock::now();
+            for (Record& record : batch.records) {
+                if (record.error.empty()) {
+                    try {
+                        process(record);
+                    } catch (const std::exception& e) {
+                        record.error = e.what();
+                    }
+                }
+            }
+            stats.records += batch.records.size();
+            stats.batches++;
+            stats.busySeconds += std::chrono::duration<double>(Clock::now() - begin).count();
+            bool last = batch.last;
+            pushBlocking(output, batch, stats.stalls);
+            if (last) {
+                return;
+            }
+        }
+    };
+
+    std::thread reader([&]() {
+        StageStats& stats = report.stages[0];
+        std::string line;
+        size_t lineNumber = 0;
+        bool more = true;
+        while (more) {
+            Clock::time_point begin = Clock::now();
+            Batch batch;
+            batch.records.reserve(batchSize);
+            while (batch.records.size() < batchSize && (more = static_cast<bool>(std::getline(in, line)))) {
+                lineNumber++;
+                if (!line.empty() && line.back() == '\r') {
+                    line.pop_back();
+                }
+                if (line.empty() || line[0] == '#') {
+                    continue;
+                }
+                Record record;
+                record.line = lineNumber;
+                record.text = std::move(line);
+                batch.records.push_back(std::move(record));
+            }
+            batch.last = !more;
+            stats.records += batch.records.size();
+            stats.batches++;
+            stats.busySeconds += std::chrono::duration<double>(Clock::now() - begin).count();
+            pushBlocking(queues[0], batch, stats.stalls);
+        }
+    });
+
+    std::thread tokenizer([&]() { stage(queues[0], queues[1], report.stages[1], tokenize); });
+    std::thread validator([&]() { stage(queues[1], queues[2], report.stages[2], validate); });
+
+    std::thread resolver([&]() {
+        stage(queues[2], queues[3], report.stages[3], [&known](Record& record) {
+            auto it = known.find(record.contract);
+            if (record.kind == Kind::DEAL) {
+                if (it != known.end()) {
+                    throw std::invalid_argument("Contract number already exists in the book: " +
+                                                record.contract.toString());
+                }
+                known[record.contract] = {record.deal->getProjectMoney(), Money(), 0};
+                return;
+            }
+            if (it == known.end()) {
+                throw std::invalid_argument("Unknown contract number: " + record.contract.toString());
+            }
+            KnownDeal& deal = it->second;
+            if (record.kind == Kind::FACILITY) {
+                if (deal.facilitiesAmount + record.facility->getAmountMoney() > deal.projectAmount) {
+                    throw std::invalid_argument("Total facilities amount cannot exceed project amount");
+                }
+                deal.facilitiesAmount += record.facility->getAmountMoney();
+                deal.facilities++;
+            } else if (record.facilityIndex >= deal.facilities) {
+                throw std::out_of_range("Facility index out of range");
+            }
+        });
+    });
+
+    // Écriture sur le thread appelant, seul propriétaire du book pendant l'import
+    StageStats& stats = report.stages[4];
+    std::unordered_map<ContractNumber, DealHandle> handles;
+    while (true) {
+        Batch batch;
+        popBlocking(queues[3], batch, stats.stalls);
+        Clock::time_point begin = Clock::now();
+        for (Record& record : batch.records) {
+            try {
+                if (!record.error.empty()) {
+                    throw std::invalid_argument(record.error);
+                }
+                if (record.kind == Kind::DEAL) {
+                    handles[record.contract] = book.addDeal(std::move(*record.deal));
+                    report.deals++;
+                    continue;
+                }
+                auto it = handles.find(record.contract);
+                DealHandle deal = it != handles.end() ? it->second : book.findDeal(record.contract);
+                if (record.kind == Kind::FACILITY) {
+                    book.addFacility(deal, std::move(*record.facility));
+                    report.facilities++;
+                } else {
+                    book.payPart({deal, static_cast<uint32_t>(record.facilityIndex)},
+                                 record.part->getAmount(), record.part->getDate());
+                    report.parts++;
+                }
+            } catch (const std::exception& e) {
+                report.errors.push_back({record.line, e.what()});
+            }
+        }
+        stats.records += batch.records.size();
+        stats.batches++;
+        stats.busySeconds += std::chrono::duration<double>(Clock::now() - begin).count();
+        if (batch.last) {
+            break;
+        }
+    }
+
+    reader.join();
+    tokenizer.join();
+    validator.join();
+    resolver.join();
+    report.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return report;
+}
+
+void ImportPipeline::tokenize(Record& record) {
+    // Champs CSV, guillemets doublés à l'intérieur d'un champ entre guillemets
+    const std::string& text = record.text;
+    std::string field;
+    bool quoted = false;
+    for (size_t i = 0; i < text.size(); i++) {
+        char c = text[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < text.size() && text[i + 1] == '"') {
+                field += '"';
+                i++;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                field += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            record.fields.push_back(std::move(field));
+            field.clear();
+        } else {
+            field += c;
+        }
+    }
+    if (quoted) {
+        throw std::invalid_argument("Unterminated quoted field");
+    }
+    record.fields.push_back(std::move(field));
+    record.text.clear();
+
+    const std::string& type = record.fields[0];
+    if (type == "deal") {
+        record.kind = Kind::DEAL;
+    } else if (type == "facility") {
+        record.kind = Kind::FACILITY;
+    } else if (type == "part") {
+        record.kind = Kind::PART;
+    } else {
+        throw std::invalid_argument("Unknown record type: " + type);
+    }
+}
+
+void ImportPipeline::validate(Record& record) {
+    // Toutes les validations des constructeurs ont lieu ici, hors du thread d'écriture
+    const std::vector<std::string>& f = record.fields;
+    switch (record.kind) {
+        case Kind::DEAL:
+            requireFields(f, 10);
+            record.contract = ContractNumber::parse(f[1]);
+            record.deal.emplace(f[1], f[2], lendersOf(f[9]), Borrower(f[3]), parseNumber(f[4]), f[5],
+                                f[6], f[7], parseStatus(f[8]));
+            break;
+        case Kind::FACILITY:
+            requireFields(f, 8);
+            record.contract = ContractNumber::parse(f[1]);
+            record.facility.emplace(f[2], f[3], parseNumber(f[4]), f[5], lendersOf(f[7]), parseNumber(f[6]));
+            break;
+        case Kind::PART: {
+            requireFields(f, 5);
+            record.contract = ContractNumber::parse(f[1]);
+            double number = parseNumber(f[2]);
+            if (number < 1 || number != static_cast<double>(static_cast<size_t>(number))) {
+                throw std::invalid_argument("Invalid facility number: " + f[2]);
+            }
+            record.facilityIndex = static_cast<size_t>(number) - 1;
+            record.part.emplace(parseNumber(f[3]), f[4]);
+            break;
+        }
+    }
+    record.fields.clear();
+}
+
+void ImportPipeline::validateBatchSize(size_t size) const {
+    if (size == 0) {
+        throw std::invalid_argument("Batch size and queue capacity must be positive");
+    }
+}
\ No newline at end of file
@@ -0,0 +1,139 @@
+#ifndef IMPORT_PIPELINE_H
+#define IMPORT_PIPELINE_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <optional>
+#include <istream>
+#include <cstddef>
+#include "BookStore.h"
+#include "Deal.h"
+#include "Facility.h"
+#include "Part.h"
+
+// File bornée à un producteur et un consommateur, sans verrou.
+// La capacité est arrondie à la puissance de deux supérieure.
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) : head(0), tail(0) {
+        size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    // Faux si la file est pleine, la valeur n'est alors pas déplacée
+    bool tryPush(T& value) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        if (position - head.load(std::memory_order_acquire) == slots.size()) {
+            return false;
+        }
+        slots[position & mask] = std::move(value);
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& value) {
+        size_t position = head.load(std::memory_order_relaxed);
+        if (position == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(slots[position & mask]);
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t getCapacity() const {
+        return slots.size();
+    }
+
+private:
+    std::vector<T> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head;   // Position du consommateur
+    alignas(64) std::atomic<size_t> tail;   // Position du producteur
+};
+
+// Import en masse de deals, facilities et parts depuis un fichier CSV.
+//
+// Format : une ligne par enregistrement, listes de prêteurs séparées par ';',
+// lignes vides et lignes commençant par '#' ignorées.
+//   deal,contrat,agent,emprunteur,montant,devise,date signature,date fin,statut,prêteurs
+//   facility,contrat,date début,date fin,montant,devise,taux,prêteurs
+//   part,contrat,numéro de facility (à partir de 1),montant,date
+//
+// Les étapes lecture -> découpage -> validation -> résolution des contrats -> écriture
+// tournent chacune sur son thread et échangent des lots de lignes par des SpscQueue
+// bornées : une étape lente bloque les précédentes (contre-pression). Seule l'étape
+// d'écriture modifie le BookStore. Une ligne rejetée est reportée avec son numéro
+// sans interrompre l'import.
+class ImportPipeline {
+public:
+    struct StageStats {
+        std::string name;
+        size_t records;
+        size_t batches;
+        size_t stalls;        // Attentes sur une file vide ou pleine
+        double busySeconds;   // Temps passé à traiter les lots
+    };
+
+    struct ImportError {
+        size_t line;
+        std::string message;
+    };
+
+    struct Report {
+        size_t deals;
+        size_t facilities;
+        size_t parts;
+        std::vector<ImportError> errors;
+        std::vector<StageStats> stages;
+        double seconds;
+    };
+
+    static const size_t DEFAULT_BATCH_SIZE = 256;
+    static const size_t DEFAULT_QUEUE_CAPACITY = 64;
+
+    explicit ImportPipeline(BookStore& book, size_t batchSize = DEFAULT_BATCH_SIZE,
+                            size_t queueCapacity = DEFAULT_QUEUE_CAPACITY);
+
+    Report run(std::istream& in);
+    Report runFile(const std::string& path);
+
+private:
+    enum class Kind { DEAL, FACILITY, PART };
+
+    // Enregistrement complété au fil des étapes ; error non vide = ligne rejetée
+    struct Record {
+        size_t line = 0;
+        std::string text;
+        Kind kind = Kind::DEAL;
+        std::vector<std::string> fields;
+        ContractNumber contract;
+        size_t facilityIndex = 0;
+        std::optional<Deal> deal;
+        std::optional<Facility> facility;
+        std::optional<Part> part;
+        std::string error;
+    };
+
+    struct Batch {
+        std::vector<Record> records;
+        bool last = false;
+    };
+
+    BookStore& book;
+    size_t batchSize;
+    size_t queueCapacity;
+
+    static void tokenize(Record& record);
+    static void validate(Record& record);
+
+    void validateBatchSize(size_t size) const;
+};
+
+#endif
\ No newline at end of file
@@ -1,8 +1,8 @@
-#include "Lender.h"
-
-Lender::Lender(const std::string& name) : name(name) {
-}
-
-const std::string& Lender::getName() const {
-    return name;
+#include "Lender.h"
+
+Lender::Lender(const std::string& name) : name(name) {
+}
+
+const std::string& Lender::getName() const {
+    return name;
 }
\ No newline at end of file
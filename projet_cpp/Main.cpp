@@ -1,369 +1,864 @@
-#include <iostream>
-#include <vector>
-#include <algorithm>
-#include <stdexcept>
-
-#include "Facility.h"
-#include "Lender.h"
-#include "Part.h"
-#include "Borrower.h"
-#include "Deal.h"
-#include "Portfolio.h"
-
-std::vector<Lender> pool;
-std::vector<Lender> lenders;
-std::vector<Borrower> borrowers;
-std::vector<Facility> facilities;
-std::vector<Deal> deals;
-
-void createDeal();
-Borrower createBorrower();
-Lender createLender();
-void addLenderToPool();
-void createFacility();
-void pay();
-void displayFacilities();
-void displayParts();
-Deal* findDealByNumber(const std::string& dealNum);
-
-int main() {
-    try {
-        // Création des emprunteurs
-        borrowers.push_back(Borrower("Air France"));
-        borrowers.push_back(Borrower("Orange"));
-
-        // Création des prêteurs
-        lenders.push_back(Lender("BNP"));
-        lenders.push_back(Lender("SG"));
-
-        // Création d'un deal avec le nouveau constructeur
-        Deal deal("S1234", "BNP", lenders, borrowers[0], 10000000, "USD", 
-                  "2025-06-26", "2035-06-26", Deal::Status::CLOSED);
-        deals.push_back(deal);
-
-        // Création d'une facility avec validation
-        Facility facility1("2025-06-26", "2035-06-26", 5000000, "USD", 
-                          {lenders[0], lenders[1]}, 0.05);
-        
-        // Ajout de remboursements
-        facility1.payPart(1000000, "2027-06-25");
-        facility1.payPart(2000000, "2030-06-25");
-        facility1.payPart(1000000, "2032-06-25");
-        
-        facilities.push_back(facility1);
-        deals[0].addFacility(facility1);
-
-        // Création du portfolio avec pointeur
-        Portfolio portfolio(&facility1);
-
-        while (true) {
-            std::cout << "\n---------------------------------------\n";
-            std::cout << "Structured Financing Application\n";
-            std::cout << "---------------------------------------\n";
-            std::cout << "1. Create a new deal\n";
-            std::cout << "2. Create a new borrower\n";
-            std::cout << "3. Create a new lender\n";
-            std::cout << "4. Add a lender to the pool\n";
-            std::cout << "5. Create a new facility\n";
-            std::cout << "6. Pay a part of a facility\n";
-            std::cout << "7. Calculate interest\n";
-            std::cout << "8. Manage portfolio\n";
-            std::cout << "9. Terminate a deal\n";
-            std::cout << "10. Display details of a deal\n";
-            std::cout << "11. Display list of borrowers and lenders\n";
-            std::cout << "12. Display the facilities\n";
-            std::cout << "13. Display the parts\n";
-            std::cout << "0. Exit\n";
-            std::cout << "---------------------------------------\n";
-            std::cout << "Enter your choice: ";
-
-            int choice;
-            std::cin >> choice;
-
-            switch (choice) {
-                case 1:
-                    createDeal();
-                    break;
-                case 2:
-                    borrowers.push_back(createBorrower());
-                    break;
-                case 3:
-                    lenders.push_back(createLender());
-                    break;
-                case 4:
-                    addLenderToPool();
-                    break;
-                case 5:
-                    createFacility();
-                    break;
-                case 6:
-                    pay();
-                    break;
-                case 7:
-                    if (!facilities.empty() && facilities[0].getPartsCount() > 0) {
-                        const std::vector<Part>& parts = facilities[0].getParts();
-                        std::cout << "Calculate the interest of first part\n";
-                        std::cout << "The interest is: " << facilities[0].calculateInterest(parts[0]) << std::endl;
-                    } else {
-                        std::cout << "No parts available for interest calculation.\n";
-                    }
-                    break;
-                case 8:
-                    std::cout << "The total interest accumulated is: " << portfolio.getTotalInterest() << std::endl;
-                    std::cout << "The total amount is: " << portfolio.getTotalAmount() << std::endl;
-                    std::cout << "Amount should be repaid: " << portfolio.getTotalRemboursement() << std::endl;
-                    break;
-                case 9:
-                    if (!deals.empty()) {
-                        deals[0].setStatus(Deal::Status::TERMINATED);
-                        std::cout << "Deal terminated successfully.\n";
-                    } else {
-                        std::cout << "No deals to terminate.\n";
-                    }
-                    break;
-                case 10:
-                    if (!deals.empty()) {
-                        deals[0].displayDetails();
-                    } else {
-                        std::cout << "No deals to display.\n";
-                    }
-                    break;
-                case 11:
-                    std::cout << "List of lenders:\n";
-                    for (const auto& lender : lenders) {
-                        std::cout << "- " << lender.getName() << std::endl;
-                    }
-                    std::cout << "\nList of borrowers:\n";
-                    for (const auto& borrower : borrowers) {
-                        std::cout << "- " << borrower.getName() << std::endl;
-                    }
-                    break;
-                case 12:
-                    displayFacilities();
-                    break;
-                case 13:
-                    displayParts();
-                    break;
-                case 0:
-                    std::cout << "Goodbye!\n";
-                    return 0;
-                default:
-                    std::cout << "Invalid choice. Please enter a number between 0 and 13.\n";
-            }
-        }
-    } catch (const std::exception& e) {
-        std::cerr << "Error: " << e.what() << std::endl;
-        return 1;
-    }
-    
-    return 0;
-}
-
-void pay() {
-    if (facilities.empty()) {
-        std::cout << "No facilities available for payment.\n";
-        return;
-    }
-
-    double amount;
-    std::string date;
-    std::cout << "Enter the amount to pay: ";
-    std::cin >> amount;
-    std::cout << "Enter the date of payment (YYYY-MM-DD): ";
-    std::cin >> date;
-
-    try {
-        if (facilities[0].getRemainingAmount() < amount) {
-            std::cout << "Payment amount exceeds remaining facility amount.\n";
-        } else {
-            facilities[0].payPart(amount, date);
-            std::cout << "Payment successful!\n";
-            std::cout << "Remaining amount: " << facilities[0].getRemainingAmount() << std::endl;
-        }
-    } catch (const std::exception& e) {
-        std::cout << "Payment failed: " << e.what() << std::endl;
-    }
-}
-
-Deal* findDealByNumber(const std::string& dealNum) {
-    for (auto& deal : deals) {
-        if (deal.getContractNum() == dealNum) {  
-            return &deal;
-        }
-    }
-    return nullptr;
-}
-
-void createFacility() {
-    if (deals.empty()) {
-        std::cout << "No deals available. Create a deal first.\n";
-        return;
-    }
-
-    std::string currency;
-    double amount;
-    double annualInterestRate;
-    std::vector<Lender> selectedLenders;
-
-    std::cout << "Enter the amount: ";
-    std::cin >> amount;
-    std::cout << "Enter the currency: ";
-    std::cin >> currency;
-    std::cout << "Enter the annual interest rate (e.g., 0.05 for 5%): ";
-    std::cin >> annualInterestRate;
-
-    // Sélection des lenders
-    int lenderCount;
-    std::cout << "How many lenders would you like to add to this facility? ";
-    std::cin >> lenderCount;
-
-    for (int i = 0; i < lenderCount; i++) {
-        std::string lenderName;
-        std::cout << "Enter the name of lender " << (i+1) << ": ";
-        std::cin >> lenderName;
-
-        auto it = std::find_if(lenders.begin(), lenders.end(), 
-                              [&lenderName](const Lender& lender) {
-            return lender.getName() == lenderName;
-        });
-
-        if (it != lenders.end()) {
-            selectedLenders.push_back(*it);
-        } else {
-            std::cout << "Lender " << lenderName << " not found.\n";
-        }
-    }
-
-    try {
-        Facility facility(deals[0].getContractSignDate(), deals[0].getContractEndDate(), 
-                         amount, currency, selectedLenders, annualInterestRate);
-        
-        facilities.push_back(facility);
-        deals[0].addFacility(facility);
-        std::cout << "Facility created successfully!\n";
-    } catch (const std::exception& e) {
-        std::cout << "Failed to create facility: " << e.what() << std::endl;
-    }
-}
-
-void createDeal() {
-    std::string contract_num;
-    std::string agent;
-    double project_amount;
-    std::string currency;
-    std::string contract_sign_date;
-    std::string contract_end_date;
-
-    std::cout << "\nEnter contract number (Format: Letter + 4 digits, e.g., S1234): ";
-    std::cin >> contract_num;
-    std::cout << "\nEnter agent: ";
-    std::cin >> agent;
-    std::cout << "\nEnter project amount: ";
-    std::cin >> project_amount;
-    std::cout << "\nEnter currency (3 letters, e.g., EUR): ";
-    std::cin >> currency;
-    std::cout << "\nEnter contract sign date (YYYY-MM-DD): ";
-    std::cin >> contract_sign_date;
-    std::cout << "\nEnter contract end date (YYYY-MM-DD): ";
-    std::cin >> contract_end_date;
-
-    try {
-        if (borrowers.empty()) {
-            std::cout << "No borrowers available. Create a borrower first.\n";
-            return;
-        }
-
-        Deal deal(contract_num, agent, lenders, borrowers[0], project_amount, 
-                 currency, contract_sign_date, contract_end_date, Deal::Status::CLOSED);
-        deals.push_back(deal);
-        std::cout << "Deal created successfully!\n";
-    } catch (const std::exception& e) {
-        std::cout << "Failed to create deal: " << e.what() << std::endl;
-    }
-}
-
-Borrower createBorrower() {
-    std::string name;
-    std::cout << "Enter borrower's name: ";
-    std::cin >> name;
-
-    try {
-        return Borrower(name);
-    } catch (const std::exception& e) {
-        std::cout << "Failed to create borrower: " << e.what() << std::endl;
-        return Borrower();  // Retourne le constructeur par défaut
-    }
-}
-
-Lender createLender() {
-    std::string name;
-    std::cout << "Enter lender's name: ";
-    std::cin >> name;
-
-    try {
-        return Lender(name);
-    } catch (const std::exception& e) {
-        std::cout << "Failed to create lender: " << e.what() << std::endl;
-        throw;  // Re-lancer l'exception car Lender n'a pas de constructeur par défaut
-    }
-}
-
-void addLenderToPool() {
-    std::string lenderName;
-    std::cout << "Enter the lender's name: ";
-    std::cin >> lenderName;
-
-    auto it = std::find_if(lenders.begin(), lenders.end(), 
-                          [&lenderName](const Lender& lender) {
-        return lender.getName() == lenderName;
-    });
-
-    if (it != lenders.end()) {
-        pool.push_back(*it);
-        std::cout << "Lender " << lenderName << " added to the pool.\n";
-    } else {
-        std::cout << "Error: Lender " << lenderName << " does not exist.\n";
-    }
-}
-
-void displayFacilities() {
-    if (facilities.empty()) {
-        std::cout << "No facilities to display.\n";
-        return;
-    }
-
-    std::cout << "\n=== FACILITIES ===\n";
-    for (size_t i = 0; i < facilities.size(); i++) {
-        std::cout << "Facility " << (i+1) << ":\n";
-        std::cout << "  Amount: " << facilities[i].getAmount() << " " << facilities[i].getCurrency() << std::endl;
-        std::cout << "  Remaining: " << facilities[i].getRemainingAmount() << std::endl;
-        std::cout << "  Interest Rate: " << (facilities[i].getAnnualInterestRate() * 100) << "%\n";
-        std::cout << "  Parts Count: " << facilities[i].getPartsCount() << std::endl;
-        std::cout << "  Start Date: " << facilities[i].getStartDate() << std::endl;
-        std::cout << "  End Date: " << facilities[i].getEndDate() << std::endl;
-        std::cout << "-------------------\n";
-    }
-}
-
-void displayParts() {
-    if (facilities.empty()) {
-        std::cout << "No facilities available.\n";
-        return;
-    }
-
-    std::cout << "\n=== PARTS ===\n";
-    for (size_t i = 0; i < facilities.size(); i++) {
-        std::cout << "Facility " << (i+1) << " Parts:\n";
-        const std::vector<Part>& parts = facilities[i].getParts();
-        
-        if (parts.empty()) {
-            std::cout << "  No parts in this facility.\n";
-        } else {
-            for (size_t j = 0; j < parts.size(); j++) {
-                std::cout << "  Part " << (j+1) << ": " << parts[j].getAmount() 
-                         << " on " << parts[j].getDate() << std::endl;
-            }
-        }
-        std::cout << "-------------------\n";
-    }
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include "Facility.h"
+#include "Lender.h"
+#include "Part.h"
+#include "Borrower.h"
+#include "Deal.h"
+#include "Portfolio.h"
+#include "BorrowerIndex.h"
+#include "ColumnarExporter.h"
+#include "BufferWriter.h"
+#include "ReportRenderer.h"
+#include "CalendarIndex.h"
+#include "BookStore.h"
+#include "BookServer.h"
+#include "Pricing.h"
+#include "TieredBook.h"
+#include "ImportPipeline.h"
+#include "BookHistory.h"
+#include "ParticipationMarket.h"
+#include "CovenantEngine.h"
+#include "BookDigest.h"
+#include "ChangeStream.h"
+#include "ShardCoordinator.h"
+#include "DateUtils.h"
+
+std::vector<Lender> pool;
+std::vector<Lender> lenders;
+std::vector<Borrower> borrowers;
+BookStore book;
+std::vector<FacilityHandle> facilities;
+BorrowerIndex borrowerIndex(book);
+BookHistory history(book);
+ParticipationMarket market(book);
+CovenantEngine covenants(book, borrowerIndex);
+BookDigest digest(book);
+ChangeStream changes(book);
+CalendarIndex calendar(book);
+
+TieredBook& coldBook();
+void createDeal();
+Borrower createBorrower();
+Lender createLender();
+void addLenderToPool();
+void createFacility();
+void pay();
+void displayFacilities();
+void displayParts();
+void exportBook();
+void printReport();
+void sweepMaturities();
+void serveBook();
+void priceBook();
+void accrueInterest();
+void archiveTerminated();
+void importDeals();
+void showDealAsOf();
+void tradeParticipation();
+void manageCovenants();
+void reconcileBook();
+void exportChanges();
+void computeOnShards();
+
+int main() {
+    try {
+        // Création des emprunteurs
+        borrowers.push_back(Borrower("Air France"));
+        borrowers.push_back(Borrower("Orange"));
+
+        // Création des prêteurs
+        lenders.push_back(Lender("BNP"));
+        lenders.push_back(Lender("SG"));
+
+        // Création d'un deal avec le nouveau constructeur
+        DealHandle deal = book.addDeal(Deal("S1234", "BNP", lenders, borrowers[0], 10000000, "USD", 
+                                            "2025-06-26", "2035-06-26", Deal::Status::CLOSED));
+
+        // Création d'une facility avec validation
+        Facility facility1("2025-06-26", "2035-06-26", 5000000, "USD", 
+                          {lenders[0], lenders[1]}, 0.05);
+        
+        // Ajout de remboursements
+        facility1.payPart(1000000, "2027-06-25");
+        facility1.payPart(2000000, "2030-06-25");
+        facility1.payPart(1000000, "2032-06-25");
+        
+        facilities.push_back(book.addFacility(deal, std::move(facility1)));
+
+        // Création du portfolio à partir des handles du book
+        Portfolio portfolio(book, facilities);
+
+        while (true) {
+            std::cout << "\n---------------------------------------\n";
+            std::cout << "Structured Financing Application\n";
+            std::cout << "---------------------------------------\n";
+            std::cout << "1. Create a new deal\n";
+            std::cout << "2. Create a new borrower\n";
+            std::cout << "3. Create a new lender\n";
+            std::cout << "4. Add a lender to the pool\n";
+            std::cout << "5. Create a new facility\n";
+            std::cout << "6. Pay a part of a facility\n";
+            std::cout << "7. Calculate interest\n";
+            std::cout << "8. Manage portfolio\n";
+            std::cout << "9. Terminate a deal\n";
+            std::cout << "10. Display details of a deal\n";
+            std::cout << "11. Display list of borrowers and lenders\n";
+            std::cout << "12. Display the facilities\n";
+            std::cout << "13. Display the parts\n";
+            std::cout << "14. Export the book (columnar)\n";
+            std::cout << "15. Print the book report\n";
+            std::cout << "16. Terminate matured deals\n";
+            std::cout << "17. Serve the book on a local socket\n";
+            std::cout << "18. Price the book (NPV, IRR, yield)\n";
+            std::cout << "19. Accrue interest to a date\n";
+            std::cout << "20. Archive terminated deals\n";
+            std::cout << "21. Import deals from a CSV file\n";
+            std::cout << "22. Display a deal as of a past date\n";
+            std::cout << "23. Trade a facility participation\n";
+            std::cout << "24. Set covenant limits and show breaches\n";
+            std::cout << "25. Reconcile the book against a CSV copy\n";
+            std::cout << "26. Export book changes to a file\n";
+            std::cout << "27. Compute book totals across shard processes\n";
+            std::cout << "0. Exit\n";
+            std::cout << "---------------------------------------\n";
+            std::cout << "Enter your choice: ";
+
+            int choice;
+            std::cin >> choice;
+
+            switch (choice) {
+                case 1:
+                    createDeal();
+                    break;
+                case 2:
+                    borrowers.push_back(createBorrower());
+                    break;
+                case 3:
+                    lenders.push_back(createLender());
+                    break;
+                case 4:
+                    addLenderToPool();
+                    break;
+                case 5:
+                    createFacility();
+                    break;
+                case 6:
+                    pay();
+                    break;
+                case 7:
+                    if (!facilities.empty() && book.getFacility(facilities[0]).getPartsCount() > 0) {
+                        const Facility& facility = book.getFacility(facilities[0]);
+                        std::cout << "Calculate the interest of first part\n";
+                        std::cout << "The interest is: " << facility.calculateInterest(facility.getParts()[0]) << std::endl;
+                    } else {
+                        std::cout << "No parts available for interest calculation.\n";
+                    }
+                    break;
+                case 8:
+                    std::cout << "The total interest accumulated is: " << portfolio.getTotalInterest() << std::endl;
+                    std::cout << "The total amount is: " << portfolio.getTotalAmount() << std::endl;
+                    std::cout << "Amount should be repaid: " << portfolio.getTotalRemboursement() << std::endl;
+                    // Registre : courus jusqu'au dernier paiement ou arrêté (menu 19)
+                    std::cout << "The interest accrued to the last accrual date is: " 
+                              << portfolio.getAccruedInterest() << std::endl;
+                    break;
+                case 9:
+                    if (book.getDealsCount() > 0) {
+                        book.setStatus(book.getHandle(0), Deal::Status::TERMINATED);
+                        std::cout << "Deal terminated successfully.\n";
+                    } else {
+                        std::cout << "No deals to terminate.\n";
+                    }
+                    break;
+                case 10:
+                    if (book.getDealsCount() > 0) {
+                        BufferWriter out(std::cout);
+                        TextReportRenderer::writeDealDetails(out, book.getDeal(book.getHandle(0)));
+                    } else {
+                        std::cout << "No deals to display.\n";
+                    }
+                    break;
+                case 11: {
+                    BufferWriter out(std::cout);
+                    out << "List of lenders:\n";
+                    for (const auto& lender : lenders) {
+                        out << "- " << lender.getName() << '\n';
+                    }
+                    out << "\nList of borrowers:\n";
+                    for (const auto& borrower : borrowers) {
+                        out << "- " << borrower.getName() << '\n';
+                    }
+                    break;
+                }
+                case 12:
+                    displayFacilities();
+                    break;
+                case 13:
+                    displayParts();
+                    break;
+                case 14:
+                    exportBook();
+                    break;
+                case 15:
+                    printReport();
+                    break;
+                case 16:
+                    sweepMaturities();
+                    break;
+                case 17:
+                    serveBook();
+                    break;
+                case 18:
+                    priceBook();
+                    break;
+                case 19:
+                    accrueInterest();
+                    break;
+                case 20:
+                    archiveTerminated();
+                    portfolio = Portfolio(book, facilities);
+                    break;
+                case 21:
+                    importDeals();
+                    break;
+                case 22:
+                    showDealAsOf();
+                    break;
+                case 23:
+                    tradeParticipation();
+                    break;
+                case 24:
+                    manageCovenants();
+                    break;
+                case 25:
+                    reconcileBook();
+                    break;
+                case 26:
+                    exportChanges();
+                    break;
+                case 27:
+                    computeOnShards();
+                    break;
+                case 0:
+                    std::cout << "Goodbye!\n";
+                    return 0;
+                default:
+                    std::cout << "Invalid choice. Please enter a number between 0 and 27.\n";
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
+
+void pay() {
+    if (facilities.empty()) {
+        std::cout << "No facilities available for payment.\n";
+        return;
+    }
+
+    double amount;
+    std::string date;
+    std::cout << "Enter the amount to pay: ";
+    std::cin >> amount;
+    std::cout << "Enter the date of payment (YYYY-MM-DD): ";
+    std::cin >> date;
+
+    try {
+        const Facility& facility = book.getFacility(facilities[0]);
+        if (facility.getRemainingAmount() < amount) {
+            std::cout << "Payment amount exceeds remaining facility amount.\n";
+        } else {
+            book.payPart(facilities[0], amount, date);
+            std::cout << "Payment successful!\n";
+            std::cout << "Remaining amount: " << facility.getRemainingAmount() << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cout << "Payment failed: " << e.what() << std::endl;
+    }
+}
+
+void createFacility() {
+    if (book.getDealsCount() == 0) {
+        std::cout << "No deals available. Create a deal first.\n";
+        return;
+    }
+
+    std::string currency;
+    double amount;
+    double annualInterestRate;
+    std::vector<Lender> selectedLenders;
+
+    std::cout << "Enter the amount: ";
+    std::cin >> amount;
+    std::cout << "Enter the currency: ";
+    std::cin >> currency;
+    std::cout << "Enter the annual interest rate (e.g., 0.05 for 5%): ";
+    std::cin >> annualInterestRate;
+
+    // Sélection des lenders
+    int lenderCount;
+    std::cout << "How many lenders would you like to add to this facility? ";
+    std::cin >> lenderCount;
+
+    for (int i = 0; i < lenderCount; i++) {
+        std::string lenderName;
+        std::cout << "Enter the name of lender " << (i+1) << ": ";
+        std::cin >> lenderName;
+
+        auto it = std::find_if(lenders.begin(), lenders.end(), 
+                              [&lenderName](const Lender& lender) {
+            return lender.getName() == lenderName;
+        });
+
+        if (it != lenders.end()) {
+            selectedLenders.push_back(*it);
+        } else {
+            std::cout << "Lender " << lenderName << " not found.\n";
+        }
+    }
+
+    try {
+        DealHandle deal = book.getHandle(0);
+        Facility facility(book.getDeal(deal).getContractSignDate(), book.getDeal(deal).getContractEndDate(), 
+                         amount, currency, selectedLenders, annualInterestRate);
+        
+        FacilityHandle handle = book.addFacility(deal, std::move(facility));
+        facilities.push_back(handle);
+        std::cout << "Facility created successfully!\n";
+
+        const std::string& borrower = book.getDeal(deal).getBorrower().getName();
+        if (borrowerIndex.isBreached(borrower, currency)) {
+            std::cout << "Warning: concentration limit breached for " << borrower
+                      << " (outstanding: " << borrowerIndex.getOutstanding(borrower, currency).toDouble()
+                      << " " << currency << ")\n";
+        }
+    } catch (const std::exception& e) {
+        std::cout << "Failed to create facility: " << e.what() << std::endl;
+    }
+}
+
+void createDeal() {
+    std::string contract_num;
+    std::string agent;
+    double project_amount;
+    std::string currency;
+    std::string contract_sign_date;
+    std::string contract_end_date;
+
+    std::cout << "\nEnter contract number (Format: Letter + 4 digits, e.g., S1234): ";
+    std::cin >> contract_num;
+    std::cout << "\nEnter agent: ";
+    std::cin >> agent;
+    std::cout << "\nEnter project amount: ";
+    std::cin >> project_amount;
+    std::cout << "\nEnter currency (3 letters, e.g., EUR): ";
+    std::cin >> currency;
+    std::cout << "\nEnter contract sign date (YYYY-MM-DD): ";
+    std::cin >> contract_sign_date;
+    std::cout << "\nEnter contract end date (YYYY-MM-DD): ";
+    std::cin >> contract_end_date;
+
+    try {
+        if (borrowers.empty()) {
+            std::cout << "No borrowers available. Create a borrower first.\n";
+            return;
+        }
+
+        if (coldBook().isArchived(contract_num)) {
+            std::cout << "Contract " << contract_num << " is already archived.\n";
+            return;
+        }
+        book.addDeal(Deal(contract_num, agent, lenders, borrowers[0], project_amount, 
+                          currency, contract_sign_date, contract_end_date, Deal::Status::CLOSED));
+        std::cout << "Deal created successfully!\n";
+    } catch (const std::exception& e) {
+        std::cout << "Failed to create deal: " << e.what() << std::endl;
+    }
+}
+
+Borrower createBorrower() {
+    std::string name;
+    std::cout << "Enter borrower's name: ";
+    std::cin >> name;
+
+    try {
+        return Borrower(name);
+    } catch (const std::exception& e) {
+        std::cout << "Failed to create borrower: " << e.what() << std::endl;
+        return Borrower();  // Retourne le constructeur par défaut
+    }
+}
+
+Lender createLender() {
+    std::string name;
+    std::cout << "Enter lender's name: ";
+    std::cin >> name;
+
+    try {
+        return Lender(name);
+    } catch (const std::exception& e) {
+        std::cout << "Failed to create lender: " << e.what() << std::endl;
+        throw;  // Re-lancer l'exception car Lender n'a pas de constructeur par défaut
+    }
+}
+
+void addLenderToPool() {
+    std::string lenderName;
+    std::cout << "Enter the lender's name: ";
+    std::cin >> lenderName;
+
+    auto it = std::find_if(lenders.begin(), lenders.end(), 
+                          [&lenderName](const Lender& lender) {
+        return lender.getName() == lenderName;
+    });
+
+    if (it != lenders.end()) {
+        pool.push_back(*it);
+        std::cout << "Lender " << lenderName << " added to the pool.\n";
+    } else {
+        std::cout << "Error: Lender " << lenderName << " does not exist.\n";
+    }
+}
+
+void displayFacilities() {
+    if (facilities.empty()) {
+        std::cout << "No facilities to display.\n";
+        return;
+    }
+
+    BufferWriter out(std::cout);
+    out << "\n=== FACILITIES ===\n";
+    for (size_t i = 0; i < facilities.size(); i++) {
+        const Facility& facility = book.getFacility(facilities[i]);
+        out << "Facility " << static_cast<uint64_t>(i+1) << ":\n";
+        out << "  Amount: " << facility.getAmount() << " " << facility.getCurrency() << '\n';
+        out << "  Remaining: " << facility.getRemainingAmount() << '\n';
+        out << "  Interest Rate: " << (facility.getAnnualInterestRate() * 100) << "%\n";
+        out << "  Parts Count: " << static_cast<uint64_t>(facility.getPartsCount()) << '\n';
+        out << "  Start Date: " << facility.getStartDate() << '\n';
+        out << "  End Date: " << facility.getEndDate() << '\n';
+        out << "-------------------\n";
+        out.endBlock();
+    }
+}
+
+void displayParts() {
+    if (facilities.empty()) {
+        std::cout << "No facilities available.\n";
+        return;
+    }
+
+    BufferWriter out(std::cout);
+    out << "\n=== PARTS ===\n";
+    for (size_t i = 0; i < facilities.size(); i++) {
+        out << "Facility " << static_cast<uint64_t>(i+1) << " Parts:\n";
+        const PartHistory& parts = book.getFacility(facilities[i]).getParts();
+        
+        if (parts.empty()) {
+            out << "  No parts in this facility.\n";
+        } else {
+            uint64_t j = 0;
+            for (const Part& part : parts) {
+                out << "  Part " << ++j << ": " << part.getAmount() << " on " << part.getDate() << '\n';
+            }
+        }
+        out << "-------------------\n";
+        out.endBlock();
+    }
+}
+
+void exportBook() {
+    std::string directory;
+    std::cout << "Enter the export directory: ";
+    std::cin >> directory;
+
+    try {
+        ColumnarExporter exporter(directory);
+        size_t rows = exporter.exportBook(book.getDeals());
+        std::cout << rows << " rows exported to " << directory << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << "Export failed: " << e.what() << std::endl;
+    }
+}
+
+void printReport() {
+    std::string format;
+    std::cout << "Enter the report format (text, csv, json): ";
+    std::cin >> format;
+
+    BufferWriter out(std::cout);
+    if (format == "text") {
+        TextReportRenderer(out).render(book.getDeals());
+    } else if (format == "csv") {
+        CsvReportRenderer(out).render(book.getDeals());
+    } else if (format == "json") {
+        JsonReportRenderer(out).render(book.getDeals());
+    } else {
+        std::cout << "Unknown report format: " << format << std::endl;
+    }
+}
+
+void sweepMaturities() {
+    std::string date;
+    std::cout << "Enter the current date (YYYY-MM-DD): ";
+    std::cin >> date;
+
+    try {
+        size_t terminated = calendar.sweep(date);
+        std::cout << terminated << " deal(s) terminated.\n";
+    } catch (const std::exception& e) {
+        std::cout << "Sweep failed: " << e.what() << std::endl;
+    }
+}
+
+void serveBook() {
+    std::string path;
+    std::cout << "Enter the socket path: ";
+    std::cin >> path;
+
+    try {
+        BookServer server(book, path);
+        server.setArchive(&coldBook());
+        server.start();
+        std::cout << "Serving the book on " << path << ". Press Enter to stop.\n";
+        std::string line;
+        std::getline(std::cin, line);
+        std::getline(std::cin, line);
+        server.stop();
+        std::cout << server.getRequestsCount() << " request(s) served in " 
+                  << server.getBatchesCount() << " batch(es).\n";
+    } catch (const std::exception& e) {
+        std::cout << "Server failed: " << e.what() << std::endl;
+    }
+}
+
+// Courbe et moteur d'évaluation gardés pour la session : les solutions d'une évaluation
+// servent de point de départ à la suivante, même après un changement de taux
+FlatCurve& discountCurve() {
+    static FlatCurve curve(0.0);
+    return curve;
+}
+
+PricingEngine& pricingEngine() {
+    static PricingEngine engine(discountCurve());
+    return engine;
+}
+
+void priceBook() {
+    std::string date;
+    double rate;
+    std::cout << "Enter the valuation date (YYYY-MM-DD): ";
+    std::cin >> date;
+    std::cout << "Enter the flat discount rate (e.g., 0.03 for 3%): ";
+    std::cin >> rate;
+
+    try {
+        discountCurve() = FlatCurve(rate);
+        PricingEngine& engine = pricingEngine();
+        BufferWriter out(std::cout);
+        for (const FacilityPricing& result : engine.priceBook(book.getDeals(), date)) {
+            out << result.contractNum << " facility " << static_cast<uint64_t>(result.facilityIndex + 1) << ": NPV ";
+            out.fixed(result.npv, 2);
+            if (result.converged) {
+                out << ", IRR ";
+                out.fixed(result.irr * 100, 4) << "%, yield ";
+                out.fixed(result.yield * 100, 4) << "%\n";
+            } else {
+                out << ", IRR/yield not available\n";
+            }
+            out.endBlock();
+        }
+        out << static_cast<uint64_t>(engine.getLastEvaluations()) << " solver evaluation(s)\n";
+        out.endBlock();
+    } catch (const std::exception& e) {
+        std::cout << "Pricing failed: " << e.what() << std::endl;
+    }
+}
+
+void accrueInterest() {
+    std::string date;
+    std::cout << "Enter the accrual date (YYYY-MM-DD): ";
+    std::cin >> date;
+
+    try {
+        book.accrueTo(date);
+        Portfolio portfolio(book, book.getFacilityHandles());
+        std::cout << "The total interest accrued is: " << portfolio.getAccruedInterest() << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << "Accrual failed: " << e.what() << std::endl;
+    }
+}
+
+// Segments froids du répertoire local, ouverts au premier usage et gardés pour les
+// recherches des contrats sortis du book actif
+TieredBook& coldBook() {
+    static TieredBook tiers(book, "cold_book");
+    return tiers;
+}
+
+void archiveTerminated() {
+    try {
+        TieredBook& tiers = coldBook();
+        size_t archived = tiers.archiveTerminated();
+
+        // Les handles des facilities archivées ne sont plus valides
+        facilities.erase(std::remove_if(facilities.begin(), facilities.end(),
+                                        [](FacilityHandle handle) { return !book.isValid(handle); }),
+                         facilities.end());
+        std::cout << archived << " deal(s) archived, " << tiers.getArchivedDealsCount() 
+                  << " deal(s) in " << tiers.getSegmentsCount() << " cold segment(s).\n";
+    } catch (const std::exception& e) {
+        std::cout << "Archiving failed: " << e.what() << std::endl;
+    }
+}
+
+void importDeals() {
+    std::string path;
+    std::cout << "Enter the path of the CSV file: ";
+    std::cin >> path;
+
+    try {
+        ImportPipeline pipeline(book);
+        ImportPipeline::Report report = pipeline.runFile(path);
+        for (const ImportPipeline::ImportError& error : report.errors) {
+            std::cout << "Line " << error.line << ": " << error.message << std::endl;
+        }
+        std::cout << report.deals << " deal(s), " << report.facilities << " facility(ies) and " 
+                  << report.parts << " part(s) imported in " << report.seconds << " s.\n";
+        for (const ImportPipeline::StageStats& stage : report.stages) {
+            std::cout << "  " << stage.name << ": " << stage.records << " record(s), " 
+                      << stage.busySeconds << " s busy, " << stage.stalls << " stall(s)\n";
+        }
+    } catch (const std::exception& e) {
+        std::cout << "Import failed: " << e.what() << std::endl;
+    }
+}
+
+void showDealAsOf() {
+    std::string contractNum;
+    std::string date;
+    std::cout << "Enter the contract number: ";
+    std::cin >> contractNum;
+    std::cout << "Enter the date (YYYY-MM-DD): ";
+    std::cin >> date;
+
+    try {
+        std::shared_ptr<const DealVersion> version = history.dealAsOf(contractNum, date);
+        if (!version && history.getVersionsCount(contractNum) == 0 && coldBook().isArchived(contractNum)) {
+            // Archivé lors d'une session précédente : seul l'état final est conservé
+            std::cout << "No recorded history for " << contractNum << ", archived final state:\n";
+            BufferWriter out(std::cout);
+            TextReportRenderer::writeDealDetails(out, coldBook().loadArchived(contractNum));
+            return;
+        }
+        if (!version) {
+            std::cout << "No recorded state for " << contractNum << " on " << date << ".\n";
+            return;
+        }
+        // Seules les parts effectives à la date sont retenues dans la version renvoyée
+        std::cout << "Deal " << contractNum << " as of " << date << " (version of " << toDateString(version->day) << ")\n";
+        std::cout << "  Agent: " << version->agent << "\n";
+        std::cout << "  Status: " << (version->status == Deal::Status::CLOSED ? "closed" : "terminated") << "\n";
+        for (size_t i = 0; i < version->facilities.size(); i++) {
+            const FacilityVersion& facility = *version->facilities[i];
+            std::cout << "  Facility " << i + 1 << ": remaining " << facility.remaining.toDouble() 
+                      << ", " << facility.parts.size() << " part(s), accrued interest " 
+                      << facility.accruedInterestAt(toDayNumber(date)) << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cout << "Lookup failed: " << e.what() << std::endl;
+    }
+}
+
+void tradeParticipation() {
+    if (facilities.empty()) {
+        std::cout << "No facilities available for trading.\n";
+        return;
+    }
+
+    size_t number;
+    std::string side;
+    std::string lender;
+    double quantity;
+    double price;
+    std::cout << "Enter the facility number: ";
+    std::cin >> number;
+    std::cout << "Buy or sell (b/s): ";
+    std::cin >> side;
+    std::cout << "Enter the lender name: ";
+    std::cin >> lender;
+    std::cout << "Enter the amount of participation: ";
+    std::cin >> quantity;
+    std::cout << "Enter the price (% of par): ";
+    std::cin >> price;
+
+    try {
+        if (number < 1 || number > facilities.size()) {
+            throw std::out_of_range("Facility number out of range");
+        }
+        FacilityHandle handle = facilities[number - 1];
+        ParticipationMarket::Side orderSide = side == "s" ? ParticipationMarket::Side::SELL 
+                                                          : ParticipationMarket::Side::BUY;
+        market.clearTrades();
+        ParticipationMarket::OrderId order = market.submit(orderSide, handle, lender, quantity, price);
+        for (const ParticipationMarket::Trade& trade : market.getTrades()) {
+            std::cout << market.getLenderName(trade.seller) << " sold " << trade.quantity.toDouble() 
+                      << " to " << market.getLenderName(trade.buyer) << " at " << trade.price << "%\n";
+        }
+        if (market.isActive(order)) {
+            std::cout << "Order resting for " << market.getRemaining(order).toDouble() << ".\n";
+        }
+
+        const Facility& facility = book.getFacility(handle);
+        std::cout << "Lenders of facility " << number << ":\n";
+        for (size_t i = 0; i < facility.getLenders().size(); i++) {
+            std::cout << "  " << facility.getLenders()[i].getName() << ": " 
+                      << facility.getShares()[i].toDouble() << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cout << "Order failed: " << e.what() << std::endl;
+    }
+}
+
+void manageCovenants() {
+    std::string kind;
+    std::cout << "Limit to set (lender/borrower/currency/pace, or none): ";
+    std::cin >> kind;
+
+    try {
+        if (kind == "lender" || kind == "borrower") {
+            std::string name;
+            std::string currency;
+            double limit;
+            std::cout << "Enter the " << kind << " name: ";
+            std::cin >> name;
+            std::cout << "Enter the currency: ";
+            std::cin >> currency;
+            std::cout << "Enter the maximum outstanding: ";
+            std::cin >> limit;
+            if (kind == "lender") {
+                covenants.setLenderLimit(name, currency, limit);
+            } else {
+                covenants.setBorrowerLimit(name, currency, limit);
+            }
+        } else if (kind == "currency") {
+            std::string currency;
+            double limit;
+            std::cout << "Enter the currency: ";
+            std::cin >> currency;
+            std::cout << "Enter the maximum outstanding: ";
+            std::cin >> limit;
+            covenants.setCurrencyLimit(currency, limit);
+        } else if (kind == "pace") {
+            double ratio;
+            std::cout << "Enter the minimum share of the linear schedule (0 to 1): ";
+            std::cin >> ratio;
+            covenants.setMinimumRepaymentPace(ratio);
+        }
+
+        const char* rules[] = {"lender outstanding", "borrower outstanding", "currency outstanding", "repayment pace"};
+        const char* events[] = {"new limit", "deal added", "facility added", "part paid", "shares transferred",
+                                "interest accrual"};
+        if (covenants.getBreaches().empty()) {
+            std::cout << "No covenant breach.\n";
+        }
+        for (const CovenantEngine::Breach& breach : covenants.getBreaches()) {
+            std::cout << "Breach of " << rules[static_cast<int>(breach.rule)] << " for " << breach.subject << ": " 
+                      << breach.value.toDouble() << " " << breach.currency.toString() << " (limit " 
+                      << breach.limit.toDouble() << "), on " << events[static_cast<int>(breach.event)];
+            if (!breach.contractNum.empty()) {
+                std::cout << " of " << breach.contractNum << " facility " << breach.facilityIndex + 1;
+            }
+            std::cout << (breach.date.empty() ? "" : " dated " + breach.date) << "\n";
+        }
+        covenants.clearBreaches();
+    } catch (const std::exception& e) {
+        std::cout << "Covenant update failed: " << e.what() << std::endl;
+    }
+}
+
+void reconcileBook() {
+    std::string path;
+    std::cout << "Enter the path of the CSV copy (import format): ";
+    std::cin >> path;
+
+    try {
+        BookStore copy;
+        ImportPipeline pipeline(copy);
+        ImportPipeline::Report imported = pipeline.runFile(path);
+        if (!imported.errors.empty()) {
+            std::cout << imported.errors.size() << " line(s) of the copy could not be loaded.\n";
+        }
+        BookDigest copyDigest(copy);
+        BookDigest::Report report = digest.compare(copyDigest);
+        if (report.differences.empty()) {
+            std::cout << "Books match (" << report.comparedNodes << " hash(es) compared).\n";
+            return;
+        }
+        for (const BookDigest::Difference& difference : report.differences) {
+            std::cout << difference.contractNum << ": ";
+            if (difference.kind == BookDigest::Kind::ONLY_HERE) {
+                std::cout << "missing from the copy\n";
+            } else if (difference.kind == BookDigest::Kind::ONLY_THERE) {
+                std::cout << "only in the copy\n";
+            } else {
+                std::cout << (difference.termsChanged ? "deal terms differ" : "deal terms match");
+                for (size_t facility : difference.facilities) {
+                    std::cout << ", facility " << facility + 1 << " differs";
+                }
+                std::cout << "\n";
+            }
+        }
+        std::cout << report.differences.size() << " difference(s), " << report.comparedNodes << " hash(es) compared.\n";
+    } catch (const std::exception& e) {
+        std::cout << "Reconciliation failed: " << e.what() << std::endl;
+    }
+}
+
+void exportChanges() {
+    std::string path;
+    uint64_t from;
+    std::cout << "Enter the path of the change file (appended): ";
+    std::cin >> path;
+    std::cout << "Resume from sequence (0 for the oldest kept, next is " << changes.getNextSequence() << "): ";
+    std::cin >> from;
+
+    try {
+        ChangeFileSink sink(changes, path, from == 0 ? changes.getOldestSequence() : from);
+        size_t written = sink.drain();
+        std::cout << written << " change(s) written, next sequence " << sink.getNextSequence() << ".\n";
+    } catch (const std::exception& e) {
+        std::cout << "Change export failed: " << e.what() << std::endl;
+    }
+}
+
+void computeOnShards() {
+    size_t count;
+    int byBorrower;
+    std::cout << "Enter the number of shard processes: ";
+    std::cin >> count;
+    std::cout << "Partition by contract range (0) or by borrower (1): ";
+    std::cin >> byBorrower;
+
+    try {
+        ShardCoordinator coordinator(count, byBorrower == 1 ? ShardCoordinator::Partition::BORROWER
+                                                            : ShardCoordinator::Partition::CONTRACT_RANGE);
+        coordinator.load(book);
+        for (size_t i = 0; i < coordinator.getShardsCount(); i++) {
+            std::cout << "Shard " << i + 1 << ": " << coordinator.getDealsCount(i) << " deal(s)\n";
+        }
+        protocol::PortfolioTotals totals = coordinator.portfolio();
+        std::cout << "Total amount: " << totals.amount.toDouble() << ", interest: " << totals.interest.toDouble() 
+                  << ", accrued interest: " << totals.accrued.toDouble() << ", remaining: " << totals.remaining.toDouble() << ", " << totals.partsCount << " part(s)\n";
+    } catch (const std::exception& e) {
+        std::cout << "Shard computation failed: " << e.what() << std::endl;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include "Money.h"
+#include <cmath>
+#include <stdexcept>
+
+Money Money::fromDouble(double amount) {
+    return fromDouble(amount, 3);
+}
+
+Money Money::fromDouble(double amount, int decimals) {
+    if (decimals < 0 || decimals > 3) {
+        throw std::invalid_argument("Money supports 0 to 3 decimals");
+    }
+    if (!std::isfinite(amount)) {
+        throw std::invalid_argument("Amount must be a finite number");
+    }
+
+    // Arrondi à l'unité mineure puis mise à l'échelle exacte en millièmes
+    static const double factors[] = {1.0, 10.0, 100.0, 1000.0};
+    double scaled = std::round(amount * factors[decimals]);
+    if (std::fabs(scaled) > 9.0e15 / factors[3 - decimals]) {
+        throw std::invalid_argument("Amount out of range");
+    }
+    return Money(static_cast<int64_t>(scaled) * static_cast<int64_t>(factors[3 - decimals]));
+}
+
+Money Money::fromDouble(double amount, const std::string& currency) {
+    return fromDouble(amount, minorUnitDigits(currency));
+}
+
+Money Money::fromDouble(double amount, CurrencyCode currency) {
+    return fromDouble(amount, currency.minorUnitDigits());
+}
+
+int Money::minorUnitDigits(const std::string& currency) {
+    return CurrencyCode::isValid(currency) ? CurrencyCode::parse(currency).minorUnitDigits() : 2;
+}
+
+Money Money::sum(const std::vector<Money>& values) {
+    // Boucle sur des entiers contigus : vectorisable et sans erreur d'arrondi
+    int64_t total = 0;
+    for (const Money& value : values) {
+        total += value.units;
+    }
+    return Money(total);
+}
+
+double Money::toDouble() const {
+    return static_cast<double>(units) / UNITS_PER_MAJOR;
+}
+
+std::string Money::toString() const {
+    int64_t absolute = units < 0 ? -units : units;
+    std::string fraction = std::to_string(absolute % UNITS_PER_MAJOR);
+    fraction.insert(0, 3 - fraction.size(), '0');
+    return (units < 0 ? "-" : "") + std::to_string(absolute / UNITS_PER_MAJOR) + "." + fraction;
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "CurrencyCode.h"
+
+// Montant en virgule fixe : entier 64 bits en millièmes d'unité monétaire, ce qui
+// représente exactement les unités mineures de toutes les devises (0, 2 ou 3 décimales).
+// Les sommes sont exactes et indépendantes de l'ordre ; l'arrondi n'intervient
+// qu'aux conversions depuis un double (saisie, calcul d'intérêts).
+class Money {
+public:
+    static constexpr int64_t UNITS_PER_MAJOR = 1000;
+
+    constexpr Money() : units(0) {}
+
+    static constexpr Money fromUnits(int64_t units) {
+        return Money(units);
+    }
+
+    // Conversion arrondie (demi-unité loin de zéro) à l'unité mineure de la devise
+    static Money fromDouble(double amount);
+    static Money fromDouble(double amount, int decimals);
+    static Money fromDouble(double amount, const std::string& currency);
+    static Money fromDouble(double amount, CurrencyCode currency);
+
+    // Nombre de décimales de l'unité mineure d'une devise (ISO 4217)
+    static int minorUnitDigits(const std::string& currency);
+
+    // Somme exacte d'un tableau contigu de montants
+    static Money sum(const std::vector<Money>& values);
+
+    constexpr int64_t getUnits() const { return units; }
+    double toDouble() const;
+    std::string toString() const;
+
+    constexpr Money operator+(Money other) const { return Money(units + other.units); }
+    constexpr Money operator-(Money other) const { return Money(units - other.units); }
+    constexpr Money operator-() const { return Money(-units); }
+    Money& operator+=(Money other) { units += other.units; return *this; }
+    Money& operator-=(Money other) { units -= other.units; return *this; }
+
+    constexpr bool operator==(Money other) const { return units == other.units; }
+    constexpr bool operator!=(Money other) const { return units != other.units; }
+    constexpr bool operator<(Money other) const { return units < other.units; }
+    constexpr bool operator<=(Money other) const { return units <= other.units; }
+    constexpr bool operator>(Money other) const { return units > other.units; }
+    constexpr bool operator>=(Money other) const { return units >= other.units; }
+
+private:
+    int64_t units;
+
+    constexpr explicit Money(int64_t units) : units(units) {}
+};
+
+#endif
\ No newline at end of file
@@ -1,22 +1,31 @@
-#ifndef PART_H
-#define PART_H
-
-#include <string>
-#include <stdexcept>
-
-class Part {
-public:
-    Part(double amount, const std::string& date);
-    
-    double getAmount() const;
-    const std::string& getDate() const;
-
-private:
-    double amount;
-    std::string date;
-    
-    void validateAmount(double amount) const;
-    void validateDate(const std::string& date) const;
-};
-
+#ifndef PART_H
+#define PART_H
+
+#include <string>
+#include <stdexcept>
+#include "Money.h"
+
+class Part {
+public:
+    Part(double amount, const std::string& date);
+    Part(Money amount, const std::string& date);
+    
+    double getAmount() const;
+    Money getMoney() const;
+    const std::string& getDate() const;
+
+private:
+    friend class PartHistory;
+
+    // Part relue d'un historique : montant et date déjà validés
+    struct Trusted {};
+    Part(Money amount, std::string date, Trusted);
+
+    Money amount;
+    std::string date;
+    
+    void validateAmount(Money amount) const;
+    void validateDate(const std::string& date) const;
+};
+
 #endif
\ No newline at end of file
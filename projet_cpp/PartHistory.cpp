@@ -0,0 +1,259 @@
+#include "PartHistory.h"
+#include "DateUtils.h"
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void putSigned(std::vector<uint8_t>& out, int64_t value) {
+    putVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+uint64_t getVarint(const std::vector<uint8_t>& in, size_t& pos) {
+    uint64_t value = 0;
+    for (int shift = 0;; shift += 7) {
+        uint8_t byte = in[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+}
+
+int64_t getSigned(const std::vector<uint8_t>& in, size_t& pos) {
+    uint64_t value = getVarint(in, pos);
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+}
+
+// Itérateur
+
+PartHistory::const_iterator::const_iterator(const PartHistory* history, size_t index)
+    : history(history), index(index), block(0), datePos(0), runPos(0), runLeft(0), day(0), units(0) {
+    if (index >= history->count) {
+        this->index = history->count;
+        return;
+    }
+    // Décodage depuis le début du bloc de la part
+    block = index / BLOCK_SIZE;
+    this->index = block * BLOCK_SIZE;
+    enterBlock();
+    decode();
+    while (this->index < index) {
+        ++*this;
+    }
+}
+
+Part PartHistory::const_iterator::operator*() const {
+    return Part(getMoney(), toDateString(day), Part::Trusted());
+}
+
+PartHistory::const_iterator& PartHistory::const_iterator::operator++() {
+    index++;
+    if (index >= history->count) {
+        index = history->count;
+        return *this;
+    }
+    if (index % BLOCK_SIZE == 0) {
+        block++;
+        enterBlock();
+    }
+    decode();
+    return *this;
+}
+
+PartHistory::const_iterator PartHistory::const_iterator::operator++(int) {
+    const_iterator previous = *this;
+    ++*this;
+    return previous;
+}
+
+bool PartHistory::const_iterator::operator==(const const_iterator& other) const {
+    return history == other.history && index == other.index;
+}
+
+bool PartHistory::const_iterator::operator!=(const const_iterator& other) const {
+    return !(*this == other);
+}
+
+int PartHistory::const_iterator::getDay() const {
+    return day;
+}
+
+Money PartHistory::const_iterator::getMoney() const {
+    return Money::fromUnits(units * history->unitsPerMinor);
+}
+
+void PartHistory::const_iterator::enterBlock() {
+    units = 0;
+    runLeft = 0;
+    if (block < history->blocks.size()) {
+        const Block& sealed = history->blocks[block];
+        day = sealed.firstDay;
+        runPos = sealed.dictionarySize * sizeof(int64_t);
+        datePos = sealed.datesOffset;
+    } else {
+        day = history->tailFirstDay;
+        datePos = 0;
+    }
+}
+
+void PartHistory::const_iterator::decode() {
+    if (block < history->blocks.size()) {
+        const Block& sealed = history->blocks[block];
+        day += static_cast<int>(getSigned(sealed.bytes, datePos));
+        if (runLeft == 0) {
+            uint64_t entry = getVarint(sealed.bytes, runPos);
+            runLeft = getVarint(sealed.bytes, runPos);
+            std::memcpy(&units, sealed.bytes.data() + entry * sizeof(int64_t), sizeof(int64_t));
+        }
+        runLeft--;
+    } else {
+        day += static_cast<int>(getSigned(history->tail, datePos));
+        units += getSigned(history->tail, datePos);
+    }
+}
+
+// Historique
+
+PartHistory::PartHistory(int minorUnitDigits)
+    : count(0), unitsPerMinor(Money::UNITS_PER_MAJOR), tailFirstDay(0), lastDay(0), lastUnits(0) {
+    if (minorUnitDigits < 0 || minorUnitDigits > 3) {
+        throw std::invalid_argument("Part history supports 0 to 3 decimals");
+    }
+    for (int i = 0; i < minorUnitDigits; i++) {
+        unitsPerMinor /= 10;
+    }
+}
+
+void PartHistory::push_back(const Part& part) {
+    int day = toDayNumber(part.getDate());
+    if (part.getMoney().getUnits() % unitsPerMinor != 0) {
+        throw std::invalid_argument("Part amount is below the minor unit of the history");
+    }
+    int64_t units = part.getMoney().getUnits() / unitsPerMinor;
+    if (tail.empty()) {
+        tailFirstDay = day;
+        putSigned(tail, 0);
+        putSigned(tail, units);
+    } else {
+        putSigned(tail, static_cast<int64_t>(day) - lastDay);
+        putSigned(tail, units - lastUnits);
+    }
+    lastDay = day;
+    lastUnits = units;
+    count++;
+    if (count % BLOCK_SIZE == 0) {
+        seal();
+    }
+}
+
+size_t PartHistory::size() const {
+    return count;
+}
+
+bool PartHistory::empty() const {
+    return count == 0;
+}
+
+Part PartHistory::operator[](size_t index) const {
+    if (index >= count) {
+        throw std::out_of_range("Part index out of range");
+    }
+    return *const_iterator(this, index);
+}
+
+Part PartHistory::front() const {
+    return (*this)[0];
+}
+
+Part PartHistory::back() const {
+    if (count == 0) {
+        throw std::out_of_range("Part index out of range");
+    }
+    return Part(Money::fromUnits(lastUnits * unitsPerMinor), toDateString(lastDay), Part::Trusted());
+}
+
+PartHistory::const_iterator PartHistory::begin() const {
+    return const_iterator(this, 0);
+}
+
+PartHistory::const_iterator PartHistory::end() const {
+    return const_iterator(this, count);
+}
+
+size_t PartHistory::getBlocksCount() const {
+    return blocks.size() + (tail.empty() ? 0 : 1);
+}
+
+size_t PartHistory::getMemoryBytes() const {
+    size_t bytes = sizeof(PartHistory) + blocks.capacity() * sizeof(Block) + tail.capacity();
+    for (const Block& block : blocks) {
+        bytes += block.bytes.capacity();
+    }
+    return bytes;
+}
+
+void PartHistory::seal() {
+    // Relecture du bloc ouvert
+    std::vector<int> days;
+    std::vector<int64_t> amounts;
+    days.reserve(BLOCK_SIZE);
+    amounts.reserve(BLOCK_SIZE);
+    size_t pos = 0;
+    int day = tailFirstDay;
+    int64_t units = 0;
+    while (pos < tail.size()) {
+        day += static_cast<int>(getSigned(tail, pos));
+        units += getSigned(tail, pos);
+        days.push_back(day);
+        amounts.push_back(units);
+    }
+
+    // Dictionnaire des montants distincts et plages de montants égaux
+    std::vector<int64_t> dictionary;
+    std::vector<std::pair<uint64_t, uint64_t>> runs;
+    for (int64_t amount : amounts) {
+        size_t entry = 0;
+        while (entry < dictionary.size() && dictionary[entry] != amount) {
+            entry++;
+        }
+        if (entry == dictionary.size()) {
+            dictionary.push_back(amount);
+        }
+        if (!runs.empty() && runs.back().first == entry) {
+            runs.back().second++;
+        } else {
+            runs.push_back({entry, 1});
+        }
+    }
+
+    Block block;
+    block.firstDay = days.front();
+    block.dictionarySize = static_cast<uint32_t>(dictionary.size());
+    block.bytes.resize(dictionary.size() * sizeof(int64_t));
+    std::memcpy(block.bytes.data(), dictionary.data(), block.bytes.size());
+    for (const std::pair<uint64_t, uint64_t>& run : runs) {
+        putVarint(block.bytes, run.first);
+        putVarint(block.bytes, run.second);
+    }
+    block.datesOffset = static_cast<uint32_t>(block.bytes.size());
+    int previous = block.firstDay;
+    for (int partDay : days) {
+        putSigned(block.bytes, static_cast<int64_t>(partDay) - previous);
+        previous = partDay;
+    }
+    block.bytes.shrink_to_fit();
+    blocks.push_back(std::move(block));
+    tail.clear();
+}
\ No newline at end of file
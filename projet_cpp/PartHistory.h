@@ -0,0 +1,105 @@
+#ifndef PART_HISTORY_H
+#define PART_HISTORY_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include "Part.h"
+#include "Money.h"
+
+// Historique compressé des remboursements d'une facility.
+//
+// Les montants sont codés en unités mineures de la devise de la facility (centimes pour
+// EUR, unités pour JPY) : des écarts varints dix fois plus petits qu'en millièmes.
+// Les parts sont rangées par blocs de BLOCK_SIZE. Un bloc plein est scellé en colonnes :
+// dictionnaire des montants distincts du bloc (8 octets chacun), montants
+// codés en plages (indice dans le dictionnaire, longueur) et dates en écarts de jours
+// (varints zigzag : une part antidatée reste possible). Le dernier bloc, ouvert, garde
+// ses parts en écarts de jour et de montant jusqu'à ce qu'il soit plein.
+//
+// Les parts sont décodées à la volée, bloc par bloc : l'itérateur produit des Part par
+// valeur et donne aussi le jour et le montant sans construire la Part. L'accès par
+// indice décode depuis le début du bloc de la part.
+class PartHistory {
+public:
+    static const size_t BLOCK_SIZE = 128;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Part;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Part*;
+        using reference = Part;
+
+        Part operator*() const;
+        const_iterator& operator++();
+        const_iterator operator++(int);
+        bool operator==(const const_iterator& other) const;
+        bool operator!=(const const_iterator& other) const;
+
+        // Valeurs décodées de la part courante, sans construire la Part
+        int getDay() const;
+        Money getMoney() const;
+
+    private:
+        friend class PartHistory;
+        const_iterator(const PartHistory* history, size_t index);
+
+        const PartHistory* history;
+        size_t index;
+        size_t block;
+        size_t datePos;    // Écarts de dates (bloc scellé) ou enregistrements (bloc ouvert)
+        size_t runPos;
+        uint64_t runLeft;
+        int day;
+        int64_t units;
+
+        void enterBlock();
+        void decode();
+    };
+
+    using iterator = const_iterator;
+
+    // minorUnitDigits : décimales de la devise des parts (3 : millièmes, sans perte)
+    explicit PartHistory(int minorUnitDigits = 3);
+
+    // La date de la part doit être une date valide et son montant un multiple de l'unité
+    // mineure (Facility les contrôle avant l'ajout)
+    void push_back(const Part& part);
+
+    size_t size() const;
+    bool empty() const;
+    Part operator[](size_t index) const;
+    Part front() const;
+    Part back() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    size_t getBlocksCount() const;
+    // Octets occupés (objet, blocs et bloc ouvert)
+    size_t getMemoryBytes() const;
+
+private:
+    struct Block {
+        int firstDay;
+        uint32_t dictionarySize;
+        uint32_t datesOffset;
+        // [dictionnaire : montants de 8 octets][plages : varints][écarts de dates : varints]
+        std::vector<uint8_t> bytes;
+    };
+
+    std::vector<Block> blocks;
+    std::vector<uint8_t> tail;   // Bloc ouvert : écart de jour, écart de montant (varints zigzag)
+    size_t count;
+    int64_t unitsPerMinor;   // Millièmes de Money par unité mineure codée
+    int tailFirstDay;
+    int lastDay;
+    int64_t lastUnits;       // En unités mineures, comme tout le codage
+
+    void seal();
+};
+
+#endif
\ No newline at end of file
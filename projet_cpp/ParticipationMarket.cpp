@@ -0,0 +1,402 @@
+#include "ParticipationMarket.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+ParticipationMarket::ParticipationMarket(BookStore& book, size_t capacity)
+    : book(book), freeOrders(NONE), freeLevels(NONE), activeCount(0) {
+    validateCapacity(capacity);
+    // Un emplacement de plus pour l'ordre entrant quand le carnet est plein ; un niveau
+    // contient au moins un ordre, autant de niveaux que d'ordres suffit
+    orders.resize(capacity + 1);
+    levels.resize(capacity + 1);
+    for (size_t i = capacity + 1; i-- > 0;) {
+        orders[i] = {0, false, Side::BUY, 0, 0, NONE, NONE, freeOrders, Money()};
+        freeOrders = static_cast<uint32_t>(i);
+        levels[i] = {0, NONE, NONE, NONE, freeLevels};
+        freeLevels = static_cast<uint32_t>(i);
+    }
+    trades.reserve(capacity);
+    book.addObserver(this);
+}
+
+ParticipationMarket::~ParticipationMarket() {
+    book.removeObserver(this);
+}
+
+ParticipationMarket::OrderId ParticipationMarket::submit(Side side, FacilityHandle facility, const std::string& lender,
+                                                         double quantity, double price) {
+    const Facility& target = book.getFacility(facility);   // Exception si le handle est invalide
+    Money amount = Money::fromDouble(quantity, target.getCurrencyCode());
+    validateQuantity(amount, target);
+    int32_t ticks = validatePrice(price);
+    if (lender.empty()) {
+        throw std::invalid_argument("Lender name cannot be empty");
+    }
+
+    uint32_t lenderId = lenderOf(lender);
+    uint32_t bookId = bookOf(facility);
+    const FacilityBook& facilityBook = books[bookId];
+    uint32_t best = side == Side::BUY ? facilityBook.asks : facilityBook.bids;
+    bool crosses = best != NONE && (side == Side::BUY ? levels[best].price <= ticks : levels[best].price >= ticks);
+    if (activeCount == getCapacity() && !crosses) {
+        throw std::length_error("Order pool exhausted");
+    }
+    if (side == Side::SELL) {
+        Money available = target.getShare(lender) - reservedOf(books[bookId], lenderId);
+        if (amount > available) {
+            throw std::invalid_argument("Sell order exceeds the share available to " + lender);
+        }
+    }
+
+    uint32_t slot = freeOrders;
+    Order& order = orders[slot];
+    freeOrders = order.next;
+    order.active = true;
+    order.side = side;
+    order.lender = lenderId;
+    order.book = bookId;
+    order.level = NONE;
+    order.previous = NONE;
+    order.next = NONE;
+    order.remaining = amount;
+    activeCount++;
+
+    OrderId id = idOf(slot);
+    match(slot, ticks);
+    // Carnet plein : le reliquat d'un ordre exécuté en partie n'est pas placé
+    if (orders[slot].remaining > Money() && activeCount <= getCapacity()) {
+        rest(slot, ticks);
+    } else {
+        release(slot);
+    }
+    return id;
+}
+
+bool ParticipationMarket::cancel(OrderId order) {
+    uint32_t slot = slotOf(order);
+    if (slot == NONE) {
+        return false;
+    }
+    unlink(slot);
+    release(slot);
+    return true;
+}
+
+bool ParticipationMarket::isActive(OrderId order) const {
+    return slotOf(order) != NONE;
+}
+
+Money ParticipationMarket::getRemaining(OrderId order) const {
+    uint32_t slot = slotOf(order);
+    return slot == NONE ? Money() : orders[slot].remaining;
+}
+
+size_t ParticipationMarket::getActiveOrdersCount() const {
+    return activeCount;
+}
+
+size_t ParticipationMarket::getCapacity() const {
+    return orders.size() - 1;
+}
+
+double ParticipationMarket::getBestBid(FacilityHandle facility) const {
+    auto it = bookIndex.find(facility);
+    if (it == bookIndex.end() || books[it->second].bids == NONE) {
+        return 0;
+    }
+    return levels[books[it->second].bids].price / 100.0;
+}
+
+double ParticipationMarket::getBestAsk(FacilityHandle facility) const {
+    auto it = bookIndex.find(facility);
+    if (it == bookIndex.end() || books[it->second].asks == NONE) {
+        return 0;
+    }
+    return levels[books[it->second].asks].price / 100.0;
+}
+
+const std::vector<ParticipationMarket::Trade>& ParticipationMarket::getTrades() const {
+    return trades;
+}
+
+void ParticipationMarket::clearTrades() {
+    trades.clear();
+}
+
+const std::string& ParticipationMarket::getLenderName(uint32_t lender) const {
+    if (lender >= lenderNames.size()) {
+        throw std::out_of_range("Unknown lender identifier");
+    }
+    return lenderNames[lender];
+}
+
+void ParticipationMarket::match(uint32_t slot, int32_t price) {
+    Order& incoming = orders[slot];
+    FacilityBook& facilityBook = books[incoming.book];
+    bool buying = incoming.side == Side::BUY;
+
+    while (incoming.remaining > Money()) {
+        uint32_t best = buying ? facilityBook.asks : facilityBook.bids;
+        if (best == NONE || (buying ? levels[best].price > price : levels[best].price < price)) {
+            return;
+        }
+        uint32_t restingSlot = levels[best].head;
+        Order& resting = orders[restingSlot];
+        if (resting.lender == incoming.lender) {
+            // Pas d'exécution contre soi-même : l'ordre en attente est retiré
+            unlink(restingSlot);
+            release(restingSlot);
+            continue;
+        }
+
+        const Order& sell = buying ? resting : incoming;
+        const Order& buy = buying ? incoming : resting;
+        const std::string& seller = lenderNames[sell.lender];
+        Money quantity = std::min(incoming.remaining, resting.remaining);
+        if (book.getFacility(facilityBook.facility).getShare(seller) < quantity) {
+            // Participation cédée hors du marché depuis l'ordre : la vente n'est plus honorable
+            if (buying) {
+                unlink(restingSlot);
+                release(restingSlot);
+                continue;
+            }
+            incoming.remaining = Money();
+            return;
+        }
+
+        book.transferShare(facilityBook.facility, seller, lenderNames[buy.lender], quantity);
+        trades.push_back({idOf(buying ? slot : restingSlot), idOf(buying ? restingSlot : slot),
+                          facilityBook.facility, buy.lender, sell.lender, levels[best].price / 100.0, quantity});
+
+        incoming.remaining -= quantity;
+        resting.remaining -= quantity;
+        if (buying) {
+            reservedOf(facilityBook, resting.lender) -= quantity;
+        }
+        if (resting.remaining == Money()) {
+            unlink(restingSlot);
+            release(restingSlot);
+        }
+    }
+}
+
+void ParticipationMarket::rest(uint32_t slot, int32_t price) {
+    Order& order = orders[slot];
+    FacilityBook& facilityBook = books[order.book];
+    bool buying = order.side == Side::BUY;
+    uint32_t& best = buying ? facilityBook.bids : facilityBook.asks;
+
+    // Recherche du niveau du prix, du meilleur au moins bon
+    uint32_t better = NONE;
+    uint32_t current = best;
+    while (current != NONE && (buying ? levels[current].price > price : levels[current].price < price)) {
+        better = current;
+        current = levels[current].worse;
+    }
+    if (current == NONE || levels[current].price != price) {
+        uint32_t created = freeLevels;
+        freeLevels = levels[created].worse;
+        levels[created] = {price, NONE, NONE, better, current};
+        if (current != NONE) {
+            levels[current].better = created;
+        }
+        if (better != NONE) {
+            levels[better].worse = created;
+        } else {
+            best = created;
+        }
+        current = created;
+    }
+
+    Level& level = levels[current];
+    order.level = current;
+    order.previous = level.tail;
+    order.next = NONE;
+    if (level.tail != NONE) {
+        orders[level.tail].next = slot;
+    } else {
+        level.head = slot;
+    }
+    level.tail = slot;
+    if (!buying) {
+        reservedOf(facilityBook, order.lender) += order.remaining;
+    }
+}
+
+void ParticipationMarket::unlink(uint32_t slot) {
+    Order& order = orders[slot];
+    if (order.level == NONE) {
+        return;
+    }
+    FacilityBook& facilityBook = books[order.book];
+    if (order.side == Side::SELL) {
+        reservedOf(facilityBook, order.lender) -= order.remaining;
+    }
+
+    Level& level = levels[order.level];
+    if (order.previous != NONE) {
+        orders[order.previous].next = order.next;
+    } else {
+        level.head = order.next;
+    }
+    if (order.next != NONE) {
+        orders[order.next].previous = order.previous;
+    } else {
+        level.tail = order.previous;
+    }
+
+    if (level.head == NONE) {
+        // Niveau vide : retiré de la liste de son côté et rendu au pool
+        uint32_t& best = order.side == Side::BUY ? facilityBook.bids : facilityBook.asks;
+        if (level.better != NONE) {
+            levels[level.better].worse = level.worse;
+        } else {
+            best = level.worse;
+        }
+        if (level.worse != NONE) {
+            levels[level.worse].better = level.better;
+        }
+        level.worse = freeLevels;
+        freeLevels = order.level;
+    }
+    order.level = NONE;
+}
+
+void ParticipationMarket::release(uint32_t slot) {
+    Order& order = orders[slot];
+    order.active = false;
+    order.generation++;
+    order.remaining = Money();
+    order.next = freeOrders;
+    freeOrders = slot;
+    activeCount--;
+}
+
+size_t ParticipationMarket::getBooksCount() const {
+    return books.size();
+}
+
+void ParticipationMarket::onDealAdded(const Deal&) {}
+
+void ParticipationMarket::onFacilityAdded(const Deal&, size_t) {}
+
+void ParticipationMarket::onPartPaid(const Deal&, size_t) {}
+
+void ParticipationMarket::onSharesTransferred(const Deal&, size_t) {
+    // Une cession hors marché est contrôlée à l'exécution (participation du vendeur)
+}
+
+void ParticipationMarket::onInterestAccrued(const Deal&, size_t) {}
+
+void ParticipationMarket::onStatusChanged(const Deal&) {}
+
+void ParticipationMarket::onAgentChanged(const Deal&) {}
+
+void ParticipationMarket::onDealRemoved(const Deal& deal) {
+    DealHandle handle = book.findDeal(deal.getContractNumber());
+    for (size_t f = 0; f < deal.getFacilitiesCount(); f++) {
+        auto it = bookIndex.find({handle, static_cast<uint32_t>(f)});
+        if (it != bookIndex.end()) {
+            closeBook(it->second);
+        }
+    }
+}
+
+void ParticipationMarket::closeBook(uint32_t bookId) {
+    // Ordres en attente annulés : emplacements, niveaux et réservations rendus au pool
+    for (uint32_t* side : {&books[bookId].bids, &books[bookId].asks}) {
+        while (*side != NONE) {
+            uint32_t slot = levels[*side].head;
+            unlink(slot);
+            release(slot);
+        }
+    }
+    bookIndex.erase(books[bookId].facility);
+
+    // Le dernier carnet prend la place libérée ; ses ordres sont renumérotés
+    uint32_t last = static_cast<uint32_t>(books.size() - 1);
+    if (bookId != last) {
+        books[bookId] = std::move(books[last]);
+        bookIndex[books[bookId].facility] = bookId;
+        for (uint32_t level : {books[bookId].bids, books[bookId].asks}) {
+            for (; level != NONE; level = levels[level].worse) {
+                for (uint32_t slot = levels[level].head; slot != NONE; slot = orders[slot].next) {
+                    orders[slot].book = bookId;
+                }
+            }
+        }
+    }
+    books.pop_back();
+}
+
+uint32_t ParticipationMarket::lenderOf(const std::string& name) {
+    auto it = lenderIds.find(name);
+    if (it != lenderIds.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(lenderNames.size());
+    lenderNames.push_back(name);
+    lenderIds.emplace(name, id);
+    return id;
+}
+
+uint32_t ParticipationMarket::bookOf(FacilityHandle facility) {
+    auto it = bookIndex.find(facility);
+    if (it != bookIndex.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(books.size());
+    books.push_back({facility, NONE, NONE, {}});
+    bookIndex.emplace(facility, id);
+    return id;
+}
+
+Money& ParticipationMarket::reservedOf(FacilityBook& facilityBook, uint32_t lender) {
+    for (Reservation& reservation : facilityBook.reserved) {
+        if (reservation.lender == lender) {
+            return reservation.amount;
+        }
+    }
+    facilityBook.reserved.push_back({lender, Money()});
+    return facilityBook.reserved.back().amount;
+}
+
+ParticipationMarket::OrderId ParticipationMarket::idOf(uint32_t slot) const {
+    return static_cast<OrderId>(orders[slot].generation) << 32 | slot;
+}
+
+uint32_t ParticipationMarket::slotOf(OrderId order) const {
+    uint32_t slot = static_cast<uint32_t>(order);
+    if (slot >= orders.size() || !orders[slot].active || orders[slot].generation != static_cast<uint32_t>(order >> 32)) {
+        return NONE;
+    }
+    return slot;
+}
+
+void ParticipationMarket::validateCapacity(size_t capacity) const {
+    if (capacity == 0 || capacity >= NONE - 1) {
+        throw std::invalid_argument("Invalid order capacity");
+    }
+}
+
+void ParticipationMarket::validateQuantity(Money quantity, const Facility& facility) const {
+    if (quantity <= Money()) {
+        throw std::invalid_argument("Order quantity must be positive");
+    }
+    if (quantity > facility.getAmountMoney()) {
+        throw std::invalid_argument("Order quantity exceeds the facility amount");
+    }
+}
+
+int32_t ParticipationMarket::validatePrice(double price) const {
+    // Pourcentage du pair arrondi au point de base
+    if (!std::isfinite(price) || price <= 0 || price > 1000) {
+        throw std::invalid_argument("Price must be between 0% and 1000% of par");
+    }
+    int32_t ticks = static_cast<int32_t>(std::llround(price * 100));
+    if (ticks <= 0) {
+        throw std::invalid_argument("Price must be between 0% and 1000% of par");
+    }
+    return ticks;
+}
\ No newline at end of file
@@ -0,0 +1,153 @@
+#ifndef PARTICIPATION_MARKET_H
+#define PARTICIPATION_MARKET_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "BookStore.h"
+#include "Money.h"
+
+// Marché secondaire des participations : un carnet d'ordres limites par facility,
+// priorité prix puis ancienneté. Chaque exécution est réglée aussitôt par une cession
+// de participation dans le BookStore (vérifiée avant modification, donc atomique).
+//
+// Les ordres et les niveaux de prix vivent dans des pools préalloués à la construction,
+// chaînés par indices : soumettre, exécuter ou annuler un ordre n'alloue rien (seuls le
+// premier ordre d'une facility ou d'un prêteur et la croissance du journal des
+// exécutions allouent). Les prix sont en pourcentage du pair, au point de base près.
+//
+// Observateur du book : au retrait d'un deal (archivage), les carnets de ses facilities
+// sont fermés, leurs ordres annulés et les ventes réservées rendues au pool.
+class ParticipationMarket : public BookObserver {
+public:
+    enum class Side { BUY, SELL };
+
+    // Emplacement dans le pool + génération : un identifiant d'ordre terminé reste invalide
+    using OrderId = uint64_t;
+
+    struct Trade {
+        OrderId buyOrder;
+        OrderId sellOrder;
+        FacilityHandle facility;
+        uint32_t buyer;    // Identifiants de prêteurs, voir getLenderName
+        uint32_t seller;
+        double price;      // Prix de l'ordre en attente
+        Money quantity;
+    };
+
+    static const size_t DEFAULT_CAPACITY = 65536;
+
+    explicit ParticipationMarket(BookStore& book, size_t capacity = DEFAULT_CAPACITY);
+    ~ParticipationMarket() override;
+
+    ParticipationMarket(const ParticipationMarket&) = delete;
+    ParticipationMarket& operator=(const ParticipationMarket&) = delete;
+
+    // Ordre limite : exécuté contre le carnet opposé tant que les prix se croisent, le
+    // reste est placé dans le carnet. Un vendeur ne peut pas offrir plus que sa
+    // participation moins ses ventes en attente. Face à un ordre du même prêteur,
+    // l'ordre en attente est annulé. Carnet plein : un ordre qui ne croise pas est
+    // rejeté, le reliquat d'un ordre qui croise n'est pas placé.
+    OrderId submit(Side side, FacilityHandle facility, const std::string& lender, double quantity, double price);
+    // Faux si l'ordre est déjà exécuté ou annulé
+    bool cancel(OrderId order);
+
+    bool isActive(OrderId order) const;
+    Money getRemaining(OrderId order) const;
+    size_t getActiveOrdersCount() const;
+    size_t getCapacity() const;
+
+    // Meilleurs prix du carnet d'une facility, 0 si le côté est vide
+    double getBestBid(FacilityHandle facility) const;
+    double getBestAsk(FacilityHandle facility) const;
+
+    // Journal des exécutions, vidé par clearTrades (la capacité est conservée)
+    const std::vector<Trade>& getTrades() const;
+    void clearTrades();
+    const std::string& getLenderName(uint32_t lender) const;
+    size_t getBooksCount() const;
+
+    void onDealAdded(const Deal& deal) override;
+    void onFacilityAdded(const Deal& deal, size_t facilityIndex) override;
+    void onPartPaid(const Deal& deal, size_t facilityIndex) override;
+    void onSharesTransferred(const Deal& deal, size_t facilityIndex) override;
+    void onInterestAccrued(const Deal& deal, size_t facilityIndex) override;
+    void onStatusChanged(const Deal& deal) override;
+    void onAgentChanged(const Deal& deal) override;
+    void onDealRemoved(const Deal& deal) override;
+
+private:
+    static const uint32_t NONE = UINT32_MAX;
+
+    struct Order {
+        uint32_t generation;
+        bool active;
+        Side side;
+        uint32_t lender;
+        uint32_t book;
+        uint32_t level;
+        uint32_t previous;   // File du niveau de prix
+        uint32_t next;       // File du niveau de prix, ou liste des emplacements libres
+        Money remaining;
+    };
+
+    // Niveau de prix : file FIFO d'ordres, niveaux d'un côté chaînés du meilleur au moins bon
+    struct Level {
+        int32_t price;
+        uint32_t head;
+        uint32_t tail;
+        uint32_t better;
+        uint32_t worse;      // Ou liste des niveaux libres
+    };
+
+    struct Reservation {
+        uint32_t lender;
+        Money amount;
+    };
+
+    struct FacilityBook {
+        FacilityHandle facility;
+        uint32_t bids;       // Meilleur niveau acheteur
+        uint32_t asks;       // Meilleur niveau vendeur
+        std::vector<Reservation> reserved;   // Ventes en attente par prêteur
+    };
+
+    struct FacilityHandleHash {
+        size_t operator()(const FacilityHandle& handle) const {
+            uint64_t key = (static_cast<uint64_t>(handle.deal.index) << 32 | handle.deal.generation) * 31 +
+                           handle.index;
+            return std::hash<uint64_t>()(key);
+        }
+    };
+
+    BookStore& book;
+    std::vector<Order> orders;
+    std::vector<Level> levels;
+    uint32_t freeOrders;
+    uint32_t freeLevels;
+    size_t activeCount;
+    std::vector<FacilityBook> books;
+    std::unordered_map<FacilityHandle, uint32_t, FacilityHandleHash> bookIndex;
+    std::vector<std::string> lenderNames;
+    std::unordered_map<std::string, uint32_t> lenderIds;
+    std::vector<Trade> trades;
+
+    uint32_t lenderOf(const std::string& name);
+    uint32_t bookOf(FacilityHandle facility);
+    Money& reservedOf(FacilityBook& facilityBook, uint32_t lender);
+    OrderId idOf(uint32_t slot) const;
+    uint32_t slotOf(OrderId order) const;
+
+    void match(uint32_t slot, int32_t price);
+    void rest(uint32_t slot, int32_t price);
+    void unlink(uint32_t slot);
+    void release(uint32_t slot);
+    void closeBook(uint32_t bookId);
+
+    void validateCapacity(size_t capacity) const;
+    void validateQuantity(Money quantity, const Facility& facility) const;
+    int32_t validatePrice(double price) const;
+};
+
+#endif
\ No newline at end of file
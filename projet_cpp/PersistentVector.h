@@ -0,0 +1,135 @@
+#ifndef PERSISTENT_VECTOR_H
+#define PERSISTENT_VECTOR_H
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Vecteur immuable à partage de structure : arbre de branchement 32 dont les feuilles
+// portent les valeurs. pushBack et set renvoient un nouveau vecteur en ne recopiant que
+// le chemin modifié (au plus log32(n) nœuds) ; les versions précédentes restent
+// intactes et partagent le reste de l'arbre. Accès en O(log32 n).
+template <typename T>
+class PersistentVector {
+public:
+    PersistentVector() : count(0), shift(0) {}
+
+    size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    const T& operator[](size_t index) const {
+        const Node* node = root.get();
+        for (unsigned level = shift; level > 0; level -= BITS) {
+            node = node->children[(index >> level) & MASK].get();
+        }
+        return node->values[index & MASK];
+    }
+
+    const T& at(size_t index) const {
+        if (index >= count) {
+            throw std::out_of_range("Persistent vector index out of range");
+        }
+        return (*this)[index];
+    }
+
+    const T& back() const {
+        return at(count - 1);
+    }
+
+    PersistentVector pushBack(T value) const {
+        PersistentVector result;
+        result.count = count + 1;
+        if (!root) {
+            result.root = path(0, std::move(value));
+            return result;
+        }
+        if (count == (static_cast<size_t>(1) << (shift + BITS))) {
+            // Racine pleine : un niveau de plus, l'ancienne racine devient le premier enfant
+            auto grown = std::make_shared<Node>();
+            grown->children.push_back(root);
+            grown->children.push_back(path(shift, std::move(value)));
+            result.root = grown;
+            result.shift = shift + BITS;
+            return result;
+        }
+        result.root = pushInto(*root, shift, count, std::move(value));
+        result.shift = shift;
+        return result;
+    }
+
+    PersistentVector set(size_t index, T value) const {
+        if (index >= count) {
+            throw std::out_of_range("Persistent vector index out of range");
+        }
+        PersistentVector result(*this);
+        result.root = setInto(*root, shift, index, std::move(value));
+        return result;
+    }
+
+    std::vector<T> toVector() const {
+        std::vector<T> values;
+        values.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            values.push_back((*this)[i]);
+        }
+        return values;
+    }
+
+private:
+    static const unsigned BITS = 5;
+    static const size_t MASK = (1 << BITS) - 1;
+
+    struct Node {
+        std::vector<std::shared_ptr<const Node>> children;
+        std::vector<T> values;
+    };
+
+    std::shared_ptr<const Node> root;
+    size_t count;
+    unsigned shift;
+
+    static std::shared_ptr<const Node> path(unsigned level, T value) {
+        auto node = std::make_shared<Node>();
+        if (level == 0) {
+            node->values.push_back(std::move(value));
+        } else {
+            node->children.push_back(path(level - BITS, std::move(value)));
+        }
+        return node;
+    }
+
+    static std::shared_ptr<const Node> pushInto(const Node& node, unsigned level, size_t index, T value) {
+        auto copy = std::make_shared<Node>(node);
+        if (level == 0) {
+            copy->values.push_back(std::move(value));
+            return copy;
+        }
+        size_t child = (index >> level) & MASK;
+        if (child < copy->children.size()) {
+            copy->children[child] = pushInto(*copy->children[child], level - BITS, index, std::move(value));
+        } else {
+            copy->children.push_back(path(level - BITS, std::move(value)));
+        }
+        return copy;
+    }
+
+    static std::shared_ptr<const Node> setInto(const Node& node, unsigned level, size_t index, T value) {
+        auto copy = std::make_shared<Node>(node);
+        if (level == 0) {
+            copy->values[index & MASK] = std::move(value);
+        } else {
+            size_t child = (index >> level) & MASK;
+            copy->children[child] = setInto(*copy->children[child], level - BITS, index, std::move(value));
+        }
+        return copy;
+    }
+};
+
+#endif
\ No newline at end of file
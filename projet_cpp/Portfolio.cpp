@@ -1,38 +1,179 @@
-#include "Portfolio.h"
-#include <stdexcept>
-
-Portfolio::Portfolio(const Facility* facility) : facility(facility) {
-    validateFacility(facility);
-}
-
-double Portfolio::getTotalAmount() const {
-    return facility->getAmount();
-}
-
-double Portfolio::getTotalInterest() const {
-    double total = 0;
-    const std::vector<Part>& parts = facility->getParts();
-    
-    for (const Part& part : parts) {
-        total += facility->calculateInterest(part);
-    }
-    return total;
-}
-
-double Portfolio::getTotalRemboursement() const {
-    return getTotalAmount() + getTotalInterest();
-}
-
-size_t Portfolio::getNumberOfParts() const {
-    return facility->getPartsCount();
-}
-
-double Portfolio::getRemainingAmount() const {
-    return facility->getRemainingAmount();
-}
-
-void Portfolio::validateFacility(const Facility* facility) const {
-    if (facility == nullptr) {
-        throw std::invalid_argument("Facility cannot be null");
-    }
+#include "Portfolio.h"
+#include "TaskScheduler.h"
+#include <atomic>
+#include <stdexcept>
+
+Portfolio::Portfolio(const Facility* facility) : book(nullptr) {
+    addFacility(facility);
+}
+
+Portfolio::Portfolio(const std::vector<const Facility*>& facilities) : book(nullptr) {
+    for (const Facility* facility : facilities) {
+        addFacility(facility);
+    }
+}
+
+Portfolio::Portfolio(const BookStore& book, const std::vector<FacilityHandle>& handles) : book(&book) {
+    for (FacilityHandle handle : handles) {
+        addFacility(handle);
+    }
+}
+
+Portfolio::Portfolio(std::shared_ptr<const BookSnapshot> snapshot, const std::vector<FacilityHandle>& handles)
+    : book(nullptr), pinned(std::move(snapshot)) {
+    if (!pinned) {
+        throw std::invalid_argument("Book snapshot cannot be null");
+    }
+    for (FacilityHandle handle : handles) {
+        addFacility(handle);
+    }
+}
+
+void Portfolio::addFacility(const Facility* facility) {
+    validateFacility(facility);
+    facilities.push_back(facility);
+    handles.push_back({{0, 0}, 0});
+    cache.push_back({0, false, 0, Money(), Money(), Money()});
+}
+
+void Portfolio::addFacility(FacilityHandle handle) {
+    pin();
+    if (!pinned) {
+        throw std::invalid_argument("Portfolio is not bound to a book");
+    }
+    if (!pinned->isValid(handle)) {
+        throw std::invalid_argument("Invalid facility handle");
+    }
+    facilities.push_back(nullptr);
+    handles.push_back(handle);
+    cache.push_back({0, false, 0, Money(), Money(), Money()});
+}
+
+size_t Portfolio::getFacilitiesCount() const {
+    return facilities.size();
+}
+
+double Portfolio::getTotalAmount() const {
+    return getTotalAmountMoney().toDouble();
+}
+
+double Portfolio::getTotalInterest() const {
+    return getTotalInterestMoney().toDouble();
+}
+
+double Portfolio::getTotalRemboursement() const {
+    return getTotalAmount() + getTotalInterest();
+}
+
+double Portfolio::getAccruedInterest() const {
+    return getAccruedInterestMoney().toDouble();
+}
+
+size_t Portfolio::getNumberOfParts() const {
+    pin();
+    size_t total = 0;
+    for (size_t i = 0; i < facilities.size(); i++) {
+        total += facilityAt(i).getPartsCount();
+    }
+    return total;
+}
+
+double Portfolio::getRemainingAmount() const {
+    return getRemainingMoney().toDouble();
+}
+
+Money Portfolio::getTotalAmountMoney() const {
+    pin();
+    Money total;
+    for (size_t i = 0; i < facilities.size(); i++) {
+        total += facilityAt(i).getAmountMoney();
+    }
+    return total;
+}
+
+Money Portfolio::getTotalInterestMoney() const {
+    refresh();
+    return totalInterest;
+}
+
+Money Portfolio::getTotalRemboursementMoney() const {
+    return getTotalAmountMoney() + getTotalInterestMoney();
+}
+
+Money Portfolio::getAccruedInterestMoney() const {
+    refresh();
+    return totalAccrued;
+}
+
+Money Portfolio::getRemainingMoney() const {
+    refresh();
+    return totalRemaining;
+}
+
+const Facility& Portfolio::facilityAt(size_t i) const {
+    if (facilities[i] != nullptr) {
+        return *facilities[i];
+    }
+    return pinned->getFacility(handles[i]);
+}
+
+void Portfolio::pin() const {
+    if (book != nullptr) {
+        pinned = book->snapshot();
+    }
+}
+
+void Portfolio::refresh() const {
+    pin();
+    // Seules les facilities modifiées depuis la dernière requête sont recalculées,
+    // par tranches réparties sur l'ordonnanceur pour un grand portfolio
+    std::atomic<bool> changed(false);
+    TaskScheduler::shared().parallelFor(0, facilities.size(), REFRESH_GRAIN, [this, &changed](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const Facility& facility = facilityAt(i);
+            CachedResult& entry = cache[i];
+            if (entry.valid && entry.version == facility.getVersion()) {
+                continue;
+            }
+            
+            if (!entry.valid || entry.partsCount != facility.getPartsCount()) {
+                entry.interest = computeInterest(facility);
+                entry.partsCount = facility.getPartsCount();
+            }
+            // Intérêts tenus à jour par le registre de la facility, sans parcourir ses parts
+            entry.accrued = facility.getAccruedInterestMoney();
+            entry.remaining = facility.getRemainingMoney();
+            entry.version = facility.getVersion();
+            entry.valid = true;
+            changed.store(true, std::memory_order_relaxed);
+        }
+    });
+    
+    if (!changed.load()) {
+        return;
+    }
+    
+    totalInterest = Money();
+    totalAccrued = Money();
+    totalRemaining = Money();
+    for (const CachedResult& entry : cache) {
+        totalInterest += entry.interest;
+        totalAccrued += entry.accrued;
+        totalRemaining += entry.remaining;
+    }
+}
+
+Money Portfolio::computeInterest(const Facility& facility) {
+    // Arrondi à l'unité mineure pour chaque intérêt calculé, sommes exactes ensuite
+    Money total;
+    for (const Part& part : facility.getParts()) {
+        total += facility.calculateInterestMoney(part);
+    }
+    return total;
+}
+
+void Portfolio::validateFacility(const Facility* facility) const {
+    if (facility == nullptr) {
+        throw std::invalid_argument("Facility cannot be null");
+    }
 }
\ No newline at end of file
@@ -1,23 +1,74 @@
-#ifndef PORTFOLIO_H
-#define PORTFOLIO_H
-
-#include "Facility.h"
-
-class Portfolio {
-public:
-    explicit Portfolio(const Facility* facility);
-    
-    double getTotalAmount() const;
-    double getTotalInterest() const;
-    double getTotalRemboursement() const;
-    
-    size_t getNumberOfParts() const;
-    double getRemainingAmount() const;
-
-private:
-    const Facility* facility;
-    
-    void validateFacility(const Facility* facility) const;
-};
-
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include <vector>
+#include <cstdint>
+#include <memory>
+#include "Facility.h"
+#include "Money.h"
+#include "BookStore.h"
+
+class Portfolio {
+public:
+    explicit Portfolio(const Facility* facility);
+    explicit Portfolio(const std::vector<const Facility*>& facilities);
+    // Portfolio adossé au book : chaque requête lit la dernière version publiée du book,
+    // gardée le temps du calcul ; les écritures ne sont jamais bloquées
+    Portfolio(const BookStore& book, const std::vector<FacilityHandle>& handles);
+    // Portfolio figé sur une version du book
+    Portfolio(std::shared_ptr<const BookSnapshot> snapshot, const std::vector<FacilityHandle>& handles);
+    
+    void addFacility(const Facility* facility);
+    void addFacility(FacilityHandle handle);
+    size_t getFacilitiesCount() const;
+    
+    double getTotalAmount() const;
+    // Somme des intérêts composés de chaque part (Facility::calculateInterest)
+    double getTotalInterest() const;
+    double getTotalRemboursement() const;
+    // Intérêts courus des registres des facilities (jusqu'à leur dernier paiement ou arrêté)
+    double getAccruedInterest() const;
+    
+    size_t getNumberOfParts() const;
+    double getRemainingAmount() const;
+    
+    // Totaux exacts en virgule fixe, indépendants de l'ordre des facilities
+    Money getTotalAmountMoney() const;
+    Money getTotalInterestMoney() const;
+    Money getTotalRemboursementMoney() const;
+    Money getAccruedInterestMoney() const;
+    Money getRemainingMoney() const;
+
+private:
+    // Facilities par tâche lors d'un recalcul parallèle
+    static const size_t REFRESH_GRAIN = 512;
+
+    // Résultats mis en cache par facility, associés à la version de la facility ; les
+    // intérêts par part ne dépendent que des parts et ne sont repris qu'à leur changement
+    struct CachedResult {
+        uint64_t version;
+        bool valid;
+        size_t partsCount;
+        Money interest;
+        Money accrued;
+        Money remaining;
+    };
+
+    // Pour chaque facility : pointeur direct, ou handle résolu dans la version retenue
+    const BookStore* book;
+    mutable std::shared_ptr<const BookSnapshot> pinned;
+    std::vector<const Facility*> facilities;
+    std::vector<FacilityHandle> handles;
+    mutable std::vector<CachedResult> cache;
+    mutable Money totalInterest;
+    mutable Money totalAccrued;
+    mutable Money totalRemaining;
+    
+    const Facility& facilityAt(size_t i) const;
+    void pin() const;
+    void refresh() const;
+    static Money computeInterest(const Facility& facility);
+    void validateFacility(const Facility* facility) const;
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,357 @@
+#include "Pricing.h"
+#include "DateUtils.h"
+#include "YieldCurve.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+const double LOWER_RATE = -0.99;
+const double UPPER_RATE = 10.0;
+
+// Taux annuel appliqué à la période [fromDay, toDay] d'une facility
+
+double periodRate(const Facility& facility, const CurveStore* curves, int fromDay, int toDay) {
+    if (curves == nullptr || !facility.isFloating()) {
+        return facility.getAnnualInterestRate();
+    }
+    return curves->get(facility.getCurveCurrency()).forwardRate(fromDay, toDay) + facility.getSpread();
+}
+
+std::vector<CashFlow> buildCashFlows(const Facility& facility, const CurveStore* curves) {
+    int start = toDayNumber(facility.getStartDate());
+    int end = toDayNumber(facility.getEndDate());
+
+    std::vector<CashFlow> repayments;
+    for (const Part& part : facility.getParts()) {
+        repayments.push_back({toDayNumber(part.getDate()), part.getAmount()});
+    }
+    std::stable_sort(repayments.begin(), repayments.end(),
+                     [](const CashFlow& a, const CashFlow& b) { return a.day < b.day; });
+
+    std::vector<CashFlow> flows;
+    flows.reserve(repayments.size() + 2);
+    flows.push_back({start, -facility.getAmount()});
+
+    double balance = facility.getAmount();
+    int last = start;
+    for (const CashFlow& repayment : repayments) {
+        double rate = periodRate(facility, curves, last, repayment.day);
+        double interest = balance * rate * (repayment.day - last) / 365.0;
+        flows.push_back({repayment.day, repayment.amount + interest});
+        balance -= repayment.amount;
+        last = repayment.day;
+    }
+
+    int maturity = std::max(end, last);
+    double interest = balance * periodRate(facility, curves, last, maturity) * (maturity - last) / 365.0;
+    if (balance > 0 || interest > 0) {
+        flows.push_back({maturity, balance + interest});
+    }
+    return flows;
+}
+
+}
+
+// Courbes
+
+double DiscountCurve::discountFactorForDays(int days) const {
+    return discountFactor(days / 365.0);
+}
+
+double DiscountCurve::discountFactorBetween(int fromDay, int toDay) const {
+    return discountFactorForDays(toDay - fromDay);
+}
+
+FlatCurve::FlatCurve(double annualRate) : annualRate(annualRate), growth(nullptr) {
+    validateRate(annualRate);
+    growth = &GrowthFactorCache::shared().table(1.0 + annualRate);
+}
+
+double FlatCurve::discountFactor(double years) const {
+    return std::pow(1.0 + annualRate, -years);
+}
+
+double FlatCurve::discountFactorForDays(int days) const {
+    return growth->factor(-days);
+}
+
+double FlatCurve::getRate() const {
+    return annualRate;
+}
+
+void FlatCurve::validateRate(double rate) const {
+    if (rate <= -1.0) {
+        throw std::invalid_argument("Curve rate must be greater than -100%");
+    }
+}
+
+// Flux et valeur actuelle
+
+namespace pricing {
+
+std::vector<CashFlow> cashFlows(const Facility& facility) {
+    return buildCashFlows(facility, nullptr);
+}
+
+std::vector<CashFlow> cashFlows(const Facility& facility, const CurveStore& curves) {
+    return buildCashFlows(facility, &curves);
+}
+
+double npv(const std::vector<CashFlow>& flows, const DiscountCurve& curve, int valuationDay) {
+    double total = 0;
+    for (const CashFlow& flow : flows) {
+        if (flow.day >= valuationDay) {
+            total += flow.amount * curve.discountFactorBetween(valuationDay, flow.day);
+        }
+    }
+    return total;
+}
+
+}
+
+// Solveur par lots
+
+YieldSolver::YieldSolver(double tolerance, size_t maxIterations)
+    : tolerance(tolerance), maxIterations(maxIterations), evaluations(0) {
+    offsets.push_back(0);
+}
+
+void YieldSolver::clear() {
+    times.clear();
+    amounts.clear();
+    offsets.assign(1, 0);
+    prices.clear();
+    solutions.clear();
+    converged.clear();
+    evaluations = 0;
+}
+
+size_t YieldSolver::addProblem(const std::vector<CashFlow>& flows, int baseDay, double price, double guess) {
+    for (const CashFlow& flow : flows) {
+        times.push_back((flow.day - baseDay) / 365.0);
+        amounts.push_back(flow.amount);
+    }
+    offsets.push_back(times.size());
+    prices.push_back(price);
+    solutions.push_back(std::min(std::max(guess, LOWER_RATE / 2), UPPER_RATE / 2));
+    converged.push_back(0);
+    return prices.size() - 1;
+}
+
+void YieldSolver::solve() {
+    size_t count = prices.size();
+    std::vector<double> lower(count, LOWER_RATE);
+    std::vector<double> upper(count, UPPER_RATE);
+    std::vector<double> lowerValue(count);
+    evaluations = 0;
+
+    // Flux des problèmes actifs rangés à la suite, chacun avec le rang de son problème dans
+    // le lot : une évaluation parcourt tous les flux du lot en un seul passage
+    std::vector<size_t> active;
+    std::vector<double> laneTimes;
+    std::vector<double> laneAmounts;
+    std::vector<uint32_t> lanes;
+    auto pack = [&]() {
+        laneTimes.clear();
+        laneAmounts.clear();
+        lanes.clear();
+        for (size_t k = 0; k < active.size(); k++) {
+            for (size_t j = offsets[active[k]]; j < offsets[active[k] + 1]; j++) {
+                laneTimes.push_back(times[j]);
+                laneAmounts.push_back(amounts[j]);
+                lanes.push_back(static_cast<uint32_t>(k));
+            }
+        }
+    };
+
+    // Valeur actualisée moins le prix et sa dérivée, pour tous les problèmes du lot aux taux donnés
+    std::vector<double> rates;
+    std::vector<double> logBases;
+    std::vector<double> values;
+    std::vector<double> derivatives;
+    auto evaluate = [&]() {
+        size_t width = active.size();
+        logBases.resize(width);
+        values.resize(width);
+        derivatives.resize(width);
+        for (size_t k = 0; k < width; k++) {
+            logBases[k] = std::log1p(rates[k]);
+            values[k] = -prices[active[k]];
+            derivatives[k] = 0;
+        }
+        const double* t = laneTimes.data();
+        const double* a = laneAmounts.data();
+        const uint32_t* lane = lanes.data();
+        for (size_t j = 0; j < laneTimes.size(); j++) {
+            double discounted = a[j] * std::exp(-t[j] * logBases[lane[j]]);
+            values[lane[j]] += discounted;
+            derivatives[lane[j]] -= t[j] * discounted;
+        }
+        for (size_t k = 0; k < width; k++) {
+            derivatives[k] /= 1.0 + rates[k];
+        }
+    };
+
+    // Encadrement : seuls les problèmes dont la fonction change de signe sont résolus
+    for (size_t i = 0; i < count; i++) {
+        converged[i] = 0;
+        if (offsets[i + 1] > offsets[i]) {
+            active.push_back(i);
+        } else {
+            solutions[i] = std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+    pack();
+    rates.assign(active.size(), LOWER_RATE);
+    evaluate();
+    std::vector<double> bounds = values;
+    rates.assign(active.size(), UPPER_RATE);
+    evaluate();
+
+    std::vector<size_t> next;
+    for (size_t k = 0; k < active.size(); k++) {
+        size_t i = active[k];
+        lowerValue[i] = bounds[k];
+        if ((bounds[k] > 0) != (values[k] > 0)) {
+            next.push_back(i);
+        } else {
+            solutions[i] = std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+    if (next.size() != active.size()) {
+        active.swap(next);
+        pack();
+    }
+
+    // Chaque itération fait un pas de Newton (ou de bissection) sur tous les problèmes actifs
+    for (size_t iteration = 0; iteration < maxIterations && !active.empty(); iteration++) {
+        rates.resize(active.size());
+        for (size_t k = 0; k < active.size(); k++) {
+            rates[k] = solutions[active[k]];
+        }
+        evaluate();
+        evaluations += active.size();
+
+        next.clear();
+        for (size_t k = 0; k < active.size(); k++) {
+            size_t i = active[k];
+            double y = rates[k];
+            double value = values[k];
+            double derivative = derivatives[k];
+
+            double scale = std::max(1.0, std::fabs(prices[i]) + std::fabs(amounts[offsets[i]]));
+            if (std::fabs(value) <= tolerance * scale) {
+                converged[i] = 1;
+                continue;
+            }
+            if ((value > 0) == (lowerValue[i] > 0)) {
+                lower[i] = y;
+            } else {
+                upper[i] = y;
+            }
+
+            double step = derivative != 0 ? y - value / derivative : lower[i];
+            if (!(step > lower[i] && step < upper[i])) {
+                step = 0.5 * (lower[i] + upper[i]);
+            }
+            solutions[i] = step;
+            if (std::fabs(step - y) <= tolerance * (1.0 + std::fabs(y))) {
+                converged[i] = 1;
+                continue;
+            }
+            next.push_back(i);
+        }
+        // Le lot n'est reconstruit que lorsque des problèmes en sortent
+        if (next.size() != active.size()) {
+            active.swap(next);
+            pack();
+        }
+    }
+}
+
+size_t YieldSolver::getProblemsCount() const {
+    return prices.size();
+}
+
+double YieldSolver::getSolution(size_t problem) const {
+    return solutions.at(problem);
+}
+
+bool YieldSolver::isConverged(size_t problem) const {
+    return converged.at(problem) != 0;
+}
+
+size_t YieldSolver::getEvaluations() const {
+    return evaluations;
+}
+
+// Évaluation du book
+
+PricingEngine::PricingEngine(const DiscountCurve& curve) : curve(&curve), curves(nullptr), lastEvaluations(0) {}
+
+PricingEngine::PricingEngine(const CurveStore& curves) : curve(nullptr), curves(&curves), lastEvaluations(0) {}
+
+std::vector<FacilityPricing> PricingEngine::priceBook(const std::vector<Deal>& deals,
+                                                      const std::string& valuationDate) {
+    int valuationDay = toDayNumber(valuationDate);
+    std::vector<FacilityPricing> results;
+
+    // Un problème de TRI et un problème de rendement par facility, résolus ensemble
+    solver.clear();
+    for (const Deal& deal : deals) {
+        for (size_t f = 0; f < deal.getFacilitiesCount(); f++) {
+            const Facility& facility = deal.getFacilities()[f];
+            std::vector<CashFlow> facilityFlows = curves != nullptr ? pricing::cashFlows(facility, *curves)
+                                                                    : pricing::cashFlows(facility);
+            const DiscountCurve& discount = curves != nullptr ? curves->get(facility.getCurrencyCode()) : *curve;
+
+            auto it = previous.find(keyOf(deal, f));
+            double rate = facility.getAnnualInterestRate();
+            double irrGuess = it != previous.end() && std::isfinite(it->second.irr) ? it->second.irr : rate;
+            double yieldGuess = it != previous.end() && std::isfinite(it->second.yield) ? it->second.yield : rate;
+
+            std::vector<CashFlow> remaining;
+            for (const CashFlow& flow : facilityFlows) {
+                if (flow.day > valuationDay) {
+                    remaining.push_back(flow);
+                }
+            }
+            solver.addProblem(facilityFlows, facilityFlows.front().day, 0.0, irrGuess);
+            // Prix au pair : encours à la date d'évaluation (parts postérieures non déduites)
+            double outstanding = facility.getAmount();
+            for (const Part& part : facility.getParts()) {
+                if (toDayNumber(part.getDate()) <= valuationDay) {
+                    outstanding -= part.getAmount();
+                }
+            }
+            solver.addProblem(remaining, valuationDay, outstanding, yieldGuess);
+
+            results.push_back({deal.getContractNum(), f, pricing::npv(facilityFlows, discount, valuationDay), 0, 0, false});
+        }
+    }
+    solver.solve();
+    lastEvaluations = solver.getEvaluations();
+
+    size_t row = 0;
+    for (const Deal& deal : deals) {
+        for (size_t f = 0; f < deal.getFacilitiesCount(); f++, row++) {
+            FacilityPricing& result = results[row];
+            result.irr = solver.getSolution(2 * row);
+            result.yield = solver.getSolution(2 * row + 1);
+            result.converged = solver.isConverged(2 * row) && solver.isConverged(2 * row + 1);
+            previous[keyOf(deal, f)] = {result.irr, result.yield};
+        }
+    }
+    return results;
+}
+
+size_t PricingEngine::getLastEvaluations() const {
+    return lastEvaluations;
+}
+
+uint32_t PricingEngine::keyOf(const Deal& deal, size_t facilityIndex) {
+    return (static_cast<uint32_t>(deal.getContractNumber().getCode()) << 16) | static_cast<uint32_t>(facilityIndex);
+}
\ No newline at end of file
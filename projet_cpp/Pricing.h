@@ -0,0 +1,129 @@
+#ifndef PRICING_H
+#define PRICING_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "Deal.h"
+#include "Facility.h"
+#include "GrowthFactorCache.h"
+
+class CurveStore;
+
+// Flux de trésorerie du point de vue des prêteurs, daté par numéro de jour
+struct CashFlow {
+    int day;
+    double amount;
+};
+
+// Courbe d'actualisation : facteur d'actualisation pour une maturité donnée
+class DiscountCurve {
+public:
+    virtual ~DiscountCurve() = default;
+
+    virtual double discountFactor(double years) const = 0;
+    // Maturité exprimée en jours (base 365), surchargée par les courbes tabulées par jour
+    virtual double discountFactorForDays(int days) const;
+    // Actualisation d'une date vers une date antérieure (numéros de jour)
+    virtual double discountFactorBetween(int fromDay, int toDay) const;
+};
+
+// Courbe plate à taux annuel composé
+class FlatCurve : public DiscountCurve {
+public:
+    explicit FlatCurve(double annualRate);
+
+    double discountFactor(double years) const override;
+    // Lecture dans la table partagée du taux, sans pow
+    double discountFactorForDays(int days) const override;
+    double getRate() const;
+
+private:
+    double annualRate;
+    const GrowthFactorCache::Table* growth;
+
+    void validateRate(double rate) const;
+};
+
+namespace pricing {
+
+// Tirage au début, parts aux dates effectives avec les intérêts courus sur l'encours,
+// puis flux projeté à l'échéance : restant dû et intérêts courus depuis la dernière part
+std::vector<CashFlow> cashFlows(const Facility& facility);
+// Idem, les intérêts des facilities à taux variable suivant les forwards de leur courbe plus la marge
+std::vector<CashFlow> cashFlows(const Facility& facility, const CurveStore& curves);
+
+// Valeur actuelle des flux à partir de la date d'évaluation incluse
+double npv(const std::vector<CashFlow>& flows, const DiscountCurve& curve, int valuationDay);
+
+}
+
+// Résolution par lots de taux actuariels y tels que somme(flux * (1 + y)^-t) = prix.
+// Les flux de tous les problèmes sont rangés à la suite dans des tableaux contigus ;
+// chaque itération évalue tous les problèmes encore actifs en un seul passage sur
+// leurs flux, puis fait un pas sur chacun (Newton, repli par bissection dès qu'un pas
+// sort de l'intervalle d'encadrement).
+class YieldSolver {
+public:
+    YieldSolver(double tolerance = 1e-10, size_t maxIterations = 100);
+
+    void clear();
+    // t est mesuré en années depuis baseDay ; guess sert de point de départ
+    size_t addProblem(const std::vector<CashFlow>& flows, int baseDay, double price, double guess);
+    void solve();
+
+    size_t getProblemsCount() const;
+    double getSolution(size_t problem) const;
+    bool isConverged(size_t problem) const;
+    // Nombre total d'évaluations (problème x itération) de la dernière résolution
+    size_t getEvaluations() const;
+
+private:
+    double tolerance;
+    size_t maxIterations;
+    std::vector<double> times;
+    std::vector<double> amounts;
+    std::vector<size_t> offsets;
+    std::vector<double> prices;
+    std::vector<double> solutions;
+    std::vector<uint8_t> converged;
+    size_t evaluations;
+};
+
+// Résultats d'évaluation d'une facility
+struct FacilityPricing {
+    std::string contractNum;
+    size_t facilityIndex;
+    double npv;
+    double irr;             // Taux de rendement interne sur l'ensemble des flux
+    double yield;           // Rendement effectif des flux restants, au pair (encours à la date)
+    bool converged;
+};
+
+// Évaluation de tout le book ; les solutions de la veille servent de point de départ.
+// Avec un CurveStore, chaque facility est actualisée sur la courbe de sa devise.
+class PricingEngine {
+public:
+    explicit PricingEngine(const DiscountCurve& curve);
+    explicit PricingEngine(const CurveStore& curves);
+
+    std::vector<FacilityPricing> priceBook(const std::vector<Deal>& deals, const std::string& valuationDate);
+    size_t getLastEvaluations() const;
+
+private:
+    struct Solution {
+        double irr;
+        double yield;
+    };
+
+    const DiscountCurve* curve;
+    const CurveStore* curves;
+    YieldSolver solver;
+    std::unordered_map<uint32_t, Solution> previous;
+    size_t lastEvaluations;
+
+    static uint32_t keyOf(const Deal& deal, size_t facilityIndex);
+};
+
+#endif
\ No newline at end of file
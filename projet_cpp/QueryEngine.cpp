@@ -0,0 +1,355 @@
+#include "QueryEngine.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Union des bitmaps associées aux valeurs demandées pour un critère
+template <typename Index, typename Key>
+Bitmap unionOf(const Index& index, const std::vector<Key>& keys, size_t rows) {
+    Bitmap result(rows);
+    for (const Key& key : keys) {
+        auto it = index.find(key);
+        if (it != index.end()) {
+            // Bitmap ajustée à la taille du niveau : les lignes ajoutées depuis sont à zéro
+            Bitmap part = it->second;
+            part.resize(rows);
+            result |= part;
+        }
+    }
+    return result;
+}
+
+}
+
+QueryEngine::Filter& QueryEngine::Filter::status(Deal::Status status) {
+    statuses.push_back(status);
+    return *this;
+}
+
+QueryEngine::Filter& QueryEngine::Filter::currency(const std::string& currency) {
+    currencies.push_back(CurrencyCode::parse(currency));
+    return *this;
+}
+
+QueryEngine::Filter& QueryEngine::Filter::borrower(const std::string& borrower) {
+    borrowers.push_back(borrower);
+    return *this;
+}
+
+QueryEngine::Filter& QueryEngine::Filter::lender(const std::string& lender) {
+    lenders.push_back(lender);
+    return *this;
+}
+
+QueryEngine::Filter& QueryEngine::Filter::maturityYear(int year) {
+    maturityYears.push_back(year);
+    return *this;
+}
+
+QueryEngine::QueryEngine(BookStore& book) : book(book) {
+    rebuild();
+    book.addObserver(this);
+}
+
+QueryEngine::~QueryEngine() {
+    book.removeObserver(this);
+}
+
+void QueryEngine::rebuild() {
+    dealLevel = Level();
+    facilityLevel = Level();
+    facilityRows.clear();
+    dealFacilities.clear();
+    freeFacilityRows.clear();
+
+    for (const Deal& deal : book.getDeals()) {
+        index(deal);
+    }
+}
+
+Bitmap QueryEngine::selectDeals(const Filter& filter) const {
+    return select(dealLevel, filter);
+}
+
+Bitmap QueryEngine::selectFacilities(const Filter& filter) const {
+    return select(facilityLevel, filter);
+}
+
+bool QueryEngine::matchesDeal(const Filter& filter, const Deal& deal) {
+    Keys keys = dealKeysOf(deal);
+    auto accepts = [](const auto& values, const auto& key) {
+        return values.empty() || std::find(values.begin(), values.end(), key) != values.end();
+    };
+    bool status = filter.statuses.empty();
+    for (Deal::Status wanted : filter.statuses) {
+        status = status || statusSlot(wanted) == keys.status;
+    }
+    bool lender = filter.lenders.empty();
+    for (const std::string& name : keys.lenders) {
+        lender = lender || accepts(filter.lenders, name);
+    }
+    return status && lender && accepts(filter.currencies, keys.currency) &&
+           accepts(filter.borrowers, keys.borrower) && accepts(filter.maturityYears, keys.year);
+}
+
+std::vector<const Deal*> QueryEngine::getDeals(const Bitmap& selection) const {
+    const std::vector<Deal>& deals = book.getDeals();
+    std::vector<const Deal*> result;
+    selection.forEach([&](size_t row) { result.push_back(&deals.at(row)); });
+    return result;
+}
+
+std::vector<const Facility*> QueryEngine::getFacilities(const Bitmap& selection) const {
+    const std::vector<Deal>& deals = book.getDeals();
+    std::vector<const Facility*> result;
+    selection.forEach([&](size_t row) {
+        const std::pair<size_t, size_t>& position = facilityRows.at(row);
+        result.push_back(&deals.at(position.first).getFacilities().at(position.second));
+    });
+    return result;
+}
+
+QueryEngine::Aggregate QueryEngine::aggregateDeals(const Bitmap& selection) const {
+    return aggregate(dealLevel, selection);
+}
+
+QueryEngine::Aggregate QueryEngine::aggregateFacilities(const Bitmap& selection) const {
+    return aggregate(facilityLevel, selection);
+}
+
+size_t QueryEngine::getDealsCount() const {
+    return dealLevel.rows;
+}
+
+size_t QueryEngine::getFacilitiesCount() const {
+    return facilityLevel.live.count();
+}
+
+void QueryEngine::onDealAdded(const Deal& deal) {
+    index(deal);
+}
+
+void QueryEngine::onFacilityAdded(const Deal& deal, size_t) {
+    index(deal);
+}
+
+void QueryEngine::onPartPaid(const Deal& deal, size_t facilityIndex) {
+    updateRemaining(deal, facilityIndex);
+}
+
+void QueryEngine::onSharesTransferred(const Deal& deal, size_t) {
+    index(deal);
+}
+
+void QueryEngine::onInterestAccrued(const Deal&, size_t) {
+    // Les critères de recherche ne portent pas sur les intérêts
+}
+
+void QueryEngine::onStatusChanged(const Deal& deal) {
+    index(deal);
+}
+
+void QueryEngine::onAgentChanged(const Deal& deal) {
+    index(deal);
+}
+
+void QueryEngine::onDealRemoved(const Deal& deal) {
+    // Le book remplace le deal retiré par son dernier deal : la dernière ligne prend sa place
+    size_t position = positionOf(deal);
+    size_t last = dealLevel.rows - 1;
+    for (size_t row : dealFacilities[position]) {
+        facilityLevel.clear(row);
+        freeFacilityRows.push_back(row);
+    }
+    dealLevel.clear(position);
+    if (position != last) {
+        Keys moved = dealLevel.keys[last];
+        double amount = dealLevel.amounts[last];
+        double remaining = dealLevel.remaining[last];
+        dealLevel.clear(last);
+        dealLevel.set(position, std::move(moved), amount, remaining);
+        dealFacilities[position] = std::move(dealFacilities[last]);
+        for (size_t row : dealFacilities[position]) {
+            facilityRows[row].first = position;
+        }
+    }
+    dealFacilities.pop_back();
+    dealLevel.truncate(last);
+}
+
+size_t QueryEngine::positionOf(const Deal& deal) const {
+    const std::vector<Deal>& deals = book.getDeals();
+    if (deals.empty() || &deal < deals.data() || &deal >= deals.data() + deals.size()) {
+        throw std::invalid_argument("Deal is not stored in the indexed book");
+    }
+    return static_cast<size_t>(&deal - deals.data());
+}
+
+void QueryEngine::index(const Deal& deal) {
+    size_t position = positionOf(deal);
+    if (position >= dealFacilities.size()) {
+        dealFacilities.resize(position + 1);
+    }
+    std::vector<size_t>& rows = dealFacilities[position];
+
+    Keys dealKeys = dealKeysOf(deal);
+    double dealRemaining = 0;
+    for (size_t f = 0; f < deal.getFacilities().size(); f++) {
+        const Facility& facility = deal.getFacilities()[f];
+        Keys facilityKeys{dealKeys.status, facility.getCurrencyCode(), dealKeys.borrower, {},
+                          maturityYearOf(facility.getEndDate())};
+        for (const Lender& lender : facility.getLenders()) {
+            facilityKeys.lenders.push_back(lender.getName());
+        }
+        dealRemaining += facility.getRemainingAmount();
+
+        if (f == rows.size()) {
+            size_t row = facilityLevel.rows;
+            if (!freeFacilityRows.empty()) {
+                row = freeFacilityRows.back();
+                freeFacilityRows.pop_back();
+            }
+            rows.push_back(row);
+            if (row >= facilityRows.size()) {
+                facilityRows.resize(row + 1);
+            }
+        }
+        facilityRows[rows[f]] = {position, f};
+        facilityLevel.set(rows[f], std::move(facilityKeys), facility.getAmount(), facility.getRemainingAmount());
+    }
+    dealLevel.set(position, std::move(dealKeys), deal.getProjectAmount(), dealRemaining);
+}
+
+void QueryEngine::updateRemaining(const Deal& deal, size_t facilityIndex) {
+    // Un remboursement ne change que les montants restants, pas les bitmaps
+    size_t position = positionOf(deal);
+    size_t row = dealFacilities.at(position).at(facilityIndex);
+    double remaining = deal.getFacilities()[facilityIndex].getRemainingAmount();
+    dealLevel.remaining[position] += remaining - facilityLevel.remaining[row];
+    facilityLevel.remaining[row] = remaining;
+}
+
+void QueryEngine::Level::set(size_t row, Keys rowKeys, double amount, double remainingAmount) {
+    if (row < rows) {
+        clear(row);
+    } else {
+        rows = row + 1;
+        keys.resize(rows);
+        amounts.resize(rows);
+        remaining.resize(rows);
+    }
+    live.set(row);
+    statusIndex[rowKeys.status].set(row);
+    currencyIndex[rowKeys.currency].set(row);
+    borrowerIndex[rowKeys.borrower].set(row);
+    for (const std::string& lender : rowKeys.lenders) {
+        lenderIndex[lender].set(row);
+    }
+    yearIndex[rowKeys.year].set(row);
+    keys[row] = std::move(rowKeys);
+    amounts[row] = amount;
+    remaining[row] = remainingAmount;
+}
+
+void QueryEngine::Level::clear(size_t row) {
+    // Les bits de la ligne sont retirés des bitmaps de ses anciennes valeurs
+    const Keys& old = keys[row];
+    live.reset(row);
+    statusIndex[old.status].reset(row);
+    auto currency = currencyIndex.find(old.currency);
+    if (currency != currencyIndex.end()) {
+        currency->second.reset(row);
+    }
+    auto borrower = borrowerIndex.find(old.borrower);
+    if (borrower != borrowerIndex.end()) {
+        borrower->second.reset(row);
+    }
+    for (const std::string& name : old.lenders) {
+        auto lender = lenderIndex.find(name);
+        if (lender != lenderIndex.end()) {
+            lender->second.reset(row);
+        }
+    }
+    auto year = yearIndex.find(old.year);
+    if (year != yearIndex.end()) {
+        year->second.reset(row);
+    }
+    amounts[row] = 0;
+    remaining[row] = 0;
+}
+
+void QueryEngine::Level::truncate(size_t count) {
+    // Les lignes retirées ont été effacées de toutes les bitmaps
+    rows = count;
+    keys.resize(count);
+    amounts.resize(count);
+    remaining.resize(count);
+    live.resize(count);
+}
+
+Bitmap QueryEngine::select(const Level& level, const Filter& filter) const {
+    Bitmap result = level.live;
+    result.resize(level.rows);
+
+    if (!filter.statuses.empty()) {
+        Bitmap statuses(level.rows);
+        for (Deal::Status status : filter.statuses) {
+            Bitmap part = level.statusIndex[statusSlot(status)];
+            part.resize(level.rows);
+            statuses |= part;
+        }
+        result &= statuses;
+    }
+    if (!filter.currencies.empty()) {
+        result &= unionOf(level.currencyIndex, filter.currencies, level.rows);
+    }
+    if (!filter.borrowers.empty()) {
+        result &= unionOf(level.borrowerIndex, filter.borrowers, level.rows);
+    }
+    if (!filter.lenders.empty()) {
+        result &= unionOf(level.lenderIndex, filter.lenders, level.rows);
+    }
+    if (!filter.maturityYears.empty()) {
+        result &= unionOf(level.yearIndex, filter.maturityYears, level.rows);
+    }
+    return result;
+}
+
+QueryEngine::Aggregate QueryEngine::aggregate(const Level& level, const Bitmap& selection) const {
+    if (selection.size() != level.rows) {
+        throw std::invalid_argument("Selection does not match the index");
+    }
+
+    Aggregate result = {0, 0, 0};
+    selection.forEach([&](size_t row) {
+        result.count++;
+        result.amount += level.amounts[row];
+        result.remaining += level.remaining[row];
+    });
+    return result;
+}
+
+QueryEngine::Keys QueryEngine::dealKeysOf(const Deal& deal) {
+    // Un deal est rattaché à son pool, à son agent et aux prêteurs de ses facilities
+    Keys keys{statusSlot(deal.getStatus()), deal.getCurrencyCode(), deal.getBorrower().getName(), {},
+              maturityYearOf(deal.getContractEndDate())};
+    for (const Lender& lender : deal.getPool()) {
+        keys.lenders.push_back(lender.getName());
+    }
+    keys.lenders.push_back(deal.getAgent());
+    for (const Facility& facility : deal.getFacilities()) {
+        for (const Lender& lender : facility.getLenders()) {
+            keys.lenders.push_back(lender.getName());
+        }
+    }
+    return keys;
+}
+
+int QueryEngine::maturityYearOf(const std::string& date) {
+    return std::stoi(date.substr(0, 4));
+}
+
+size_t QueryEngine::statusSlot(Deal::Status status) {
+    return status == Deal::Status::TERMINATED ? 0 : 1;
+}
\ No newline at end of file
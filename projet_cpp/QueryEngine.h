@@ -0,0 +1,130 @@
+#ifndef QUERY_ENGINE_H
+#define QUERY_ENGINE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <cstdint>
+#include "Bitmap.h"
+#include "Deal.h"
+#include "BookStore.h"
+#include "CurrencyCode.h"
+
+// Moteur de requêtes en mémoire sur les deals et facilities, par index bitmap
+// (statut, devise, emprunteur, prêteur, année d'échéance).
+// Abonné au book : une mutation ne met à jour que les lignes du deal concerné et de
+// ses facilities. Une ligne de deal est la position du deal dans le book ; les lignes
+// des facilities d'un deal retiré sont libérées et réutilisées.
+class QueryEngine : public BookObserver {
+public:
+    // Filtre conjonctif : OU entre les valeurs d'un même critère, ET entre critères
+    class Filter {
+    public:
+        Filter& status(Deal::Status status);
+        Filter& currency(const std::string& currency);
+        Filter& borrower(const std::string& borrower);
+        Filter& lender(const std::string& lender);
+        Filter& maturityYear(int year);
+
+    private:
+        friend class QueryEngine;
+        std::vector<Deal::Status> statuses;
+        std::vector<CurrencyCode> currencies;
+        std::vector<std::string> borrowers;
+        std::vector<std::string> lenders;
+        std::vector<int> maturityYears;
+    };
+
+    // Agrégats calculés sur un ensemble de lignes
+    struct Aggregate {
+        size_t count;
+        double amount;
+        double remaining;
+    };
+
+    // Indexe les deals du book puis s'abonne à ses mutations
+    explicit QueryEngine(BookStore& book);
+    ~QueryEngine() override;
+
+    QueryEngine(const QueryEngine&) = delete;
+    QueryEngine& operator=(const QueryEngine&) = delete;
+
+    // Reconstruction complète des index
+    void rebuild();
+
+    Bitmap selectDeals(const Filter& filter) const;
+    Bitmap selectFacilities(const Filter& filter) const;
+    // Même critère que selectDeals pour un deal hors du book (deal archivé)
+    static bool matchesDeal(const Filter& filter, const Deal& deal);
+
+    std::vector<const Deal*> getDeals(const Bitmap& selection) const;
+    std::vector<const Facility*> getFacilities(const Bitmap& selection) const;
+
+    // amount : montant projet (deals) ou montant tiré (facilities)
+    Aggregate aggregateDeals(const Bitmap& selection) const;
+    Aggregate aggregateFacilities(const Bitmap& selection) const;
+
+    size_t getDealsCount() const;
+    size_t getFacilitiesCount() const;
+
+    void onDealAdded(const Deal& deal) override;
+    void onFacilityAdded(const Deal& deal, size_t facilityIndex) override;
+    void onPartPaid(const Deal& deal, size_t facilityIndex) override;
+    void onSharesTransferred(const Deal& deal, size_t facilityIndex) override;
+    void onInterestAccrued(const Deal& deal, size_t facilityIndex) override;
+    void onStatusChanged(const Deal& deal) override;
+    void onAgentChanged(const Deal& deal) override;
+    void onDealRemoved(const Deal& deal) override;
+
+private:
+    // Valeurs indexées d'une ligne, pour en retirer les bits à sa mise à jour
+    struct Keys {
+        size_t status;
+        CurrencyCode currency;
+        std::string borrower;
+        std::vector<std::string> lenders;
+        int year;
+    };
+
+    // Index bitmap d'un niveau (deals ou facilities). Les bitmaps ne sont pas toutes
+    // à la taille du niveau : elles sont ajustées à la sélection.
+    struct Level {
+        size_t rows = 0;
+        Bitmap live;
+        Bitmap statusIndex[2];
+        std::unordered_map<CurrencyCode, Bitmap> currencyIndex;
+        std::unordered_map<std::string, Bitmap> borrowerIndex;
+        std::unordered_map<std::string, Bitmap> lenderIndex;
+        std::map<int, Bitmap> yearIndex;
+        std::vector<Keys> keys;
+        std::vector<double> amounts;
+        std::vector<double> remaining;
+
+        // Indexe une ligne, en remplaçant ses valeurs si elle existe déjà
+        void set(size_t row, Keys rowKeys, double amount, double remainingAmount);
+        void clear(size_t row);
+        void truncate(size_t count);
+    };
+
+    BookStore& book;
+    Level dealLevel;
+    Level facilityLevel;
+    // Deal (position dans le book) et position dans le deal de chaque ligne de facility
+    std::vector<std::pair<size_t, size_t>> facilityRows;
+    // Lignes des facilities de chaque deal, par position du deal
+    std::vector<std::vector<size_t>> dealFacilities;
+    std::vector<size_t> freeFacilityRows;
+
+    size_t positionOf(const Deal& deal) const;
+    void index(const Deal& deal);
+    void updateRemaining(const Deal& deal, size_t facilityIndex);
+
+    Bitmap select(const Level& level, const Filter& filter) const;
+    Aggregate aggregate(const Level& level, const Bitmap& selection) const;
+    static Keys dealKeysOf(const Deal& deal);
+    static int maturityYearOf(const std::string& date);
+    static size_t statusSlot(Deal::Status status);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,254 @@
+#include "ReportRenderer.h"
+
+ReportRenderer::ReportRenderer(BufferWriter& out) : out(out) {
+}
+
+void ReportRenderer::render(const std::vector<Deal>& deals) {
+    beginReport();
+    for (const Deal& deal : deals) {
+        renderDeal(deal);
+        out.endBlock();
+    }
+    endReport();
+    out.flush();
+}
+
+void ReportRenderer::render(const Deal& deal) {
+    beginReport();
+    renderDeal(deal);
+    endReport();
+    out.flush();
+}
+
+void ReportRenderer::renderDeal(const Deal& deal) {
+    beginDeal(deal);
+    const std::vector<Facility>& facilities = deal.getFacilities();
+    for (size_t i = 0; i < facilities.size(); i++) {
+        beginFacility(deal, i, facilities[i]);
+        size_t j = 0;
+        for (const Part& paid : facilities[i].getParts()) {
+            part(facilities[i], j++, paid);
+        }
+        endFacility(facilities[i]);
+    }
+    endDeal(deal);
+}
+
+// Rendu texte
+
+TextReportRenderer::TextReportRenderer(BufferWriter& out) : ReportRenderer(out) {
+}
+
+void TextReportRenderer::writeDealDetails(BufferWriter& out, const Deal& deal) {
+    out << "=== DEAL DETAILS ===\n";
+    out << "Contract Number: " << deal.getContractNum() << '\n';
+    out << "Agent: " << deal.getAgent() << '\n';
+
+    out << "Pool: ";
+    for (const Lender& lender : deal.getPool()) {
+        out << lender.getName() << ' ';
+    }
+    out << '\n';
+
+    out << "Borrower: " << deal.getBorrower().getName() << '\n';
+    out << "Project Amount: " << deal.getProjectAmount() << ' ' << deal.getCurrency() << '\n';
+    out << "Contract Sign Date: " << deal.getContractSignDate() << '\n';
+    out << "Contract End Date: " << deal.getContractEndDate() << '\n';
+    out << "Status: " << deal.getStatusString() << '\n';
+    out << "Facilities Count: " << static_cast<uint64_t>(deal.getFacilitiesCount()) << '\n';
+    out << "Total Facilities Amount: " << deal.getTotalFacilitiesAmount() << ' ' << deal.getCurrency() << '\n';
+    out << "===================\n";
+}
+
+void TextReportRenderer::beginDeal(const Deal& deal) {
+    writeDealDetails(out, deal);
+}
+
+void TextReportRenderer::endDeal(const Deal&) {
+    out << '\n';
+}
+
+void TextReportRenderer::beginFacility(const Deal&, size_t index, const Facility& facility) {
+    out << "Facility " << static_cast<uint64_t>(index + 1) << ":\n";
+    out << "  Amount: " << facility.getAmount() << ' ' << facility.getCurrency() << '\n';
+    out << "  Remaining: " << facility.getRemainingAmount() << '\n';
+    out << "  Interest Rate: " << facility.getAnnualInterestRate() * 100 << "%\n";
+    out << "  Parts Count: " << static_cast<uint64_t>(facility.getPartsCount()) << '\n';
+    out << "  Start Date: " << facility.getStartDate() << '\n';
+    out << "  End Date: " << facility.getEndDate() << '\n';
+}
+
+void TextReportRenderer::endFacility(const Facility&) {
+    out << "-------------------\n";
+}
+
+void TextReportRenderer::part(const Facility&, size_t index, const Part& part) {
+    out << "  Part " << static_cast<uint64_t>(index + 1) << ": " << part.getAmount()
+        << " on " << part.getDate() << '\n';
+}
+
+// Rendu CSV : une ligne par deal, facility et part, colonnes communes
+
+CsvReportRenderer::CsvReportRenderer(BufferWriter& out)
+    : ReportRenderer(out), currentDeal(nullptr), currentFacility(0) {
+}
+
+void CsvReportRenderer::beginReport() {
+    out << "record,contract_num,facility,part,borrower,agent,status,currency,amount,remaining,rate,date,end_date\n";
+}
+
+void CsvReportRenderer::beginDeal(const Deal& deal) {
+    currentDeal = &deal;
+    out << "deal,";
+    writeField(deal.getContractNum());
+    out << ",,,";
+    writeField(deal.getBorrower().getName());
+    out << ',';
+    writeField(deal.getAgent());
+    out << ',' << deal.getStatusString() << ',' << deal.getCurrency() << ','
+        << deal.getProjectAmount() << ",,," << deal.getContractSignDate() << ','
+        << deal.getContractEndDate() << '\n';
+}
+
+void CsvReportRenderer::endDeal(const Deal&) {
+    currentDeal = nullptr;
+}
+
+void CsvReportRenderer::beginFacility(const Deal& deal, size_t index, const Facility& facility) {
+    currentFacility = index;
+    out << "facility,";
+    writeField(deal.getContractNum());
+    out << ',' << static_cast<uint64_t>(index + 1) << ",,,,," << facility.getCurrency() << ','
+        << facility.getAmount() << ',' << facility.getRemainingAmount() << ','
+        << facility.getAnnualInterestRate() << ',' << facility.getStartDate() << ','
+        << facility.getEndDate() << '\n';
+}
+
+void CsvReportRenderer::endFacility(const Facility&) {
+}
+
+void CsvReportRenderer::part(const Facility& facility, size_t index, const Part& part) {
+    out << "part,";
+    writeField(currentDeal->getContractNum());
+    out << ',' << static_cast<uint64_t>(currentFacility + 1) << ',' << static_cast<uint64_t>(index + 1)
+        << ",,,," << facility.getCurrency() << ',' << part.getAmount() << ",,," << part.getDate() << ",\n";
+}
+
+void CsvReportRenderer::writeField(const std::string& value) {
+    if (value.find_first_of(",\"\r\n") == std::string::npos) {
+        out << value;
+        return;
+    }
+    out << '"';
+    for (char c : value) {
+        if (c == '"') {
+            out << '"';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+// Rendu JSON : tableau de deals contenant leurs facilities et leurs parts
+
+JsonReportRenderer::JsonReportRenderer(BufferWriter& out)
+    : ReportRenderer(out), firstDeal(true), firstFacility(true), firstPart(true) {
+}
+
+void JsonReportRenderer::beginReport() {
+    firstDeal = true;
+    out << '[';
+}
+
+void JsonReportRenderer::endReport() {
+    out << "]\n";
+}
+
+void JsonReportRenderer::beginDeal(const Deal& deal) {
+    if (!firstDeal) {
+        out << ',';
+    }
+    firstDeal = false;
+    firstFacility = true;
+
+    out << "\n{\"contract_num\":";
+    writeString(deal.getContractNum());
+    out << ",\"agent\":";
+    writeString(deal.getAgent());
+    out << ",\"borrower\":";
+    writeString(deal.getBorrower().getName());
+    out << ",\"pool\":[";
+    const std::vector<Lender>& pool = deal.getPool();
+    for (size_t i = 0; i < pool.size(); i++) {
+        if (i > 0) {
+            out << ',';
+        }
+        writeString(pool[i].getName());
+    }
+    out << "],\"project_amount\":" << deal.getProjectAmount();
+    out << ",\"currency\":";
+    writeString(deal.getCurrency());
+    out << ",\"sign_date\":\"" << deal.getContractSignDate() << '"';
+    out << ",\"end_date\":\"" << deal.getContractEndDate() << '"';
+    out << ",\"status\":\"" << deal.getStatusString() << '"';
+    out << ",\"facilities\":[";
+}
+
+void JsonReportRenderer::endDeal(const Deal&) {
+    out << "]}";
+}
+
+void JsonReportRenderer::beginFacility(const Deal&, size_t, const Facility& facility) {
+    if (!firstFacility) {
+        out << ',';
+    }
+    firstFacility = false;
+    firstPart = true;
+
+    out << "{\"amount\":" << facility.getAmount();
+    out << ",\"remaining\":" << facility.getRemainingAmount();
+    out << ",\"currency\":";
+    writeString(facility.getCurrency());
+    out << ",\"rate\":" << facility.getAnnualInterestRate();
+    out << ",\"start_date\":\"" << facility.getStartDate() << '"';
+    out << ",\"end_date\":\"" << facility.getEndDate() << '"';
+    out << ",\"parts\":[";
+}
+
+void JsonReportRenderer::endFacility(const Facility&) {
+    out << "]}";
+}
+
+void JsonReportRenderer::part(const Facility&, size_t, const Part& part) {
+    if (!firstPart) {
+        out << ',';
+    }
+    firstPart = false;
+    out << "{\"amount\":" << part.getAmount() << ",\"date\":\"" << part.getDate() << "\"}";
+}
+
+void JsonReportRenderer::writeString(const std::string& value) {
+    out << '"';
+    for (char c : value) {
+        switch (c) {
+            case '"':
+                out << "\\\"";
+                break;
+            case '\\':
+                out << "\\\\";
+                break;
+            case '\n':
+                out << "\\n";
+                break;
+            default:
+                // Autres caractères de contrôle interdits tels quels en JSON
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    const char* hex = "0123456789abcdef";
+                    out << "\\u00" << hex[(c >> 4) & 0xF] << hex[c & 0xF];
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
\ No newline at end of file
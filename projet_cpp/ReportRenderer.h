@@ -0,0 +1,89 @@
+#ifndef REPORT_RENDERER_H
+#define REPORT_RENDERER_H
+
+#include <vector>
+#include "BufferWriter.h"
+#include "Deal.h"
+
+// Rendu des relevés du book : une même traversée deals -> facilities -> parts
+// alimente les rendus texte, CSV et JSON via un BufferWriter
+class ReportRenderer {
+public:
+    explicit ReportRenderer(BufferWriter& out);
+    virtual ~ReportRenderer() = default;
+
+    // Traversée complète du book, un bloc d'écriture par deal
+    void render(const std::vector<Deal>& deals);
+    void render(const Deal& deal);
+
+protected:
+    BufferWriter& out;
+
+    virtual void beginReport() {}
+    virtual void endReport() {}
+    virtual void beginDeal(const Deal& deal) = 0;
+    virtual void endDeal(const Deal& deal) = 0;
+    virtual void beginFacility(const Deal& deal, size_t index, const Facility& facility) = 0;
+    virtual void endFacility(const Facility& facility) = 0;
+    virtual void part(const Facility& facility, size_t index, const Part& part) = 0;
+
+private:
+    void renderDeal(const Deal& deal);
+};
+
+class TextReportRenderer : public ReportRenderer {
+public:
+    explicit TextReportRenderer(BufferWriter& out);
+
+    // En-tête d'un deal seul (détail d'un deal dans le menu)
+    static void writeDealDetails(BufferWriter& out, const Deal& deal);
+
+protected:
+    void beginDeal(const Deal& deal) override;
+    void endDeal(const Deal& deal) override;
+    void beginFacility(const Deal& deal, size_t index, const Facility& facility) override;
+    void endFacility(const Facility& facility) override;
+    void part(const Facility& facility, size_t index, const Part& part) override;
+};
+
+class CsvReportRenderer : public ReportRenderer {
+public:
+    explicit CsvReportRenderer(BufferWriter& out);
+
+protected:
+    void beginReport() override;
+    void beginDeal(const Deal& deal) override;
+    void endDeal(const Deal& deal) override;
+    void beginFacility(const Deal& deal, size_t index, const Facility& facility) override;
+    void endFacility(const Facility& facility) override;
+    void part(const Facility& facility, size_t index, const Part& part) override;
+
+private:
+    const Deal* currentDeal;
+    size_t currentFacility;
+
+    void writeField(const std::string& value);
+};
+
+class JsonReportRenderer : public ReportRenderer {
+public:
+    explicit JsonReportRenderer(BufferWriter& out);
+
+protected:
+    void beginReport() override;
+    void endReport() override;
+    void beginDeal(const Deal& deal) override;
+    void endDeal(const Deal& deal) override;
+    void beginFacility(const Deal& deal, size_t index, const Facility& facility) override;
+    void endFacility(const Facility& facility) override;
+    void part(const Facility& facility, size_t index, const Part& part) override;
+
+private:
+    bool firstDeal;
+    bool firstFacility;
+    bool firstPart;
+
+    void writeString(const std::string& value);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,326 @@
+#include "ShardCoordinator.h"
+#include "BookServer.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#endif
+
+namespace {
+
+// Codes de contrat : rang de la lettre (1 à 3) * 10000 + numéro
+const uint32_t FIRST_CODE = 10000;
+const uint32_t CODES_COUNT = 30000;
+
+void check(const std::vector<protocol::Reply>& replies, size_t shard) {
+    for (const protocol::Reply& reply : replies) {
+        if (!reply.ok) {
+            throw std::runtime_error("Shard " + std::to_string(shard) + ": " + reply.error);
+        }
+    }
+}
+
+}
+
+ShardCoordinator::ShardCoordinator(size_t shards, Partition partition) : partition(partition) {
+    validateShards(shards);
+    // Plages égales sur l'espace des numéros de contrat, en attendant un chargement
+    for (size_t i = 1; i < shards; i++) {
+        bounds.push_back(static_cast<uint16_t>(FIRST_CODE + i * CODES_COUNT / shards));
+    }
+    try {
+        spawn(shards);
+    } catch (...) {
+        shutdown();
+        throw;
+    }
+}
+
+ShardCoordinator::~ShardCoordinator() {
+    shutdown();
+}
+
+size_t ShardCoordinator::getShardsCount() const {
+    return shards.size();
+}
+
+ShardCoordinator::Partition ShardCoordinator::getPartition() const {
+    return partition;
+}
+
+size_t ShardCoordinator::getDealsCount() const {
+    return owners.size();
+}
+
+size_t ShardCoordinator::getDealsCount(size_t shard) const {
+    return shards.at(shard).dealsCount;
+}
+
+size_t ShardCoordinator::shardOf(const std::string& contractNum) const {
+    ContractNumber contract = ContractNumber::parse(contractNum);
+    auto it = owners.find(contract);
+    if (it == owners.end()) {
+        throw std::invalid_argument("Unknown contract number: " + contract.toString());
+    }
+    return it->second;
+}
+
+size_t ShardCoordinator::load(const BookStore& book) {
+    balance(book);
+    size_t loaded = 0;
+    for (const Deal& deal : book.getDeals()) {
+        ContractNumber contract = deal.getContractNumber();
+        if (owners.count(contract) > 0) {
+            throw std::invalid_argument("Contract number already exists in the book: " + contract.toString());
+        }
+        size_t target = route(contract, deal.getBorrower().getName());
+        BookClient& client = *shards[target].client;
+
+        protocol::DealSpec spec{deal.getContractNum(), deal.getAgent(), deal.getBorrower().getName(), {},
+                                deal.getProjectAmount(), deal.getCurrency(), deal.getContractSignDate(),
+                                deal.getContractEndDate(), static_cast<uint8_t>(deal.getStatus())};
+        for (const Lender& lender : deal.getPool()) {
+            spec.pool.push_back(lender.getName());
+        }
+        reserve(target);
+        client.createDeal(spec);
+
+        for (size_t f = 0; f < deal.getFacilitiesCount(); f++) {
+            const Facility& facility = deal.getFacilities()[f];
+            // Prêteurs après cessions avec leurs participations, taux variable, parts puis
+            // date d'arrêté du registre d'intérêts
+            protocol::FacilitySpec facilitySpec{spec.contractNum, facility.getStartDate(), facility.getEndDate(),
+                                                facility.getAmount(), facility.getCurrency(),
+                                                facility.getAnnualInterestRate(), {}, facility.getShares(), "", 0};
+            for (const Lender& lender : facility.getLenders()) {
+                facilitySpec.lenders.push_back(lender.getName());
+            }
+            if (facility.isFloating()) {
+                facilitySpec.curveCurrency = facility.getCurveCurrency().toString();
+                facilitySpec.spread = facility.getSpread();
+            }
+            reserve(target);
+            client.addFacility(facilitySpec);
+            for (const Part& part : facility.getParts()) {
+                reserve(target);
+                client.pay({spec.contractNum, static_cast<uint32_t>(f), part.getAmount(), part.getDate()});
+            }
+            reserve(target);
+            client.accrue(facility.getAccrualDate(), spec.contractNum, static_cast<uint32_t>(f));
+        }
+        owners[contract] = static_cast<uint32_t>(target);
+        shards[target].dealsCount++;
+        loaded++;
+    }
+
+    // Derniers lots de tous les shards
+    for (size_t i = 0; i < shards.size(); i++) {
+        check(shards[i].client->receive(), i);
+        shards[i].client->send();
+    }
+    for (size_t i = 0; i < shards.size(); i++) {
+        check(shards[i].client->receive(), i);
+    }
+    return loaded;
+}
+
+void ShardCoordinator::createDeal(const protocol::DealSpec& spec) {
+    ContractNumber contract = ContractNumber::parse(spec.contractNum);
+    if (owners.count(contract) > 0) {
+        throw std::invalid_argument("Contract number already exists in the book: " + contract.toString());
+    }
+    size_t target = route(contract, spec.borrower);
+    shards[target].client->createDeal(spec);
+    single(target);
+    owners[contract] = static_cast<uint32_t>(target);
+    shards[target].dealsCount++;
+}
+
+uint32_t ShardCoordinator::addFacility(const protocol::FacilitySpec& spec) {
+    size_t target = shardOf(spec.contractNum);
+    shards[target].client->addFacility(spec);
+    return single(target).facilityIndex;
+}
+
+Money ShardCoordinator::pay(const protocol::PaymentSpec& spec) {
+    size_t target = shardOf(spec.contractNum);
+    shards[target].client->pay(spec);
+    return single(target).remaining;
+}
+
+void ShardCoordinator::accrueTo(const std::string& date) {
+    for (Shard& shard : shards) {
+        shard.client->accrue(date);
+    }
+    scatter();
+}
+
+protocol::DealSummary ShardCoordinator::getDeal(const std::string& contractNum) {
+    size_t target = shardOf(contractNum);
+    shards[target].client->getDeal(contractNum);
+    return single(target).deal;
+}
+
+protocol::QueryResult ShardCoordinator::query(const protocol::QuerySpec& spec) {
+    for (Shard& shard : shards) {
+        shard.client->query(spec);
+    }
+    protocol::QueryResult result{0, 0.0, 0.0, {}};
+    for (const protocol::Reply& reply : scatter()) {
+        result.count += reply.query.count;
+        result.amount += reply.query.amount;
+        result.remaining += reply.query.remaining;
+        result.contracts.insert(result.contracts.end(), reply.query.contracts.begin(), reply.query.contracts.end());
+    }
+    std::sort(result.contracts.begin(), result.contracts.end(), [](const std::string& a, const std::string& b) {
+        return ContractNumber::parse(a) < ContractNumber::parse(b);
+    });
+    return result;
+}
+
+protocol::PortfolioTotals ShardCoordinator::portfolio() {
+    for (Shard& shard : shards) {
+        shard.client->portfolio();
+    }
+    protocol::PortfolioTotals totals{Money(), Money(), Money(), Money(), 0};
+    for (const protocol::Reply& reply : scatter()) {
+        totals.amount += reply.portfolio.amount;
+        totals.interest += reply.portfolio.interest;
+        totals.accrued += reply.portfolio.accrued;
+        totals.remaining += reply.portfolio.remaining;
+        totals.partsCount += reply.portfolio.partsCount;
+    }
+    return totals;
+}
+
+size_t ShardCoordinator::route(ContractNumber contract, const std::string& borrower) const {
+    if (partition == Partition::BORROWER) {
+        return std::hash<std::string>()(borrower) % shards.size();
+    }
+    return static_cast<size_t>(std::upper_bound(bounds.begin(), bounds.end(), contract.getCode()) - bounds.begin());
+}
+
+void ShardCoordinator::balance(const BookStore& book) {
+    if (partition != Partition::CONTRACT_RANGE || !owners.empty() || book.getDeals().empty()) {
+        return;
+    }
+    std::vector<uint16_t> codes;
+    codes.reserve(book.getDeals().size());
+    for (const Deal& deal : book.getDeals()) {
+        codes.push_back(deal.getContractNumber().getCode());
+    }
+    std::sort(codes.begin(), codes.end());
+    for (size_t i = 1; i < shards.size(); i++) {
+        bounds[i - 1] = codes[i * codes.size() / shards.size()];
+    }
+}
+
+void ShardCoordinator::reserve(size_t shard) {
+    // Un lot en cours de traitement par shard pendant que le suivant se remplit
+    BookClient& client = *shards[shard].client;
+    if (client.getPendingCount() >= LOAD_BATCH) {
+        check(client.receive(), shard);
+        client.send();
+    }
+}
+
+protocol::Reply ShardCoordinator::single(size_t shard) {
+    std::vector<protocol::Reply> replies = shards[shard].client->flush();
+    check(replies, shard);
+    return replies.front();
+}
+
+std::vector<protocol::Reply> ShardCoordinator::scatter() {
+    // Tous les lots partent avant la lecture de la première réponse
+    for (Shard& shard : shards) {
+        shard.client->send();
+    }
+    std::vector<protocol::Reply> replies;
+    std::vector<std::vector<protocol::Reply>> received;
+    for (Shard& shard : shards) {
+        received.push_back(shard.client->receive());
+    }
+    for (size_t i = 0; i < received.size(); i++) {
+        check(received[i], i);
+        replies.push_back(received[i].front());
+    }
+    return replies;
+}
+
+void ShardCoordinator::validateShards(size_t shards) const {
+    if (shards == 0) {
+        throw std::invalid_argument("Coordinator needs at least one shard");
+    }
+}
+
+#ifndef _WIN32
+
+void ShardCoordinator::spawn(size_t count) {
+    if (!TaskScheduler::canFork()) {
+        throw std::runtime_error("Cannot start shard processes while parallel work is running");
+    }
+    for (size_t i = 0; i < count; i++) {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+            throw std::runtime_error(std::string("Cannot create shard connection: ") + std::strerror(errno));
+        }
+        pid_t pid = fork();
+        if (pid < 0) {
+            std::string error = std::strerror(errno);
+            close(fds[0]);
+            close(fds[1]);
+            throw std::runtime_error("Cannot start shard process: " + error);
+        }
+        if (pid == 0) {
+            // Processus shard : seul le thread appelant existe, sortie par _exit
+            // sans les destructeurs statiques hérités du coordinateur. Les calculs
+            // parallèles du shard passent par un ordonnanceur neuf.
+            TaskScheduler::afterForkInChild();
+            close(fds[0]);
+            for (Shard& shard : shards) {
+                shard.client.reset();
+            }
+            int status = 0;
+            try {
+                BookStore book;
+                BookServer server(book, "", 1);
+                server.serve(fds[1]);
+            } catch (...) {
+                status = 1;
+            }
+            _exit(status);
+        }
+        close(fds[1]);
+        shards.push_back({static_cast<int>(pid), std::make_unique<BookClient>(fds[0]), 0});
+    }
+}
+
+void ShardCoordinator::shutdown() {
+    // Fermer la connexion termine le shard
+    for (Shard& shard : shards) {
+        shard.client.reset();
+    }
+    for (Shard& shard : shards) {
+        waitpid(static_cast<pid_t>(shard.pid), nullptr, 0);
+    }
+    shards.clear();
+}
+
+#else
+
+void ShardCoordinator::spawn(size_t) {
+    throw std::runtime_error("Shard processes are not supported on this platform");
+}
+
+void ShardCoordinator::shutdown() {
+    shards.clear();
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef SHARD_COORDINATOR_H
+#define SHARD_COORDINATOR_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+#include "BookStore.h"
+#include "BookClient.h"
+#include "BookProtocol.h"
+#include "ContractNumber.h"
+
+// Book réparti entre des processus shards locaux (scatter-gather).
+//
+// Chaque shard est un processus fils qui possède sa part des deals, avec leurs
+// facilities et leurs parts, et la sert avec le protocole du serveur de book sur une
+// paire de sockets. Les deals sont répartis par plage de numéros de contrat ou par
+// emprunteur ; le coordinateur garde le shard de chaque contrat pour router les
+// facilities et les paiements. Les requêtes sur tout le book (recherche, portfolio,
+// arrêté des intérêts) sont envoyées à tous les shards avant de lire la première
+// réponse : les shards calculent en parallèle, le coordinateur agrège les résultats
+// partiels. Les écritures d'un chargement sont groupées en lots par shard.
+//
+// Les processus sont créés par fork() à la construction, refusée pendant un calcul
+// parallèle de l'ordonnanceur commun (exception) ; chaque shard utilise son propre
+// ordonnanceur, pas celui hérité dont les workers n'existent pas dans le fils.
+// Unix uniquement.
+class ShardCoordinator {
+public:
+    enum class Partition { CONTRACT_RANGE, BORROWER };
+
+    ShardCoordinator(size_t shards, Partition partition);
+    // Ferme les connexions et attend la fin des processus
+    ~ShardCoordinator();
+
+    ShardCoordinator(const ShardCoordinator&) = delete;
+    ShardCoordinator& operator=(const ShardCoordinator&) = delete;
+
+    size_t getShardsCount() const;
+    Partition getPartition() const;
+    size_t getDealsCount() const;
+    size_t getDealsCount(size_t shard) const;
+    // Shard propriétaire d'un contrat déjà créé
+    size_t shardOf(const std::string& contractNum) const;
+
+    // Copie d'un book : au premier chargement, les plages de contrats sont prises aux
+    // quantiles du book pour équilibrer les shards. Retourne le nombre de deals chargés.
+    size_t load(const BookStore& book);
+
+    // Écritures routées vers le shard du contrat
+    void createDeal(const protocol::DealSpec& spec);
+    uint32_t addFacility(const protocol::FacilitySpec& spec);
+    Money pay(const protocol::PaymentSpec& spec);
+    void accrueTo(const std::string& date);
+
+    // Lectures : un shard, ou tous avec agrégation (contrats triés par numéro)
+    protocol::DealSummary getDeal(const std::string& contractNum);
+    protocol::QueryResult query(const protocol::QuerySpec& spec);
+    protocol::PortfolioTotals portfolio();
+
+private:
+    struct Shard {
+        int pid;
+        std::unique_ptr<BookClient> client;
+        size_t dealsCount;
+    };
+
+    static const size_t LOAD_BATCH = 4096;
+
+    Partition partition;
+    std::vector<Shard> shards;
+    std::vector<uint16_t> bounds;   // Premier code de contrat de chaque shard après le premier
+    std::unordered_map<ContractNumber, uint32_t> owners;
+
+    size_t route(ContractNumber contract, const std::string& borrower) const;
+    void balance(const BookStore& book);
+    void reserve(size_t shard);
+    protocol::Reply single(size_t shard);
+    std::vector<protocol::Reply> scatter();
+    void spawn(size_t count);
+    void shutdown();
+    void validateShards(size_t shards) const;
+};
+
+#endif
\ No newline at end of file
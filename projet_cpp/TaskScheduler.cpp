@@ -0,0 +1,339 @@
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace {
+
+// Worker courant du thread (nul hors des workers)
+thread_local const TaskScheduler* currentScheduler = nullptr;
+thread_local int currentIndex = -1;
+
+// Ordonnanceur commun une fois créé, et celui qui le remplace dans un processus fils
+std::atomic<TaskScheduler*> sharedScheduler(nullptr);
+TaskScheduler* forkedScheduler = nullptr;
+
+// Liste de cœurs au format du noyau : "0-3,8,10-11"
+std::vector<int> parseCpuList(const std::string& text) {
+    std::vector<int> cpus;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t comma = text.find(',', start);
+        std::string range = text.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; cpu++) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            // Entrée illisible ignorée : le placement reste une optimisation
+        }
+        if (comma == std::string::npos) {
+            break;
+        }
+        start = comma + 1;
+    }
+    return cpus;
+}
+
+// Nœud NUMA de chaque cœur, lu dans /sys (vide si la topologie n'est pas exposée)
+std::map<int, int> readNodes() {
+    std::map<int, int> nodeOf;
+    std::error_code error;
+    std::filesystem::directory_iterator it("/sys/devices/system/node", error);
+    if (error) {
+        return nodeOf;
+    }
+    for (const std::filesystem::directory_entry& entry : it) {
+        std::string name = entry.path().filename().string();
+        if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+            name.find_first_not_of("0123456789", 4) != std::string::npos) {
+            continue;
+        }
+        std::ifstream in(entry.path() / "cpulist");
+        std::string list;
+        if (std::getline(in, list)) {
+            for (int cpu : parseCpuList(list)) {
+                nodeOf[cpu] = std::stoi(name.substr(4));
+            }
+        }
+    }
+    return nodeOf;
+}
+
+// Cœurs autorisés au processus
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return cpus;
+}
+
+}
+
+TaskScheduler::TaskScheduler(size_t workers, bool pinned)
+    : nodesCount(1), queued(0), running(0), sleeping(0), steals(0), stopping(false) {
+    if (workers == 0) {
+        size_t cores = std::thread::hardware_concurrency();
+        workers = cores > 1 ? cores - 1 : 1;
+    }
+    for (size_t i = 0; i < workers; i++) {
+        this->workers.push_back(std::make_unique<Worker>());
+    }
+    placeWorkers(pinned);
+    for (size_t i = 0; i < workers; i++) {
+        this->workers[i]->thread = std::thread([this, i]() { loop(i); });
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping.store(true);
+    }
+    wake.notify_all();
+    for (std::unique_ptr<Worker>& worker : workers) {
+        worker->thread.join();
+    }
+}
+
+TaskScheduler& TaskScheduler::shared() {
+    if (forkedScheduler != nullptr) {
+        return *forkedScheduler;
+    }
+    static TaskScheduler scheduler;
+    static const bool published = (sharedScheduler.store(&scheduler), true);
+    (void)published;
+    return scheduler;
+}
+
+bool TaskScheduler::canFork() {
+    if (currentScheduler != nullptr) {
+        return false;
+    }
+    // Une tâche retirée compte dans running avant de quitter queued : lire queued d'abord
+    TaskScheduler* scheduler = sharedScheduler.load();
+    return scheduler == nullptr || (scheduler->queued.load() == 0 && scheduler->running.load() == 0);
+}
+
+void TaskScheduler::afterForkInChild(size_t workers) {
+    // L'ordonnanceur hérité n'est plus jamais touché : ses verrous ont pu être copiés pris
+    forkedScheduler = new TaskScheduler(workers, false);
+}
+
+size_t TaskScheduler::getWorkersCount() const {
+    return workers.size();
+}
+
+size_t TaskScheduler::getNodesCount() const {
+    return nodesCount;
+}
+
+int TaskScheduler::getNode(size_t worker) const {
+    return workers.at(worker)->node;
+}
+
+int TaskScheduler::getCpu(size_t worker) const {
+    return workers.at(worker)->cpu;
+}
+
+size_t TaskScheduler::getStealsCount() const {
+    return steals.load(std::memory_order_relaxed);
+}
+
+void TaskScheduler::push(std::function<void()> task) {
+    int self = currentWorker();
+    if (self >= 0) {
+        Worker& worker = *workers[self];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+        queued.fetch_add(1);
+    } else {
+        std::lock_guard<std::mutex> lock(injectedMutex);
+        injected.push_back(std::move(task));
+        queued.fetch_add(1);
+    }
+    if (sleeping.load() > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wake.notify_one();
+    }
+}
+
+bool TaskScheduler::runOne() {
+    std::function<void()> task;
+    if (!pop(task)) {
+        return false;
+    }
+    task();
+    running.fetch_sub(1);
+    return true;
+}
+
+bool TaskScheduler::pop(std::function<void()>& task) {
+    if (queued.load() == 0) {
+        return false;
+    }
+    int self = currentWorker();
+
+    // Sa propre file par la fin
+    if (self >= 0) {
+        Worker& worker = *workers[self];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!worker.tasks.empty()) {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            running.fetch_add(1);
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(injectedMutex);
+        if (!injected.empty()) {
+            task = std::move(injected.front());
+            injected.pop_front();
+            running.fetch_add(1);
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // Vol par le début, dans les files du même nœud d'abord
+    size_t count = self >= 0 ? workers[self]->victims.size() : workers.size();
+    for (size_t i = 0; i < count; i++) {
+        Worker& victim = *workers[self >= 0 ? workers[self]->victims[i] : i];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            running.fetch_add(1);
+            queued.fetch_sub(1);
+            steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::loop(size_t index) {
+    currentScheduler = this;
+    currentIndex = static_cast<int>(index);
+#ifdef __linux__
+    if (workers[index]->cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(workers[index]->cpu, &set);
+        sched_setaffinity(0, sizeof(set), &set);   // Échec sans conséquence : worker non fixé
+    }
+#endif
+    while (true) {
+        if (runOne()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleeping.fetch_add(1);
+        wake.wait(lock, [this]() { return queued.load() > 0 || stopping.load(); });
+        sleeping.fetch_sub(1);
+        if (stopping.load() && queued.load() == 0) {
+            return;
+        }
+    }
+}
+
+int TaskScheduler::currentWorker() const {
+    return currentScheduler == this ? currentIndex : -1;
+}
+
+void TaskScheduler::placeWorkers(bool pinned) {
+    // Cœurs autorisés rangés par nœud, répartis à tour de rôle entre les workers
+    std::map<int, int> nodeOf = readNodes();
+    std::vector<int> cpus = allowedCpus();
+    std::stable_sort(cpus.begin(), cpus.end(), [&nodeOf](int a, int b) {
+        auto nodeA = nodeOf.find(a);
+        auto nodeB = nodeOf.find(b);
+        return (nodeA == nodeOf.end() ? 0 : nodeA->second) < (nodeB == nodeOf.end() ? 0 : nodeB->second);
+    });
+    std::vector<int> nodes;
+    for (size_t i = 0; i < workers.size(); i++) {
+        if (cpus.empty()) {
+            break;
+        }
+        int cpu = cpus[i % cpus.size()];
+        auto node = nodeOf.find(cpu);
+        workers[i]->node = node == nodeOf.end() ? 0 : node->second;
+        workers[i]->cpu = pinned ? cpu : -1;
+        if (std::find(nodes.begin(), nodes.end(), workers[i]->node) == nodes.end()) {
+            nodes.push_back(workers[i]->node);
+        }
+    }
+    nodesCount = std::max<size_t>(nodes.size(), 1);
+
+    for (size_t i = 0; i < workers.size(); i++) {
+        for (int sameNode = 1; sameNode >= 0; sameNode--) {
+            for (size_t step = 1; step < workers.size(); step++) {
+                size_t victim = (i + step) % workers.size();
+                if ((workers[victim]->node == workers[i]->node) == (sameNode == 1)) {
+                    workers[i]->victims.push_back(victim);
+                }
+            }
+        }
+    }
+}
+
+// Groupe de tâches
+
+TaskGroup::TaskGroup(TaskScheduler& scheduler) : scheduler(scheduler), pending(0) {}
+
+TaskGroup::~TaskGroup() {
+    // Les tâches encore en cours référencent le groupe
+    try {
+        wait();
+    } catch (...) {
+    }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    pending.fetch_add(1, std::memory_order_relaxed);
+    scheduler.push([this, task = std::move(task)]() {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        pending.fetch_sub(1, std::memory_order_release);
+    });
+}
+
+void TaskGroup::wait() {
+    // Le thread qui attend exécute des tâches (les siennes d'abord) au lieu de bloquer
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (!scheduler.runOne()) {
+            std::this_thread::yield();
+        }
+    }
+    std::lock_guard<std::mutex> lock(errorMutex);
+    if (error) {
+        std::exception_ptr failure = error;
+        error = nullptr;
+        std::rethrow_exception(failure);
+    }
+}
\ No newline at end of file
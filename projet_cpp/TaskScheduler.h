@@ -0,0 +1,128 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <cstddef>
+
+class TaskGroup;
+
+// Ordonnanceur de tâches partagé par tous les calculs du book (vol de travail).
+//
+// Chaque worker a sa propre file : il empile et dépile ses tâches par la fin (LIFO, les
+// données encore en cache), les autres workers lui volent les plus anciennes par le début
+// (les plus gros morceaux d'un découpage récursif). Un voleur essaie d'abord les workers
+// de son nœud NUMA. Les workers peuvent être fixés chacun sur un cœur, dans l'ordre des
+// nœuds, parmi les cœurs autorisés au processus.
+//
+// Un thread qui attend un TaskGroup exécute des tâches en attendant : le parallélisme
+// imbriqué (parallelFor dans une tâche) ne bloque pas de worker.
+class TaskScheduler {
+public:
+    // workers = 0 : un par cœur disponible, moins le thread appelant qui participe à l'attente
+    explicit TaskScheduler(size_t workers = 0, bool pinned = true);
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    // Ordonnanceur commun du programme, créé au premier usage
+    static TaskScheduler& shared();
+
+    // fork() : faux pendant un calcul parallèle de l'ordonnanceur commun (tâches en file
+    // ou en cours) ou depuis un worker. Des workers endormis ne tiennent aucun verrou.
+    static bool canFork();
+    // Dans le processus fils : les workers hérités n'existent plus, shared() y renvoie
+    // désormais un nouvel ordonnanceur propre au fils (jamais détruit, sortie par _exit)
+    static void afterForkInChild(size_t workers = 1);
+
+    size_t getWorkersCount() const;
+    size_t getNodesCount() const;
+    int getNode(size_t worker) const;
+    int getCpu(size_t worker) const;   // -1 si le worker n'est pas fixé
+    size_t getStealsCount() const;
+
+    // body(début, fin) sur des tranches d'au plus grain éléments, découpées récursivement
+    template <typename Body>
+    void parallelFor(size_t begin, size_t end, size_t grain, const Body& body);
+
+private:
+    friend class TaskGroup;
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+        int node = 0;
+        int cpu = -1;
+        std::vector<size_t> victims;   // Même nœud d'abord
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    size_t nodesCount;
+    std::mutex injectedMutex;
+    std::deque<std::function<void()>> injected;   // Tâches soumises hors des workers
+    std::atomic<size_t> queued;
+    std::atomic<size_t> running;    // Tâches retirées d'une file et pas encore terminées
+    std::atomic<size_t> sleeping;
+    std::atomic<size_t> steals;
+    std::atomic<bool> stopping;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+
+    void push(std::function<void()> task);
+    bool runOne();
+    bool pop(std::function<void()>& task);
+    void loop(size_t index);
+    int currentWorker() const;
+    void placeWorkers(bool pinned);
+};
+
+// Groupe de tâches fork/join : run() lance, wait() attend la fin de toutes les tâches
+// lancées et relance la première exception levée par l'une d'elles.
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskScheduler& scheduler = TaskScheduler::shared());
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(std::function<void()> task);
+    void wait();
+
+private:
+    TaskScheduler& scheduler;
+    std::atomic<size_t> pending;
+    std::mutex errorMutex;
+    std::exception_ptr error;
+};
+
+template <typename Body>
+void TaskScheduler::parallelFor(size_t begin, size_t end, size_t grain, const Body& body) {
+    if (begin >= end) {
+        return;
+    }
+    if (grain == 0) {
+        grain = 1;
+    }
+    if (end - begin <= grain || workers.empty()) {
+        body(begin, end);
+        return;
+    }
+    // Moitié haute offerte au vol, moitié basse traitée sur place
+    size_t middle = begin + (end - begin) / 2;
+    TaskGroup group(*this);
+    group.run([this, middle, end, grain, &body]() { parallelFor(middle, end, grain, body); });
+    parallelFor(begin, middle, grain, body);
+    group.wait();
+}
+
+#endif
\ No newline at end of file
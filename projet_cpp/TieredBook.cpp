@@ -0,0 +1,587 @@
+#include "TieredBook.h"
+#include "DateUtils.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+const uint32_t SEGMENT_MAGIC = 0x47455343;   // "CSEG"
+// Version 2 : participation de chaque prêteur des facilities (la version 1 reste lisible,
+// ses participations sont réparties à parts égales)
+const uint32_t SEGMENT_VERSION = 2;
+const size_t HEADER_SIZE = 32;
+const size_t DIRECTORY_ENTRY_SIZE = 16;
+
+// Écriture compacte : varints, dates en écart, chaînes par indice de dictionnaire
+class SegmentWriter {
+public:
+    explicit SegmentWriter(std::vector<uint8_t>& out) : out(out) {}
+
+    void putFixed(uint64_t value, size_t bytes) {
+        for (size_t i = 0; i < bytes; i++) {
+            out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    void putVarint(uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    void putSigned(int64_t value) {
+        putVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    void putDouble(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        putFixed(bits, 8);
+    }
+
+    void putString(const std::string& value) {
+        auto inserted = ids.emplace(value, strings.size());
+        if (inserted.second) {
+            strings.push_back(value);
+        }
+        putVarint(inserted.first->second);
+    }
+
+    void putDictionary() {
+        putVarint(strings.size());
+        for (const std::string& value : strings) {
+            putVarint(value.size());
+            out.insert(out.end(), value.begin(), value.end());
+        }
+    }
+
+private:
+    std::vector<uint8_t>& out;
+    std::unordered_map<std::string, uint64_t> ids;
+    std::vector<std::string> strings;
+};
+
+class SegmentReader {
+public:
+    SegmentReader(const uint8_t* data, size_t size) : data(data), size(size), position(0) {}
+
+    uint64_t getFixed(size_t bytes) {
+        require(bytes);
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; i++) {
+            value |= static_cast<uint64_t>(data[position + i]) << (8 * i);
+        }
+        position += bytes;
+        return value;
+    }
+
+    uint64_t getVarint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            require(1);
+            uint8_t byte = data[position++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw std::runtime_error("Corrupted cold segment: varint too long");
+    }
+
+    int64_t getSigned() {
+        uint64_t value = getVarint();
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    int getDay(int base) {
+        return static_cast<int>(base + getSigned());
+    }
+
+    double getDouble() {
+        uint64_t bits = getFixed(8);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::string getBytes(size_t length) {
+        require(length);
+        std::string value(reinterpret_cast<const char*>(data + position), length);
+        position += length;
+        return value;
+    }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t position;
+
+    void require(size_t bytes) const {
+        if (bytes > size - position) {
+            throw std::runtime_error("Corrupted cold segment: truncated record");
+        }
+    }
+};
+
+const std::string& wordOf(SegmentReader& in, const std::vector<std::string>& dictionary) {
+    uint64_t id = in.getVarint();
+    if (id >= dictionary.size()) {
+        throw std::runtime_error("Corrupted cold segment: unknown string");
+    }
+    return dictionary[id];
+}
+
+std::vector<Lender> lendersOf(SegmentReader& in, const std::vector<std::string>& dictionary) {
+    std::vector<Lender> lenders;
+    size_t count = in.getVarint();
+    for (size_t i = 0; i < count; i++) {
+        lenders.push_back(Lender(wordOf(in, dictionary)));
+    }
+    return lenders;
+}
+
+void encodeDeal(SegmentWriter& out, const Deal& deal) {
+    int signDay = toDayNumber(deal.getContractSignDate());
+    out.putString(deal.getContractNum());
+    out.putString(deal.getAgent());
+    out.putString(deal.getBorrower().getName());
+    out.putString(deal.getCurrency());
+    out.putSigned(deal.getProjectMoney().getUnits());
+    out.putVarint(static_cast<uint64_t>(deal.getStatus()));
+    out.putSigned(signDay);
+    out.putSigned(toDayNumber(deal.getContractEndDate()) - signDay);
+    out.putVarint(deal.getPool().size());
+    for (const Lender& lender : deal.getPool()) {
+        out.putString(lender.getName());
+    }
+
+    out.putVarint(deal.getFacilitiesCount());
+    for (const Facility& facility : deal.getFacilities()) {
+        int startDay = toDayNumber(facility.getStartDate());
+        out.putSigned(startDay - signDay);
+        out.putSigned(toDayNumber(facility.getEndDate()) - startDay);
+        out.putSigned(facility.getAmountMoney().getUnits());
+        out.putString(facility.getCurrency());
+        out.putDouble(facility.getAnnualInterestRate());
+        out.putVarint(facility.isFloating() ? 1 : 0);
+        if (facility.isFloating()) {
+            out.putString(facility.getCurveCurrency().toString());
+            out.putDouble(facility.getSpread());
+        }
+        out.putVarint(facility.getLenders().size());
+        for (size_t i = 0; i < facility.getLenders().size(); i++) {
+            out.putString(facility.getLenders()[i].getName());
+            out.putSigned(facility.getShares()[i].getUnits());
+        }
+
+        // Parts dans leur ordre d'ajout, chaque date en écart avec la précédente
+        int previous = startDay;
+        out.putVarint(facility.getPartsCount());
+        for (const Part& part : facility.getParts()) {
+            int day = toDayNumber(part.getDate());
+            out.putSigned(day - previous);
+            out.putSigned(part.getMoney().getUnits());
+            previous = day;
+        }
+        out.putSigned(toDayNumber(facility.getAccrualDate()) - startDay);
+    }
+}
+
+Deal decodeDeal(SegmentReader& in, const std::vector<std::string>& dictionary, uint32_t formatVersion) {
+    std::string contractNum = wordOf(in, dictionary);
+    std::string agent = wordOf(in, dictionary);
+    std::string borrower = wordOf(in, dictionary);
+    std::string currency = wordOf(in, dictionary);
+    Money projectAmount = Money::fromUnits(in.getSigned());
+    Deal::Status status = in.getVarint() == 0 ? Deal::Status::TERMINATED : Deal::Status::CLOSED;
+    int signDay = in.getDay(0);
+    int endDay = in.getDay(signDay);
+    std::vector<Lender> pool = lendersOf(in, dictionary);
+
+    Deal deal(contractNum, agent, pool, Borrower(borrower), projectAmount.toDouble(), currency,
+              toDateString(signDay), toDateString(endDay), status);
+
+    size_t facilitiesCount = in.getVarint();
+    for (size_t f = 0; f < facilitiesCount; f++) {
+        int startDay = in.getDay(signDay);
+        int facilityEnd = in.getDay(startDay);
+        Money amount = Money::fromUnits(in.getSigned());
+        std::string facilityCurrency = wordOf(in, dictionary);
+        double rate = in.getDouble();
+        bool floating = in.getVarint() != 0;
+        std::string curveCurrency;
+        double spread = 0;
+        if (floating) {
+            curveCurrency = wordOf(in, dictionary);
+            spread = in.getDouble();
+        }
+        std::vector<Lender> lenders;
+        std::vector<Money> shares;
+        if (formatVersion == 1) {
+            lenders = lendersOf(in, dictionary);
+        } else {
+            size_t lendersCount = in.getVarint();
+            for (size_t i = 0; i < lendersCount; i++) {
+                lenders.push_back(Lender(wordOf(in, dictionary)));
+                shares.push_back(Money::fromUnits(in.getSigned()));
+            }
+        }
+
+        Facility facility(toDateString(startDay), toDateString(facilityEnd), amount.toDouble(),
+                          facilityCurrency, lenders, rate);
+        if (!shares.empty()) {
+            facility.setShares(shares);
+        }
+        if (floating) {
+            facility.setFloatingRate(curveCurrency, spread);
+        }
+        int previous = startDay;
+        size_t partsCount = in.getVarint();
+        for (size_t p = 0; p < partsCount; p++) {
+            previous = in.getDay(previous);
+            facility.addPart(Part(Money::fromUnits(in.getSigned()), toDateString(previous)));
+        }
+        facility.accrueTo(toDateString(in.getDay(startDay)));
+        deal.addFacility(std::move(facility));
+    }
+    return deal;
+}
+
+// Numéro d'un fichier "segment-NNNNNN.cold", faux pour un autre nom
+bool segmentNumber(const std::string& name, uint32_t& number) {
+    const std::string prefix = "segment-";
+    const std::string suffix = ".cold";
+    if (name.size() <= prefix.size() + suffix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+        name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+        return false;
+    }
+    std::string digits = name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+    if (digits.size() > 9 || digits.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    number = static_cast<uint32_t>(std::stoul(digits));
+    return true;
+}
+
+}
+
+// Segment froid
+
+ColdSegment::ColdSegment(const std::string& path)
+    : path(path), data(nullptr), size(0), formatVersion(0), dealsCount(0), dictionaryOffset(0), directoryOffset(0) {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open cold segment: " + path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(HEADER_SIZE)) {
+        ::close(fd);
+        throw std::runtime_error("Invalid cold segment: " + path);
+    }
+    size = static_cast<size_t>(info.st_size);
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Cannot map cold segment: " + path);
+    }
+    data = static_cast<const uint8_t*>(mapped);
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open cold segment: " + path);
+    }
+    buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    data = buffer.data();
+    size = buffer.size();
+#endif
+
+    try {
+        readHeader();
+    } catch (...) {
+#ifndef _WIN32
+        ::munmap(const_cast<uint8_t*>(data), size);
+#endif
+        throw;
+    }
+}
+
+ColdSegment::~ColdSegment() {
+#ifndef _WIN32
+    ::munmap(const_cast<uint8_t*>(data), size);
+#endif
+}
+
+void ColdSegment::write(const std::string& path, const std::vector<const Deal*>& deals) {
+    std::vector<uint8_t> bytes(HEADER_SIZE, 0);
+    SegmentWriter out(bytes);
+
+    struct Entry {
+        uint32_t code;
+        uint32_t length;
+        uint64_t offset;
+    };
+    std::vector<Entry> entries;
+    for (const Deal* deal : deals) {
+        size_t offset = bytes.size();
+        encodeDeal(out, *deal);
+        entries.push_back({deal->getContractNumber().getCode(), static_cast<uint32_t>(bytes.size() - offset), offset});
+    }
+
+    uint64_t dictionaryOffset = bytes.size();
+    out.putDictionary();
+
+    // Répertoire à taille fixe trié par code : recherche dichotomique dans la projection
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.code < b.code; });
+    uint64_t directoryOffset = bytes.size();
+    for (const Entry& entry : entries) {
+        out.putFixed(entry.code, 4);
+        out.putFixed(entry.length, 4);
+        out.putFixed(entry.offset, 8);
+    }
+
+    std::vector<uint8_t> header;
+    SegmentWriter headerOut(header);
+    headerOut.putFixed(SEGMENT_MAGIC, 4);
+    headerOut.putFixed(SEGMENT_VERSION, 4);
+    headerOut.putFixed(entries.size(), 4);
+    headerOut.putFixed(0, 4);
+    headerOut.putFixed(dictionaryOffset, 8);
+    headerOut.putFixed(directoryOffset, 8);
+    std::copy(header.begin(), header.end(), bytes.begin());
+
+    // Écriture dans un fichier temporaire puis renommage : un segment est complet ou absent
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error("Cannot write cold segment: " + path);
+        }
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file) {
+            throw std::runtime_error("Cannot write cold segment: " + path);
+        }
+    }
+    std::filesystem::rename(temporary, path);
+}
+
+bool ColdSegment::hasDeal(const std::string& contractNum) const {
+    uint64_t offset;
+    uint32_t length;
+    return locate(contractNum, offset, length);
+}
+
+Deal ColdSegment::loadDeal(const std::string& contractNum) const {
+    uint64_t offset;
+    uint32_t length;
+    if (!locate(contractNum, offset, length)) {
+        throw std::invalid_argument("Unknown contract number: " + contractNum);
+    }
+    std::call_once(dictionaryLoaded, [this]() { loadDictionary(); });
+    SegmentReader in(data + offset, length);
+    return decodeDeal(in, dictionary, formatVersion);
+}
+
+std::vector<std::string> ColdSegment::getContracts() const {
+    std::call_once(dictionaryLoaded, [this]() { loadDictionary(); });
+    std::vector<std::string> contracts;
+    contracts.reserve(dealsCount);
+    SegmentReader directory(data + directoryOffset, dealsCount * DIRECTORY_ENTRY_SIZE);
+    for (size_t i = 0; i < dealsCount; i++) {
+        directory.getFixed(4);
+        uint32_t length = static_cast<uint32_t>(directory.getFixed(4));
+        // Le numéro de contrat est la première chaîne de l'enregistrement
+        uint64_t offset = directory.getFixed(8);
+        if (offset < HEADER_SIZE || offset > dictionaryOffset || length > dictionaryOffset - offset) {
+            throw std::runtime_error("Corrupted cold segment: " + path);
+        }
+        SegmentReader record(data + offset, length);
+        contracts.push_back(dictionary.at(record.getVarint()));
+    }
+    return contracts;
+}
+
+const std::string& ColdSegment::getPath() const {
+    return path;
+}
+
+size_t ColdSegment::getDealsCount() const {
+    return dealsCount;
+}
+
+size_t ColdSegment::getSizeInBytes() const {
+    return size;
+}
+
+bool ColdSegment::locate(const std::string& contractNum, uint64_t& offset, uint32_t& length) const {
+    if (!ContractNumber::isValid(contractNum)) {
+        return false;
+    }
+    uint32_t code = ContractNumber::parse(contractNum).getCode();
+    size_t low = 0;
+    size_t high = dealsCount;
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        SegmentReader entry(data + directoryOffset + middle * DIRECTORY_ENTRY_SIZE, DIRECTORY_ENTRY_SIZE);
+        uint32_t entryCode = static_cast<uint32_t>(entry.getFixed(4));
+        if (entryCode == code) {
+            length = static_cast<uint32_t>(entry.getFixed(4));
+            offset = entry.getFixed(8);
+            if (offset < HEADER_SIZE || offset > dictionaryOffset || length > dictionaryOffset - offset) {
+                throw std::runtime_error("Corrupted cold segment: " + path);
+            }
+            return true;
+        }
+        if (entryCode < code) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return false;
+}
+
+void ColdSegment::loadDictionary() const {
+    SegmentReader in(data + dictionaryOffset, directoryOffset - dictionaryOffset);
+    size_t count = in.getVarint();
+    dictionary.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        dictionary.push_back(in.getBytes(in.getVarint()));
+    }
+}
+
+void ColdSegment::readHeader() {
+    SegmentReader in(data, size);
+    if (in.getFixed(4) != SEGMENT_MAGIC) {
+        throw std::runtime_error("Invalid cold segment: " + path);
+    }
+    formatVersion = static_cast<uint32_t>(in.getFixed(4));
+    if (formatVersion < 1 || formatVersion > SEGMENT_VERSION) {
+        throw std::runtime_error("Invalid cold segment: " + path);
+    }
+    dealsCount = in.getFixed(4);
+    in.getFixed(4);
+    dictionaryOffset = in.getFixed(8);
+    directoryOffset = in.getFixed(8);
+    if (dictionaryOffset < HEADER_SIZE || directoryOffset < dictionaryOffset ||
+        directoryOffset + dealsCount * DIRECTORY_ENTRY_SIZE != size) {
+        throw std::runtime_error("Invalid cold segment: " + path);
+    }
+}
+
+// Book hiérarchisé
+
+TieredBook::TieredBook(BookStore& book, const std::string& directory)
+    : book(book), directory(directory), nextSegment(1) {
+    std::filesystem::create_directories(directory);
+
+    // Segments existants dans l'ordre de leur numéro ; le prochain suit le plus grand,
+    // même si des segments plus anciens ont été supprimés
+    std::vector<std::pair<uint32_t, std::string>> paths;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        uint32_t number;
+        if (segmentNumber(entry.path().filename().string(), number)) {
+            paths.push_back({number, entry.path().string()});
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    for (const auto& path : paths) {
+        segments.push_back(std::make_unique<ColdSegment>(path.second));
+        nextSegment = path.first + 1;
+    }
+}
+
+size_t TieredBook::archiveTerminated() {
+    std::vector<DealHandle> handles;
+    std::vector<const Deal*> terminated;
+    for (DealHandle handle : book.getHandles()) {
+        const Deal& deal = book.getDeal(handle);
+        if (deal.isCompleted()) {
+            handles.push_back(handle);
+            terminated.push_back(&deal);
+        }
+    }
+    if (terminated.empty()) {
+        return 0;
+    }
+
+    // Le segment est écrit et relu avant le retrait : aucun deal n'est perdu en cas d'erreur
+    std::string path = segmentPath(nextSegment);
+    ColdSegment::write(path, terminated);
+    segments.push_back(std::make_unique<ColdSegment>(path));
+    nextSegment++;
+
+    for (DealHandle handle : handles) {
+        book.removeDeal(handle);
+    }
+    return handles.size();
+}
+
+bool TieredBook::isArchived(const std::string& contractNum) const {
+    for (const auto& segment : segments) {
+        if (segment->hasDeal(contractNum)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Deal TieredBook::loadArchived(const std::string& contractNum) const {
+    for (auto it = segments.rbegin(); it != segments.rend(); ++it) {
+        if ((*it)->hasDeal(contractNum)) {
+            return (*it)->loadDeal(contractNum);
+        }
+    }
+    throw std::invalid_argument("Contract is not archived: " + contractNum);
+}
+
+std::vector<std::string> TieredBook::getArchivedContracts() const {
+    std::vector<std::string> contracts;
+    std::unordered_set<std::string> seen;
+    for (const auto& segment : segments) {
+        for (std::string& contract : segment->getContracts()) {
+            if (seen.insert(contract).second) {
+                contracts.push_back(std::move(contract));
+            }
+        }
+    }
+    return contracts;
+}
+
+BookStore& TieredBook::getActiveBook() {
+    return book;
+}
+
+size_t TieredBook::getArchivedDealsCount() const {
+    size_t count = 0;
+    for (const auto& segment : segments) {
+        count += segment->getDealsCount();
+    }
+    return count;
+}
+
+size_t TieredBook::getSegmentsCount() const {
+    return segments.size();
+}
+
+std::string TieredBook::segmentPath(uint32_t number) const {
+    std::ostringstream name;
+    name << "segment-" << std::setw(6) << std::setfill('0') << number << ".cold";
+    return (std::filesystem::path(directory) / name.str()).string();
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#ifndef TIERED_BOOK_H
+#define TIERED_BOOK_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include "Deal.h"
+#include "BookStore.h"
+
+// Segment froid : deals terminés sérialisés dans un fichier en lecture seule.
+//
+// Fichier : en-tête (magic, version, nombre de deals, positions du dictionnaire et du
+// répertoire), enregistrements des deals, dictionnaire des chaînes (agents, prêteurs,
+// emprunteurs, devises, contrats), puis répertoire trié par code de contrat.
+// Les entiers sont codés en varint, les dates en écart avec la date précédente et
+// chaque chaîne par son indice dans le dictionnaire.
+//
+// Le fichier est projeté en mémoire à l'ouverture ; seul l'en-tête est lu. Un deal
+// n'est décodé que lorsqu'il est demandé, le dictionnaire au premier décodage.
+class ColdSegment {
+public:
+    explicit ColdSegment(const std::string& path);
+    ~ColdSegment();
+
+    ColdSegment(const ColdSegment&) = delete;
+    ColdSegment& operator=(const ColdSegment&) = delete;
+
+    // Écrit les deals dans un nouveau fichier (remplacement atomique)
+    static void write(const std::string& path, const std::vector<const Deal*>& deals);
+
+    bool hasDeal(const std::string& contractNum) const;
+    Deal loadDeal(const std::string& contractNum) const;
+    std::vector<std::string> getContracts() const;
+
+    const std::string& getPath() const;
+    size_t getDealsCount() const;
+    size_t getSizeInBytes() const;
+
+private:
+    std::string path;
+    const uint8_t* data;
+    size_t size;
+    std::vector<uint8_t> buffer;   // Copie du fichier quand la projection n'est pas disponible
+    uint32_t formatVersion;
+    size_t dealsCount;
+    uint64_t dictionaryOffset;
+    uint64_t directoryOffset;
+    mutable std::once_flag dictionaryLoaded;
+    mutable std::vector<std::string> dictionary;
+
+    // Position et taille de l'enregistrement, faux si le contrat est absent
+    bool locate(const std::string& contractNum, uint64_t& offset, uint32_t& length) const;
+    void loadDictionary() const;
+    void readHeader();
+};
+
+// Book hiérarchisé : les deals actifs restent dans le BookStore, les deals terminés
+// sont déplacés vers des segments froids d'un répertoire local. Les calculs sur le
+// book actif (requêtes, portfolios, évaluation) ne voient plus les deals archivés.
+class TieredBook {
+public:
+    // Ouvre les segments déjà présents dans le répertoire (créé si besoin)
+    TieredBook(BookStore& book, const std::string& directory);
+
+    // Déplace les deals terminés du book actif vers un nouveau segment
+    size_t archiveTerminated();
+
+    bool isArchived(const std::string& contractNum) const;
+    // Décodage à la demande depuis le segment le plus récent qui contient le contrat
+    Deal loadArchived(const std::string& contractNum) const;
+    // Contrats archivés, chacun une fois, dans l'ordre des segments
+    std::vector<std::string> getArchivedContracts() const;
+
+    BookStore& getActiveBook();
+    size_t getArchivedDealsCount() const;
+    size_t getSegmentsCount() const;
+
+private:
+    BookStore& book;
+    std::string directory;
+    std::vector<std::unique_ptr<ColdSegment>> segments;
+    uint32_t nextSegment;
+
+    std::string segmentPath(uint32_t number) const;
+};
+
+#endif
\ No newline at end of file
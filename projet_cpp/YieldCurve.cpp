@@ -0,0 +1,286 @@
+#include "YieldCurve.h"
+#include "DateUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Champ numérique entier, sans caractère en trop
+int parseDays(const std::string& field) {
+    size_t end = 0;
+    int days = std::stoi(field, &end);
+    if (end != field.size()) {
+        throw std::invalid_argument("invalid maturity: " + field);
+    }
+    return days;
+}
+
+double parseRate(const std::string& field) {
+    size_t end = 0;
+    double rate = std::stod(field, &end);
+    if (end != field.size() || !std::isfinite(rate)) {
+        throw std::invalid_argument("invalid rate: " + field);
+    }
+    return rate;
+}
+
+}
+
+YieldCurve::YieldCurve(const std::string& currency, const std::string& referenceDate,
+                       const std::vector<Pillar>& pillars, Interpolation interpolation, int gridDays)
+    : currency(CurrencyCode::parse(currency)), referenceDay(toDayNumber(referenceDate)),
+      interpolation(interpolation) {
+    validatePillars(pillars);
+    if (gridDays < 0) {
+        throw std::invalid_argument("Grid size cannot be negative");
+    }
+
+    // Pilier implicite à l'origine : facteur d'actualisation 1
+    times.push_back(0);
+    logDiscounts.push_back(0);
+    for (const Pillar& pillar : pillars) {
+        times.push_back(pillar.days);
+        logDiscounts.push_back(-pillar.days / 365.0 * std::log1p(pillar.rate));
+    }
+    computeSlopes();
+
+    grid.resize(static_cast<size_t>(gridDays) + 1);
+    for (size_t day = 0; day < grid.size(); day++) {
+        grid[day] = std::exp(interpolateLog(static_cast<double>(day)));
+    }
+}
+
+double YieldCurve::discountFactor(double years) const {
+    return std::exp(interpolateLog(years * 365.0));
+}
+
+double YieldCurve::discountFactorForDays(int days) const {
+    if (days >= 0 && static_cast<size_t>(days) < grid.size()) {
+        return grid[days];
+    }
+    return std::exp(interpolateLog(days));
+}
+
+double YieldCurve::discountFactorBetween(int fromDay, int toDay) const {
+    return discountFactorForDays(toDay - referenceDay) / discountFactorForDays(fromDay - referenceDay);
+}
+
+double YieldCurve::zeroRate(int day) const {
+    int days = std::max(1, day - referenceDay);
+    return std::pow(discountFactorForDays(days), -365.0 / days) - 1.0;
+}
+
+double YieldCurve::forwardRate(int fromDay, int toDay) const {
+    // Les périodes passées sont ramenées à la date de référence de la courbe
+    int from = std::max(fromDay, referenceDay);
+    int to = std::max(toDay, from + 1);
+    return std::pow(discountFactorBetween(from, to), -365.0 / (to - from)) - 1.0;
+}
+
+std::string YieldCurve::getCurrency() const {
+    return currency.toString();
+}
+
+CurrencyCode YieldCurve::getCurrencyCode() const {
+    return currency;
+}
+
+int YieldCurve::getReferenceDay() const {
+    return referenceDay;
+}
+
+YieldCurve::Interpolation YieldCurve::getInterpolation() const {
+    return interpolation;
+}
+
+size_t YieldCurve::getPillarsCount() const {
+    return times.size() - 1;
+}
+
+size_t YieldCurve::getGridDays() const {
+    return grid.size() - 1;
+}
+
+double YieldCurve::interpolateLog(double days) const {
+    if (days <= 0) {
+        // Avant la référence : prolongement du premier forward
+        return slopes.front() * days;
+    }
+    size_t last = times.size() - 1;
+    if (days >= times[last]) {
+        // Au-delà du dernier pilier : forward constant
+        return logDiscounts[last] + slopes[last] * (days - times[last]);
+    }
+
+    size_t i = std::upper_bound(times.begin(), times.end(), days) - times.begin() - 1;
+    double h = times[i + 1] - times[i];
+    double s = (days - times[i]) / h;
+    if (interpolation == Interpolation::LINEAR) {
+        return logDiscounts[i] + s * (logDiscounts[i + 1] - logDiscounts[i]);
+    }
+
+    // Hermite cubique avec les pentes monotones
+    double s2 = s * s;
+    double s3 = s2 * s;
+    return (2 * s3 - 3 * s2 + 1) * logDiscounts[i] + (s3 - 2 * s2 + s) * h * slopes[i] +
+           (-2 * s3 + 3 * s2) * logDiscounts[i + 1] + (s3 - s2) * h * slopes[i + 1];
+}
+
+void YieldCurve::computeSlopes() {
+    size_t n = times.size();
+    std::vector<double> secants(n - 1);
+    for (size_t i = 0; i + 1 < n; i++) {
+        secants[i] = (logDiscounts[i + 1] - logDiscounts[i]) / (times[i + 1] - times[i]);
+    }
+
+    slopes.assign(n, 0);
+    if (interpolation == Interpolation::LINEAR) {
+        // Pente du segment de gauche, utilisée pour le prolongement au-delà des piliers
+        slopes[0] = secants[0];
+        for (size_t i = 1; i < n; i++) {
+            slopes[i] = secants[i - 1];
+        }
+        return;
+    }
+
+    // Pentes de Fritsch-Carlson : moyenne harmonique pondérée, nulle aux extrema locaux
+    slopes[0] = secants[0];
+    slopes[n - 1] = secants[n - 2];
+    for (size_t i = 1; i + 1 < n; i++) {
+        if (secants[i - 1] * secants[i] <= 0) {
+            slopes[i] = 0;
+            continue;
+        }
+        double h0 = times[i] - times[i - 1];
+        double h1 = times[i + 1] - times[i];
+        double w0 = 2 * h1 + h0;
+        double w1 = h1 + 2 * h0;
+        slopes[i] = (w0 + w1) / (w0 / secants[i - 1] + w1 / secants[i]);
+    }
+}
+
+void YieldCurve::validatePillars(const std::vector<Pillar>& pillars) const {
+    if (pillars.empty()) {
+        throw std::invalid_argument("Curve needs at least one pillar");
+    }
+    int previous = 0;
+    for (const Pillar& pillar : pillars) {
+        if (pillar.days <= previous) {
+            throw std::invalid_argument("Curve pillars must have strictly increasing positive maturities");
+        }
+        if (pillar.rate <= -1.0) {
+            throw std::invalid_argument("Curve rate must be greater than -100%");
+        }
+        previous = pillar.days;
+    }
+}
+
+// Courbes du marché
+
+void CurveStore::add(const YieldCurve& curve) {
+    curves.erase(curve.getCurrencyCode());
+    curves.emplace(curve.getCurrencyCode(), curve);
+}
+
+size_t CurveStore::load(const std::string& path, YieldCurve::Interpolation interpolation) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open curve file: " + path);
+    }
+
+    // Piliers regroupés par devise (code analysé, pas le texte du fichier), triés par maturité
+    struct Definition {
+        int referenceDay;
+        size_t firstLine;
+        std::map<int, double> pillars;
+    };
+    std::map<CurrencyCode, Definition> definitions;
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::vector<std::string> fields;
+        std::stringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, ',')) {
+            fields.push_back(field);
+        }
+        try {
+            if (fields.size() != 4) {
+                throw std::invalid_argument("expected 4 fields");
+            }
+            CurrencyCode currency = CurrencyCode::parse(fields[0]);
+            int referenceDay = toDayNumber(fields[1]);
+            int days = parseDays(fields[2]);
+            double rate = parseRate(fields[3]);
+            if (days <= 0) {
+                throw std::invalid_argument("maturity must be positive");
+            }
+            if (rate <= -1.0) {
+                throw std::invalid_argument("rate must be greater than -100%");
+            }
+
+            auto inserted = definitions.emplace(currency, Definition{referenceDay, lineNumber, {}});
+            Definition& definition = inserted.first->second;
+            if (definition.referenceDay != referenceDay) {
+                throw std::invalid_argument("reference date differs from previous pillars");
+            }
+            if (!definition.pillars.emplace(days, rate).second) {
+                throw std::invalid_argument("duplicate maturity " + fields[2] + " for " + currency.toString());
+            }
+        } catch (const std::exception& e) {
+            throw std::invalid_argument("Invalid curve line " + std::to_string(lineNumber) + ": " + e.what());
+        }
+    }
+
+    // Courbes construites avant d'en remplacer une seule : un fichier invalide est sans effet
+    std::vector<YieldCurve> loaded;
+    for (const auto& definition : definitions) {
+        std::vector<YieldCurve::Pillar> pillars;
+        for (const auto& pillar : definition.second.pillars) {
+            pillars.push_back({pillar.first, pillar.second});
+        }
+        try {
+            loaded.push_back(YieldCurve(definition.first.toString(), toDateString(definition.second.referenceDay),
+                                        pillars, interpolation));
+        } catch (const std::exception& e) {
+            throw std::invalid_argument("Invalid curve " + definition.first.toString() + " starting at line " +
+                                        std::to_string(definition.second.firstLine) + ": " + e.what());
+        }
+    }
+    for (const YieldCurve& curve : loaded) {
+        add(curve);
+    }
+    return loaded.size();
+}
+
+bool CurveStore::has(const std::string& currency) const {
+    return CurrencyCode::isValid(currency) && curves.count(CurrencyCode::parse(currency)) > 0;
+}
+
+const YieldCurve& CurveStore::get(const std::string& currency) const {
+    return get(CurrencyCode::parse(currency));
+}
+
+const YieldCurve& CurveStore::get(CurrencyCode currency) const {
+    auto it = curves.find(currency);
+    if (it == curves.end()) {
+        throw std::invalid_argument("No curve for currency: " + currency.toString());
+    }
+    return it->second;
+}
+
+size_t CurveStore::getCurvesCount() const {
+    return curves.size();
+}
\ No newline at end of file
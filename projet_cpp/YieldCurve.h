@@ -0,0 +1,81 @@
+#ifndef YIELD_CURVE_H
+#define YIELD_CURVE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "Pricing.h"
+#include "CurrencyCode.h"
+
+// Courbe de taux d'une devise construite à partir de piliers (maturité en jours, taux
+// zéro annuel composé). L'interpolation porte sur le logarithme des facteurs
+// d'actualisation ; les facteurs sont précalculés sur une grille journalière afin que
+// l'actualisation d'un flux daté soit une simple lecture de table.
+class YieldCurve : public DiscountCurve {
+public:
+    enum class Interpolation {
+        LINEAR,          // Log-linéaire : forwards constants entre piliers
+        MONOTONE_CUBIC   // Hermite monotone (Fritsch-Carlson) : forwards continus
+    };
+
+    struct Pillar {
+        int days;
+        double rate;
+    };
+
+    static const int DEFAULT_GRID_DAYS = 50 * 365;
+
+    YieldCurve(const std::string& currency, const std::string& referenceDate, const std::vector<Pillar>& pillars,
+               Interpolation interpolation = Interpolation::MONOTONE_CUBIC, int gridDays = DEFAULT_GRID_DAYS);
+
+    double discountFactor(double years) const override;
+    double discountFactorForDays(int days) const override;
+    double discountFactorBetween(int fromDay, int toDay) const override;
+
+    // Taux zéro et taux forward annuels composés, dates en numéros de jour
+    double zeroRate(int day) const;
+    double forwardRate(int fromDay, int toDay) const;
+
+    std::string getCurrency() const;
+    CurrencyCode getCurrencyCode() const;
+    int getReferenceDay() const;
+    Interpolation getInterpolation() const;
+    size_t getPillarsCount() const;
+    size_t getGridDays() const;
+
+private:
+    CurrencyCode currency;
+    int referenceDay;
+    Interpolation interpolation;
+    std::vector<double> times;
+    std::vector<double> logDiscounts;
+    std::vector<double> slopes;
+    std::vector<double> grid;
+
+    double interpolateLog(double days) const;
+    void computeSlopes();
+    void validatePillars(const std::vector<Pillar>& pillars) const;
+};
+
+// Courbes du marché, une par devise, chargées depuis un fichier local.
+//
+// Format : une ligne par pilier "DEVISE,date de référence,maturité en jours,taux",
+// lignes vides et lignes commençant par '#' ignorées. Chaque ligne est contrôlée à la
+// lecture (devise, date, maturité positive, taux supérieur à -100 %, maturité pas encore
+// vue pour la devise) : une erreur donne le numéro de la ligne fautive.
+class CurveStore {
+public:
+    void add(const YieldCurve& curve);
+    size_t load(const std::string& path,
+                YieldCurve::Interpolation interpolation = YieldCurve::Interpolation::MONOTONE_CUBIC);
+
+    bool has(const std::string& currency) const;
+    const YieldCurve& get(const std::string& currency) const;
+    const YieldCurve& get(CurrencyCode currency) const;
+    size_t getCurvesCount() const;
+
+private:
+    std::unordered_map<CurrencyCode, YieldCurve> curves;
+};
+
+#endif
\ No newline at end of file
@@ -1,333 +1,2327 @@
-#include <iostream>
-#include <cassert>
-#include <stdexcept>
-#include <vector>
-#include <string>
-
-#include "Borrower.h"
-#include "Lender.h"
-#include "Part.h"
-#include "Facility.h"
-#include "Deal.h"
-#include "Portfolio.h"
-
-// Compteurs pour les tests
-int tests_passed = 0;
-int tests_failed = 0;
-
-#define TEST_ASSERT(condition, test_name) \
-    do { \
-        if (condition) { \
-            std::cout << "PASS: " << test_name << std::endl; \
-            tests_passed++; \
-        } else { \
-            std::cout << "FAIL: " << test_name << std::endl; \
-            tests_failed++; \
-        } \
-    } while(0)
-
-#define TEST_EXCEPTION(code, exception_type, test_name) \
-    do { \
-        bool caught = false; \
-        try { \
-            code; \
-        } catch (const exception_type&) { \
-            caught = true; \
-        } catch (...) { \
-            caught = false; \
-        } \
-        TEST_ASSERT(caught, test_name); \
-    } while(0)
-
-// Tests pour la classe Borrower
-void test_borrower() {
-    std::cout << "\n=== Tests Borrower ===" << std::endl;
-    
-    // Test constructeur par defaut
-    Borrower defaultBorrower;
-    TEST_ASSERT(defaultBorrower.getName() == "Air France", "Borrower - Constructeur par defaut");
-    
-    // Test constructeur avec parametre
-    Borrower customBorrower("Lufthansa");
-    TEST_ASSERT(customBorrower.getName() == "Lufthansa", "Borrower - Constructeur avec parametre");
-    
-    // Test setter
-    customBorrower.setName("British Airways");
-    TEST_ASSERT(customBorrower.getName() == "British Airways", "Borrower - Setter");
-    
-    // Test validation nom vide
-    TEST_EXCEPTION(customBorrower.setName(""), std::invalid_argument, "Borrower - Validation nom vide");
-}
-
-// Tests pour la classe Lender
-void test_lender() {
-    std::cout << "\n=== Tests Lender ===" << std::endl;
-    
-    // Test constructeur
-    Lender lender("BNP Paribas");
-    TEST_ASSERT(lender.getName() == "BNP Paribas", "Lender - Constructeur");
-    
-    // Test que le nom ne peut pas être modifie (pas de setter)
-    // Ceci est teste par la compilation - si ça compile, c'est bon
-    TEST_ASSERT(true, "Lender - Immutabilite du nom");
-}
-
-// Tests pour la classe Part
-void test_part() {
-    std::cout << "\n=== Tests Part ===" << std::endl;
-    
-    // Test constructeur valide
-    Part validPart(100000.0, "2024-06-01");
-    TEST_ASSERT(validPart.getAmount() == 100000.0, "Part - Montant valide");
-    TEST_ASSERT(validPart.getDate() == "2024-06-01", "Part - Date valide");
-    
-    // Test validation montant negatif
-    TEST_EXCEPTION(Part(-1000.0, "2024-06-01"), std::invalid_argument, "Part - Montant negatif rejete");
-    
-    // Test validation montant zero
-    TEST_EXCEPTION(Part(0.0, "2024-06-01"), std::invalid_argument, "Part - Montant zero rejete");
-    
-    // Test validation date vide
-    TEST_EXCEPTION(Part(1000.0, ""), std::invalid_argument, "Part - Date vide rejetee");
-    
-    // Test validation format date incorrect
-    TEST_EXCEPTION(Part(1000.0, "invalid-date"), std::invalid_argument, "Part - Format date incorrect rejete");
-    
-    // Test validation format date court
-    TEST_EXCEPTION(Part(1000.0, "2024-6-1"), std::invalid_argument, "Part - Format date court rejete");
-}
-
-// Tests pour la classe Facility
-void test_facility() {
-    std::cout << "\n=== Tests Facility ===" << std::endl;
-    
-    // Preparation des lenders
-    std::vector<Lender> lenders = {Lender("BNP"), Lender("SG")};
-    
-    // Test constructeur valide
-    Facility facility("2024-01-01", "2025-01-01", 1000000.0, "EUR", lenders, 0.03);
-    TEST_ASSERT(facility.getAmount() == 1000000.0, "Facility - Montant");
-    TEST_ASSERT(facility.getCurrency() == "EUR", "Facility - Devise");
-    TEST_ASSERT(facility.getAnnualInterestRate() == 0.03, "Facility - Taux d'interêt");
-    TEST_ASSERT(facility.getPartsCount() == 0, "Facility - Pas de parts initialement");
-    TEST_ASSERT(facility.getRemainingAmount() == 1000000.0, "Facility - Montant restant initial");
-    
-    // Test ajout de part valide
-    Part part(100000.0, "2024-06-01");
-    facility.addPart(part);
-    TEST_ASSERT(facility.getPartsCount() == 1, "Facility - Ajout part");
-    TEST_ASSERT(facility.getRemainingAmount() == 900000.0, "Facility - Montant restant apres part");
-    
-    // Test payPart
-    facility.payPart(200000.0, "2024-12-01");
-    TEST_ASSERT(facility.getPartsCount() == 2, "Facility - PayPart ajoute une part");
-    TEST_ASSERT(facility.getRemainingAmount() == 700000.0, "Facility - Montant restant apres payPart");
-    
-    // Test validation montant negatif
-    TEST_EXCEPTION(Facility("2024-01-01", "2025-01-01", -1000.0, "EUR", lenders, 0.03), 
-                   std::invalid_argument, "Facility - Montant negatif rejete");
-    
-    // Test validation taux negatif
-    TEST_EXCEPTION(Facility("2024-01-01", "2025-01-01", 1000000.0, "EUR", lenders, -0.01), 
-                   std::invalid_argument, "Facility - Taux negatif rejete");
-    
-    // Test validation dates incorrectes (fin avant debut)
-    TEST_EXCEPTION(Facility("2025-01-01", "2024-01-01", 1000000.0, "EUR", lenders, 0.03), 
-                   std::invalid_argument, "Facility - Date fin avant debut rejetee");
-    
-    // Test validation devise vide
-    std::vector<Lender> emptyLenders;
-    TEST_EXCEPTION(Facility("2024-01-01", "2025-01-01", 1000000.0, "", lenders, 0.03), 
-                   std::invalid_argument, "Facility - Devise vide rejetee");
-    
-    // Test validation lenders vides
-    TEST_EXCEPTION(Facility("2024-01-01", "2025-01-01", 1000000.0, "EUR", emptyLenders, 0.03), 
-                   std::invalid_argument, "Facility - Lenders vides rejetes");
-    
-    // Test part qui depasse le montant restant
-    Facility smallFacility("2024-01-01", "2025-01-01", 100000.0, "EUR", lenders, 0.03);
-    TEST_EXCEPTION(smallFacility.addPart(Part(200000.0, "2024-06-01")), 
-                   std::invalid_argument, "Facility - Part depassant le montant rejetee");
-}
-
-// Tests pour la classe Deal
-void test_deal() {
-    std::cout << "\n=== Tests Deal ===" << std::endl;
-    
-    // Preparation des donnees
-    std::vector<Lender> pool = {Lender("BNP"), Lender("SG")};
-    Borrower borrower("Air France");
-    
-    // Test constructeur valide
-    Deal deal("S1234", "BNP Paribas", pool, borrower, 10000000.0, "EUR", 
-              "2024-01-01", "2025-01-01", Deal::Status::CLOSED);
-    
-    TEST_ASSERT(deal.getContractNum() == "S1234", "Deal - Numero de contrat");
-    TEST_ASSERT(deal.getAgent() == "BNP Paribas", "Deal - Agent");
-    TEST_ASSERT(deal.getProjectAmount() == 10000000.0, "Deal - Montant projet");
-    TEST_ASSERT(deal.getCurrency() == "EUR", "Deal - Devise");
-    TEST_ASSERT(deal.getStatus() == Deal::Status::CLOSED, "Deal - Statut");
-    TEST_ASSERT(deal.getStatusString() == "closed", "Deal - Statut string");
-    TEST_ASSERT(deal.getFacilitiesCount() == 0, "Deal - Pas de facilities initialement");
-    
-    // Test ajout facility
-    Facility facility("2024-01-01", "2025-01-01", 5000000.0, "EUR", pool, 0.03);
-    deal.addFacility(facility);
-    TEST_ASSERT(deal.getFacilitiesCount() == 1, "Deal - Ajout facility");
-    TEST_ASSERT(deal.getTotalFacilitiesAmount() == 5000000.0, "Deal - Total facilities");
-    
-    // Test changement de statut
-    deal.setStatus(Deal::Status::TERMINATED);
-    TEST_ASSERT(deal.getStatus() == Deal::Status::TERMINATED, "Deal - Changement statut");
-    TEST_ASSERT(deal.getStatusString() == "terminated", "Deal - Statut terminated string");
-    TEST_ASSERT(deal.isCompleted() == true, "Deal - Deal complete");
-    
-    // Test validation numero de contrat incorrect
-    TEST_EXCEPTION(Deal("INVALID", "BNP", pool, borrower, 1000000.0, "EUR", 
-                       "2024-01-01", "2025-01-01", Deal::Status::CLOSED), 
-                   std::invalid_argument, "Deal - Numero contrat invalide rejete");
-    
-    // Test validation numero de contrat avec mauvaise lettre
-    TEST_EXCEPTION(Deal("X1234", "BNP", pool, borrower, 1000000.0, "EUR", 
-                       "2024-01-01", "2025-01-01", Deal::Status::CLOSED), 
-                   std::invalid_argument, "Deal - Lettre incorrecte rejetee");
-    
-    // Test validation montant negatif
-    TEST_EXCEPTION(Deal("S1234", "BNP", pool, borrower, -1000000.0, "EUR", 
-                       "2024-01-01", "2025-01-01", Deal::Status::CLOSED), 
-                   std::invalid_argument, "Deal - Montant negatif rejete");
-    
-    // Test validation devise incorrecte
-    TEST_EXCEPTION(Deal("S1234", "BNP", pool, borrower, 1000000.0, "eu", 
-                       "2024-01-01", "2025-01-01", Deal::Status::CLOSED), 
-                   std::invalid_argument, "Deal - Devise incorrecte rejetee");
-    
-    // Test validation pool vide
-    std::vector<Lender> emptyPool;
-    TEST_EXCEPTION(Deal("S1234", "BNP", emptyPool, borrower, 1000000.0, "EUR", 
-                       "2024-01-01", "2025-01-01", Deal::Status::CLOSED), 
-                   std::invalid_argument, "Deal - Pool vide rejete");
-    
-    // Test facility depassant le montant du projet
-    Deal smallDeal("S5678", "BNP", pool, borrower, 1000000.0, "EUR", 
-                   "2024-01-01", "2025-01-01", Deal::Status::CLOSED);
-    Facility largeFacility("2024-01-01", "2025-01-01", 2000000.0, "EUR", pool, 0.03);
-    TEST_EXCEPTION(smallDeal.addFacility(largeFacility), 
-                   std::invalid_argument, "Deal - Facility depassant projet rejetee");
-}
-
-// Tests pour la classe Portfolio
-void test_portfolio() {
-    std::cout << "\n=== Tests Portfolio ===" << std::endl;
-    
-    // Preparation des donnees
-    std::vector<Lender> lenders = {Lender("BNP"), Lender("SG")};
-    Facility facility("2024-01-01", "2025-01-01", 1000000.0, "EUR", lenders, 0.05);
-    
-    // Ajout de quelques remboursements
-    facility.payPart(100000.0, "2024-06-01");
-    facility.payPart(200000.0, "2024-12-01");
-    
-    // Test constructeur
-    Portfolio portfolio(&facility);
-    TEST_ASSERT(portfolio.getTotalAmount() == 1000000.0, "Portfolio - Montant total");
-    TEST_ASSERT(portfolio.getRemainingAmount() == 700000.0, "Portfolio - Montant restant");
-    TEST_ASSERT(portfolio.getNumberOfParts() == 2, "Portfolio - Nombre de parts");
-    
-    // Test calculs (les montants exacts dependent de la formule d'interêt)
-    double totalInterest = portfolio.getTotalInterest();
-    double totalRepayment = portfolio.getTotalRemboursement();
-    TEST_ASSERT(totalInterest > 0, "Portfolio - Interêts calcules");
-    TEST_ASSERT(totalRepayment > portfolio.getTotalAmount(), "Portfolio - Remboursement > montant");
-    TEST_ASSERT(totalRepayment == portfolio.getTotalAmount() + totalInterest, "Portfolio - Coherence calculs");
-    
-    // Test synchronisation : ajout d'une nouvelle part
-    facility.payPart(150000.0, "2025-01-01");
-    TEST_ASSERT(portfolio.getNumberOfParts() == 3, "Portfolio - Synchronisation nouvelle part");
-    TEST_ASSERT(portfolio.getRemainingAmount() == 550000.0, "Portfolio - Synchronisation montant restant");
-    
-    // Test validation pointeur null
-    TEST_EXCEPTION(Portfolio(nullptr), std::invalid_argument, "Portfolio - Pointeur null rejete");
-}
-
-// Tests d'integration
-void test_integration() {
-    std::cout << "\n=== Tests d'Integration ===" << std::endl;
-    
-    // Scenario complet : Creation d'un deal avec facility et remboursements
-    try {
-        // Creation des acteurs
-        Borrower borrower("Air France");
-        std::vector<Lender> pool = {Lender("BNP Paribas"), Lender("Societe Generale")};
-        
-        // Creation du deal
-        Deal deal("B9876", "BNP Paribas", pool, borrower, 50000000.0, "EUR", 
-                  "2024-01-01", "2026-01-01", Deal::Status::CLOSED);
-        
-        // Creation de la facility
-        Facility facility("2024-01-01", "2026-01-01", 30000000.0, "EUR", pool, 0.04);
-        
-        // Ajout de remboursements
-        facility.payPart(5000000.0, "2024-06-01");
-        facility.payPart(10000000.0, "2025-01-01");
-        facility.payPart(8000000.0, "2025-06-01");
-        
-        // Ajout de la facility au deal
-        deal.addFacility(facility);
-        
-        // Creation du portfolio
-        Portfolio portfolio(&facility);
-        
-        // Verifications finales
-        TEST_ASSERT(deal.getFacilitiesCount() == 1, "Integration - Deal contient facility");
-        TEST_ASSERT(facility.getPartsCount() == 3, "Integration - Facility contient 3 parts");
-        TEST_ASSERT(facility.getRemainingAmount() == 7000000.0, "Integration - Montant restant correct");
-        TEST_ASSERT(portfolio.getNumberOfParts() == 3, "Integration - Portfolio synchronise");
-        TEST_ASSERT(deal.getTotalFacilitiesAmount() <= deal.getProjectAmount(), "Integration - Facilities <= Projet");
-        
-        // Test completion du deal
-        deal.setStatus(Deal::Status::TERMINATED);
-        TEST_ASSERT(deal.isCompleted(), "Integration - Deal termine");
-        
-        std::cout << "PASS: Scenario d'integration complet" << std::endl;
-        tests_passed++;
-        
-    } catch (const std::exception& e) {
-        std::cout << "FAIL: Scenario d'integration - Exception: " << e.what() << std::endl;
-        tests_failed++;
-    }
-}
-
-// Fonction principale des tests
-int main() {
-    std::cout << "Demarrage des tests unitaires du systeme de financement structure\n" << std::endl;
-    
-    try {
-        test_borrower();
-        test_lender();
-        test_part();
-        test_facility();
-        test_deal();
-        test_portfolio();
-        test_integration();
-        
-        std::cout << "\n" << std::string(50, '=') << std::endl;
-        std::cout << "RESULTATS DES TESTS" << std::endl;
-        std::cout << std::string(50, '=') << std::endl;
-        std::cout << "Tests reussis: " << tests_passed << std::endl;
-        std::cout << "Tests echoues: " << tests_failed << std::endl;
-        std::cout << "Taux de reussite: " << (tests_passed * 100.0 / (tests_passed + tests_failed)) << "%" << std::endl;
-        
-        if (tests_failed == 0) {
-            std::cout << "\nTOUS LES TESTS SONT PASSES ! Le systeme fonctionne correctement." << std::endl;
-            return 0;
-        } else {
-            std::cout << "\nCERTAINS TESTS ONT ECHOUE. Verifiez l'implementation." << std::endl;
-            return 1;
-        }
-        
-    } catch (const std::exception& e) {
-        std::cout << "ERREUR FATALE lors des tests: " << e.what() << std::endl;
-        return 1;
-    }
+#include <iostream>
+#include <cassert>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <filesystem>
+#include <sstream>
+#include <type_traits>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "Borrower.h"
+#include "Lender.h"
+#include "Part.h"
+#include "Facility.h"
+#include "Deal.h"
+#include "Portfolio.h"
+#include "BorrowerIndex.h"
+#include "ColumnarExporter.h"
+#include "Bitmap.h"
+#include "QueryEngine.h"
+#include "BufferWriter.h"
+#include "ReportRenderer.h"
+#include "DateUtils.h"
+#include "CalendarIndex.h"
+#include "Money.h"
+#include "CurrencyCode.h"
+#include "ContractNumber.h"
+#include "BookStore.h"
+#include "BookServer.h"
+#include "BookClient.h"
+#include "Pricing.h"
+#include "YieldCurve.h"
+#include "GrowthFactorCache.h"
+#include "TieredBook.h"
+#include "ImportPipeline.h"
+#include "BookHistory.h"
+#include "ParticipationMarket.h"
+#include "CovenantEngine.h"
+#include "BookDigest.h"
+#include "ChangeStream.h"
+#include "TaskScheduler.h"
+#include "ShardCoordinator.h"
+#include "PartHistory.h"
+
+// Compteurs pour les tests
+int tests_passed = 0;
+int tests_failed = 0;
+
+#define TEST_ASSERT(condition, test_name) \
+    do { \
+        if (condition) { \
+            std::cout << "PASS: " << test_name << std::endl; \
+            tests_passed++; \
+        } else { \
+            std::cout << "FAIL: " << test_name << std::endl; \
+            tests_failed++; \
+        } \
+    } while(0)
+
+#define TEST_EXCEPTION(code, exception_type, test_name) \
+    do { \
+        bool caught = false; \
+        try { \
+            code; \
+        } catch (const exception_type&) { \
+            caught = true; \
+        } catch (...) { \
+            caught = false; \
+        } \
+        TEST_ASSERT(caught, test_name); \
+    } while(0)
+
+// Tests pour la classe Borrower
+void test_borrower() {
+    std::cout << "\n=== Tests Borrower ===" << std::endl;
+    
+    // Test constructeur par defaut
+    Borrower defaultBorrower;
+    TEST_ASSERT(defaultBorrower.getName() == "Air France", "Borrower - Constructeur par defaut");
+    
+    // Test constructeur avec parametre
+    Borrower customBorrower("Lufthansa");
+    TEST_ASSERT(customBorrower.getName() == "Lufthansa", "Borrower - Constructeur avec parametre");
+    
+    // Test setter
+    customBorrower.setName("British Airways");
+    TEST_ASSERT(customBorrower.getName() == "British Airways", "Borrower - Setter");
+    
+    // Test validation nom vide
+    TEST_EXCEPTION(customBorrower.setName(""), std::invalid_argument, "Borrower - Validation nom vide");
+}
+
+// Tests pour la classe Lender
+void test_lender() {
+    std::cout << "\n=== Tests Lender ===" << std::endl;
+    
+    // Test constructeur
+    Lender lender("BNP Paribas");
+    TEST_ASSERT(lender.getName() == "BNP Paribas", "Lender - Constructeur");
+    
+    // Test que le nom ne peut pas être modifie (pas de setter)
+    // Ceci est teste par la compilation - si ça compile, c'est bon
+    TEST_ASSERT(true, "Lender - Immutabilite du nom");
+}
+
+// Tests pour la classe Part
+void test_part() {
+    std::cout << "\n=== Tests Part ===" << std::endl;
+    
+    // Test constructeur valide
+    Part validPart(100000.0, "2024-06-01");
+    TEST_ASSERT(validPart.getAmount() == 100000.0, "Part - Montant valide");
+    TEST_ASSERT(validPart.getDate() == "2024-06-01", "Part - Date valide");
+    
+    // Test validation montant negatif
+    TEST_EXCEPTION(Part(-1000.0, "2024-06-01"), std::invalid_argument, "Part - Montant negatif rejete");
+    
+    // Test validation montant zero
+    TEST_EXCEPTION(Part(0.0, "2024-06-01"), std::invalid_argument, "Part - Montant zero rejete");
+    
+    // Test validation date vide
+    TEST_EXCEPTION(Part(1000.0, ""), std::invalid_argument, "Part - Date vide rejetee");
+    
+    // Test validation format date incorrect
+    TEST_EXCEPTION(Part(1000.0, "invalid-date"), std::invalid_argument, "Part - Format date incorrect rejete");
+    
+    // Test validation format date court
+    TEST_EXCEPTION(Part(1000.0, "2024-6-1"), std::invalid_argument, "Part - Format date court rejete");
+}
+
+// Tests pour la classe Facility
+void test_facility() {
+    std::cout << "\n=== Tests Facility ===" << std::endl;
+    
+    // Preparation des lenders
+    std::vector<Lender> lenders = {Lender("BNP"), Lender("SG")};
+    
+    // Test constructeur valide
+    Facility facility("2024-01-01", "2025-01-01", 1000000.0, "EUR", lenders, 0.03);
+    TEST_ASSERT(facility.getAmount() == 1000000.0, "Facility - Montant");
+    TEST_ASSERT(facility.getCurrency() == "EUR", "Facility - Devise");
+    TEST_ASSERT(facility.getAnnualInterestRate() == 0.03, "Facility - Taux d'interêt");
+    TEST_ASSERT(facility.getPartsCount() == 0, "Facility - Pas de parts initialement");
+    TEST_ASSERT(facility.getRemainingAmount() == 1000000.0, "Facility - Montant restant initial");
+    
+    // Test ajout de part valide
+    Part part(100000.0, "2024-06-01");
+    facility.addPart(part);
+    TEST_ASSERT(facility.getPartsCount() == 1, "Facility - Ajout part");
+    TEST_ASSERT(facility.getRemainingAmount() == 900000.0, "Facility - Montant restant apres part");
+    
+    // Test payPart
+    facility.payPart(200000.0, "2024-12-01");
+    TEST_ASSERT(facility.getPartsCount() == 2, "Facility - PayPart ajoute une part");
+    TEST_ASSERT(facility.getRemainingAmount() == 700000.0, "Facility - Montant restant apres payPart");
+    
+    // Test validation montant negatif
+    TEST_EXCEPTION(Facility("2024-01-01", "2025-01-01", -1000.0, "EUR", lenders, 0.03), 
+                   std::invalid_argument, "Facility - Montant negatif rejete");
+    
+    // Test validation taux negatif
+    TEST_EXCEPTION(Facility("2024-01-01", "2025-01-01", 1000000.0, "EUR", lenders, -0.01), 
+                   std::invalid_argument, "Facility - Taux negatif rejete");
+    
+    // Test validation dates incorrectes (fin avant debut)
+    TEST_EXCEPTION(Facility("2025-01-01", "2024-01-01", 1000000.0, "EUR", lenders, 0.03), 
+                   std::invalid_argument, "Facility - Date fin avant debut rejetee");
+    
+    // Test validation devise vide
+    std::vector<Lender> emptyLenders;
+    TEST_EXCEPTION(Facility("2024-01-01", "2025-01-01", 1000000.0, "", lenders, 0.03), 
+                   std::invalid_argument, "Facility - Devise vide rejetee");
+    
+    // Test validation lenders vides
+    TEST_EXCEPTION(Facility("2024-01-01", "2025-01-01", 1000000.0, "EUR", emptyLenders, 0.03), 
+                   std::invalid_argument, "Facility - Lenders vides rejetes");
+    
+    // Test part qui depasse le montant restant
+    Facility smallFacility("2024-01-01", "2025-01-01", 100000.0, "EUR", lenders, 0.03);
+    TEST_EXCEPTION(smallFacility.addPart(Part(200000.0, "2024-06-01")), 
+                   std::invalid_argument, "Facility - Part depassant le montant rejetee");
+    
+    // Participations : repartition egale puis cessions
+    Facility shared("2024-01-01", "2025-01-01", 1000000.01, "EUR", {Lender("BNP"), Lender("SG"), Lender("CA")}, 0.03);
+    TEST_ASSERT(shared.getShare("BNP") == Money::fromDouble(333333.34) && shared.getShare("CA") == Money::fromDouble(333333.33) && 
+                shared.getShare("HSBC") == Money(), "Facility - Repartition egale des participations");
+    shared.transferShare("SG", "HSBC", Money::fromDouble(100000.0));
+    shared.transferShare("CA", "BNP", Money::fromDouble(333333.33));
+    TEST_ASSERT(shared.getLenders().size() == 3 && shared.getLenders()[2].getName() == "HSBC" && 
+                shared.getShare("BNP") == Money::fromDouble(666666.67) && shared.getShare("SG") == Money::fromDouble(233333.34), 
+                "Facility - Cessions de participations");
+    TEST_EXCEPTION(shared.transferShare("SG", "BNP", Money::fromDouble(300000.0)), std::invalid_argument, 
+                   "Facility - Cession superieure a la participation rejetee");
+    TEST_EXCEPTION(shared.transferShare("CA", "BNP", Money::fromDouble(1.0)), std::invalid_argument, 
+                   "Facility - Cedant inconnu rejete");
+    TEST_EXCEPTION(shared.setShares({Money::fromDouble(1.0)}), std::invalid_argument, "Facility - Participations incoherentes rejetees");
+    
+    // Registre d'interets courus
+    Facility accrual("2025-01-01", "2027-01-01", 1000000.0, "EUR", lenders, 0.05);
+    accrual.payPart(500000.0, "2025-07-01");
+    double expected = 1000000.0 * 0.05 * 181 / 365;
+    TEST_ASSERT(std::fabs(accrual.getAccruedInterest() - expected) < 1e-6 && accrual.getAccrualDate() == "2025-07-01", 
+                "Facility - Interets courus jusqu'a la part");
+    uint64_t accrualVersion = accrual.getVersion();
+    expected += 500000.0 * 0.05 * 184 / 365;
+    TEST_ASSERT(std::fabs(accrual.accrueTo("2026-01-01") - expected) < 1e-6, "Facility - Arrete des interets");
+    TEST_ASSERT(accrual.getVersion() == accrualVersion + 1, "Facility - Version incrementee par l'arrete");
+    accrual.accrueTo("2025-10-01");
+    TEST_ASSERT(accrual.getAccrualDate() == "2026-01-01" && accrual.getVersion() == accrualVersion + 1, 
+                "Facility - Arrete anterieur sans effet");
+    
+    // Une part antidatee rejoue l'historique dans l'ordre des dates
+    Facility ordered("2025-01-01", "2027-01-01", 1000000.0, "EUR", lenders, 0.05);
+    ordered.payPart(200000.0, "2025-04-01");
+    ordered.payPart(300000.0, "2025-07-01");
+    ordered.accrueTo("2025-12-01");
+    Facility backdated("2025-01-01", "2027-01-01", 1000000.0, "EUR", lenders, 0.05);
+    backdated.payPart(300000.0, "2025-07-01");
+    backdated.accrueTo("2025-12-01");
+    backdated.payPart(200000.0, "2025-04-01");
+    TEST_ASSERT(std::fabs(backdated.getAccruedInterest() - ordered.getAccruedInterest()) < 1e-6 && 
+                backdated.getAccrualDate() == "2025-12-01", "Facility - Part antidatee rejouee");
+    
+    // Parts a l'unite mineure de la devise de la facility
+    Facility yen("2025-01-01", "2027-01-01", 1000000.0, "JPY", lenders, 0.01);
+    TEST_EXCEPTION(yen.addPart(Part(0.5, "2025-03-01")), std::invalid_argument, "Facility - Demi-yen rejete");
+    TEST_EXCEPTION(yen.addPart(Part(100.25, "2025-03-01")), std::invalid_argument, "Facility - Centimes de yen rejetes");
+    TEST_EXCEPTION(yen.payPart(0.4, "2025-03-01"), std::invalid_argument, "Facility - Paiement arrondi a zero rejete");
+    yen.payPart(100.6, "2025-03-01");
+    TEST_ASSERT(yen.getRemainingMoney() == Money::fromDouble(999899.0) && yen.getPartsCount() == 1, 
+                "Facility - Paiement arrondi au yen");
+    Facility euro("2025-01-01", "2027-01-01", 1000.0, "EUR", lenders, 0.01);
+    TEST_EXCEPTION(euro.addPart(Part(10.005, "2025-03-01")), std::invalid_argument, "Facility - Millieme d'euro rejete");
+}
+
+// Tests pour la classe Deal
+void test_deal() {
+    std::cout << "\n=== Tests Deal ===" << std::endl;
+    
+    // Preparation des donnees
+    std::vector<Lender> pool = {Lender("BNP"), Lender("SG")};
+    Borrower borrower("Air France");
+    
+    // Test constructeur valide
+    Deal deal("S1234", "BNP Paribas", pool, borrower, 10000000.0, "EUR", 
+              "2024-01-01", "2025-01-01", Deal::Status::CLOSED);
+    
+    TEST_ASSERT(deal.getContractNum() == "S1234", "Deal - Numero de contrat");
+    TEST_ASSERT(deal.getAgent() == "BNP Paribas", "Deal - Agent");
+    TEST_ASSERT(deal.getProjectAmount() == 10000000.0, "Deal - Montant projet");
+    TEST_ASSERT(deal.getCurrency() == "EUR", "Deal - Devise");
+    TEST_ASSERT(deal.getStatus() == Deal::Status::CLOSED, "Deal - Statut");
+    TEST_ASSERT(deal.getStatusString() == "closed", "Deal - Statut string");
+    TEST_ASSERT(deal.getFacilitiesCount() == 0, "Deal - Pas de facilities initialement");
+    
+    // Test ajout facility
+    Facility facility("2024-01-01", "2025-01-01", 5000000.0, "EUR", pool, 0.03);
+    deal.addFacility(facility);
+    TEST_ASSERT(deal.getFacilitiesCount() == 1, "Deal - Ajout facility");
+    TEST_ASSERT(deal.getTotalFacilitiesAmount() == 5000000.0, "Deal - Total facilities");
+    
+    // Test changement de statut
+    deal.setStatus(Deal::Status::TERMINATED);
+    TEST_ASSERT(deal.getStatus() == Deal::Status::TERMINATED, "Deal - Changement statut");
+    TEST_ASSERT(deal.getStatusString() == "terminated", "Deal - Statut terminated string");
+    TEST_ASSERT(deal.isCompleted() == true, "Deal - Deal complete");
+    
+    // Test validation numero de contrat incorrect
+    TEST_EXCEPTION(Deal("INVALID", "BNP", pool, borrower, 1000000.0, "EUR", 
+                       "2024-01-01", "2025-01-01", Deal::Status::CLOSED), 
+                   std::invalid_argument, "Deal - Numero contrat invalide rejete");
+    
+    // Test validation numero de contrat avec mauvaise lettre
+    TEST_EXCEPTION(Deal("X1234", "BNP", pool, borrower, 1000000.0, "EUR", 
+                       "2024-01-01", "2025-01-01", Deal::Status::CLOSED), 
+                   std::invalid_argument, "Deal - Lettre incorrecte rejetee");
+    
+    // Test validation montant negatif
+    TEST_EXCEPTION(Deal("S1234", "BNP", pool, borrower, -1000000.0, "EUR", 
+                       "2024-01-01", "2025-01-01", Deal::Status::CLOSED), 
+                   std::invalid_argument, "Deal - Montant negatif rejete");
+    
+    // Test validation devise incorrecte
+    TEST_EXCEPTION(Deal("S1234", "BNP", pool, borrower, 1000000.0, "eu", 
+                       "2024-01-01", "2025-01-01", Deal::Status::CLOSED), 
+                   std::invalid_argument, "Deal - Devise incorrecte rejetee");
+    
+    // Test validation pool vide
+    std::vector<Lender> emptyPool;
+    TEST_EXCEPTION(Deal("S1234", "BNP", emptyPool, borrower, 1000000.0, "EUR", 
+                       "2024-01-01", "2025-01-01", Deal::Status::CLOSED), 
+                   std::invalid_argument, "Deal - Pool vide rejete");
+    
+    // Test facility depassant le montant du projet
+    Deal smallDeal("S5678", "BNP", pool, borrower, 1000000.0, "EUR", 
+                   "2024-01-01", "2025-01-01", Deal::Status::CLOSED);
+    Facility largeFacility("2024-01-01", "2025-01-01", 2000000.0, "EUR", pool, 0.03);
+    TEST_EXCEPTION(smallDeal.addFacility(largeFacility), 
+                   std::invalid_argument, "Deal - Facility depassant projet rejetee");
+}
+
+// Tests pour la classe Portfolio
+void test_portfolio() {
+    std::cout << "\n=== Tests Portfolio ===" << std::endl;
+    
+    // Preparation des donnees
+    std::vector<Lender> lenders = {Lender("BNP"), Lender("SG")};
+    Facility facility("2024-01-01", "2025-01-01", 1000000.0, "EUR", lenders, 0.05);
+    
+    // Ajout de quelques remboursements
+    facility.payPart(100000.0, "2024-06-01");
+    facility.payPart(200000.0, "2024-12-01");
+    
+    // Test constructeur
+    Portfolio portfolio(&facility);
+    TEST_ASSERT(portfolio.getTotalAmount() == 1000000.0, "Portfolio - Montant total");
+    TEST_ASSERT(portfolio.getRemainingAmount() == 700000.0, "Portfolio - Montant restant");
+    TEST_ASSERT(portfolio.getNumberOfParts() == 2, "Portfolio - Nombre de parts");
+    
+    // Test calculs (les montants exacts dependent de la formule d'interêt)
+    double totalInterest = portfolio.getTotalInterest();
+    double totalRepayment = portfolio.getTotalRemboursement();
+    TEST_ASSERT(totalInterest > 0, "Portfolio - Interêts calcules");
+    TEST_ASSERT(totalRepayment > portfolio.getTotalAmount(), "Portfolio - Remboursement > montant");
+    TEST_ASSERT(totalRepayment == portfolio.getTotalAmount() + totalInterest, "Portfolio - Coherence calculs");
+    
+    // Test synchronisation : ajout d'une nouvelle part
+    facility.payPart(150000.0, "2025-01-01");
+    TEST_ASSERT(portfolio.getNumberOfParts() == 3, "Portfolio - Synchronisation nouvelle part");
+    TEST_ASSERT(portfolio.getRemainingAmount() == 550000.0, "Portfolio - Synchronisation montant restant");
+    
+    // Test validation pointeur null
+    TEST_EXCEPTION(Portfolio(nullptr), std::invalid_argument, "Portfolio - Pointeur null rejete");
+    
+    // Test compteurs de version
+    uint64_t versionBefore = facility.getVersion();
+    facility.payPart(50000.0, "2025-01-01");
+    TEST_ASSERT(facility.getVersion() == versionBefore + 1, "Portfolio - Version incrementee par payPart");
+    
+    std::vector<Lender> pool = {Lender("BNP")};
+    Deal deal("S4321", "BNP", pool, Borrower("Orange"), 5000000.0, "EUR", 
+              "2024-01-01", "2025-01-01", Deal::Status::CLOSED);
+    uint64_t dealVersion = deal.getVersion();
+    deal.setStatus(Deal::Status::TERMINATED);
+    deal.setAgent("SG");
+    TEST_ASSERT(deal.getVersion() == dealVersion + 2, "Portfolio - Version du deal incrementee");
+    
+    // Test portfolio multi-facilities avec cache
+    Facility other("2024-01-01", "2025-01-01", 500000.0, "EUR", lenders, 0.05);
+    other.payPart(100000.0, "2024-09-01");
+    Portfolio multi(std::vector<const Facility*>{&facility, &other});
+    TEST_ASSERT(multi.getFacilitiesCount() == 2, "Portfolio - Plusieurs facilities");
+    TEST_ASSERT(multi.getTotalAmount() == 1500000.0, "Portfolio - Montant total multi-facilities");
+    TEST_ASSERT(multi.getRemainingAmount() == 900000.0, "Portfolio - Montant restant multi-facilities");
+    
+    double cachedInterest = multi.getTotalInterest();
+    TEST_ASSERT(multi.getTotalInterest() == cachedInterest, "Portfolio - Resultat mis en cache stable");
+    TEST_ASSERT(multi.getTotalInterestMoney() == portfolio.getTotalInterestMoney() + Portfolio(&other).getTotalInterestMoney(), 
+                "Portfolio - Interets multi-facilities");
+    
+    // Une nouvelle part invalide uniquement la facility modifiee
+    other.payPart(100000.0, "2024-12-01");
+    TEST_ASSERT(multi.getRemainingAmount() == 800000.0, "Portfolio - Invalidation apres mutation");
+    TEST_ASSERT(multi.getTotalInterest() != cachedInterest, "Portfolio - Interets recalcules apres mutation");
+}
+
+// Tests pour le type Money
+void test_money() {
+    std::cout << "\n=== Tests Money ===" << std::endl;
+    
+    // Sommes exactes la ou les doubles accumulent des erreurs
+    std::vector<Money> tenths(10, Money::fromDouble(0.1));
+    TEST_ASSERT(Money::sum(tenths) == Money::fromDouble(1.0), "Money - Somme exacte");
+    TEST_ASSERT(Money::fromDouble(0.1) + Money::fromDouble(0.2) == Money::fromDouble(0.3), "Money - Addition exacte");
+    
+    // Arrondi a l'unite mineure de la devise
+    TEST_ASSERT(Money::fromDouble(1234.565, "EUR").toString() == "1234.570", "Money - Arrondi au centime");
+    TEST_ASSERT(Money::fromDouble(1234.5, "JPY").toString() == "1235.000", "Money - Devise sans decimales");
+    TEST_ASSERT(Money::fromDouble(1.2345, "KWD").toString() == "1.235", "Money - Devise a trois decimales");
+    TEST_ASSERT(Money::fromDouble(-2.5, 0).getUnits() == -3000, "Money - Arrondi loin de zero");
+    TEST_ASSERT(Money::fromDouble(42.25).toDouble() == 42.25, "Money - Conversion en double");
+    TEST_EXCEPTION(Money::fromDouble(1e300), std::invalid_argument, "Money - Depassement rejete");
+    
+    // Le dernier remboursement du restant du n'est plus rejete par un arrondi
+    std::vector<Lender> lenders = {Lender("BNP")};
+    Facility facility("2024-01-01", "2025-01-01", 0.3, "EUR", lenders, 0.03);
+    facility.payPart(0.1, "2024-02-01");
+    facility.payPart(0.1, "2024-03-01");
+    facility.payPart(0.1, "2024-04-01");
+    TEST_ASSERT(facility.getRemainingMoney() == Money(), "Money - Remboursement final accepte");
+    TEST_EXCEPTION(facility.payPart(0.01, "2024-05-01"), std::invalid_argument, "Money - Depassement du restant rejete");
+}
+
+// Tests pour le stockage par handles
+void test_book_store() {
+    std::cout << "\n=== Tests BookStore ===" << std::endl;
+    
+    std::vector<Lender> pool = {Lender("BNP")};
+    BookStore book;
+    DealHandle first = book.addDeal(Deal("S0001", "BNP", pool, Borrower("Air France"), 2000000.0, "EUR", 
+                                         "2024-01-01", "2030-01-01", Deal::Status::CLOSED));
+    FacilityHandle facility = book.addFacility(first, Facility("2024-01-01", "2030-01-01", 1000000.0, "EUR", 
+                                                                pool, 0.05));
+    TEST_ASSERT(book.getDealsCount() == 1 && book.getFacilitiesCount() == 1, "BookStore - Ajout deal et facility");
+    TEST_ASSERT(book.getFacility(facility).getAmount() == 1000000.0, "BookStore - Resolution du handle");
+    
+    // Les handles restent valides malgre la croissance du stockage
+    for (int i = 2; i < 100; i++) {
+        std::string number = std::to_string(i);
+        book.addDeal(Deal("Z" + std::string(4 - number.size(), '0') + number, "BNP", pool, Borrower("Orange"), 
+                          1000000.0, "USD", "2024-01-01", "2030-01-01", Deal::Status::CLOSED));
+    }
+    TEST_ASSERT(book.getDealsCount() == 99, "BookStore - Croissance du book");
+    TEST_ASSERT(book.getDeal(first).getContractNum() == "S0001", "BookStore - Handle stable apres reallocation");
+    
+    // Mutation unique visible par le portfolio sans copie a synchroniser
+    Portfolio portfolio(book, {facility});
+    book.payPart(facility, 300000.0, "2025-01-01");
+    TEST_ASSERT(book.getFacility(facility).getRemainingAmount() == 700000.0, "BookStore - Paiement applique");
+    TEST_ASSERT(portfolio.getRemainingAmount() == 700000.0, "BookStore - Portfolio synchronise");
+    TEST_ASSERT(portfolio.getNumberOfParts() == 1, "BookStore - Parts vues par le portfolio");
+    
+    // Arrete des interets du book entier, repris par le portfolio
+    double interest = portfolio.getTotalInterest();
+    double accruedBefore = portfolio.getAccruedInterest();
+    uint64_t dealVersion = book.getDeal(first).getVersion();
+    book.accrueTo("2026-01-01");
+    TEST_ASSERT(book.getFacility(facility).getAccrualDate() == "2026-01-01" && 
+                book.getDeal(first).getVersion() == dealVersion + 1, "BookStore - Arrete des interets");
+    TEST_ASSERT(portfolio.getAccruedInterestMoney() == book.getFacility(facility).getAccruedInterestMoney() && 
+                portfolio.getAccruedInterest() > accruedBefore, "BookStore - Interets courus dans le portfolio");
+    TEST_ASSERT(portfolio.getTotalInterest() == interest && 
+                portfolio.getTotalInterestMoney() == book.getFacility(facility).calculateInterestMoney(book.getFacility(facility).getParts()[0]), 
+                "BookStore - Interets par part inchanges par l'arrete");
+    
+    // Recherche par numero de contrat et doublons
+    TEST_ASSERT(book.findDeal("Z0042") == book.getHandle(41), "BookStore - Recherche par contrat");
+    TEST_ASSERT(book.hasDeal("S0001") && !book.hasDeal("B0001"), "BookStore - Presence d'un contrat");
+    TEST_EXCEPTION(book.findDeal("B0001"), std::invalid_argument, "BookStore - Contrat inconnu");
+    TEST_EXCEPTION(book.addDeal(Deal("S0001", "BNP", pool, Borrower("Orange"), 1000000.0, "EUR", 
+                                     "2024-01-01", "2030-01-01", Deal::Status::CLOSED)), 
+                   std::invalid_argument, "BookStore - Contrat en double rejete");
+    
+    // Retrait : les handles perimes sont detectes, les autres restent valides
+    DealHandle removed = book.findDeal("Z0042");
+    DealHandle last = book.getHandle(book.getDealsCount() - 1);
+    book.removeDeal(removed);
+    TEST_ASSERT(!book.isValid(removed), "BookStore - Handle perime");
+    TEST_ASSERT(book.isValid(last) && book.getDeal(last).getContractNum() == "Z0099", 
+                "BookStore - Deal deplace toujours accessible");
+    TEST_EXCEPTION(book.getDeal(removed), std::invalid_argument, "BookStore - Acces par handle perime rejete");
+    DealHandle reused = book.addDeal(Deal("B0042", "BNP", pool, Borrower("Orange"), 1000000.0, "EUR", 
+                                          "2024-01-01", "2030-01-01", Deal::Status::CLOSED));
+    TEST_ASSERT(reused.index == removed.index && reused != removed, "BookStore - Emplacement reutilise");
+    TEST_ASSERT(!book.isValid(removed), "BookStore - Ancien handle toujours invalide");
+    TEST_EXCEPTION(book.payPart({first, 3}, 1000.0, "2025-01-01"), std::out_of_range, 
+                   "BookStore - Facility inexistante");
+    
+    // Versions publiees : une version gardee reste figee, les deals non modifies sont partages
+    std::shared_ptr<const BookSnapshot> pinned = book.snapshot();
+    Portfolio frozen(pinned, {facility});
+    book.payPart(facility, 100000.0, "2025-06-01");
+    std::shared_ptr<const BookSnapshot> current = book.snapshot();
+    TEST_ASSERT(pinned->getFacility(facility).getRemainingAmount() == 700000.0 && 
+                current->getFacility(facility).getRemainingAmount() == 600000.0 && 
+                current->getEpoch() == pinned->getEpoch() + 1, "BookSnapshot - Version gardee intacte");
+    TEST_ASSERT(&pinned->getDeal(last) == &current->getDeal(last) && &pinned->getDeal(first) != &current->getDeal(first), 
+                "BookSnapshot - Copie du seul deal modifie");
+    TEST_ASSERT(frozen.getRemainingAmount() == 700000.0 && portfolio.getRemainingAmount() == 600000.0, 
+                "BookSnapshot - Portfolio fige ou suivant le book");
+    TEST_ASSERT(current->getDealsCount() == book.getDealsCount() && current->findDeal("B0042") == reused && 
+                !current->isValid(removed) && current->getFacilityHandles().size() == book.getFacilitiesCount(), 
+                "BookSnapshot - Handles et contrats de la version");
+    
+    // Un lot n'est publie qu'a sa fermeture, d'un seul bloc
+    {
+        BookStore::Batch batch(book);
+        book.payPart(facility, 50000.0, "2025-07-01");
+        book.setAgent(last, "SG");
+        TEST_ASSERT(book.snapshot() == current, "BookSnapshot - Lot en cours invisible");
+    }
+    TEST_ASSERT(book.snapshot()->getEpoch() == current->getEpoch() + 1 && 
+                book.snapshot()->getDeal(last).getAgent() == "SG" && 
+                book.snapshot()->getFacility(facility).getRemainingAmount() == 550000.0, "BookSnapshot - Lot publie entier");
+    
+    // Une version sans detenteur est liberee
+    std::weak_ptr<const BookSnapshot> released = pinned;
+    pinned.reset();
+    frozen = Portfolio(current, {facility});
+    TEST_ASSERT(released.expired(), "BookSnapshot - Version liberee au dernier detenteur");
+    
+    // Lecteur concurrent : chaque lot paie deux facilities, jamais vues a moitie payees
+    DealHandle paired = book.addDeal(Deal("S0500", "BNP", pool, Borrower("Orange"), 2000000.0, "EUR", 
+                                          "2024-01-01", "2030-01-01", Deal::Status::CLOSED));
+    FacilityHandle left = book.addFacility(paired, Facility("2024-01-01", "2030-01-01", 1000000.0, "EUR", pool, 0.05));
+    FacilityHandle right = book.addFacility(paired, Facility("2024-01-01", "2030-01-01", 1000000.0, "EUR", pool, 0.05));
+    std::atomic<bool> writing(true);
+    std::atomic<int> torn(0);
+    std::thread reader([&book, &writing, &torn, left, right]() {
+        while (writing.load()) {
+            std::shared_ptr<const BookSnapshot> snapshot = book.snapshot();
+            Portfolio pair(snapshot, {left, right});
+            if (snapshot->getFacility(left).getRemainingMoney() != snapshot->getFacility(right).getRemainingMoney() || 
+                pair.getNumberOfParts() % 2 != 0) {
+                torn++;
+            }
+        }
+    });
+    for (int i = 0; i < 300; i++) {
+        BookStore::Batch batch(book);
+        book.payPart(left, 1000.0, "2025-01-01");
+        book.payPart(right, 1000.0, "2025-01-01");
+    }
+    writing = false;
+    reader.join();
+    TEST_ASSERT(torn.load() == 0 && book.getFacility(right).getRemainingAmount() == 700000.0, 
+                "BookSnapshot - Lecture concurrente sans lot partiel");
+}
+
+// Tests pour les codes devise et numeros de contrat compactes
+void test_packed_codes() {
+    std::cout << "\n=== Tests CurrencyCode / ContractNumber ===" << std::endl;
+    
+    // Analyse et validation a la compilation
+    constexpr CurrencyCode eur = CurrencyCode::parse("EUR");
+    constexpr ContractNumber contract = ContractNumber::parse("Z0042");
+    static_assert(sizeof(CurrencyCode) == 2 && sizeof(ContractNumber) == 2, "Types compactes sur 16 bits");
+    static_assert(std::is_trivially_copyable<CurrencyCode>::value, "CurrencyCode trivialement copiable");
+    static_assert(std::is_trivially_copyable<ContractNumber>::value, "ContractNumber trivialement copiable");
+    static_assert(eur == CurrencyCode::parse("EUR") && eur != CurrencyCode::parse("USD"), "Egalite constexpr");
+    static_assert(CurrencyCode::parse("JPY").minorUnitDigits() == 0, "Decimales constexpr");
+    static_assert(!CurrencyCode::isValid("eur") && !ContractNumber::isValid("X1234"), "Validation constexpr");
+    static_assert(contract.getPrefix() == 'Z' && contract.getNumber() == 42, "Decomposition constexpr");
+    
+    TEST_ASSERT(eur.toString() == "EUR", "CurrencyCode - Aller-retour");
+    TEST_ASSERT(CurrencyCode::parse("KWD").minorUnitDigits() == 3, "CurrencyCode - Unite mineure");
+    TEST_EXCEPTION(CurrencyCode::parse("EU"), std::invalid_argument, "CurrencyCode - Longueur incorrecte rejetee");
+    TEST_EXCEPTION(CurrencyCode::parse("Eur"), std::invalid_argument, "CurrencyCode - Minuscules rejetees");
+    TEST_ASSERT(contract.toString() == "Z0042", "ContractNumber - Aller-retour");
+    TEST_ASSERT(ContractNumber::parse("b1234") == ContractNumber::parse("B1234"), "ContractNumber - Lettre normalisee");
+    TEST_EXCEPTION(ContractNumber::parse("S12A4"), std::invalid_argument, "ContractNumber - Chiffres requis");
+    
+    // Utilisation comme cles de table de hachage
+    std::unordered_map<CurrencyCode, int> byCurrency;
+    byCurrency[CurrencyCode::parse("USD")]++;
+    byCurrency[CurrencyCode::parse("USD")]++;
+    byCurrency[eur]++;
+    TEST_ASSERT(byCurrency.size() == 2 && byCurrency[CurrencyCode::parse("USD")] == 2, "CurrencyCode - Cle de table");
+    std::unordered_map<ContractNumber, std::string> byContract;
+    byContract[contract] = "Orange";
+    TEST_ASSERT(byContract.at(ContractNumber::parse("Z0042")) == "Orange", "ContractNumber - Cle de table");
+    
+    // Membres des deals et facilities
+    std::vector<Lender> pool = {Lender("BNP")};
+    Deal deal("s0042", "BNP", pool, Borrower("Orange"), 1000000.0, "EUR", 
+              "2024-01-01", "2025-01-01", Deal::Status::CLOSED);
+    TEST_ASSERT(deal.getContractNumber() == ContractNumber::parse("S0042"), "Deal - Numero de contrat compacte");
+    TEST_ASSERT(deal.getCurrencyCode() == eur && deal.getCurrency() == "EUR", "Deal - Devise compactee");
+    TEST_EXCEPTION(Facility("2024-01-01", "2025-01-01", 1000.0, "euro", pool, 0.03), 
+                   std::invalid_argument, "Facility - Devise invalide rejetee");
+}
+
+// Tests pour l'index des emprunteurs
+void test_borrower_index() {
+    std::cout << "\n=== Tests BorrowerIndex ===" << std::endl;
+    
+    // Preparation des donnees
+    std::vector<Lender> pool = {Lender("BNP"), Lender("SG")};
+    Borrower airFrance("Air France");
+    Borrower orange("Orange");
+    
+    Deal deal1("S1111", "BNP", pool, airFrance, 10000000.0, "EUR", 
+               "2024-01-01", "2026-01-01", Deal::Status::CLOSED);
+    Deal deal2("Z2222", "SG", pool, airFrance, 10000000.0, "USD", 
+               "2024-01-01", "2026-01-01", Deal::Status::CLOSED);
+    Deal deal3("B3333", "SG", pool, orange, 10000000.0, "EUR", 
+               "2024-01-01", "2026-01-01", Deal::Status::CLOSED);
+    
+    // Un deal avec une facility deja presente est repris a la construction de l'index
+    Facility facility1("2024-01-01", "2026-01-01", 4000000.0, "EUR", pool, 0.03);
+    deal1.addFacility(facility1);
+    
+    BookStore book;
+    DealHandle handle1 = book.addDeal(deal1);
+    BorrowerIndex index(book);
+    DealHandle handle2 = book.addDeal(deal2);
+    book.addDeal(deal3);
+    TEST_ASSERT(index.getBorrowersCount() == 2, "BorrowerIndex - Nombre d'emprunteurs");
+    TEST_ASSERT(index.getDeals("Air France").size() == 2, "BorrowerIndex - Deals par emprunteur");
+    TEST_ASSERT(index.getOutstanding("Air France", "EUR").toDouble() == 4000000.0, "BorrowerIndex - Reprise des facilities existantes");
+    
+    // Agregation sur plusieurs deals, chaque devise a son propre encours
+    book.addFacility(handle2, Facility("2024-01-01", "2026-01-01", 3000000.0, "USD", pool, 0.03));
+    book.addFacility(handle2, Facility("2024-01-01", "2026-01-01", 5000000.0, "EUR", pool, 0.03));
+    TEST_ASSERT(index.getBreaches().empty(), "BorrowerIndex - Facility sans limite");
+    TEST_ASSERT(index.getOutstanding("Air France", "EUR").toDouble() == 9000000.0, "BorrowerIndex - Encours agrege multi-deals");
+    TEST_ASSERT(index.getOutstanding("Air France", "USD").toDouble() == 3000000.0, "BorrowerIndex - Encours separe par devise");
+    TEST_ASSERT(index.getFacilities("Air France").size() == 3, "BorrowerIndex - Facilities par emprunteur");
+    TEST_ASSERT(index.getOutstanding("Orange", "EUR") == Money(), "BorrowerIndex - Emprunteurs independants");
+    
+    // Limite de concentration : elle ne porte que sur sa devise
+    index.setLimit("Air France", "EUR", 10000000.0);
+    TEST_ASSERT(!index.isBreached("Air France", "EUR"), "BorrowerIndex - Limite respectee");
+    TEST_ASSERT(index.wouldBreach("Air France", "EUR", 2000000.0), "BorrowerIndex - Depassement anticipe");
+    TEST_ASSERT(!index.hasLimit("Air France", "USD"), "BorrowerIndex - Limite propre a la devise");
+    TEST_ASSERT(!index.wouldBreach("Air France", "USD", 20000000.0), "BorrowerIndex - Autre devise sans limite");
+    
+    FacilityHandle facility3 = book.addFacility(handle1, Facility("2024-01-01", "2026-01-01", 2000000.0, "EUR", pool, 0.03));
+    TEST_ASSERT(index.isBreached("Air France", "EUR"), "BorrowerIndex - Depassement detecte");
+    TEST_ASSERT(index.getBreaches().size() == 1, "BorrowerIndex - Depassement enregistre");
+    TEST_ASSERT(index.getBreaches()[0].contractNum == "S1111", "BorrowerIndex - Deal declencheur");
+    TEST_ASSERT(index.getBreaches()[0].currency.toString() == "EUR", "BorrowerIndex - Devise du depassement");
+    TEST_ASSERT(index.getBreaches()[0].outstanding.toDouble() == 11000000.0, "BorrowerIndex - Encours du depassement");
+    TEST_ASSERT(index.getFacilities("Air France").back().index == 1, "BorrowerIndex - Position de la facility dans le deal");
+    
+    // Un remboursement ramene l'encours sous la limite
+    book.payPart(facility3, 1500000.0, "2024-06-01");
+    TEST_ASSERT(!index.isBreached("Air France", "EUR"), "BorrowerIndex - Remboursement sous la limite");
+    TEST_ASSERT(index.getOutstanding("Air France", "EUR").toDouble() == 9500000.0, "BorrowerIndex - Encours apres remboursement");
+    
+    // Un remboursement superieur au restant du est rejete par la facility avant toute mutation :
+    // l'index n'est pas notifie et les observateurs suivants restent coherents
+    TEST_EXCEPTION(book.payPart(facility3, 600000.0, "2024-07-01"), std::invalid_argument,
+                   "BorrowerIndex - Remboursement excessif rejete");
+    TEST_ASSERT(index.getOutstanding("Air France", "EUR").toDouble() == 9500000.0, "BorrowerIndex - Encours jamais negatif");
+    book.payPart(facility3, 500000.0, "2024-07-01");
+    TEST_ASSERT(index.getOutstanding("Air France", "EUR").toDouble() == 9000000.0, "BorrowerIndex - Remboursement du restant du");
+    
+    // Retrait d'un deal : ses facilities et son encours quittent l'index
+    book.removeDeal(handle1);
+    TEST_ASSERT(index.getOutstanding("Air France", "EUR").toDouble() == 5000000.0, "BorrowerIndex - Encours apres retrait du deal");
+    TEST_ASSERT(index.getOutstanding("Air France", "USD").toDouble() == 3000000.0, "BorrowerIndex - Autre devise intacte");
+    TEST_ASSERT(index.getDeals("Air France").size() == 1, "BorrowerIndex - Deal retire de l'index");
+    TEST_ASSERT(index.getFacilities("Air France").size() == 2, "BorrowerIndex - Facilities du deal retirees");
+    
+    // Validations
+    TEST_EXCEPTION(index.setLimit("Orange", "EUR", -1.0), std::invalid_argument, "BorrowerIndex - Limite negative rejetee");
+    TEST_EXCEPTION(index.setLimit("Orange", "eur", 1.0), std::invalid_argument, "BorrowerIndex - Devise invalide rejetee");
+    TEST_EXCEPTION(index.getLimit("Orange", "EUR"), std::invalid_argument, "BorrowerIndex - Absence de limite");
+}
+
+// Tests pour l'export colonnaire
+void test_columnar_export() {
+    std::cout << "\n=== Tests ColumnarExporter ===" << std::endl;
+    
+    // Preparation d'un book de deux deals
+    std::vector<Lender> pool = {Lender("BNP"), Lender("SG")};
+    std::vector<Deal> deals;
+    deals.push_back(Deal("S1000", "BNP", pool, Borrower("Air France"), 10000000.0, "EUR", 
+                         "2024-01-01", "2030-01-01", Deal::Status::CLOSED));
+    deals.push_back(Deal("Z2000", "SG", pool, Borrower("Orange"), 8000000.0, "USD", 
+                         "2024-01-01", "2030-01-01", Deal::Status::TERMINATED));
+    
+    Facility facility1("2024-01-01", "2030-01-01", 6000000.0, "EUR", pool, 0.04);
+    facility1.payPart(1000000.0, "2025-01-01");
+    facility1.payPart(500000.0, "2026-01-01");
+    facility1.payPart(250000.0, "2027-01-01");
+    deals[0].addFacility(facility1);
+    
+    Facility facility2("2024-01-01", "2030-01-01", 3000000.0, "USD", {Lender("SG")}, 0.05);
+    facility2.payPart(750000.0, "2025-06-01");
+    deals[1].addFacility(facility2);
+    
+    std::string directory = (std::filesystem::temp_directory_path() / "sfc_export_test").string();
+    
+    // Export avec dictionnaires et petits lots pour couvrir plusieurs lots
+    ColumnarExporter::Options options;
+    options.batchRows = 2;
+    ColumnarExporter exporter(directory, options);
+    size_t exported = exporter.exportBook(deals);
+    TEST_ASSERT(exported == 2 + 2 + 4 + 7, "ColumnarExporter - Nombre de lignes exportees");
+    
+    ColumnarTable dealTable(directory + "/deals.sfc");
+    TEST_ASSERT(dealTable.getRowCount() == 2, "ColumnarExporter - Table deals");
+    size_t currency = dealTable.getColumnIndex("currency");
+    TEST_ASSERT(dealTable.getColumnType(currency) == ColumnarExporter::ColumnType::DICTIONARY, 
+                "ColumnarExporter - Devise encodee par dictionnaire");
+    TEST_ASSERT(dealTable.getString(currency, 1) == "USD", "ColumnarExporter - Decodage du dictionnaire");
+    TEST_ASSERT(dealTable.getString(dealTable.getColumnIndex("status"), 1) == "terminated", 
+                "ColumnarExporter - Statut exporte");
+    
+    ColumnarTable partTable(directory + "/parts.sfc");
+    TEST_ASSERT(partTable.getRowCount() == 4, "ColumnarExporter - Table parts");
+    TEST_ASSERT(partTable.getDouble(1, 2) == 250000.0, "ColumnarExporter - Montant sur plusieurs lots");
+    TEST_ASSERT(partTable.getString(2, 3) == "2025-06-01", "ColumnarExporter - Date de part");
+    TEST_ASSERT(partTable.getInt(0, 3) == 1, "ColumnarExporter - Reference de facility");
+    
+    ColumnarTable facilityTable(directory + "/facilities.sfc");
+    TEST_ASSERT(facilityTable.getDouble(facilityTable.getColumnIndex("remaining"), 0) == 4250000.0, 
+                "ColumnarExporter - Montant restant exporte");
+    
+    ColumnarTable lenderTable(directory + "/lenders.sfc");
+    TEST_ASSERT(lenderTable.getRowCount() == 7, "ColumnarExporter - Table lenders");
+    TEST_ASSERT(lenderTable.getString(2, 6) == "SG", "ColumnarExporter - Preteur de facility");
+    
+    // Export sans dictionnaire : colonnes en clair
+    options.dictionaryEncoding = false;
+    ColumnarExporter(directory, options).exportBook(deals);
+    ColumnarTable plainTable(directory + "/facilities.sfc");
+    size_t plainCurrency = plainTable.getColumnIndex("currency");
+    TEST_ASSERT(plainTable.getColumnType(plainCurrency) == ColumnarExporter::ColumnType::STRING, 
+                "ColumnarExporter - Devise en clair");
+    TEST_ASSERT(plainTable.getString(plainCurrency, 1) == "USD", "ColumnarExporter - Lecture en clair");
+    
+    // Validations
+    options.batchRows = 0;
+    TEST_EXCEPTION(ColumnarExporter(directory, options), std::invalid_argument, "ColumnarExporter - Lot vide rejete");
+    TEST_EXCEPTION(ColumnarTable(directory + "/missing.sfc"), std::runtime_error, "ColumnarExporter - Fichier absent");
+    
+    std::filesystem::remove_all(directory);
+}
+
+// Tests pour les bitmaps
+void test_bitmap() {
+    std::cout << "\n=== Tests Bitmap ===" << std::endl;
+    
+    Bitmap left(130);
+    Bitmap right(130);
+    left.set(1);
+    left.set(64);
+    left.set(129);
+    right.set(64);
+    right.set(100);
+    TEST_ASSERT(left.count() == 3, "Bitmap - Comptage");
+    TEST_ASSERT(left.test(129) && !left.test(128), "Bitmap - Test de ligne");
+    TEST_ASSERT((left & right).rows() == std::vector<size_t>({64}), "Bitmap - Intersection");
+    TEST_ASSERT((left | right).count() == 4, "Bitmap - Union");
+    
+    Bitmap remaining = left;
+    remaining.andNot(right);
+    TEST_ASSERT(remaining.rows() == std::vector<size_t>({1, 129}), "Bitmap - Difference");
+    TEST_ASSERT(Bitmap(70, true).count() == 70, "Bitmap - Remplissage sans debordement");
+    TEST_ASSERT(Bitmap(10).none(), "Bitmap - Bitmap vide");
+    TEST_EXCEPTION(left &= Bitmap(10), std::invalid_argument, "Bitmap - Tailles differentes rejetees");
+}
+
+// Tests pour le moteur de requetes
+void test_query_engine() {
+    std::cout << "\n=== Tests QueryEngine ===" << std::endl;
+    
+    // Book de 100 deals alternant devises, statuts, emprunteurs et echeances
+    std::vector<Lender> bnp = {Lender("BNP")};
+    std::vector<Lender> sg = {Lender("SG")};
+    BookStore book;
+    for (int i = 0; i < 100; i++) {
+        std::string contractNum = "S" + std::to_string(1000 + i);
+        std::string endDate = (i % 2 == 0) ? "2030-06-01" : "2031-06-01";
+        Deal deal(contractNum, "BNP", (i % 4 == 0) ? sg : bnp, Borrower(i % 5 == 0 ? "Orange" : "Air France"),
+                  1000000.0, (i % 3 == 0) ? "USD" : "EUR", "2024-01-01", endDate,
+                  (i % 10 == 0) ? Deal::Status::TERMINATED : Deal::Status::CLOSED);
+        Facility facility("2024-01-01", endDate, 400000.0, deal.getCurrency(), deal.getPool(), 0.03);
+        facility.payPart(100000.0, "2025-01-01");
+        deal.addFacility(facility);
+        book.addDeal(deal);
+    }
+    
+    QueryEngine engine(book);
+    TEST_ASSERT(engine.getDealsCount() == 100, "QueryEngine - Deals indexes");
+    TEST_ASSERT(engine.getFacilitiesCount() == 100, "QueryEngine - Facilities indexees");
+    
+    // Tous les deals CLOSED en USD echeant en 2030 avec le preteur SG
+    QueryEngine::Filter filter;
+    filter.status(Deal::Status::CLOSED).currency("USD").maturityYear(2030).lender("SG");
+    Bitmap selection = engine.selectDeals(filter);
+    size_t expected = 0;
+    for (int i = 0; i < 100; i++) {
+        if (i % 10 != 0 && i % 3 == 0 && i % 2 == 0 && i % 4 == 0) {
+            expected++;
+        }
+    }
+    TEST_ASSERT(selection.count() == expected, "QueryEngine - Filtre conjonctif");
+    
+    bool consistent = true;
+    for (const Deal* deal : engine.getDeals(selection)) {
+        consistent = consistent && deal->getCurrency() == "USD" && deal->getStatus() == Deal::Status::CLOSED
+                     && deal->getContractEndDate().substr(0, 4) == "2030";
+    }
+    TEST_ASSERT(consistent, "QueryEngine - Deals selectionnes coherents");
+    
+    // Plusieurs valeurs d'un meme critere : union
+    QueryEngine::Filter years;
+    years.maturityYear(2030).maturityYear(2031);
+    TEST_ASSERT(engine.selectDeals(years).count() == 100, "QueryEngine - Union de valeurs");
+    
+    // Agregations sur le resultat
+    QueryEngine::Filter orange;
+    orange.borrower("Orange");
+    QueryEngine::Aggregate dealAggregate = engine.aggregateDeals(engine.selectDeals(orange));
+    TEST_ASSERT(dealAggregate.count == 20, "QueryEngine - Agregat nombre de deals");
+    TEST_ASSERT(dealAggregate.amount == 20000000.0, "QueryEngine - Agregat montant projet");
+    QueryEngine::Aggregate facilityAggregate = engine.aggregateFacilities(engine.selectFacilities(orange));
+    TEST_ASSERT(facilityAggregate.remaining == 6000000.0, "QueryEngine - Agregat montant restant");
+    TEST_ASSERT(engine.getFacilities(engine.selectFacilities(orange)).size() == 20, "QueryEngine - Facilities selectionnees");
+    
+    // Valeur inconnue : aucun resultat
+    QueryEngine::Filter unknown;
+    unknown.currency("JPY");
+    TEST_ASSERT(engine.selectDeals(unknown).none(), "QueryEngine - Valeur inconnue");
+    
+    // Mise a jour des seules lignes du deal modifie
+    book.setStatus(book.getHandle(1), Deal::Status::TERMINATED);
+    QueryEngine::Filter terminated;
+    terminated.status(Deal::Status::TERMINATED);
+    TEST_ASSERT(engine.selectDeals(terminated).count() == 11, "QueryEngine - Statut mis a jour");
+    book.payPart({book.getHandle(0), 0}, 100000.0, "2025-06-01");
+    TEST_ASSERT(engine.aggregateFacilities(engine.selectFacilities(orange)).remaining == 5900000.0,
+                "QueryEngine - Montant restant mis a jour au paiement");
+    
+    // Retrait du dernier deal puis ajout d'un deal a la meme position : l'index suit le nouveau deal
+    book.removeDeal(book.getHandle(99));
+    Deal replacement("Z9999", "SG", sg, Borrower("Engie"), 2000000.0, "GBP", "2024-01-01", "2032-06-01",
+                     Deal::Status::CLOSED);
+    replacement.addFacility(Facility("2024-01-01", "2032-06-01", 500000.0, "GBP", sg, 0.03));
+    book.addDeal(replacement);
+    QueryEngine::Filter engie;
+    engie.borrower("Engie");
+    TEST_ASSERT(engine.getDealsCount() == 100, "QueryEngine - Ligne du deal retire reutilisee");
+    TEST_ASSERT(engine.selectDeals(engie).count() == 1 && engine.getDeals(engine.selectDeals(engie))[0]->getContractNum() == "Z9999",
+                "QueryEngine - Nouveau deal indexe a la place du deal retire");
+    QueryEngine::Filter maturity2031;
+    maturity2031.maturityYear(2031);
+    TEST_ASSERT(engine.selectDeals(maturity2031).count() == 49, "QueryEngine - Valeurs du deal retire effacees");
+    
+    // Retrait au milieu : le dernier deal prend la place du deal retire
+    book.removeDeal(book.getHandle(5));
+    QueryEngine::Filter gbp;
+    gbp.currency("GBP");
+    Bitmap moved = engine.selectFacilities(gbp);
+    TEST_ASSERT(moved.count() == 1 && engine.getFacilities(moved)[0]->getAmount() == 500000.0,
+                "QueryEngine - Facilities du deal deplace suivies");
+    TEST_ASSERT(engine.getDeals(engine.selectDeals(engie))[0]->getContractNum() == "Z9999",
+                "QueryEngine - Deal deplace suivi");
+    TEST_ASSERT(engine.getFacilitiesCount() == 99, "QueryEngine - Facilities du deal retire liberees");
+    
+    // Reconstruction complete identique a l'index tenu a jour
+    size_t before = engine.selectDeals(orange).count();
+    engine.rebuild();
+    TEST_ASSERT(engine.selectDeals(orange).count() == before, "QueryEngine - Reconstruction coherente");
+}
+
+// Tests pour le tampon d'ecriture et les rendus de releves
+void test_report_renderer() {
+    std::cout << "\n=== Tests ReportRenderer ===" << std::endl;
+    
+    // Formatage des nombres et ecriture par bloc
+    std::ostringstream stream;
+    {
+        BufferWriter out(stream, 16);
+        out << "Amount: " << 1234.5 << ' ' << 10000000.0 << ' ' << 42;
+        TEST_ASSERT(stream.str().empty(), "BufferWriter - Texte conserve dans le tampon");
+        out.endBlock();
+        TEST_ASSERT(stream.str() == "Amount: 1234.5 10000000 42", "BufferWriter - Ecriture du bloc");
+        out.fixed(0.125, 2);
+    }
+    TEST_ASSERT(stream.str() == "Amount: 1234.5 10000000 420.12", "BufferWriter - Vidage a la destruction");
+    TEST_EXCEPTION(BufferWriter(stream, 0), std::invalid_argument, "BufferWriter - Bloc vide rejete");
+    std::ostringstream rounded;
+    {
+        BufferWriter out(rounded);
+        out << 0.035 * 100 << ' ' << 0.1 + 0.2 << ' ' << -1e-9 << ' ' << 0.05;
+    }
+    TEST_ASSERT(rounded.str() == "3.5 0.3 0 0.05", "BufferWriter - Precision fixe a l'affichage");
+    
+    // Book d'un deal, une facility et deux parts
+    std::vector<Lender> pool = {Lender("BNP"), Lender("SG")};
+    std::vector<Deal> deals;
+    deals.push_back(Deal("S1234", "BNP", pool, Borrower("Air \"France\""), 1000000.0, "EUR", 
+                         "2024-01-01", "2026-01-01", Deal::Status::CLOSED));
+    Facility facility("2024-01-01", "2026-01-01", 500000.0, "EUR", pool, 0.05);
+    facility.payPart(100000.0, "2024-06-01");
+    facility.payPart(50000.0, "2025-01-01");
+    deals[0].addFacility(facility);
+    
+    std::ostringstream text;
+    {
+        BufferWriter out(text);
+        TextReportRenderer(out).render(deals);
+    }
+    TEST_ASSERT(text.str().find("Contract Number: S1234\n") != std::string::npos, "ReportRenderer - Texte deal");
+    TEST_ASSERT(text.str().find("  Remaining: 350000\n") != std::string::npos, "ReportRenderer - Texte facility");
+    TEST_ASSERT(text.str().find("  Part 2: 50000 on 2025-01-01\n") != std::string::npos, "ReportRenderer - Texte part");
+    
+    std::ostringstream csv;
+    {
+        BufferWriter out(csv);
+        CsvReportRenderer(out).render(deals);
+    }
+    std::string csvText = csv.str();
+    TEST_ASSERT(std::count(csvText.begin(), csvText.end(), '\n') == 5, "ReportRenderer - Lignes CSV");
+    TEST_ASSERT(csvText.find("deal,S1234,,,\"Air \"\"France\"\"\",BNP,closed,EUR,1000000,,,2024-01-01,2026-01-01\n") 
+                != std::string::npos, "ReportRenderer - Echappement CSV");
+    TEST_ASSERT(csvText.find("part,S1234,1,2,,,,EUR,50000,,,2025-01-01,\n") != std::string::npos, "ReportRenderer - Ligne CSV part");
+    
+    std::ostringstream json;
+    {
+        BufferWriter out(json);
+        JsonReportRenderer(out).render(deals);
+    }
+    std::string expected = "[\n{\"contract_num\":\"S1234\",\"agent\":\"BNP\",\"borrower\":\"Air \\\"France\\\"\","
+                           "\"pool\":[\"BNP\",\"SG\"],\"project_amount\":1000000,\"currency\":\"EUR\","
+                           "\"sign_date\":\"2024-01-01\",\"end_date\":\"2026-01-01\",\"status\":\"closed\","
+                           "\"facilities\":[{\"amount\":500000,\"remaining\":350000,\"currency\":\"EUR\",\"rate\":0.05,"
+                           "\"start_date\":\"2024-01-01\",\"end_date\":\"2026-01-01\",\"parts\":["
+                           "{\"amount\":100000,\"date\":\"2024-06-01\"},{\"amount\":50000,\"date\":\"2025-01-01\"}]}]}]\n";
+    TEST_ASSERT(json.str() == expected, "ReportRenderer - Document JSON");
+    
+    // Caracteres de controle echappes en JSON, taux affiche sans erreur d'arrondi
+    std::vector<Deal> controls;
+    controls.push_back(Deal("S5678", "BNP", pool, Borrower("Air\tFrance\r\x01"), 1000000.0, "EUR",
+                            "2024-01-01", "2026-01-01", Deal::Status::CLOSED));
+    controls[0].addFacility(Facility("2024-01-01", "2026-01-01", 500000.0, "EUR", pool, 0.035));
+    std::ostringstream escaped;
+    std::ostringstream rate;
+    {
+        BufferWriter jsonOut(escaped);
+        JsonReportRenderer(jsonOut).render(controls);
+        BufferWriter textOut(rate);
+        TextReportRenderer(textOut).render(controls);
+    }
+    TEST_ASSERT(escaped.str().find("\"borrower\":\"Air\\u0009France\\u000d\\u0001\"") != std::string::npos,
+                "ReportRenderer - Caracteres de controle JSON");
+    TEST_ASSERT(rate.str().find("  Interest Rate: 3.5%\n") != std::string::npos, "ReportRenderer - Taux affiche");
+}
+
+// Tests pour les numeros de jour
+void test_date_utils() {
+    std::cout << "\n=== Tests DateUtils ===" << std::endl;
+    
+    TEST_ASSERT(toDayNumber("1970-01-01") == 0, "DateUtils - Origine");
+    TEST_ASSERT(toDayNumber("2024-03-01") - toDayNumber("2024-02-28") == 2, "DateUtils - Annee bissextile");
+    TEST_ASSERT(toDayNumber("2025-01-01") - toDayNumber("2024-01-01") == 366, "DateUtils - Duree d'une annee");
+    TEST_ASSERT(toDateString(toDayNumber("2035-06-26")) == "2035-06-26", "DateUtils - Aller-retour");
+    TEST_ASSERT(toDateString(-1) == "1969-12-31", "DateUtils - Jour negatif");
+    TEST_EXCEPTION(toDayNumber("2023-02-29"), std::invalid_argument, "DateUtils - Jour inexistant rejete");
+    TEST_EXCEPTION(toDayNumber("2024/01/01"), std::invalid_argument, "DateUtils - Format incorrect rejete");
+}
+
+// Tests pour le calendrier des evenements
+void test_calendar_index() {
+    std::cout << "\n=== Tests CalendarIndex ===" << std::endl;
+    
+    std::vector<Lender> pool = {Lender("BNP")};
+    BookStore book;
+    DealHandle first = book.addDeal(Deal("S0001", "BNP", pool, Borrower("Air France"), 1000000.0, "EUR", 
+                                         "2024-01-01", "2025-06-30", Deal::Status::CLOSED));
+    DealHandle second = book.addDeal(Deal("S0002", "BNP", pool, Borrower("Orange"), 1000000.0, "EUR", 
+                                          "2024-01-01", "2027-01-01", Deal::Status::CLOSED));
+    Facility facility("2024-01-01", "2025-06-01", 500000.0, "EUR", pool, 0.03);
+    facility.payPart(100000.0, "2024-09-01");
+    book.addFacility(first, facility);
+    
+    CalendarIndex calendar(book);
+    TEST_ASSERT(calendar.getEventsCount() == 4, "CalendarIndex - Evenements indexes");
+    
+    // Prochains evenements dans l'ordre chronologique
+    std::vector<CalendarIndex::Event> next = calendar.nextEvents("2024-01-01", 2);
+    TEST_ASSERT(next.size() == 2, "CalendarIndex - Nombre d'evenements demandes");
+    TEST_ASSERT(next[0].type == CalendarIndex::EventType::REPAYMENT && next[0].amount == 100000.0, 
+                "CalendarIndex - Premier evenement");
+    TEST_ASSERT(next[1].type == CalendarIndex::EventType::FACILITY_MATURITY && next[1].amount == 400000.0, 
+                "CalendarIndex - Echeance de facility");
+    
+    // Evenements sur une periode
+    std::vector<CalendarIndex::Event> range = calendar.eventsInRange("2025-06-01", "2025-06-30");
+    TEST_ASSERT(range.size() == 2, "CalendarIndex - Evenements de la periode");
+    TEST_ASSERT(range[1].type == CalendarIndex::EventType::DEAL_MATURITY && range[1].deal == first, 
+                "CalendarIndex - Echeance du deal");
+    TEST_EXCEPTION(calendar.eventsInRange("2025-06-30", "2025-06-01"), std::invalid_argument, 
+                   "CalendarIndex - Periode inversee rejetee");
+    
+    // Changement de statut programme puis balayage de fin de journee
+    calendar.scheduleStatusChange(second, "2026-01-01", Deal::Status::TERMINATED);
+    TEST_ASSERT(calendar.sweep("2025-06-29") == 0, "CalendarIndex - Rien d'echu");
+    TEST_ASSERT(calendar.sweep("2025-06-30") == 1, "CalendarIndex - Deal echu");
+    TEST_ASSERT(book.getDeal(first).isCompleted() && !book.getDeal(second).isCompleted(), 
+                "CalendarIndex - Deal echu termine");
+    TEST_ASSERT(calendar.sweep("2026-01-01") == 1, "CalendarIndex - Changement de statut applique");
+    TEST_ASSERT(book.getDeal(second).isCompleted(), "CalendarIndex - Statut programme");
+    TEST_ASSERT(calendar.sweep("2027-01-01") == 0, "CalendarIndex - Deal deja termine");
+    TEST_EXCEPTION(calendar.sweep("2026-06-01"), std::invalid_argument, "CalendarIndex - Retour arriere rejete");
+    TEST_EXCEPTION(calendar.scheduleStatusChange(first, "2026-06-01", Deal::Status::CLOSED), std::invalid_argument, 
+                   "CalendarIndex - Programmation dans le passe rejetee");
+    
+    // Mutations suivies sans reconstruction
+    DealHandle third = book.addDeal(Deal("S0003", "BNP", pool, Borrower("Orange"), 1000000.0, "EUR", 
+                                         "2024-01-01", "2028-01-01", Deal::Status::CLOSED));
+    FacilityHandle facility3 = book.addFacility(third, Facility("2024-01-01", "2027-06-01", 300000.0, "EUR", pool, 0.03));
+    book.payPart(facility3, 50000.0, "2027-03-01");
+    TEST_ASSERT(calendar.getEventsCount() == 8, "CalendarIndex - Deal, facility et part indexes a la mutation");
+    TEST_ASSERT(calendar.eventsInRange("2027-03-01", "2027-03-01").size() == 1, "CalendarIndex - Part ajoutee");
+    std::vector<CalendarIndex::Event> maturity = calendar.eventsInRange("2027-06-01", "2027-06-01");
+    TEST_ASSERT(maturity.size() == 1 && maturity[0].amount == 250000.0, "CalendarIndex - Echeance apres la part");
+    
+    // Echeance sur un jour deja balaye : appliquee au balayage suivant
+    DealHandle late = book.addDeal(Deal("S0004", "BNP", pool, Borrower("Orange"), 1000000.0, "EUR", 
+                                        "2024-01-01", "2025-12-31", Deal::Status::CLOSED));
+    TEST_ASSERT(calendar.sweep("2027-01-02") == 1 && book.getDeal(late).isCompleted(), 
+                "CalendarIndex - Echeance passee appliquee");
+    
+    // Retrait d'un deal : ses evenements sont effaces
+    book.removeDeal(third);
+    TEST_ASSERT(calendar.getEventsCount() == 6, "CalendarIndex - Evenements du deal retire effaces");
+    TEST_ASSERT(calendar.eventsInRange("2027-03-01", "2027-03-01").empty(), "CalendarIndex - Part du deal retire effacee");
+}
+
+// Tests pour le stockage hierarchise
+void test_tiered_book() {
+    std::cout << "\n=== Tests TieredBook ===" << std::endl;
+    
+    std::vector<Lender> pool = {Lender("BNP"), Lender("SG")};
+    BookStore book;
+    DealHandle archived = book.addDeal(Deal("S0101", "BNP", pool, Borrower("Air France"), 3000000.0, "EUR", 
+                                            "2020-01-01", "2024-01-01", Deal::Status::TERMINATED));
+    Facility floating("2020-01-01", "2024-01-01", 1000000.0, "EUR", pool, 0.04);
+    floating.setFloatingRate("EUR", 0.015);
+    floating.payPart(400000.0, "2022-01-01");
+    floating.payPart(250000.5, "2021-01-01");
+    floating.accrueTo("2023-06-30");
+    floating.transferShare("SG", "CA", Money::fromDouble(200000.0));
+    book.addFacility(archived, floating);
+    book.addFacility(archived, Facility("2020-06-01", "2023-06-01", 500000.0, "USD", {Lender("SG")}, 0.06));
+    book.addDeal(Deal("S0102", "SG", pool, Borrower("Orange"), 1000000.0, "EUR", 
+                      "2021-01-01", "2023-01-01", Deal::Status::TERMINATED));
+    book.addDeal(Deal("S0103", "BNP", pool, Borrower("Orange"), 2000000.0, "EUR", 
+                      "2024-01-01", "2030-01-01", Deal::Status::CLOSED));
+    
+    std::string directory = (std::filesystem::temp_directory_path() / "sfc_tiered_test").string();
+    std::filesystem::remove_all(directory);
+    {
+        TieredBook tiers(book, directory);
+        TEST_ASSERT(tiers.archiveTerminated() == 2 && tiers.getSegmentsCount() == 1, "TieredBook - Archivage des deals termines");
+        TEST_ASSERT(book.getDealsCount() == 1 && book.hasDeal("S0103") && !book.isValid(archived), 
+                    "TieredBook - Book actif allege");
+        TEST_ASSERT(tiers.isArchived("S0101") && !tiers.isArchived("S0103"), "TieredBook - Contrats archives");
+        TEST_ASSERT(tiers.archiveTerminated() == 0 && tiers.getSegmentsCount() == 1, "TieredBook - Rien a archiver");
+        TEST_EXCEPTION(tiers.loadArchived("S0103"), std::invalid_argument, "TieredBook - Contrat non archive");
+    }
+    
+    // Reouverture : les segments du repertoire sont repris, les deals decodes a la demande
+    TieredBook reopened(book, directory);
+    TEST_ASSERT(reopened.getSegmentsCount() == 1 && reopened.getArchivedDealsCount() == 2, "TieredBook - Reouverture");
+    Deal restored = reopened.loadArchived("S0101");
+    TEST_ASSERT(restored.getAgent() == "BNP" && restored.getBorrower().getName() == "Air France" && 
+                restored.getPool().size() == 2 && restored.getStatus() == Deal::Status::TERMINATED && 
+                restored.getProjectMoney() == Money::fromDouble(3000000.0), "TieredBook - Deal restaure");
+    const Facility& facility = restored.getFacilities()[0];
+    TEST_ASSERT(restored.getFacilitiesCount() == 2 && facility.getPartsCount() == 2 && 
+                facility.getParts()[1].getDate() == "2021-01-01" && facility.getRemainingMoney() == floating.getRemainingMoney(), 
+                "TieredBook - Parts restaurees");
+    TEST_ASSERT(facility.isFloating() && facility.getSpread() == 0.015 && 
+                facility.getAccrualDate() == "2023-06-30" && facility.getAccruedInterest() == floating.getAccruedInterest(), 
+                "TieredBook - Taux variable et interets courus restaures");
+    TEST_ASSERT(facility.getLenders().size() == 3 && facility.getShares() == floating.getShares(), 
+                "TieredBook - Participations restaurees");
+    TEST_ASSERT(restored.getFacilities()[1].getCurrency() == "USD" && restored.getFacilities()[1].getLenders().size() == 1, 
+                "TieredBook - Seconde facility restauree");
+    
+    // Fichier invalide rejete a l'ouverture
+    std::string corrupted = (std::filesystem::path(directory) / "invalid.bin").string();
+    {
+        std::ofstream out(corrupted, std::ios::binary);
+        out << std::string(64, 'x');
+    }
+    TEST_EXCEPTION(ColdSegment{corrupted}, std::runtime_error, "TieredBook - Segment invalide rejete");
+    std::filesystem::remove(corrupted);
+    
+    // Segment supprime : le suivant prend le numero apres le plus grand, sans ecraser
+    book.addDeal(Deal("S0104", "SG", pool, Borrower("Orange"), 1000000.0, "EUR", 
+                      "2021-01-01", "2023-01-01", Deal::Status::TERMINATED));
+    TEST_ASSERT(reopened.archiveTerminated() == 1 && reopened.getSegmentsCount() == 2, "TieredBook - Second segment");
+    std::filesystem::remove(std::filesystem::path(directory) / "segment-000001.cold");
+    book.addDeal(Deal("S0105", "SG", pool, Borrower("Orange"), 1000000.0, "EUR", 
+                      "2021-01-01", "2023-01-01", Deal::Status::TERMINATED));
+    {
+        TieredBook gap(book, directory);
+        TEST_ASSERT(gap.getSegmentsCount() == 1 && gap.archiveTerminated() == 1, "TieredBook - Archivage apres un trou");
+    }
+    TieredBook afterGap(book, directory);
+    TEST_ASSERT(afterGap.getSegmentsCount() == 2 && afterGap.isArchived("S0104") && afterGap.isArchived("S0105") && 
+                std::filesystem::exists(std::filesystem::path(directory) / "segment-000003.cold"), 
+                "TieredBook - Numerotation apres le plus grand segment");
+    
+    // Recherche des contrats archives : meme critere que l'index du book actif
+    Deal cold = afterGap.loadArchived("S0104");
+    TEST_ASSERT(QueryEngine::matchesDeal(QueryEngine::Filter().borrower("Orange").lender("SG"), cold) && 
+                !QueryEngine::matchesDeal(QueryEngine::Filter().status(Deal::Status::CLOSED), cold) && 
+                !QueryEngine::matchesDeal(QueryEngine::Filter().currency("USD"), cold), "QueryEngine - Filtre d'un deal archive");
+    TEST_ASSERT(afterGap.getArchivedContracts() == std::vector<std::string>({"S0104", "S0105"}), 
+                "TieredBook - Contrats archives listes");
+    
+    // Position d'enregistrement hors du segment dans le repertoire : fichier rejete a la lecture
+    std::filesystem::copy_file(std::filesystem::path(directory) / "segment-000003.cold", corrupted);
+    {
+        std::fstream file(corrupted, std::ios::binary | std::ios::in | std::ios::out);
+        unsigned char header[32];
+        file.read(reinterpret_cast<char*>(header), sizeof(header));
+        uint64_t directoryOffset = 0;
+        for (int i = 0; i < 8; i++) {
+            directoryOffset |= static_cast<uint64_t>(header[24 + i]) << (8 * i);
+        }
+        file.seekp(static_cast<std::streamoff>(directoryOffset + 8));
+        file.write(std::string(8, '\xff').data(), 8);
+    }
+    ColdSegment damaged(corrupted);
+    TEST_EXCEPTION(damaged.getContracts(), std::runtime_error, "TieredBook - Repertoire de segment corrompu");
+    std::filesystem::remove(corrupted);
+#ifndef _WIN32
+    std::string socket = (std::filesystem::temp_directory_path() / "tiered_server_test.sock").string();
+    BookServer server(book, socket, 1);
+    server.setArchive(&afterGap);
+    server.start();
+    BookClient client(socket);
+    client.getDeal("S0104");
+    client.query(protocol::QuerySpec{protocol::ANY_STATUS, "EUR", "Orange", ""});
+    client.query(protocol::QuerySpec{static_cast<uint8_t>(Deal::Status::CLOSED), "", "", ""});
+    client.createDeal({"S0105", "SG", "Orange", {"SG"}, 1000000.0, "EUR", "2024-01-01", "2030-01-01", 
+                       static_cast<uint8_t>(Deal::Status::CLOSED)});
+    std::vector<protocol::Reply> replies = client.flush();
+    server.stop();
+    TEST_ASSERT(replies[0].ok && replies[0].deal.borrower == "Orange" && 
+                replies[0].deal.status == static_cast<uint8_t>(Deal::Status::TERMINATED), "BookServer - Deal archive consulte");
+    TEST_ASSERT(replies[1].ok && replies[1].query.count == 3 && 
+                replies[1].query.contracts == std::vector<std::string>({"S0103", "S0104", "S0105"}), 
+                "BookServer - Requete sur le book actif et archive");
+    TEST_ASSERT(replies[2].ok && replies[2].query.count == 1, "BookServer - Archives exclues des deals ouverts");
+    TEST_ASSERT(!replies[3].ok && !book.hasDeal("S0105"), "BookServer - Contrat archive non recree");
+#endif
+    std::filesystem::remove_all(directory);
+}
+
+// Tests pour l'import en masse
+void test_import_pipeline() {
+    std::cout << "\n=== Tests ImportPipeline ===" << std::endl;
+    
+    // File bornee : refus quand elle est pleine, ordre conserve
+    SpscQueue<int> queue(3);
+    int value = 0;
+    bool filled = true;
+    for (int i = 0; i < 4; i++) {
+        value = i;
+        filled = filled && queue.tryPush(value);
+    }
+    value = 4;
+    TEST_ASSERT(queue.getCapacity() == 4 && filled && !queue.tryPush(value), "SpscQueue - Capacite bornee");
+    TEST_ASSERT(queue.tryPop(value) && value == 0 && queue.tryPop(value) && value == 1, "SpscQueue - Ordre FIFO");
+    
+    std::vector<Lender> pool = {Lender("BNP")};
+    BookStore book;
+    book.addDeal(Deal("S0001", "BNP", pool, Borrower("Orange"), 1000000.0, "EUR", 
+                      "2024-01-01", "2030-01-01", Deal::Status::CLOSED));
+    
+    std::stringstream csv;
+    csv << "# import de test\n";
+    for (int i = 1; i <= 2000; i++) {
+        std::string number = std::to_string(i);
+        std::string contract = "Z" + std::string(4 - number.size(), '0') + number;
+        csv << "deal," << contract << ",BNP,\"Borrower " << i % 50 << ", SA\",5000000,EUR,2024-01-01,2030-01-01,closed,BNP;SG\n";
+        csv << "facility," << contract << ",2024-01-01,2029-01-01,2000000,EUR,0.04,BNP;SG\n";
+        csv << "part," << contract << ",1,500000,2025-01-01\n";
+    }
+    csv << "facility,S0001,2024-01-01,2029-01-01,500000,EUR,0.03,BNP\n";    // ligne 6002 : contrat existant
+    csv << "deal,S0001,BNP,Orange,1000,EUR,2024-01-01,2030-01-01,closed,BNP\n";   // doublon
+    csv << "facility,B0001,2024-01-01,2029-01-01,1000,EUR,0.03,BNP\n";      // contrat inconnu
+    csv << "part,Z0001,2,1000,2025-01-01\n";                                 // facility inexistante
+    csv << "facility,Z0002,2024-01-01,2023-01-01,1000,EUR,0.03,BNP\n";      // dates inversees
+    csv << "facility,Z0003,2024-01-01,2029-01-01,4000000,EUR,0.03,BNP\n";   // depasse le montant projet
+    csv << "loan,Z0004\n";                                                    // type inconnu
+    csv << "part,Z0005,1,abc,2025-01-01\n";                                  // montant invalide
+    
+    ImportPipeline pipeline(book, 16, 2);
+    ImportPipeline::Report report = pipeline.run(csv);
+    TEST_ASSERT(report.deals == 2000 && report.facilities == 2001 && report.parts == 2000, "ImportPipeline - Lignes importees");
+    TEST_ASSERT(book.getDealsCount() == 2001 && book.getFacilitiesCount() == 2001, "ImportPipeline - Book alimente");
+    const Deal& imported = book.getDeal(book.findDeal("Z1234"));
+    TEST_ASSERT(imported.getBorrower().getName() == "Borrower 34, SA" && imported.getPool().size() == 2 && 
+                imported.getFacilities()[0].getRemainingAmount() == 1500000.0, "ImportPipeline - Champs et parts");
+    TEST_ASSERT(book.getDeal(book.findDeal("S0001")).getFacilitiesCount() == 1, "ImportPipeline - Contrat deja present");
+    
+    TEST_ASSERT(report.errors.size() == 7 && report.errors[0].line == 6003 && report.errors[6].line == 6009, 
+                "ImportPipeline - Lignes rejetees avec leur numero");
+    TEST_ASSERT(report.errors[0].message.find("already exists") != std::string::npos && 
+                report.errors[1].message.find("Unknown contract") != std::string::npos && 
+                report.errors[4].message.find("exceed") != std::string::npos, "ImportPipeline - Motifs de rejet");
+    bool counted = report.stages.size() == 5;
+    for (const ImportPipeline::StageStats& stage : report.stages) {
+        counted = counted && stage.records == 6008 && stage.batches >= 6008 / 16;
+    }
+    TEST_ASSERT(counted, "ImportPipeline - Compteurs par etape");
+    TEST_EXCEPTION(ImportPipeline(book, 0), std::invalid_argument, "ImportPipeline - Taille de lot nulle rejetee");
+    TEST_EXCEPTION(pipeline.runFile("/nonexistent/import.csv"), std::runtime_error, "ImportPipeline - Fichier absent");
+}
+
+// Tests pour l'historique du book
+void test_book_history() {
+    std::cout << "\n=== Tests BookHistory ===" << std::endl;
+    
+    // Vecteur persistant : les versions precedentes restent intactes
+    PersistentVector<int> empty;
+    std::vector<PersistentVector<int>> versions = {empty};
+    for (int i = 0; i < 1100; i++) {
+        versions.push_back(versions.back().pushBack(i));
+    }
+    const PersistentVector<int>& full = versions.back();
+    PersistentVector<int> changed = full.set(1000, -1);
+    TEST_ASSERT(full.size() == 1100 && full[1099] == 1099 && full[31] == 31 && full[1024] == 1024, 
+                "PersistentVector - Ajouts sur plusieurs niveaux");
+    TEST_ASSERT(changed[1000] == -1 && full[1000] == 1000 && versions[500].size() == 500 && versions[500].back() == 499, 
+                "PersistentVector - Versions precedentes intactes");
+    TEST_EXCEPTION(full.at(1100), std::out_of_range, "PersistentVector - Index hors limites");
+    
+    std::vector<Lender> pool = {Lender("BNP"), Lender("SG")};
+    BookStore book;
+    book.addDeal(Deal("S0001", "BNP", pool, Borrower("Orange"), 1000000.0, "EUR", 
+                      "2024-01-01", "2030-01-01", Deal::Status::CLOSED));
+    BookHistory history(book, "2025-01-01");
+    TEST_ASSERT(history.getVersionsCount("S0001") == 1, "BookHistory - Reprise du book existant");
+    
+    DealHandle deal = book.addDeal(Deal("S0002", "BNP", pool, Borrower("Air France"), 3000000.0, "EUR", 
+                                        "2025-01-01", "2030-01-01", Deal::Status::CLOSED));
+    // Les versions sont datees par la date de gestion de la mutation, pas par l'horloge
+    history.setCurrentDate("2025-06-01");
+    FacilityHandle facility = book.addFacility(deal, Facility("2025-02-01", "2028-01-01", 1000000.0, "EUR", pool, 0.05));
+    history.setCurrentDate("2025-07-01");
+    book.payPart(facility, 500000.0, "2025-07-01");
+    history.setCurrentDate("2026-01-10");
+    book.setStatus(deal, Deal::Status::TERMINATED);
+    book.setAgent(deal, "SG");
+    
+    TEST_ASSERT(history.getVersionsCount("S0002") == 5, "BookHistory - Une version par mutation");
+    TEST_ASSERT(history.dealAsOf("S0002", "2024-12-31") == nullptr && history.dealAsOf("B0001", "2025-01-01") == nullptr, 
+                "BookHistory - Deal inexistant a la date");
+    TEST_ASSERT(history.dealAsOf("S0002", "2025-01-15")->facilities.size() == 0, "BookHistory - Etat avant la facility");
+    std::shared_ptr<const FacilityVersion> before = history.facilityAsOf("S0002", 0, "2025-03-01");
+    TEST_ASSERT(before->parts.size() == 0 && before->remaining == Money::fromDouble(1000000.0), "BookHistory - Facility avant la part");
+    std::shared_ptr<const FacilityVersion> after = history.facilityAsOf("S0002", 0, "2025-12-31");
+    TEST_ASSERT(after->parts.size() == 1 && toDateString(after->parts[0].day) == "2025-07-01" && 
+                after->remaining == Money::fromDouble(500000.0), "BookHistory - Parts a la date");
+    
+    double accrued = 1000000.0 * 0.05 * 150 / 365;
+    TEST_ASSERT(std::fabs(history.accruedInterestAsOf("S0002", 0, "2025-07-01") - accrued) < 1e-6, 
+                "BookHistory - Interets courus a la date de la part");
+    accrued += 500000.0 * 0.05 * 184 / 365;
+    TEST_ASSERT(std::fabs(history.accruedInterestAsOf("S0002", 0, "2026-01-01") - accrued) < 1e-6, 
+                "BookHistory - Interets courus projetes");
+    TEST_ASSERT(std::fabs(before->accruedInterestAt(toDayNumber("2025-03-01")) - 1000000.0 * 0.05 * 28 / 365) < 1e-6, 
+                "BookHistory - Interets d'une version anterieure");
+    
+    std::shared_ptr<const DealVersion> closed = history.dealAsOf("S0002", "2026-01-09");
+    std::shared_ptr<const DealVersion> terminated = history.dealAsOf("S0002", "2026-01-10");
+    TEST_ASSERT(closed->status == Deal::Status::CLOSED && closed->agent == "BNP", "BookHistory - Statut et agent anterieurs");
+    TEST_ASSERT(terminated->status == Deal::Status::TERMINATED && terminated->agent == "SG" && 
+                terminated->facilities[0] == after, "BookHistory - Changements enregistres et partages");
+    TEST_EXCEPTION(history.setCurrentDate("2025-01-01"), std::invalid_argument, "BookHistory - Retour dans le temps rejete");
+    
+    // Une part future est enregistree a l'horloge mais n'apparait qu'a sa date
+    book.payPart(facility, 100000.0, "2027-01-01");
+    std::shared_ptr<const FacilityVersion> pending = history.facilityAsOf("S0002", 0, "2026-06-01");
+    std::shared_ptr<const FacilityVersion> effective = history.facilityAsOf("S0002", 0, "2027-01-01");
+    TEST_ASSERT(history.getVersion("S0002", 5)->day == toDayNumber("2026-01-10"), "BookHistory - Date future ramenee a l'horloge");
+    TEST_ASSERT(pending->parts.size() == 1 && pending->remaining == Money::fromDouble(500000.0) && 
+                std::fabs(pending->accruedInterestAt(toDayNumber("2026-01-01")) - accrued) < 1e-6, 
+                "BookHistory - Parts posterieures a la date ecartees");
+    TEST_ASSERT(effective->parts.size() == 2 && effective->remaining == Money::fromDouble(400000.0), 
+                "BookHistory - Part retenue a sa date");
+    
+    // Un deal signe avant la creation de l'historique est consultable des sa signature
+    TEST_ASSERT(history.dealAsOf("S0001", "2024-06-01") != nullptr, "BookHistory - Deal repris a sa date de signature");
+    
+    // Les deals retires restent consultables
+    book.removeDeal(deal);
+    TEST_ASSERT(history.dealAsOf("S0002", "2026-02-01")->agent == "SG", "BookHistory - Historique d'un deal retire");
+}
+
+// Tests pour le marche secondaire des participations
+void test_participation_market() {
+    std::cout << "\n=== Tests ParticipationMarket ===" << std::endl;
+    
+    std::vector<Lender> pool = {Lender("BNP"), Lender("SG")};
+    BookStore book;
+    DealHandle deal = book.addDeal(Deal("S0301", "BNP", pool, Borrower("Orange"), 2000000.0, "EUR", 
+                                        "2025-01-01", "2030-01-01", Deal::Status::CLOSED));
+    FacilityHandle handle = book.addFacility(deal, Facility("2025-01-01", "2028-01-01", 1000000.0, "EUR", pool, 0.04));
+    ParticipationMarket market(book, 8);
+    using Side = ParticipationMarket::Side;
+    
+    // Offres : priorite au meilleur prix puis a l'anteriorite
+    ParticipationMarket::OrderId first = market.submit(Side::SELL, handle, "BNP", 100000.0, 99.5);
+    ParticipationMarket::OrderId second = market.submit(Side::SELL, handle, "SG", 150000.0, 99.5);
+    ParticipationMarket::OrderId higher = market.submit(Side::SELL, handle, "BNP", 100000.0, 100.25);
+    TEST_ASSERT(market.getActiveOrdersCount() == 3 && market.getBestAsk(handle) == 99.5 && market.getBestBid(handle) == 0, 
+                "ParticipationMarket - Ordres places dans le carnet");
+    TEST_EXCEPTION(market.submit(Side::SELL, handle, "BNP", 400000.0, 101.0), std::invalid_argument, 
+                   "ParticipationMarket - Vente au-dela de la participation disponible rejetee");
+    
+    ParticipationMarket::OrderId bid = market.submit(Side::BUY, handle, "CA", 300000.0, 100.0);
+    const std::vector<ParticipationMarket::Trade>& trades = market.getTrades();
+    TEST_ASSERT(trades.size() == 2 && trades[0].sellOrder == first && trades[0].quantity == Money::fromDouble(100000.0) && 
+                trades[1].sellOrder == second && trades[1].price == 99.5 && market.getLenderName(trades[1].buyer) == "CA", 
+                "ParticipationMarket - Priorite prix puis temps");
+    TEST_ASSERT(market.isActive(bid) && market.getRemaining(bid) == Money::fromDouble(50000.0) && 
+                market.getBestBid(handle) == 100.0 && market.getBestAsk(handle) == 100.25 && !market.isActive(first), 
+                "ParticipationMarket - Reliquat place dans le carnet");
+    
+    // Reglement : les participations du book sont mises a jour
+    const Facility& facility = book.getFacility(handle);
+    TEST_ASSERT(facility.getShare("BNP") == Money::fromDouble(400000.0) && facility.getShare("SG") == Money::fromDouble(350000.0) && 
+                facility.getShare("CA") == Money::fromDouble(250000.0), "ParticipationMarket - Participations reglees");
+    
+    // Annulation et identifiants perimes
+    TEST_ASSERT(market.cancel(higher) && !market.cancel(higher) && market.getBestAsk(handle) == 0, 
+                "ParticipationMarket - Annulation");
+    ParticipationMarket::OrderId own = market.submit(Side::SELL, handle, "CA", 50000.0, 100.0);
+    TEST_ASSERT(!market.isActive(bid) && market.isActive(own) && market.getBestAsk(handle) == 100.0 && 
+                facility.getShare("CA") == Money::fromDouble(250000.0), "ParticipationMarket - Pas d'execution contre soi-meme");
+    market.cancel(own);
+    
+    // Pool borne : aucun ordre au-dela de la capacite
+    for (int i = 0; i < 8; i++) {
+        market.submit(Side::BUY, handle, "HSBC", 1000.0, 90.0 - i);
+    }
+    TEST_EXCEPTION(market.submit(Side::BUY, handle, "HSBC", 1000.0, 80.0), std::length_error, 
+                   "ParticipationMarket - Pool d'ordres epuise");
+    market.submit(Side::SELL, handle, "SG", 8000.0, 50.0);
+    TEST_ASSERT(market.getActiveOrdersCount() == 0 && facility.getShare("HSBC") == Money::fromDouble(8000.0) && 
+                market.getTrades().back().price == 83.0, "ParticipationMarket - Balayage de plusieurs niveaux");
+    TEST_EXCEPTION(market.submit(Side::BUY, handle, "HSBC", 1000.0, -1.0), std::invalid_argument, 
+                   "ParticipationMarket - Prix invalide rejete");
+    
+    // Retrait d'un deal : ses carnets sont fermes, ordres et reservations rendus au pool
+    DealHandle other = book.addDeal(Deal("S0302", "SG", pool, Borrower("Orange"), 2000000.0, "EUR", 
+                                         "2025-01-01", "2030-01-01", Deal::Status::CLOSED));
+    FacilityHandle otherHandle = book.addFacility(other, Facility("2025-01-01", "2028-01-01", 1000000.0, "EUR", pool, 0.04));
+    ParticipationMarket::OrderId removedAsk = market.submit(Side::SELL, handle, "BNP", 100000.0, 101.0);
+    market.submit(Side::BUY, handle, "CA", 10000.0, 95.0);
+    ParticipationMarket::OrderId kept = market.submit(Side::SELL, otherHandle, "SG", 100000.0, 99.0);
+    book.removeDeal(deal);
+    TEST_ASSERT(market.getActiveOrdersCount() == 1 && !market.isActive(removedAsk) && market.isActive(kept) && 
+                market.getBooksCount() == 1 && market.getBestAsk(handle) == 0 && market.getBestAsk(otherHandle) == 99.0, 
+                "ParticipationMarket - Carnets du deal retire fermes");
+    market.submit(Side::BUY, otherHandle, "CA", 100000.0, 99.0);
+    TEST_ASSERT(!market.isActive(kept) && market.getActiveOrdersCount() == 0 && 
+                book.getFacility(otherHandle).getShare("CA") == Money::fromDouble(100000.0), 
+                "ParticipationMarket - Carnet deplace toujours executable");
+}
+
+// Tests pour le controle des covenants
+void test_covenant_engine() {
+    std::cout << "\n=== Tests CovenantEngine ===" << std::endl;
+    
+    std::vector<Lender> pool = {Lender("BNP"), Lender("SG")};
+    BookStore book;
+    DealHandle existing = book.addDeal(Deal("S0401", "BNP", pool, Borrower("Orange"), 5000000.0, "EUR", 
+                                            "2025-01-01", "2030-01-01", Deal::Status::CLOSED));
+    FacilityHandle first = book.addFacility(existing, Facility("2025-01-01", "2029-01-01", 1000000.0, "EUR", pool, 0.04));
+    
+    // Les encours et limites par emprunteur sont ceux de l'index, construit avant le moteur
+    BorrowerIndex borrowers(book);
+    CovenantEngine covenants(book, borrowers);
+    TEST_ASSERT(covenants.getCurrencyOutstanding("EUR") == Money::fromDouble(1000000.0) && 
+                covenants.getLenderOutstanding("BNP", "EUR") == Money::fromDouble(500000.0) && 
+                covenants.getBorrowerOutstanding("Orange", "EUR") == Money::fromDouble(1000000.0), 
+                "CovenantEngine - Reprise des encours existants");
+    covenants.setLenderLimit("BNP", "EUR", 1200000.0);
+    covenants.setBorrowerLimit("Orange", "EUR", 2000000.0);
+    covenants.setCurrencyLimit("USD", 500000.0);
+    TEST_ASSERT(covenants.getBreaches().empty(), "CovenantEngine - Limites respectees");
+    TEST_ASSERT(borrowers.getLimit("Orange", "EUR") == Money::fromDouble(2000000.0), 
+                "CovenantEngine - Limite emprunteur tenue par l'index");
+    
+    // Facility qui porte la part de BNP au-dela de sa limite
+    FacilityHandle second = book.addFacility(existing, Facility("2025-01-01", "2027-01-01", 1600000.0, "EUR", pool, 0.05));
+    TEST_ASSERT(covenants.getBreaches().size() == 2, "CovenantEngine - Depassements detectes a l'ajout");
+    const CovenantEngine::Breach& lender = covenants.getBreaches()[0];
+    TEST_ASSERT(lender.rule == CovenantEngine::Rule::BORROWER_OUTSTANDING && 
+                covenants.getBreaches()[1].rule == CovenantEngine::Rule::LENDER_OUTSTANDING && 
+                covenants.getBreaches()[1].subject == "BNP" && covenants.getBreaches()[1].value == Money::fromDouble(1300000.0) && 
+                covenants.getBreaches()[1].event == CovenantEngine::Event::FACILITY_ADDED && 
+                covenants.getBreaches()[1].contractNum == "S0401" && covenants.getBreaches()[1].facilityIndex == 1, 
+                "CovenantEngine - Depassement avec sa mutation");
+    covenants.clearBreaches();
+    
+    // Un remboursement fait baisser les encours sans nouveau signalement
+    book.payPart(second, 400000.0, "2025-07-01");
+    TEST_ASSERT(covenants.getBreaches().empty() && covenants.getLenderOutstanding("BNP", "EUR") == Money::fromDouble(1100000.0) && 
+                covenants.getCurrencyOutstanding("EUR") == Money::fromDouble(2200000.0), "CovenantEngine - Encours apres remboursement");
+    
+    // Cession de participation : l'encours suit le cessionnaire
+    book.transferShare(second, "SG", "BNP", Money::fromDouble(400000.0));
+    TEST_ASSERT(covenants.getBreaches().size() == 1 && covenants.getBreaches()[0].event == CovenantEngine::Event::SHARES_TRANSFERRED && 
+                covenants.getLenderOutstanding("BNP", "EUR") == Money::fromDouble(1400000.0) && 
+                covenants.getLenderOutstanding("SG", "EUR") == Money::fromDouble(800000.0), "CovenantEngine - Encours apres cession");
+    covenants.clearBreaches();
+    
+    // Rythme de remboursement : au moins la moitie de l'amortissement lineaire
+    covenants.setMinimumRepaymentPace(0.5);
+    book.payPart(second, 100000.0, "2026-01-01");
+    TEST_ASSERT(covenants.getBreaches().empty(), "CovenantEngine - Rythme de remboursement respecte");
+    book.payPart(second, 10000.0, "2026-07-01");
+    TEST_ASSERT(covenants.getBreaches().size() == 1 && covenants.getBreaches()[0].rule == CovenantEngine::Rule::REPAYMENT_PACE && 
+                covenants.getBreaches()[0].date == "2026-07-01" && covenants.getBreaches()[0].value == Money::fromDouble(510000.0), 
+                "CovenantEngine - Retard de remboursement signale");
+    covenants.clearBreaches();
+    
+    // Une facility jamais remboursee est signalee au calcul des interets courus
+    book.accrueTo(first, "2027-01-01");
+    TEST_ASSERT(covenants.getBreaches().size() == 1 && covenants.getBreaches()[0].rule == CovenantEngine::Rule::REPAYMENT_PACE && 
+                covenants.getBreaches()[0].event == CovenantEngine::Event::INTEREST_ACCRUED && 
+                covenants.getBreaches()[0].date == "2027-01-01" && covenants.getBreaches()[0].facilityIndex == 0 && 
+                covenants.getBreaches()[0].value == Money() && covenants.getBreaches()[0].limit > Money(), 
+                "CovenantEngine - Retard signale sans remboursement");
+    covenants.clearBreaches();
+    
+    // Nouvelle limite deja depassee, deal en dollars, retrait
+    covenants.setCurrencyLimit("EUR", 1000000.0);
+    TEST_ASSERT(covenants.getBreaches().size() == 1 && covenants.getBreaches()[0].event == CovenantEngine::Event::RULE_ADDED, 
+                "CovenantEngine - Limite deja depassee signalee");
+    DealHandle dollars = book.addDeal(Deal("S0402", "SG", pool, Borrower("Air France"), 900000.0, "USD", 
+                                           "2025-01-01", "2030-01-01", Deal::Status::CLOSED));
+    book.addFacility(dollars, Facility("2025-01-01", "2028-01-01", 600000.0, "USD", pool, 0.04));
+    TEST_ASSERT(covenants.getBreaches().size() == 2 && covenants.getBreaches()[1].subject == "USD", 
+                "CovenantEngine - Limite par devise");
+    book.removeDeal(existing);
+    TEST_ASSERT(covenants.getCurrencyOutstanding("EUR") == Money() && covenants.getLenderOutstanding("SG", "EUR") == Money() && 
+                covenants.getLenderOutstanding("SG", "USD") == Money::fromDouble(300000.0), "CovenantEngine - Encours apres retrait");
+    TEST_EXCEPTION(covenants.setLenderLimit("BNP", "EUR", -1.0), std::invalid_argument, "CovenantEngine - Limite negative rejetee");
+    TEST_EXCEPTION(covenants.setMinimumRepaymentPace(1.5), std::invalid_argument, "CovenantEngine - Rythme invalide rejete");
+    BookStore other;
+    TEST_EXCEPTION(CovenantEngine(other, borrowers), std::invalid_argument, "CovenantEngine - Index d'un autre book rejete");
+}
+
+// Tests pour la reconciliation par empreintes
+void test_book_digest() {
+    std::cout << "\n=== Tests BookDigest ===" << std::endl;
+    
+    // Arbre de Merkle : chemin recalcule, feuilles differentes seules visitees
+    MerkleTrie left;
+    MerkleTrie right;
+    for (uint16_t key = 0; key < 5000; key++) {
+        left.set(key, key + 1);
+        right.set(key, key + 1);
+    }
+    TEST_ASSERT(left.getRoot() == right.getRoot() && left.getLeavesCount() == 5000, "MerkleTrie - Racines identiques");
+    right.set(1234, 42);
+    right.set(4999, 0);
+    std::vector<uint16_t> keys;
+    size_t visited = 0;
+    left.diff(right, keys, visited);
+    TEST_ASSERT(keys.size() == 2 && keys[0] == 1234 && keys[1] == 4999 && visited <= 2 * MerkleTrie::DEPTH * MerkleTrie::FANOUT + 1, 
+                "MerkleTrie - Seules les branches differentes sont parcourues");
+    
+    // Deux exemplaires identiques du book
+    std::vector<Lender> pool = {Lender("BNP"), Lender("SG")};
+    const char* names[] = {"Orange", "Air France", "Total", "Renault"};
+    BookStore ours;
+    BookStore theirs;
+    for (BookStore* book : {&ours, &theirs}) {
+        for (int i = 1; i <= 2000; i++) {
+            std::string number = std::to_string(i);
+            std::string contract = "S" + std::string(4 - number.size(), '0') + number;
+            DealHandle deal = book->addDeal(Deal(contract, "BNP", pool, Borrower(names[i % 4]), 3000000.0, "EUR", 
+                                                 "2025-01-01", "2030-01-01", Deal::Status::CLOSED));
+            FacilityHandle facility = book->addFacility(deal, Facility("2025-01-01", "2028-01-01", 1000000.0, "EUR", pool, 0.04));
+            book->payPart(facility, 1000.0 * (i % 7 + 1), "2025-06-01");
+        }
+    }
+    BookDigest ourDigest(ours);
+    BookDigest theirDigest(theirs);
+    BookDigest::Report same = ourDigest.compare(theirDigest);
+    TEST_ASSERT(ourDigest.getRoot() == theirDigest.getRoot() && same.differences.empty() && same.comparedNodes == 1, 
+                "BookDigest - Exemplaires identiques");
+    
+    // Ecarts : une part, une cession, un deal de plus, un deal retire
+    FacilityHandle paid = {ours.findDeal("S0042"), 0};
+    ours.payPart(paid, 5000.0, "2025-09-01");
+    ours.transferShare({ours.findDeal("S1500"), 0}, "SG", "CA", Money::fromDouble(100000.0));
+    theirs.addDeal(Deal("Z0001", "SG", pool, Borrower("Orange"), 1000000.0, "EUR", 
+                        "2025-01-01", "2030-01-01", Deal::Status::CLOSED));
+    theirs.removeDeal(theirs.findDeal("S0777"));
+    
+    BookDigest::Report report = ourDigest.compare(theirDigest);
+    TEST_ASSERT(report.differences.size() == 4, "BookDigest - Ecarts detectes");
+    const BookDigest::Difference& part = report.differences[0];
+    TEST_ASSERT(part.contractNum == "S0042" && part.kind == BookDigest::Kind::CHANGED && !part.termsChanged && 
+                part.facilities.size() == 1 && part.facilities[0] == 0, "BookDigest - Descente jusqu'a la facility");
+    TEST_ASSERT(report.differences[1].contractNum == "S0777" && report.differences[1].kind == BookDigest::Kind::ONLY_HERE && 
+                report.differences[2].contractNum == "S1500" && 
+                report.differences[3].contractNum == "Z0001" && report.differences[3].kind == BookDigest::Kind::ONLY_THERE, 
+                "BookDigest - Deals presents d'un seul cote");
+    // Au plus un chemin dans l'arbre de tete et un dans l'arbre de l'emprunteur par ecart
+    TEST_ASSERT(report.comparedNodes <= 4 * 2 * (MerkleTrie::DEPTH * MerkleTrie::FANOUT + 1), "BookDigest - Comparaison proportionnelle aux ecarts");
+    
+    // Mise a jour incrementale identique a un recalcul complet
+    BookDigest rebuilt(ours);
+    TEST_ASSERT(rebuilt.getRoot() == ourDigest.getRoot() && rebuilt.getDealHash("S0042") == ourDigest.getDealHash("S0042") && 
+                ourDigest.getDealHash("S0042") != theirDigest.getDealHash("S0042") && ourDigest.getDealHash("Z0001") == 0, 
+                "BookDigest - Empreintes incrementales");
+    TEST_ASSERT(ourDigest.getBorrowerHash("Renault") == theirDigest.getBorrowerHash("Renault") && 
+                ourDigest.getBorrowerHash("Orange") != theirDigest.getBorrowerHash("Orange"), "BookDigest - Empreintes par emprunteur");
+    
+    // Parts identiques dans le meme ordre : meme empreinte
+    TEST_ASSERT(BookDigest::hashPart(Part(100.0, "2025-01-01")) == BookDigest::hashPart(Part(100.0, "2025-01-01")) && 
+                BookDigest::hashPart(Part(100.0, "2025-01-01")) != BookDigest::hashPart(Part(100.0, "2025-01-02")), 
+                "BookDigest - Empreinte de part");
+}
+
+// Tests pour le flux de changements
+void test_change_stream() {
+    std::cout << "\n=== Tests ChangeStream ===" << std::endl;
+    
+    std::vector<Lender> pool = {Lender("BNP"), Lender("SG")};
+    BookStore book;
+    TEST_EXCEPTION(ChangeStream(book, 0), std::invalid_argument, "ChangeStream - Capacite nulle");
+    ChangeStream stream(book, 1000);
+    TEST_ASSERT(stream.getCapacity() == 1024 && stream.getNextSequence() == 1, "ChangeStream - Anneau en puissance de 2");
+    
+    // Enregistrements dans l'ordre des mutations
+    ChangeStream::Cursor cursor = stream.subscribe();
+    DealHandle deal = book.addDeal(Deal("S0001", "BNP", pool, Borrower("Orange"), 3000000.0, "EUR", 
+                                        "2025-01-01", "2030-01-01", Deal::Status::CLOSED));
+    FacilityHandle facility = book.addFacility(deal, Facility("2025-02-01", "2028-01-01", 1000000.0, "EUR", pool, 0.04));
+    book.payPart(facility, 2500.5, "2025-06-01");
+    book.setAgent(deal, "SG");
+    ChangeRecord record;
+    std::vector<ChangeRecord> records;
+    while (cursor.poll(record) == ChangeStream::PollResult::RECORD) {
+        records.push_back(record);
+    }
+    TEST_ASSERT(records.size() == 4 && records[0].sequence == 1 && records[3].sequence == 4 && 
+                cursor.getNextSequence() == 5, "ChangeStream - Sequences consecutives");
+    TEST_ASSERT(records[0].type == ChangeRecord::Type::DEAL_ADDED && records[0].contractNum == "S0001" && 
+                records[0].text == "Orange" && records[0].date == "2025-01-01", "ChangeStream - Nouveau deal");
+    TEST_ASSERT(records[1].type == ChangeRecord::Type::FACILITY_ADDED && records[1].date == "2025-02-01" && 
+                records[2].type == ChangeRecord::Type::PART_PAID && records[2].amount == Money::fromDouble(2500.5) && 
+                records[2].facilityIndex == 0, "ChangeStream - Facility et part");
+    TEST_ASSERT(records[3].type == ChangeRecord::Type::AGENT_CHANGED && records[3].text == "SG", "ChangeStream - Changement d'agent");
+    TEST_ASSERT(cursor.poll(record) == ChangeStream::PollResult::EMPTY, "ChangeStream - Curseur a jour");
+    
+    // Un consommateur par thread pendant que le book est modifie
+    std::atomic<bool> done(false);
+    size_t consumed = 0;
+    bool ordered = true;
+    std::thread consumer([&]() {
+        ChangeStream::Cursor reader = stream.subscribeFrom(5);
+        ChangeRecord change;
+        uint64_t expected = 5;
+        while (true) {
+            bool finished = done.load();
+            ChangeStream::PollResult result = reader.poll(change);
+            if (result == ChangeStream::PollResult::RECORD) {
+                ordered = ordered && change.sequence == expected++;
+                consumed++;
+            } else if (result == ChangeStream::PollResult::LAPPED || finished) {
+                break;
+            }
+        }
+    });
+    for (int i = 0; i < 500; i++) {
+        book.payPart(facility, 100.0, "2025-07-01");
+    }
+    done.store(true);
+    consumer.join();
+    TEST_ASSERT(consumed == 500 && ordered, "ChangeStream - Consommateur concurrent");
+    
+    // Un curseur distance d'un tour est prevenu, puis reprend depuis le puits fichier
+    std::string path = (std::filesystem::temp_directory_path() / "sfc_changes_test.csv").string();
+    std::filesystem::remove(path);
+    ChangeStream small(book, 8);
+    ChangeFileSink sink(small, path);
+    ChangeStream::Cursor late = small.subscribe();
+    book.payPart(facility, 10.0, "2025-08-01");
+    book.setStatus(deal, Deal::Status::TERMINATED);
+    TEST_ASSERT(sink.drain() == 2, "ChangeStream - Puits fichier");
+    for (int i = 0; i < 20; i++) {
+        book.payPart(facility, 1.0, "2025-09-01");
+        sink.drain();
+    }
+    TEST_ASSERT(late.poll(record) == ChangeStream::PollResult::LAPPED && small.getOldestSequence() == 15, 
+                "ChangeStream - Curseur distance");
+    std::vector<ChangeRecord> replay = ChangeFileSink::read(path, late.getNextSequence());
+    TEST_ASSERT(replay.size() == 22 && replay[0].sequence == 1 && replay[0].amount == Money::fromDouble(10.0) && 
+                replay[1].type == ChangeRecord::Type::STATUS_CHANGED && replay[1].text == "terminated", 
+                "ChangeStream - Reprise depuis le fichier");
+    TEST_ASSERT(ChangeFileSink::read(path, 20).size() == 3, "ChangeStream - Reprise a une sequence donnee");
+    
+    // Puits distance : exception
+    ChangeFileSink slow(small, path);
+    for (int i = 0; i < 9; i++) {
+        book.payPart(facility, 1.0, "2025-10-01");
+    }
+    TEST_EXCEPTION(slow.drain(), std::runtime_error, "ChangeStream - Puits distance");
+    TEST_EXCEPTION(small.subscribeFrom(100), std::invalid_argument, "ChangeStream - Sequence future");
+    std::filesystem::remove(path);
+    
+    // Arrete des interets publie comme les autres mutations, une seule fois par registre avance
+    ChangeStream::Cursor accruals = stream.subscribe();
+    book.accrueTo("2026-01-01");
+    book.accrueTo("2026-01-01");
+    TEST_ASSERT(accruals.poll(record) == ChangeStream::PollResult::RECORD && 
+                record.type == ChangeRecord::Type::INTEREST_ACCRUED && record.date == "2026-01-01" && 
+                record.amount == book.getFacility(facility).getAccruedInterestMoney() && 
+                accruals.poll(record) == ChangeStream::PollResult::EMPTY, "ChangeStream - Arrete des interets");
+}
+
+// Tests pour l'ordonnanceur de taches
+void test_task_scheduler() {
+    std::cout << "\n=== Tests TaskScheduler ===" << std::endl;
+    
+    TaskScheduler scheduler(4);
+    TEST_ASSERT(scheduler.getWorkersCount() == 4 && scheduler.getNodesCount() >= 1, "TaskScheduler - Workers demarres");
+    bool placed = true;
+    for (size_t i = 0; i < scheduler.getWorkersCount(); i++) {
+        placed = placed && scheduler.getNode(i) >= 0 && scheduler.getCpu(i) >= -1;
+    }
+    TEST_ASSERT(placed, "TaskScheduler - Placement des workers");
+    
+    // Chaque indice traite exactement une fois, tranches bornees par le grain
+    std::vector<int> visits(100000, 0);
+    std::atomic<size_t> largest(0);
+    scheduler.parallelFor(0, visits.size(), 100, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            visits[i]++;
+        }
+        size_t size = end - begin;
+        size_t seen = largest.load();
+        while (size > seen && !largest.compare_exchange_weak(seen, size)) {
+        }
+    });
+    TEST_ASSERT(std::all_of(visits.begin(), visits.end(), [](int count) { return count == 1; }) && largest.load() <= 100, 
+                "TaskScheduler - parallelFor");
+    
+    // Parallelisme imbrique : parallelFor dans un parallelFor
+    std::atomic<long long> nested(0);
+    scheduler.parallelFor(0, 64, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            scheduler.parallelFor(0, 1000, 50, [&](size_t low, size_t high) {
+                long long sum = 0;
+                for (size_t j = low; j < high; j++) {
+                    sum += static_cast<long long>(j);
+                }
+                nested += sum;
+            });
+        }
+    });
+    TEST_ASSERT(nested.load() == 64LL * 999 * 1000 / 2, "TaskScheduler - Parallelisme imbrique");
+    
+    // Fork/join recursif
+    std::function<long long(int)> fibonacci = [&](int n) -> long long {
+        if (n < 15) {
+            return n < 2 ? n : fibonacci(n - 1) + fibonacci(n - 2);
+        }
+        long long left = 0;
+        TaskGroup group(scheduler);
+        group.run([&]() { left = fibonacci(n - 1); });
+        long long right = fibonacci(n - 2);
+        group.wait();
+        return left + right;
+    };
+    TEST_ASSERT(fibonacci(25) == 75025, "TaskScheduler - Fork/join recursif");
+    
+    // Exception d'une tache relancee par wait, le groupe reste utilisable
+    TaskGroup group(scheduler);
+    std::atomic<int> done(0);
+    group.run([]() { throw std::runtime_error("task failed"); });
+    group.run([&]() { done++; });
+    TEST_EXCEPTION(group.wait(), std::runtime_error, "TaskScheduler - Exception propagee");
+    group.run([&]() { done++; });
+    group.wait();
+    TEST_ASSERT(done.load() == 2, "TaskScheduler - Groupe reutilisable");
+    
+    // Book couru en parallele : meme resultat qu'un calcul facility par facility
+    std::vector<Lender> pool = {Lender("BNP"), Lender("SG")};
+    BookStore book;
+    std::vector<FacilityHandle> handles;
+    for (int i = 1; i <= 3000; i++) {
+        std::string number = std::to_string(i);
+        std::string contract = "S" + std::string(4 - number.size(), '0') + number;
+        DealHandle deal = book.addDeal(Deal(contract, "BNP", pool, Borrower("Orange"), 3000000.0, "EUR", 
+                                            "2025-01-01", "2030-01-01", Deal::Status::CLOSED));
+        handles.push_back(book.addFacility(deal, Facility("2025-01-01", "2028-01-01", 1000000.0 + i, "EUR", pool, 0.04)));
+        book.payPart(handles.back(), 1000.0 * (i % 7 + 1), "2025-06-01");
+    }
+    book.accrueTo("2026-01-01");
+    Money expected;
+    bool accrued = true;
+    for (FacilityHandle handle : handles) {
+        const Facility& facility = book.getFacility(handle);
+        accrued = accrued && facility.getAccrualDate() == "2026-01-01";
+        expected += facility.getAccruedInterestMoney();
+    }
+    Portfolio portfolio(book, handles);
+    TEST_ASSERT(accrued && portfolio.getAccruedInterestMoney() == expected, "TaskScheduler - Interets et totaux du book en parallele");
+    TEST_EXCEPTION(book.accrueTo("2026-13-01"), std::invalid_argument, "TaskScheduler - Exception d'un calcul parallele");
+}
+
+// Tests pour le book reparti entre processus
+void test_shard_coordinator() {
+    std::cout << "\n=== Tests ShardCoordinator ===" << std::endl;
+    
+    TEST_EXCEPTION(ShardCoordinator(0, ShardCoordinator::Partition::BORROWER), std::invalid_argument, "ShardCoordinator - Aucun shard");
+    
+    // Pas de fork pendant un calcul parallele ; hors calcul, les workers endormis n'empechent rien
+    bool refused = false;
+    {
+        TaskGroup group;
+        group.run([&refused]() {
+            try {
+                ShardCoordinator inside(1, ShardCoordinator::Partition::BORROWER);
+            } catch (const std::runtime_error&) {
+                refused = true;
+            }
+        });
+        group.wait();
+    }
+    TEST_ASSERT(refused && TaskScheduler::canFork(), "ShardCoordinator - Fork refuse pendant un calcul parallele");
+    
+    std::vector<Lender> pool = {Lender("BNP"), Lender("SG")};
+    const char* names[] = {"Orange", "Air France", "Total", "Renault"};
+    BookStore book;
+    std::vector<FacilityHandle> handles;
+    for (int i = 1; i <= 2000; i++) {
+        std::string number = std::to_string(i);
+        std::string contract = "S" + std::string(4 - number.size(), '0') + number;
+        DealHandle deal = book.addDeal(Deal(contract, "BNP", pool, Borrower(names[i % 4]), 3000000.0, "EUR", 
+                                            "2025-01-01", "2030-01-01", Deal::Status::CLOSED));
+        handles.push_back(book.addFacility(deal, Facility("2025-01-01", "2028-01-01", 1000000.0, "EUR", pool, 0.04)));
+        book.payPart(handles.back(), 1000.0 * (i % 7 + 1), "2025-06-01");
+    }
+    // Etat anterieur au chargement : cession de participation et arrete d'une seule facility
+    book.transferShare(handles[9], "SG", "CA", Money::fromDouble(200000.0));
+    book.accrueTo(handles[10], "2025-12-01");
+    
+    // Plages de contrats equilibrees au chargement
+    ShardCoordinator ranges(4, ShardCoordinator::Partition::CONTRACT_RANGE);
+    TEST_ASSERT(ranges.load(book) == 2000 && ranges.getDealsCount() == 2000, "ShardCoordinator - Chargement du book");
+    TEST_ASSERT(ranges.getDealsCount(0) == 500 && ranges.getDealsCount(3) == 500 && ranges.shardOf("S0001") == 0 && 
+                ranges.shardOf("S2000") == 3, "ShardCoordinator - Plages equilibrees");
+    
+    // Agregats rassembles identiques a ceux du book d'origine
+    Portfolio local(book, handles);
+    protocol::PortfolioTotals totals = ranges.portfolio();
+    TEST_ASSERT(totals.amount == local.getTotalAmountMoney() && totals.remaining == local.getRemainingMoney() && 
+                totals.interest == local.getTotalInterestMoney() && totals.accrued == local.getAccruedInterestMoney() && totals.partsCount == 2000, "ShardCoordinator - Portfolio rassemble");
+    protocol::QuerySpec orange;
+    orange.borrower = "Orange";
+    protocol::QueryResult selection = ranges.query(orange);
+    TEST_ASSERT(selection.count == 500 && selection.contracts.size() == 500 && selection.contracts[0] == "S0004" && 
+                selection.contracts[499] == "S2000", "ShardCoordinator - Recherche sur tous les shards");
+    
+    // Ecritures routees vers le shard du contrat
+    book.payPart(handles[41], 5000.0, "2025-09-01");
+    TEST_ASSERT(ranges.pay({"S0042", 0, 5000.0, "2025-09-01"}) == book.getFacility(handles[41]).getRemainingMoney() && 
+                ranges.getDeal("S0042").remaining == book.getFacility(handles[41]).getRemainingMoney(), 
+                "ShardCoordinator - Paiement route");
+    book.accrueTo("2026-01-01");
+    ranges.accrueTo("2026-01-01");
+    TEST_ASSERT(ranges.portfolio().accrued == local.getAccruedInterestMoney(), "ShardCoordinator - Interets courus par shard");
+    
+    ranges.createDeal({"Z0001", "SG", "Orange", {"BNP"}, 1000000.0, "EUR", "2025-01-01", "2030-01-01", 
+                       static_cast<uint8_t>(Deal::Status::CLOSED)});
+    TEST_ASSERT(ranges.shardOf("Z0001") == 3 && 
+                ranges.addFacility({"Z0001", "2025-01-01", "2027-01-01", 500000.0, "EUR", 0.03, {"BNP"}, {}, "", 0}) == 0, 
+                "ShardCoordinator - Nouveau deal route");
+    TEST_EXCEPTION(ranges.createDeal({"S0042", "SG", "Orange", {"BNP"}, 1000000.0, "EUR", "2025-01-01", "2030-01-01", 0}), 
+                   std::invalid_argument, "ShardCoordinator - Contrat existant");
+    TEST_EXCEPTION(ranges.shardOf("B0001"), std::invalid_argument, "ShardCoordinator - Contrat inconnu");
+    TEST_EXCEPTION(ranges.pay({"S0042", 3, 10.0, "2025-10-01"}), std::runtime_error, "ShardCoordinator - Erreur d'un shard");
+    
+    // Repartition par emprunteur : les deals d'un emprunteur sur un meme shard
+    ShardCoordinator borrowers(3, ShardCoordinator::Partition::BORROWER);
+    borrowers.load(book);
+    TEST_ASSERT(borrowers.shardOf("S0004") == borrowers.shardOf("S1000") && 
+                borrowers.shardOf("S0001") == borrowers.shardOf("S0005") && 
+                borrowers.portfolio().remaining == local.getRemainingMoney(), "ShardCoordinator - Repartition par emprunteur");
+}
+
+// Tests pour l'historique compresse des parts
+void test_part_history() {
+    std::cout << "\n=== Tests PartHistory ===" << std::endl;
+    
+    PartHistory empty;
+    TEST_ASSERT(empty.empty() && empty.size() == 0 && empty.begin() == empty.end() && empty.getBlocksCount() == 0, 
+                "PartHistory - Historique vide");
+    TEST_EXCEPTION(empty[0], std::out_of_range, "PartHistory - Indice hors limites");
+    TEST_EXCEPTION(empty.back(), std::out_of_range, "PartHistory - Derniere part d'un historique vide");
+    
+    // Echeances mensuelles aux montants repetes, avec une part antidatee
+    PartHistory history;
+    std::vector<Part> expected;
+    int start = toDayNumber("2025-01-01");
+    for (int i = 0; i < 1000; i++) {
+        int day = i == 500 ? start : start + 30 * i;
+        Part part(Money::fromDouble(i % 50 < 40 ? 2500.0 : 1250.75), toDateString(day));
+        history.push_back(part);
+        expected.push_back(part);
+    }
+    TEST_ASSERT(history.size() == 1000 && history.getBlocksCount() == (1000 + PartHistory::BLOCK_SIZE - 1) / PartHistory::BLOCK_SIZE, 
+                "PartHistory - Blocs");
+    
+    bool same = true;
+    size_t i = 0;
+    for (const Part& part : history) {
+        same = same && i < expected.size() && part.getMoney() == expected[i].getMoney() && part.getDate() == expected[i].getDate();
+        i++;
+    }
+    TEST_ASSERT(same && i == 1000, "PartHistory - Parcours decode");
+    TEST_ASSERT(history[0].getDate() == "2025-01-01" && history[500].getDate() == "2025-01-01" && 
+                history[999].getDate() == expected[999].getDate() && history[130].getMoney() == expected[130].getMoney() && 
+                history.front().getDate() == "2025-01-01" && history.back().getMoney() == expected[999].getMoney(), 
+                "PartHistory - Acces par indice");
+    PartHistory::const_iterator it = history.begin();
+    for (int step = 0; step < 200; step++) {
+        ++it;
+    }
+    TEST_ASSERT(it.getDay() == start + 30 * 200 && it.getMoney() == Money::fromDouble(2500.0), "PartHistory - Valeurs sans construire la part");
+    
+    // Quelques octets par part au lieu d'une Part avec sa chaine de date
+    TEST_ASSERT(history.getMemoryBytes() < 1000 * 4, "PartHistory - Historique compresse");
+    
+    // Montants en unites mineures de la devise : ecarts plus courts, valeurs identiques
+    PartHistory cents(2);
+    PartHistory yen(0);
+    for (int j = 0; j < 100; j++) {
+        cents.push_back(Part(Money::fromDouble(1000.0 + 0.5 * j), toDateString(start + j)));
+        yen.push_back(Part(Money::fromDouble(150000.0 + j), toDateString(start + j)));
+    }
+    PartHistory thousandths;
+    for (const Part& part : cents) {
+        thousandths.push_back(part);
+    }
+    TEST_ASSERT(cents.back().getMoney() == Money::fromDouble(1049.5) && cents[40].getMoney() == thousandths[40].getMoney() && 
+                yen[99].getMoney() == Money::fromDouble(150099.0) && cents.getMemoryBytes() < thousandths.getMemoryBytes(), 
+                "PartHistory - Unites mineures de la devise");
+    TEST_EXCEPTION(cents.push_back(Part(Money::fromUnits(1005), "2025-01-01")), std::invalid_argument, 
+                   "PartHistory - Montant sous l'unite mineure rejete");
+    TEST_EXCEPTION(PartHistory(4), std::invalid_argument, "PartHistory - Decimales invalides");
+    
+    // Facility : historique compresse et registre d'interets inchanges
+    std::vector<Lender> lenders = {Lender("BNP")};
+    Facility facility("2025-01-01", "2035-01-01", 10000000.0, "EUR", lenders, 0.05);
+    for (int j = 0; j < 300; j++) {
+        facility.payPart(1000.0, toDateString(start + 10 * j));
+    }
+    facility.payPart(500.0, "2025-01-05");
+    double interest = facility.getAccruedInterest();
+    Facility replayed("2025-01-01", "2035-01-01", 10000000.0, "EUR", lenders, 0.05);
+    for (const Part& part : facility.getParts()) {
+        replayed.addPart(part);
+    }
+    TEST_ASSERT(facility.getParts().size() == 301 && facility.getParts().back().getDate() == "2025-01-05" && 
+                std::fabs(replayed.getAccruedInterest() - interest) < 1e-6 && 
+                replayed.getRemainingMoney() == facility.getRemainingMoney(), "PartHistory - Parts de la facility");
+}
+
+// Tests pour les tables de facteurs de croissance
+void test_growth_factor_cache() {
+    std::cout << "\n=== Tests GrowthFactorCache ===" << std::endl;
+    
+    GrowthFactorCache cache;
+    const GrowthFactorCache::Table& table = cache.table(1.05);
+    TEST_ASSERT(&cache.table(1.05) == &table && cache.getTablesCount() == 1, "GrowthFactorCache - Table partagee par taux");
+    
+    // Lectures conformes a pow, dans et au-dela de l'horizon tabule
+    bool exact = true;
+    for (int days : {0, 1, 63, 64, 365, 1000, 18262, 32767, 32768, 50000, -730}) {
+        double expected = std::pow(1.05, days / 365.0);
+        exact = exact && std::fabs(table.factor(days) - expected) <= 1e-14 * expected;
+    }
+    TEST_ASSERT(exact, "GrowthFactorCache - Facteurs conformes a pow");
+    TEST_ASSERT(std::fabs(cache.discountFactor(1.05, 730) - 1.0 / (1.05 * 1.05)) < 1e-15, 
+                "GrowthFactorCache - Facteur d'actualisation");
+    TEST_ASSERT(cache.growthFactor(0.0, 0) == 1.0 && cache.growthFactor(0.0, 10) == 0.0 && cache.getTablesCount() == 2, 
+                "GrowthFactorCache - Base nulle");
+    
+    // Construction concurrente : une seule table par base
+    std::vector<std::thread> threads;
+    std::vector<const GrowthFactorCache::Table*> seen(8);
+    for (size_t t = 0; t < seen.size(); t++) {
+        threads.emplace_back([&cache, &seen, t]() { seen[t] = &cache.table(0.0425); });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    TEST_ASSERT(std::all_of(seen.begin(), seen.end(), [&](const GrowthFactorCache::Table* p) { return p == seen[0]; }) && 
+                cache.getTablesCount() == 3, "GrowthFactorCache - Construction concurrente");
+    
+    // Utilisation par les facilities et la courbe plate
+    std::vector<Lender> pool = {Lender("BNP")};
+    Facility facility("2024-01-01", "2026-01-01", 1000000.0, "EUR", pool, 0.05);
+    facility.payPart(250000.0, "2025-03-15");
+    double years = (toDayNumber("2025-03-15") - toDayNumber("2024-01-01")) / 365.0;
+    TEST_ASSERT(std::fabs(facility.calculateInterest(facility.getParts()[0]) - 750000.0 * std::pow(0.05, years)) < 1e-9, 
+                "GrowthFactorCache - Interets de la facility");
+    FlatCurve curve(0.03);
+    TEST_ASSERT(std::fabs(curve.discountFactorForDays(1000) - std::pow(1.03, -1000 / 365.0)) < 1e-15, 
+                "GrowthFactorCache - Courbe plate tabulee");
+}
+
+// Tests pour l'evaluation des facilities
+void test_pricing() {
+    std::cout << "\n=== Tests Pricing ===" << std::endl;
+    
+    std::vector<Lender> pool = {Lender("BNP")};
+    FlatCurve curve(0.05);
+    TEST_ASSERT(std::fabs(curve.discountFactor(1.0) - 1 / 1.05) < 1e-12, "FlatCurve - Facteur d'actualisation");
+    TEST_EXCEPTION(FlatCurve(-1.5), std::invalid_argument, "FlatCurve - Taux invalide rejete");
+    
+    // Facility d'un an sans remboursement anticipe : TRI egal au taux
+    Facility bullet("2024-01-01", "2024-12-31", 1000000.0, "EUR", pool, 0.05);
+    std::vector<CashFlow> flows = pricing::cashFlows(bullet);
+    TEST_ASSERT(flows.size() == 2 && flows[0].amount == -1000000.0, "Pricing - Flux de tirage");
+    TEST_ASSERT(std::fabs(flows[1].amount - 1050000.0) < 1e-6, "Pricing - Flux projete a l'echeance");
+    TEST_ASSERT(std::fabs(pricing::npv(flows, curve, toDayNumber("2024-01-01"))) < 1e-6, 
+                "Pricing - VAN nulle au taux de la facility");
+    
+    // Remboursements effectifs puis flux projete
+    Facility amortizing("2025-01-01", "2029-01-01", 1000000.0, "EUR", pool, 0.04);
+    amortizing.payPart(250000.0, "2026-01-01");
+    amortizing.payPart(250000.0, "2027-01-01");
+    flows = pricing::cashFlows(amortizing);
+    TEST_ASSERT(flows.size() == 4 && std::fabs(flows[1].amount - 290000.0) < 1e-6, "Pricing - Interets courus sur l'encours");
+    TEST_ASSERT(std::fabs(flows[3].amount - (500000.0 + 500000.0 * 0.04 * 731 / 365)) < 1e-6, 
+                "Pricing - Restant du a l'echeance");
+    
+    YieldSolver solver;
+    size_t first = solver.addProblem(pricing::cashFlows(bullet), toDayNumber("2024-01-01"), 0.0, 0.0);
+    size_t second = solver.addProblem(flows, toDayNumber("2025-01-01"), 0.0, 0.2);
+    size_t impossible = solver.addProblem({{0, 100.0}, {365, 100.0}}, 0, 0.0, 0.0);
+    solver.solve();
+    TEST_ASSERT(solver.isConverged(first) && std::fabs(solver.getSolution(first) - 0.05) < 1e-9, "YieldSolver - TRI");
+    TEST_ASSERT(solver.isConverged(second) && std::fabs(solver.getSolution(second) - 0.04) < 1e-3, 
+                "YieldSolver - TRI d'une facility amortie");
+    TEST_ASSERT(!solver.isConverged(impossible) && std::isnan(solver.getSolution(impossible)), 
+                "YieldSolver - Pas de changement de signe");
+    // Les pas sont faits sur tout le lot : chaque probleme garde la solution qu'il aurait seul
+    YieldSolver alone;
+    alone.addProblem(flows, toDayNumber("2025-01-01"), 0.0, 0.2);
+    alone.solve();
+    TEST_ASSERT(alone.getSolution(0) == solver.getSolution(second) && alone.getEvaluations() < solver.getEvaluations(), 
+                "YieldSolver - Lot sans effet sur la solution");
+    
+    // Evaluation du book par lots avec demarrage a chaud
+    std::vector<Deal> deals;
+    for (int i = 0; i < 50; i++) {
+        std::string number = std::to_string(i + 1);
+        Deal deal("S" + std::string(4 - number.size(), '0') + number, "BNP", pool, Borrower("Orange"), 
+                  10000000.0, "EUR", "2024-01-01", "2034-01-01", Deal::Status::CLOSED);
+        Facility facility("2024-01-01", "2030-01-01", 1000000.0, "EUR", pool, 0.02 + 0.001 * i);
+        facility.payPart(100000.0 + 1000.0 * i, "2025-06-01");
+        deal.addFacility(facility);
+        deals.push_back(deal);
+    }
+    PricingEngine engine(curve);
+    std::vector<FacilityPricing> day1 = engine.priceBook(deals, "2025-09-01");
+    size_t coldEvaluations = engine.getLastEvaluations();
+    bool allConverged = true;
+    for (const FacilityPricing& result : day1) {
+        allConverged = allConverged && result.converged;
+    }
+    TEST_ASSERT(day1.size() == 50 && allConverged, "PricingEngine - Book evalue");
+    TEST_ASSERT(day1[10].irr > day1[0].irr && day1[10].npv > day1[0].npv, "PricingEngine - Coherence des taux");
+    std::vector<FacilityPricing> day2 = engine.priceBook(deals, "2025-09-02");
+    TEST_ASSERT(engine.getLastEvaluations() < coldEvaluations, "PricingEngine - Demarrage a chaud");
+    TEST_ASSERT(std::fabs(day2[7].irr - day1[7].irr) < 1e-9, "PricingEngine - TRI stable d'un jour a l'autre");
+    
+    // Un moteur garde pour la session suit le nouveau taux de sa courbe sans perdre le demarrage a chaud
+    curve = FlatCurve(0.06);
+    std::vector<FacilityPricing> repriced = engine.priceBook(deals, "2025-09-02");
+    TEST_ASSERT(engine.getLastEvaluations() < coldEvaluations && repriced[7].npv < day2[7].npv && 
+                std::fabs(repriced[7].irr - day2[7].irr) < 1e-9, "PricingEngine - Changement de taux de la courbe");
+}
+
+// Tests pour les courbes de taux
+void test_yield_curve() {
+    std::cout << "\n=== Tests YieldCurve ===" << std::endl;
+    
+    std::vector<YieldCurve::Pillar> pillars = {{365, 0.03}, {730, 0.035}, {1825, 0.04}, {3650, 0.038}};
+    YieldCurve linear("EUR", "2025-01-01", pillars, YieldCurve::Interpolation::LINEAR);
+    YieldCurve cubic("EUR", "2025-01-01", pillars);
+    
+    // Les piliers sont repris exactement quelle que soit l'interpolation
+    TEST_ASSERT(std::fabs(linear.discountFactorForDays(730) - std::pow(1.035, -2.0)) < 1e-12, 
+                "YieldCurve - Pilier lineaire");
+    TEST_ASSERT(std::fabs(cubic.discountFactorForDays(1825) - std::pow(1.04, -5.0)) < 1e-12, 
+                "YieldCurve - Pilier cubique");
+    TEST_ASSERT(cubic.discountFactorForDays(0) == 1.0, "YieldCurve - Facteur unitaire a l'origine");
+    
+    // Log-lineaire : log des facteurs lineaire entre deux piliers
+    double middle = std::exp(0.5 * (std::log(linear.discountFactorForDays(365)) + 
+                                    std::log(linear.discountFactorForDays(730))));
+    TEST_ASSERT(std::fabs(linear.discountFactorForDays(547) - linear.discountFactor(547 / 365.0)) < 1e-12 && 
+                std::fabs(linear.discountFactor(547.5 / 365.0) - middle) < 1e-12, "YieldCurve - Interpolation log-lineaire");
+    
+    // Monotonie et grille journaliere coherente avec l'interpolation directe
+    bool decreasing = true;
+    for (int day = 1; day <= 4000; day++) {
+        decreasing = decreasing && cubic.discountFactorForDays(day) < cubic.discountFactorForDays(day - 1);
+    }
+    TEST_ASSERT(decreasing, "YieldCurve - Facteurs decroissants");
+    TEST_ASSERT(std::fabs(cubic.discountFactorForDays(1000) - cubic.discountFactor(1000 / 365.0)) < 1e-12, 
+                "YieldCurve - Grille journaliere");
+    int reference = cubic.getReferenceDay();
+    TEST_ASSERT(std::fabs(cubic.discountFactorBetween(reference + 365, reference + 730) * 
+                          cubic.discountFactorForDays(365) - cubic.discountFactorForDays(730)) < 1e-12, 
+                "YieldCurve - Actualisation entre deux dates");
+    TEST_ASSERT(std::fabs(cubic.zeroRate(reference + 730) - 0.035) < 1e-12, "YieldCurve - Taux zero");
+    TEST_ASSERT(cubic.forwardRate(reference + 730, reference + 1825) > 0.04, "YieldCurve - Taux forward");
+    TEST_EXCEPTION(YieldCurve("EUR", "2025-01-01", {{365, 0.03}, {365, 0.04}}), std::invalid_argument, 
+                   "YieldCurve - Piliers non croissants rejetes");
+    
+    // Chargement depuis un fichier par devise
+    std::string path = (std::filesystem::temp_directory_path() / "curves_test.csv").string();
+    {
+        std::ofstream out(path);
+        out << "# devise,date,jours,taux\n";
+        out << "EUR,2025-01-01,365,0.03\nEUR,2025-01-01,1825,0.04\nUSD,2025-01-01,365,0.05\n";
+    }
+    CurveStore curves;
+    TEST_ASSERT(curves.load(path) == 2 && curves.getCurvesCount() == 2, "CurveStore - Chargement");
+    TEST_ASSERT(curves.has("USD") && curves.get("EUR").getPillarsCount() == 2, "CurveStore - Courbes par devise");
+    TEST_EXCEPTION(curves.get("JPY"), std::invalid_argument, "CurveStore - Devise sans courbe");
+    {
+        std::ofstream out(path);
+        out << "EUR,2025-01-01,365\n";
+    }
+    TEST_EXCEPTION(curves.load(path), std::invalid_argument, "CurveStore - Ligne invalide rejetee");
+    
+    // Maturite en double : rejetee avec sa ligne, courbes existantes conservees
+    {
+        std::ofstream out(path);
+        out << "EUR,2025-01-01,365,0.03\nEUR,2025-01-01,730,0.035\nEUR,2025-01-01,365,0.04\n";
+    }
+    std::string error;
+    try {
+        curves.load(path);
+    } catch (const std::invalid_argument& e) {
+        error = e.what();
+    }
+    TEST_ASSERT(error.find("line 3") != std::string::npos && error.find("duplicate maturity") != std::string::npos, 
+                "CurveStore - Maturite en double rejetee");
+    TEST_ASSERT(curves.get("EUR").getPillarsCount() == 2, "CurveStore - Fichier invalide sans effet");
+    {
+        std::ofstream out(path);
+        out << "EUR,2025-01-01,365,0.03\nEUR,2025-01-01,730,-1.5\n";
+    }
+    error.clear();
+    try {
+        curves.load(path);
+    } catch (const std::invalid_argument& e) {
+        error = e.what();
+    }
+    TEST_ASSERT(error.find("line 2") != std::string::npos, "CurveStore - Taux invalide avec sa ligne");
+    std::filesystem::remove(path);
+    
+    // Facility a taux variable : forwards de la courbe plus la marge
+    std::vector<Lender> pool = {Lender("BNP")};
+    Facility floating("2025-01-01", "2027-01-01", 1000000.0, "EUR", pool, 0.05);
+    uint64_t version = floating.getVersion();
+    floating.setFloatingRate("EUR", 0.01);
+    TEST_ASSERT(floating.isFloating() && floating.getVersion() == version + 1, "Facility - Taux variable");
+    TEST_EXCEPTION(floating.setFloatingRate("EUR", 2.0), std::invalid_argument, "Facility - Marge invalide rejetee");
+    floating.payPart(500000.0, "2026-01-01");
+    std::vector<CashFlow> flows = pricing::cashFlows(floating, curves);
+    double forward = curves.get("EUR").forwardRate(toDayNumber("2025-01-01"), toDayNumber("2026-01-01"));
+    TEST_ASSERT(std::fabs(flows[1].amount - (500000.0 + 1000000.0 * (forward + 0.01))) < 1e-6, 
+                "Pricing - Interets au taux variable");
+    TEST_ASSERT(std::fabs(flows[1].amount - (500000.0 + 1000000.0 * 0.04)) < 1e-6, "Pricing - Forward du premier pilier");
+    
+    std::vector<Deal> deals;
+    deals.push_back(Deal("S0001", "BNP", pool, Borrower("Orange"), 5000000.0, "EUR", 
+                         "2025-01-01", "2030-01-01", Deal::Status::CLOSED));
+    deals[0].addFacility(floating);
+    PricingEngine engine(curves);
+    std::vector<FacilityPricing> results = engine.priceBook(deals, "2025-01-01");
+    TEST_ASSERT(results.size() == 1 && results[0].converged && results[0].npv > 0, "PricingEngine - Courbes par devise");
+}
+
+// Tests pour le serveur local du book
+void test_book_server() {
+    std::cout << "\n=== Tests BookServer ===" << std::endl;
+    
+    // Aller-retour du codage binaire
+    std::vector<uint8_t> bytes;
+    protocol::Encoder encoder(bytes);
+    protocol::encode(encoder, protocol::PaymentSpec{"S0001", 2, 1500.5, "2025-01-01"});
+    protocol::Decoder decoder(bytes.data(), bytes.size());
+    protocol::PaymentSpec decoded = protocol::decodePaymentSpec(decoder);
+    TEST_ASSERT(decoded.contractNum == "S0001" && decoded.facilityIndex == 2 && decoded.amount == 1500.5 && 
+                decoded.date == "2025-01-01" && decoder.atEnd(), "BookProtocol - Aller-retour");
+    protocol::Decoder truncated(bytes.data(), bytes.size() - 1);
+    TEST_EXCEPTION(protocol::decodePaymentSpec(truncated), std::runtime_error, "BookProtocol - Message tronque");
+    
+#ifndef _WIN32
+    BookStore book;
+    std::string path = (std::filesystem::temp_directory_path() / "book_server_test.sock").string();
+    BookServer server(book, path, 2);
+    server.start();
+    TEST_ASSERT(server.isRunning(), "BookServer - Demarrage");
+    
+    // Un lot melangeant ecritures et lectures
+    BookClient client(path);
+    client.createDeal({"S0001", "BNP", "Air France", {"BNP", "SG"}, 2000000.0, "EUR", 
+                       "2024-01-01", "2030-01-01", static_cast<uint8_t>(Deal::Status::CLOSED)});
+    client.addFacility({"S0001", "2024-01-01", "2030-01-01", 1000000.0, "EUR", 0.05, {"BNP"}, {}, "", 0});
+    client.pay({"S0001", 0, 200000.0, "2025-01-01"});
+    client.pay({"B0404", 0, 1000.0, "2025-01-01"});
+    client.getDeal("S0001");
+    client.query(protocol::QuerySpec{protocol::ANY_STATUS, "EUR", "Air France", ""});
+    client.portfolio();
+    TEST_ASSERT(client.getPendingCount() == 7, "BookClient - Requetes mises en lot");
+    std::vector<protocol::Reply> replies = client.flush();
+    TEST_ASSERT(replies.size() == 7 && client.getPendingCount() == 0, "BookClient - Reponses du lot");
+    TEST_ASSERT(replies[0].ok && replies[1].ok && replies[1].facilityIndex == 0, "BookServer - Creation deal et facility");
+    TEST_ASSERT(replies[2].ok && replies[2].remaining == Money::fromDouble(800000.0), "BookServer - Paiement");
+    TEST_ASSERT(!replies[3].ok && !replies[3].error.empty(), "BookServer - Erreur renvoyee a sa place");
+    TEST_ASSERT(replies[4].ok && replies[4].deal.borrower == "Air France" && replies[4].deal.facilitiesCount == 1 && 
+                replies[4].deal.remaining == Money::fromDouble(800000.0), "BookServer - Resume du deal");
+    TEST_ASSERT(replies[5].ok && replies[5].query.count == 1 && replies[5].query.contracts[0] == "S0001", 
+                "BookServer - Requete apres ecriture");
+    TEST_ASSERT(replies[6].ok && replies[6].portfolio.partsCount == 1 && 
+                replies[6].portfolio.amount == Money::fromDouble(1000000.0), "BookServer - Portfolio");
+    
+    // Acces concurrents de plusieurs clients au meme book
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&path]() {
+            BookClient worker(path);
+            for (int batch = 0; batch < 5; batch++) {
+                for (int i = 0; i < 10; i++) {
+                    worker.pay({"S0001", 0, 1000.0, "2025-06-01"});
+                    worker.portfolio("S0001");
+                }
+                worker.flush();
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    TEST_ASSERT(book.getFacility({book.findDeal("S0001"), 0}).getRemainingAmount() == 600000.0, 
+                "BookServer - Paiements concurrents");
+    TEST_ASSERT(server.getRequestsCount() == 407 && server.getBatchesCount() == 21, "BookServer - Compteurs");
+    
+    // Facility avec participations et taux variable, puis arrete de cette seule facility
+    std::vector<uint8_t> batch;
+    protocol::Encoder request(batch);
+    request.putU16(2);
+    request.putU8(static_cast<uint8_t>(protocol::Opcode::ADD_FACILITY));
+    protocol::encode(request, protocol::FacilitySpec{"S0001", "2024-01-01", "2030-01-01", 500000.0, "EUR", 0.05, 
+                                                     {"BNP", "CA"}, {Money::fromDouble(300000.0), Money::fromDouble(200000.0)}, 
+                                                     "EUR", 0.01});
+    request.putU8(static_cast<uint8_t>(protocol::Opcode::ACCRUE));
+    request.putString("2026-03-01");
+    request.putString("S0001");
+    request.putU32(1);
+    std::vector<uint8_t> answer;
+    server.handleBatch(batch.data(), batch.size(), answer);
+    const Facility& shared = book.getFacility({book.findDeal("S0001"), 1});
+    TEST_ASSERT(shared.getShare("CA") == Money::fromDouble(200000.0) && shared.isFloating() && shared.getSpread() == 0.01, 
+                "BookServer - Participations et taux variable recus");
+    TEST_ASSERT(shared.getAccrualDate() == "2026-03-01" && 
+                book.getFacility({book.findDeal("S0001"), 0}).getAccrualDate() == "2025-06-01", 
+                "BookServer - Arrete d'une seule facility");
+    
+    server.stop();
+    TEST_ASSERT(!server.isRunning() && !std::filesystem::exists(path), "BookServer - Arret");
+    TEST_EXCEPTION(BookClient{path}, std::runtime_error, "BookClient - Serveur arrete");
+    
+    // Un client qui ne lit pas ses reponses ne bloque pas les autres clients de sa boucle
+    BookStore large;
+    for (int i = 1; i <= 2000; i++) {
+        std::string number = std::to_string(i);
+        large.addDeal(Deal("S" + std::string(4 - number.size(), '0') + number, "BNP", {Lender("BNP")}, 
+                           Borrower("Orange"), 1000000.0, "EUR", "2024-01-01", "2030-01-01", Deal::Status::CLOSED));
+    }
+    BookServer single(large, path, 1);
+    single.start();
+    BookClient slow(path);
+    BookClient fast(path);
+    for (int i = 0; i < 200; i++) {
+        slow.query(protocol::QuerySpec{protocol::ANY_STATUS, "EUR", "Orange", ""});
+    }
+    slow.send();
+    fast.portfolio();
+    std::vector<protocol::Reply> prompt = fast.flush();
+    TEST_ASSERT(prompt.size() == 1 && prompt[0].ok && prompt[0].portfolio.amount == Money(), 
+                "BookServer - Client lent sans effet sur les autres");
+    std::vector<protocol::Reply> delayed = slow.receive();
+    bool complete = delayed.size() == 200;
+    for (const protocol::Reply& reply : delayed) {
+        complete = complete && reply.ok && reply.query.count == 2000 && reply.query.contracts.size() == 2000;
+    }
+    TEST_ASSERT(complete, "BookServer - Reponses du client lent conservees");
+    single.stop();
+    
+    // Trame annoncee au-dela du tampon de lecture : le serveur abandonne la connexion
+    int pair[2];
+    TEST_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == 0, "BookServer - Paire de sockets");
+    std::atomic<bool> served(false);
+    std::thread serving([&large, &pair, &served]() {
+        BookServer(large, "", 1).serve(pair[1]);
+        served = true;
+    });
+    std::vector<uint8_t> oversized;
+    protocol::Encoder(oversized).putU32(protocol::MAX_FRAME_SIZE + 1);
+    oversized.resize(4 + 65536, 0);
+    ssize_t written = send(pair[0], oversized.data(), oversized.size(), 0);
+    serving.join();
+    TEST_ASSERT(written > 0 && served, "BookServer - Trame trop grande refusee");
+    close(pair[0]);
+    close(pair[1]);
+#endif
+}
+
+// Tests d'integration
+void test_integration() {
+    std::cout << "\n=== Tests d'Integration ===" << std::endl;
+    
+    // Scenario complet : Creation d'un deal avec facility et remboursements
+    try {
+        // Creation des acteurs
+        Borrower borrower("Air France");
+        std::vector<Lender> pool = {Lender("BNP Paribas"), Lender("Societe Generale")};
+        
+        // Creation du deal
+        Deal deal("B9876", "BNP Paribas", pool, borrower, 50000000.0, "EUR", 
+                  "2024-01-01", "2026-01-01", Deal::Status::CLOSED);
+        
+        // Creation de la facility
+        Facility facility("2024-01-01", "2026-01-01", 30000000.0, "EUR", pool, 0.04);
+        
+        // Ajout de remboursements
+        facility.payPart(5000000.0, "2024-06-01");
+        facility.payPart(10000000.0, "2025-01-01");
+        facility.payPart(8000000.0, "2025-06-01");
+        
+        // Ajout de la facility au deal
+        deal.addFacility(facility);
+        
+        // Creation du portfolio
+        Portfolio portfolio(&facility);
+        
+        // Verifications finales
+        TEST_ASSERT(deal.getFacilitiesCount() == 1, "Integration - Deal contient facility");
+        TEST_ASSERT(facility.getPartsCount() == 3, "Integration - Facility contient 3 parts");
+        TEST_ASSERT(facility.getRemainingAmount() == 7000000.0, "Integration - Montant restant correct");
+        TEST_ASSERT(portfolio.getNumberOfParts() == 3, "Integration - Portfolio synchronise");
+        TEST_ASSERT(deal.getTotalFacilitiesAmount() <= deal.getProjectAmount(), "Integration - Facilities <= Projet");
+        
+        // Test completion du deal
+        deal.setStatus(Deal::Status::TERMINATED);
+        TEST_ASSERT(deal.isCompleted(), "Integration - Deal termine");
+        
+        std::cout << "PASS: Scenario d'integration complet" << std::endl;
+        tests_passed++;
+        
+    } catch (const std::exception& e) {
+        std::cout << "FAIL: Scenario d'integration - Exception: " << e.what() << std::endl;
+        tests_failed++;
+    }
+}
+
+// Fonction principale des tests
+int main() {
+    std::cout << "Demarrage des tests unitaires du systeme de financement structure\n" << std::endl;
+    
+    try {
+        test_borrower();
+        test_lender();
+        test_part();
+        test_facility();
+        test_deal();
+        test_portfolio();
+        test_book_store();
+        test_money();
+        test_packed_codes();
+        test_borrower_index();
+        test_columnar_export();
+        test_bitmap();
+        test_query_engine();
+        test_report_renderer();
+        test_date_utils();
+        test_calendar_index();
+        test_tiered_book();
+        test_import_pipeline();
+        test_book_history();
+        test_participation_market();
+        test_covenant_engine();
+        test_book_digest();
+        test_change_stream();
+        test_task_scheduler();
+        test_shard_coordinator();
+        test_part_history();
+        test_growth_factor_cache();
+        test_pricing();
+        test_yield_curve();
+        test_book_server();
+        test_integration();
+        
+        std::cout << "\n" << std::string(50, '=') << std::endl;
+        std::cout << "RESULTATS DES TESTS" << std::endl;
+        std::cout << std::string(50, '=') << std::endl;
+        std::cout << "Tests reussis: " << tests_passed << std::endl;
+        std::cout << "Tests echoues: " << tests_failed << std::endl;
+        std::cout << "Taux de reussite: " << (tests_passed * 100.0 / (tests_passed + tests_failed)) << "%" << std::endl;
+        
+        if (tests_failed == 0) {
+            std::cout << "\nTOUS LES TESTS SONT PASSES ! Le systeme fonctionne correctement." << std::endl;
+            return 0;
+        } else {
+            std::cout << "\nCERTAINS TESTS ONT ECHOUE. Verifiez l'implementation." << std::endl;
+            return 1;
+        }
+        
+    } catch (const std::exception& e) {
+        std::cout << "ERREUR FATALE lors des tests: " << e.what() << std::endl;
+        return 1;
+    }
 }
\ No newline at end of file